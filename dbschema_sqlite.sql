@@ -65,4 +65,13 @@ CREATE TABLE IF NOT EXISTS config (
   fee INTEGER NOT NULL,
   mining_mode TEXT NOT NULL,
   round_duration_hours INTEGER NOT NULL
-);
\ No newline at end of file
+);
+
+CREATE INDEX IF NOT EXISTS block_round_hash ON block(round, hash);
+CREATE INDEX IF NOT EXISTS block_hash ON block(hash);
+CREATE INDEX IF NOT EXISTS block_height ON block(height);
+CREATE INDEX IF NOT EXISTS payment_name_round ON payment(name, round);
+CREATE INDEX IF NOT EXISTS payment_round_payment_date_time ON payment(round, payment_date_time);
+CREATE INDEX IF NOT EXISTS account_shares ON account(shares, name) WHERE shares > 0;
+
+PRAGMA user_version = 2;
\ No newline at end of file
@@ -37,7 +37,7 @@ namespace LLC
 
 		uint32_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 1344, 256, 32, 0x06);
+		Keccak_HashInitialize<1344, 256>(&ctx_keccak, 32, 0x06);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 32);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
@@ -61,7 +61,7 @@ namespace LLC
 
 		uint32_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 1344, 256, 32, 0x06);
+		Keccak_HashInitialize<1344, 256>(&ctx_keccak, 32, 0x06);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 32);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
@@ -85,7 +85,7 @@ namespace LLC
 
 		uint64_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 1344, 256, 64, 0x06);
+		Keccak_HashInitialize<1344, 256>(&ctx_keccak, 64, 0x06);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 64);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
@@ -108,7 +108,7 @@ namespace LLC
 
 		uint64_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 1344, 256, 64, 0x06);
+		Keccak_HashInitialize<1344, 256>(&ctx_keccak, 64, 0x06);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 64);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
@@ -343,7 +343,7 @@ namespace LLC
 
 		uint1024_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 576, 1024, 1024, 0x05);
+		Keccak_HashInitialize<576, 1024>(&ctx_keccak, 1024, 0x05);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 1024);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
@@ -367,7 +367,7 @@ namespace LLC
 
 		uint1024_t keccak;
 		Keccak_HashInstance ctx_keccak;
-		Keccak_HashInitialize(&ctx_keccak, 576, 1024, 1024, 0x05);
+		Keccak_HashInitialize<576, 1024>(&ctx_keccak, 1024, 0x05);
 		Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 1024);
 		Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
 
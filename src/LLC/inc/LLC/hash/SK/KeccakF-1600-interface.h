@@ -70,6 +70,13 @@ void KeccakF1600_StateComplementBit(void* state, uint32_t position);
   */
 void KeccakF1600_StatePermute(void* state);
 
+/** The Keccak-f[1600] backends. KeccakF1600_StatePermute() calls the one selected at build time,
+  * the fully unrolled lane complementing one unless LLC_KECCAK_COMPACT is defined.
+  * @param  state   Pointer to the state.
+  */
+void KeccakF1600_StatePermute_Compact(void* state);
+void KeccakF1600_StatePermute_Opt64(void* state);
+
 /** Function to retrieve data from the state into bytes.
   * The bits to output are restricted to be consecutive and to be in the same lane.
   * The bit positions that are retrieved by this function are
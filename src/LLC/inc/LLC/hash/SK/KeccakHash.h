@@ -13,6 +13,7 @@ http://creativecommons.org/publicdomain/zero/1.0/
 #define _KeccakHashInterface_h_
 
 #include <LLC/hash/SK/KeccakSponge.h>
+#include <string.h>
 
 typedef uint8_t BitSequence;
 typedef unsigned long long DataLength;
@@ -66,6 +67,44 @@ HashReturn Keccak_HashInitialize(Keccak_HashInstance* hashInstance, uint32_t rat
             */
 #define Keccak_HashInitialize_SHA3_512(hashInstance)        Keccak_HashInitialize(hashInstance,  576, 1024, 512, 0x06)
 
+/**
+  * Keccak_HashInitialize() with the rate and capacity fixed at compile time.
+  * The parameter sets used by SK are specialized: (576, 1024) for SK1024 and (1344, 256) for SK32 / SK64.
+  * They skip the runtime parameter checks, all other sets are checked as usual.
+  */
+template<uint32_t rate, uint32_t capacity>
+inline HashReturn Keccak_HashInitialize(Keccak_HashInstance* hashInstance, uint32_t hashbitlen, uint8_t delimitedSuffix)
+{
+    return Keccak_HashInitialize(hashInstance, rate, capacity, hashbitlen, delimitedSuffix);
+}
+
+template<uint32_t rate>
+inline HashReturn Keccak_HashInitializeFixed(Keccak_HashInstance* hashInstance, uint32_t hashbitlen, uint8_t delimitedSuffix)
+{
+    static_assert(rate > 0 && rate < KeccakF_width && (rate % 8) == 0, "invalid Keccak rate");
+    if (delimitedSuffix == 0)
+        return FAIL;
+    memset(hashInstance->sponge.state, 0, sizeof(hashInstance->sponge.state));
+    hashInstance->sponge.rate = rate;
+    hashInstance->sponge.byteIOIndex = 0;
+    hashInstance->sponge.squeezing = 0;
+    hashInstance->fixedOutputLength = hashbitlen;
+    hashInstance->delimitedSuffix = delimitedSuffix;
+    return SUCCESS;
+}
+
+template<>
+inline HashReturn Keccak_HashInitialize<576, 1024>(Keccak_HashInstance* hashInstance, uint32_t hashbitlen, uint8_t delimitedSuffix)
+{
+    return Keccak_HashInitializeFixed<576>(hashInstance, hashbitlen, delimitedSuffix);
+}
+
+template<>
+inline HashReturn Keccak_HashInitialize<1344, 256>(Keccak_HashInstance* hashInstance, uint32_t hashbitlen, uint8_t delimitedSuffix)
+{
+    return Keccak_HashInitializeFixed<1344>(hashInstance, hashbitlen, delimitedSuffix);
+}
+
             /**
               * Function to give input data to be absorbed.
               * @param  hashInstance    Pointer to the hash instance initialized by Keccak_HashInitialize().
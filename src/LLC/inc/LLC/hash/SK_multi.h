@@ -0,0 +1,78 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_HASH_SK_MULTI_H
+#define NEXUS_LLC_HASH_SK_MULTI_H
+
+#include <LLC/types/uint1024.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/** Namespace LLC (Lower Level Crypto) **/
+namespace LLC
+{
+
+	/** SK1024 kernels. AVX2 hashes 4 messages at once, AVX512 hashes 8 messages at once. **/
+	enum class SK1024Kernel : uint8_t
+	{
+		SCALAR = 0,
+		AVX2   = 1,
+		AVX512 = 2
+	};
+
+
+	/** SK1024Supported
+	 *
+	 *  Checks if a kernel can run on this cpu (and was compiled in).
+	 *
+	 **/
+	bool SK1024Supported(SK1024Kernel kernel);
+
+
+	/** SK1024BestKernel
+	 *
+	 *  The widest kernel supported by this cpu. Detected once at runtime.
+	 *
+	 **/
+	SK1024Kernel SK1024BestKernel();
+
+
+	/** SK1024Lanes
+	 *
+	 *  Number of messages a kernel hashes at once.
+	 *
+	 **/
+	uint32_t SK1024Lanes(SK1024Kernel kernel);
+
+
+	/** SK1024Multi
+	 *
+	 *  Hashes nCount messages of nSize bytes each. The result is identical to
+	 *  SK1024(pMessages[i], pMessages[i] + nSize) for every message.
+	 *
+	 *  @param[in] pMessages The messages to hash
+	 *  @param[in] nSize Size of every message in bytes
+	 *  @param[out] pHashes nCount hashes
+	 *  @param[in] nCount Number of messages
+	 *
+	 **/
+	void SK1024Multi(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes, size_t nCount);
+
+
+	/** SK1024Multi
+	 *
+	 *  Same as above with the given kernel (tests and benchmarks). Falls back to scalar if the kernel is not supported.
+	 *
+	 **/
+	void SK1024Multi(SK1024Kernel kernel, const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes, size_t nCount);
+
+}
+
+#endif
@@ -5,45 +5,95 @@
             file COPYING or http://www.opensource.org/licenses/mit-license.php.
             "ad vocem populi" - To the Voice of the People
 ____________________________________________________________________________________________*/
-#include <cstdint>
 
+#pragma once
+#ifndef NEXUS_LLC_PRIME_FERMAT_H
+#define NEXUS_LLC_PRIME_FERMAT_H
+
+#include <LLC/types/uint1024.h>
+
+#include <cstdint>
+#include <cstring>
 
 
 #define WINDOW_BITS 7
 #define WINDOW_SIZE (1 << WINDOW_BITS)
 
-template<uint8_t WORD_MAX>
-inline void assign(uint32_t* l, uint32_t* r)
+#if defined(__GNUC__) && !defined(__clang__)
+#define FERMAT_UNROLL _Pragma("GCC unroll 32")
+#else
+#define FERMAT_UNROLL
+#endif
+
+/* sqrredc and mulredc unroll to a few thousand instructions, inlined into the exponent loop they get slower */
+#if defined(__GNUC__)
+#define FERMAT_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define FERMAT_NOINLINE __declspec(noinline)
+#else
+#define FERMAT_NOINLINE
+#endif
+
+/* Fixed width Montgomery arithmetic on little endian words (uint32_t, or uint64_t where the compiler has 128-bit integers).
+ * Nothing allocates, all scratch space is on the stack. N must be odd. */
+namespace LLC
+{
+
+template<typename Word>
+struct Fermat_word;
+
+template<>
+struct Fermat_word<uint32_t>
+{
+    using Wide = uint64_t;
+    static constexpr uint16_t BITS = 32;
+    static constexpr uint16_t SHIFT = 5;
+};
+
+#if defined(__SIZEOF_INT128__)
+template<>
+struct Fermat_word<uint64_t>
+{
+    using Wide = unsigned __int128;
+    static constexpr uint16_t BITS = 64;
+    static constexpr uint16_t SHIFT = 6;
+};
+#endif
+
+
+template<uint8_t WORD_MAX, typename Word>
+inline void assign(Word* l, Word* r)
 {
-    //#pragma unroll
+    FERMAT_UNROLL
     for (uint8_t i = 0; i < WORD_MAX; ++i)
         l[i] = r[i];
 }
 
 
-template<uint8_t WORD_MAX>
-inline void assign_zero(uint32_t* l)
+template<uint8_t WORD_MAX, typename Word>
+inline void assign_zero(Word* l)
 {
-    //#pragma unroll
+    FERMAT_UNROLL
     for (uint8_t i = 0; i < WORD_MAX; ++i)
         l[i] = 0;
 }
 
 
-inline int32_t inv2adic(uint32_t x)
+/* -x^-1 mod 2^BITS, newton iteration from 4 correct bits. */
+template<typename Word>
+inline Word inv2adic(Word x)
 {
-    uint32_t a;
+    Word a;
     a = x;
     x = (((x + 2) & 4) << 1) + x;
-    x *= 2 - a * x;
-    x *= 2 - a * x;
-    x *= 2 - a * x;
+    for (uint16_t bits = 4; bits < Fermat_word<Word>::BITS; bits <<= 1)
+        x *= 2 - a * x;
     return -x;
 }
 
 
-template<uint8_t WORD_MAX>
-inline uint32_t cmp_ge_n(uint32_t* x, uint32_t* y)
+template<uint8_t WORD_MAX, typename Word>
+inline uint32_t cmp_ge_n(Word* x, Word* y)
 {
     for (int8_t i = WORD_MAX - 1; i >= 0; --i)
     {
@@ -57,31 +107,32 @@ inline uint32_t cmp_ge_n(uint32_t* x, uint32_t* y)
 }
 
 
-template<uint8_t WORD_MAX>
-inline uint8_t sub_n(uint32_t* z, uint32_t* x, uint32_t* y)
+template<uint8_t WORD_MAX, typename Word>
+inline uint8_t sub_n(Word* z, Word* x, Word* y)
 {
-    uint32_t temp;
+    using Wide = typename Fermat_word<Word>::Wide;
+
+    Wide temp;
     uint8_t c = 0;
 
-    //#pragma unroll
+    FERMAT_UNROLL
     for (uint8_t i = 0; i < WORD_MAX; ++i)
     {
-        temp = x[i] - y[i] - c;
-        c = (temp > x[i]);
-        z[i] = temp;
+        temp = static_cast<Wide>(x[i]) - y[i] - c;
+        c = (temp >> Fermat_word<Word>::BITS) & 1;   //borrow, also when y[i] is all ones and c was set
+        z[i] = static_cast<Word>(temp);
     }
     return c;
 }
 
 
-template<uint8_t WORD_MAX>
-inline void sub_ui(uint32_t* z, uint32_t* x, const uint32_t& ui)
+template<uint8_t WORD_MAX, typename Word>
+inline void sub_ui(Word* z, Word* x, const uint32_t& ui)
 {
-    uint32_t temp = x[0] - ui;
+    Word temp = x[0] - ui;
     uint8_t c = temp > x[0];
     z[0] = temp;
 
-    //#pragma unroll
     for (uint8_t i = 1; i < WORD_MAX; ++i)
     {
         temp = x[i] - c;
@@ -91,183 +142,159 @@ inline void sub_ui(uint32_t* z, uint32_t* x, const uint32_t& ui)
 }
 
 
-template<uint8_t WORD_MAX>
-inline void add_ui(uint32_t* z, uint32_t* x, const uint64_t& ui)
+template<uint8_t WORD_MAX, typename Word>
+inline Word addmul_1(Word* z, Word* x, const Word y)
 {
-    uint32_t temp = x[0] + static_cast<uint32_t>(ui & 0xFFFFFFFF);
-    uint8_t c = temp < x[0];
-    z[0] = temp;
-
-    temp = x[1] + static_cast<uint32_t>(ui >> 32) + c;
-    c = temp < x[1];
-    z[1] = temp;
-
-    //#pragma unroll
-    for (uint8_t i = 2; i < WORD_MAX; ++i)
-    {
-        temp = x[i] + c;
-        c = (temp < x[i]);
-        z[i] = temp;
-    }
-}
+    using Wide = typename Fermat_word<Word>::Wide;
 
+    Wide prod;
+    Word c = 0;
 
-template<uint8_t WORD_MAX>
-inline uint32_t addmul_1(uint32_t* z, uint32_t* x, const uint32_t y)
-{
-    uint64_t prod;
-    uint32_t c = 0;
-
-    //#pragma unroll
+    FERMAT_UNROLL
     for (uint8_t i = 0; i < WORD_MAX; ++i)
     {
-        prod = static_cast<uint64_t>(x[i]) * static_cast<uint64_t>(y);
+        prod = static_cast<Wide>(x[i]) * static_cast<Wide>(y);
         prod += c;
         prod += z[i];
-        z[i] = prod;
-        c = prod >> 32;
+        z[i] = static_cast<Word>(prod);
+        c = prod >> Fermat_word<Word>::BITS;
     }
 
     return c;
 }
 
 
-
-template<uint8_t WORD_MAX>
-inline void sqrredc(uint32_t* z, uint32_t* x, uint32_t* n, const uint32_t d, uint32_t* t)
+/* Column accumulator for product scanning: acc holds the low two words, acc2 the third. */
+template<typename Word>
+inline void mac(typename Fermat_word<Word>::Wide& acc, Word& acc2, const Word x, const Word y)
 {
-    uint64_t prod;
-    uint32_t m;
-    uint32_t c;
+    using Wide = typename Fermat_word<Word>::Wide;
 
-    uint8_t i;
-    uint8_t j;
+    Wide prod = static_cast<Wide>(x) * y;
+    acc += prod;
+    acc2 += (acc < prod);
+}
 
-    for (i = 0; i < (WORD_MAX << 1); ++i)
-        t[i] = 0;
 
+/* Shift the accumulator one word down after a column is done. */
+template<typename Word>
+inline void next_column(typename Fermat_word<Word>::Wide& acc, Word& acc2)
+{
+    using Wide = typename Fermat_word<Word>::Wide;
 
-    for (i = 0; i < WORD_MAX; ++i)
-    {
-        for (j = i + 1; j < WORD_MAX; ++j)
-        {
-            prod = static_cast<uint64_t>(x[j]) * static_cast<uint64_t>(x[i]) +
-                static_cast<uint64_t>(t[i + j]) + c;
+    acc = (acc >> Fermat_word<Word>::BITS) | (static_cast<Wide>(acc2) << Fermat_word<Word>::BITS);
+    acc2 = 0;
+}
 
-            t[i + j] = prod;
-            c = prod >> 32;
-        }
-        t[WORD_MAX + i] = c;
-        c = 0;
-    }
 
+/* Montgomery reduction part of column k. t[0, WORD_MAX) holds m, t[WORD_MAX, WORD_MAX << 1] the result. */
+template<uint8_t WORD_MAX, typename Word>
+inline void reduce_column(typename Fermat_word<Word>::Wide& acc, Word& acc2, uint8_t k, Word* n, const Word d, Word* t)
+{
+    uint8_t i = (k < WORD_MAX) ? 0 : k - WORD_MAX + 1;
+    uint8_t end = (k < WORD_MAX) ? k : WORD_MAX;
 
-    for (i = 0; i < (WORD_MAX << 1); ++i)
+    FERMAT_UNROLL
+    for (; i < end; ++i)
+        mac(acc, acc2, t[i], n[k - i]);
+
+    if (k < WORD_MAX)
     {
-        prod = (static_cast<uint64_t>(t[i]) << 1) + c;
-        t[i] = prod;
-        c = prod >> 32;
+        /* choose m so the low word of the column becomes zero */
+        t[k] = static_cast<Word>(acc) * d;
+        mac(acc, acc2, t[k], n[0]);
     }
+    else
+        t[k] = static_cast<Word>(acc);
 
+    next_column(acc, acc2);
+}
 
-    for (i = 0; i < WORD_MAX; ++i)
-    {
-        prod = static_cast<uint64_t>(x[i]) * static_cast<uint64_t>(x[i]) +
-            static_cast<uint64_t>(t[i + i]);
 
-        t[i + i] = prod;
-        c = prod >> 32;
+/* z = t[WORD_MAX, WORD_MAX << 1] mod N, the result is < 2N so it may be one bit wider than N. */
+template<uint8_t WORD_MAX, typename Word>
+inline void final_sub(Word* z, Word* n, Word* t)
+{
+    if (t[WORD_MAX << 1] || cmp_ge_n<WORD_MAX>(&t[WORD_MAX], n))
+        sub_n<WORD_MAX>(z, &t[WORD_MAX], n);
+    else
+        assign<WORD_MAX>(z, &t[WORD_MAX]);
+}
 
-        for (j = i + 1; j < WORD_MAX; ++j)
-        {
-            prod = static_cast<uint64_t>(t[i + j]) + c;
-            t[i + j] = prod;
-            c = prod >> 32;
-        }
 
-        t[WORD_MAX + i] += c;
+/* z = x * x / R mod N. t needs (WORD_MAX << 1) + 1 words. */
+template<uint8_t WORD_MAX, typename Word>
+FERMAT_NOINLINE void sqrredc(Word* z, Word* x, Word* n, const Word d, Word* t)
+{
+    using Wide = typename Fermat_word<Word>::Wide;
+    constexpr uint16_t BITS = Fermat_word<Word>::BITS;
 
-    }
+    Wide acc = 0;
+    Word acc2 = 0;
 
+    FERMAT_UNROLL
+    for (uint8_t k = 0; k < (WORD_MAX << 1) - 1; ++k)
+    {
+        /* x[i] * x[k - i] with i < k - i, counted twice */
+        Wide cross = 0;
+        Word cross2 = 0;
 
-    c = 0;
+        FERMAT_UNROLL
+        for (uint8_t i = (k < WORD_MAX) ? 0 : k - WORD_MAX + 1; i < k - i; ++i)
+            mac(cross, cross2, x[i], x[k - i]);
 
-    for (i = 0; i < WORD_MAX; ++i)
-    {
-        m = t[i] * d;
+        cross2 = (cross2 << 1) | static_cast<Word>(cross >> ((BITS << 1) - 1));
+        cross <<= 1;
 
-        for (j = 0; j < WORD_MAX; ++j)
-        {
-            prod = static_cast<uint64_t>(t[i + j]) + m * static_cast<uint64_t>(n[j]) + c;
-            c = prod >> 32;
-            t[i + j] = prod;
-        }
+        acc += cross;
+        acc2 += cross2 + (acc < cross);
 
-        j = i;
+        if ((k & 1) == 0)
+            mac(acc, acc2, x[k >> 1], x[k >> 1]);
 
-        while (c != 0)
-        {
-            prod = static_cast<uint64_t>(t[WORD_MAX + j]) + c;
-            c = prod >> 32;
-            t[WORD_MAX + j] = prod;
-            ++j;
-        }
+        reduce_column<WORD_MAX>(acc, acc2, k, n, d, t);
     }
 
+    t[(WORD_MAX << 1) - 1] = static_cast<Word>(acc);
+    t[WORD_MAX << 1] = static_cast<Word>(acc >> BITS);
 
-    if (cmp_ge_n<WORD_MAX>(&t[WORD_MAX], n))
-        sub_n<WORD_MAX>(z, &t[WORD_MAX], n);
-    else
-        assign<WORD_MAX>(z, &t[WORD_MAX]);
+    final_sub<WORD_MAX>(z, n, t);
 }
 
 
-template<uint8_t WORD_MAX>
-inline void mulredc(uint32_t* z, uint32_t* x, uint32_t* y, uint32_t* n, const uint32_t d, uint32_t* t)
+/* z = x * y / R mod N. t needs (WORD_MAX << 1) + 1 words. */
+template<uint8_t WORD_MAX, typename Word>
+FERMAT_NOINLINE void mulredc(Word* z, Word* x, Word* y, Word* n, const Word d, Word* t)
 {
-    //uint32_t m;//, c;
-    //uint64_t temp;
+    using Wide = typename Fermat_word<Word>::Wide;
 
-    assign_zero<WORD_MAX>(t);
-    t[WORD_MAX] = 0;
-    t[WORD_MAX + 1] = 0;
+    Wide acc = 0;
+    Word acc2 = 0;
 
-    for (uint8_t i = 0; i < WORD_MAX; ++i)
+    FERMAT_UNROLL
+    for (uint8_t k = 0; k < (WORD_MAX << 1) - 1; ++k)
     {
-        //c = addmul_1(t, x, y[i]);
-        t[WORD_MAX] += addmul_1<WORD_MAX>(t, x, y[i]);
-        //temp = static_cast<uint64_t>(t[WORD_MAX]) + c;
-        //t[WORD_MAX] = temp;
-        //t[WORD_MAX] += c;
-        //t[WORD_MAX + 1] = temp >> 32;
-
-        //m = t[0]*d;
-
-        //c = addmul_1(t, n, m);
-        //t[WORD_MAX] += addmul_1<WORD_MAX>(t, n, m);
-        t[WORD_MAX] += addmul_1<WORD_MAX>(t, n, t[0] * d);
-        //temp = static_cast<uint64_t>(t[WORD_MAX]) + c;
-        //t[WORD_MAX] = temp;
-        //t[WORD_MAX] += c;
-        //t[WORD_MAX + 1] = temp >> 32;
-
-        //#pragma unroll
-        for (uint8_t j = 0; j <= WORD_MAX; ++j)
-            t[j] = t[j + 1];
+        uint8_t end = (k < WORD_MAX) ? k + 1 : WORD_MAX;
+
+        FERMAT_UNROLL
+        for (uint8_t i = (k < WORD_MAX) ? 0 : k - WORD_MAX + 1; i < end; ++i)
+            mac(acc, acc2, x[i], y[k - i]);
+
+        reduce_column<WORD_MAX>(acc, acc2, k, n, d, t);
     }
-    if (cmp_ge_n<WORD_MAX>(t, n))
-        sub_n<WORD_MAX>(t, t, n);
 
-    //#pragma unroll
-    for (uint8_t i = 0; i < WORD_MAX; ++i)
-        z[i] = t[i];
+    t[(WORD_MAX << 1) - 1] = static_cast<Word>(acc);
+    t[WORD_MAX << 1] = static_cast<Word>(acc >> Fermat_word<Word>::BITS);
+
+    final_sub<WORD_MAX>(z, n, t);
 }
 
 
-template<uint8_t WORD_MAX>
-void redc(uint32_t* z, uint32_t* x, uint32_t* n, const uint32_t d, uint32_t* t)
+/* z = x / R mod N, converts out of montgomery form. t needs WORD_MAX + 1 words. */
+template<uint8_t WORD_MAX, typename Word>
+inline void redc(Word* z, Word* x, Word* n, const Word d, Word* t)
 {
-    uint32_t m;
+    Word m;
 
     assign<WORD_MAX>(t, x);
 
@@ -291,15 +318,22 @@ void redc(uint32_t* z, uint32_t* x, uint32_t* n, const uint32_t d, uint32_t* t)
 }
 
 
-template<uint8_t WORD_MAX>
-uint16_t bit_count(uint32_t* x)
+/* Test bit i of x. */
+template<typename Word>
+inline bool bit_test(Word* x, uint16_t i)
+{
+    return (x[i >> Fermat_word<Word>::SHIFT] >> (i & (Fermat_word<Word>::BITS - 1))) & 1;
+}
+
+
+template<uint8_t WORD_MAX, typename Word>
+inline uint16_t bit_count(Word* x)
 {
     uint16_t msb = 0; //most significant bit
 
-    //#pragma unroll
-    for (uint16_t i = 0; i < (WORD_MAX << 5); ++i)
+    for (uint16_t i = 0; i < (WORD_MAX * Fermat_word<Word>::BITS); ++i)
     {
-        if (x[i >> 5] & (1 << (i & 31)))
+        if (bit_test(x, i))
             msb = i;
     }
 
@@ -307,13 +341,15 @@ uint16_t bit_count(uint32_t* x)
 }
 
 
-template<uint8_t WORD_MAX>
-inline void lshift(uint32_t* r, uint32_t* a, uint16_t shift)
+template<uint8_t WORD_MAX, typename Word>
+inline void lshift(Word* r, Word* a, uint16_t shift)
 {
+    constexpr uint16_t BITS = Fermat_word<Word>::BITS;
+
     assign_zero<WORD_MAX>(r);
 
-    uint8_t k = shift >> 5;
-    shift = shift & 31;
+    uint8_t k = shift >> Fermat_word<Word>::SHIFT;
+    shift = shift & (BITS - 1);
 
     for (int8_t i = 0; i < WORD_MAX; ++i)
     {
@@ -321,20 +357,22 @@ inline void lshift(uint32_t* r, uint32_t* a, uint16_t shift)
         uint8_t ik1 = ik + 1;
 
         if (ik1 < WORD_MAX && shift != 0)
-            r[ik1] |= (a[i] >> (32 - shift));
+            r[ik1] |= (a[i] >> (BITS - shift));
         if (ik < WORD_MAX)
             r[ik] |= (a[i] << shift);
     }
 }
 
 
-template<uint8_t WORD_MAX>
-inline void rshift(uint32_t* r, uint32_t* a, uint16_t shift)
+template<uint8_t WORD_MAX, typename Word>
+inline void rshift(Word* r, Word* a, uint16_t shift)
 {
+    constexpr uint16_t BITS = Fermat_word<Word>::BITS;
+
     assign_zero<WORD_MAX>(r);
 
-    uint8_t k = shift >> 5;
-    shift = shift & 31;
+    uint8_t k = shift >> Fermat_word<Word>::SHIFT;
+    shift = shift & (BITS - 1);
 
     for (int8_t i = 0; i < WORD_MAX; ++i)
     {
@@ -342,51 +380,58 @@ inline void rshift(uint32_t* r, uint32_t* a, uint16_t shift)
         int8_t ik1 = ik - 1;
 
         if (ik1 >= 0 && shift != 0)
-            r[ik1] |= (a[i] << (32 - shift));
+            r[ik1] |= (a[i] << (BITS - shift));
         if (ik >= 0)
             r[ik] |= (a[i] >> shift);
     }
 }
 
 
-template<uint8_t WORD_MAX>
-inline void lshift1(uint32_t* r, uint32_t* a)
+/* r = a << 1, returns the bit shifted out. */
+template<uint8_t WORD_MAX, typename Word>
+inline Word lshift1(Word* r, Word* a)
 {
-    uint32_t t = a[0];
-    uint32_t t2;
+    constexpr uint16_t BITS = Fermat_word<Word>::BITS;
+
+    Word t = a[0];
+    Word t2;
     r[0] = t << 1;
     for (uint8_t i = 1; i < WORD_MAX; ++i)
     {
         t2 = a[i];
-        r[i] = (t2 << 1) | (t >> 31);
+        r[i] = (t2 << 1) | (t >> (BITS - 1));
         t = t2;
     }
+
+    return t >> (BITS - 1);
 }
 
 
-template<uint8_t WORD_MAX>
-inline void rshift1(uint32_t* r, uint32_t* a)
+template<uint8_t WORD_MAX, typename Word>
+inline void rshift1(Word* r, Word* a)
 {
-    uint32_t t = a[WORD_MAX - 1];
-    uint32_t t2;
+    constexpr uint16_t BITS = Fermat_word<Word>::BITS;
+
+    Word t = a[WORD_MAX - 1];
+    Word t2;
 
     r[WORD_MAX - 1] = t >> 1;
     for (int8_t i = WORD_MAX - 2; i >= 0; --i)
     {
         t2 = a[i];
-        r[i] = (t2 >> 1) | (t << 31);
+        r[i] = (t2 >> 1) | (t << (BITS - 1));
         t = t2;
     }
 }
 
 
 /* Calculate ABar and BBar for Montgomery Modular Multiplication. */
-template<uint8_t WORD_MAX>
-void calcBar(uint32_t* a, uint32_t* b, uint32_t* n, uint32_t* t)
+template<uint8_t WORD_MAX, typename Word>
+inline void calcBar(Word* a, Word* b, Word* n, Word* t)
 {
     assign_zero<WORD_MAX>(a); // set R = 2^BITS == 0 (overflow mitigated by subtraction)
 
-    lshift<WORD_MAX>(t, n, (WORD_MAX << 5) - bit_count<WORD_MAX>(n));
+    lshift<WORD_MAX>(t, n, (WORD_MAX * Fermat_word<Word>::BITS) - bit_count<WORD_MAX>(n));
     sub_n<WORD_MAX>(a, a, t);
 
     while (cmp_ge_n<WORD_MAX>(a, n))  //calculate R mod N;
@@ -396,19 +441,18 @@ void calcBar(uint32_t* a, uint32_t* b, uint32_t* n, uint32_t* t)
             sub_n<WORD_MAX>(a, a, t);
     }
 
-    lshift1<WORD_MAX>(b, a);     //calculate 2R mod N;
-    if (cmp_ge_n<WORD_MAX>(b, n))
+    if (lshift1<WORD_MAX>(b, a) || cmp_ge_n<WORD_MAX>(b, n))     //calculate 2R mod N;
         sub_n<WORD_MAX>(b, b, n);
 }
 
 
 /* Calculate ABar and BBar for Montgomery Modular Multiplication. */
-template<uint8_t WORD_MAX>
-void calcBar(uint32_t* a, uint32_t* n, uint32_t* t)
+template<uint8_t WORD_MAX, typename Word>
+inline void calcBar(Word* a, Word* n, Word* t)
 {
     assign_zero<WORD_MAX>(a); // set R = 2^BITS == 0 (overflow mitigated by subtraction)
 
-    lshift<WORD_MAX>(t, n, (WORD_MAX << 5) - bit_count<WORD_MAX>(n));
+    lshift<WORD_MAX>(t, n, (WORD_MAX * Fermat_word<Word>::BITS) - bit_count<WORD_MAX>(n));
     sub_n<WORD_MAX>(a, a, t);
 
     while (cmp_ge_n<WORD_MAX>(a, n))  //calculate R mod N;
@@ -421,12 +465,11 @@ void calcBar(uint32_t* a, uint32_t* n, uint32_t* t)
 
 
 /* Calculate ABar and BBar for Montgomery Modular Multiplication. */
-template<uint8_t WORD_MAX>
-void calcTable(uint32_t* a, uint32_t* n, uint32_t* t, uint32_t* table)
+template<uint8_t WORD_MAX, typename Word>
+inline void calcTable(Word* a, Word* n, Word* t, Word* table)
 {
 
-    lshift1<WORD_MAX>(t, a);     //calculate 2R mod N;
-    if (cmp_ge_n<WORD_MAX>(t, n))
+    if (lshift1<WORD_MAX>(t, a) || cmp_ge_n<WORD_MAX>(t, n))     //calculate 2R mod N;
         sub_n<WORD_MAX>(t, t, n);
 
     assign<WORD_MAX>(&table[WORD_MAX], t);
@@ -434,8 +477,7 @@ void calcTable(uint32_t* a, uint32_t* n, uint32_t* t, uint32_t* table)
 
     for (uint16_t i = 2; i < WINDOW_SIZE; ++i) //calculate 2^i R mod N
     {
-        lshift1<WORD_MAX>(t, t);
-        if (cmp_ge_n<WORD_MAX>(t, n))
+        if (lshift1<WORD_MAX>(t, t) || cmp_ge_n<WORD_MAX>(t, n))
             sub_n<WORD_MAX>(t, t, n);
 
         assign<WORD_MAX>(&table[i * WORD_MAX], t);
@@ -443,13 +485,13 @@ void calcTable(uint32_t* a, uint32_t* n, uint32_t* t, uint32_t* table)
 }
 
 
-/* Calculate X = 2^Exp Mod N (Fermat test) */
-template<uint8_t WORD_MAX>
-void pow2m(uint32_t* X, uint32_t* Exp, uint32_t* N, uint32_t* table)
+/* Calculate X = 2^Exp Mod N (Fermat test). table needs WINDOW_SIZE * WORD_MAX words. */
+template<uint8_t WORD_MAX, typename Word>
+inline void pow2m(Word* X, Word* Exp, Word* N, Word* table)
 {
-    uint32_t t[WORD_MAX << 1];
+    Word t[(WORD_MAX << 1) + 1];
     uint32_t wval = 0;
-    uint32_t d = inv2adic(N[0]);
+    Word d = inv2adic(N[0]);
 
 
     calcBar<WORD_MAX>(X, N, t);
@@ -462,14 +504,12 @@ void pow2m(uint32_t* X, uint32_t* Exp, uint32_t* N, uint32_t* table)
     for (int16_t i = bits - 1; i >= 0; --i)
     {
 
-        //if(i != bits-1)
-        if (i < start)
-            //mulredc<WORD_MAX>(X, X, X, N, d, t);
+        if (static_cast<uint32_t>(i) < start)
             sqrredc<WORD_MAX>(X, X, N, d, t);
 
         wval <<= 1;
 
-        if (Exp[i >> 5] & (1 << (i & 31)))
+        if (bit_test(Exp, i))
             wval |= 1;
 
         if (((i % WINDOW_BITS) == 0) && wval)
@@ -484,26 +524,24 @@ void pow2m(uint32_t* X, uint32_t* Exp, uint32_t* N, uint32_t* table)
 }
 
 
-/* Calculate X = 2^Exp Mod N (Fermat test) */
-template<uint8_t WORD_MAX>
-void pow2m(uint32_t* X, uint32_t* Exp, uint32_t* N)
+/* Calculate X = 2^Exp Mod N (Fermat test). Multiplying by the base 2 is a modular doubling, so no table is needed. */
+template<uint8_t WORD_MAX, typename Word>
+inline void pow2m(Word* X, Word* Exp, Word* N)
 {
-    uint32_t A[WORD_MAX];
-    uint32_t t[(WORD_MAX << 1) + 1];
+    Word t[(WORD_MAX << 1) + 1];
 
-    uint32_t d = inv2adic(N[0]);
+    Word d = inv2adic(N[0]);
 
-    calcBar<WORD_MAX>(X, A, N, t);
+    calcBar<WORD_MAX>(X, N, t);
 
     uint32_t bits = bit_count<WORD_MAX>(Exp);
 
     for (int16_t i = bits - 1; i >= 0; --i)
     {
-        //mulredc<WORD_MAX>(X, X, X, N, d, t);
         sqrredc<WORD_MAX>(X, X, N, d, t);
 
-        if (Exp[i >> 5] & (1 << (i & 31)))
-            mulredc<WORD_MAX>(X, X, A, N, d, t);
+        if (bit_test(Exp, i) && (lshift1<WORD_MAX>(X, X) || cmp_ge_n<WORD_MAX>(X, N)))
+            sub_n<WORD_MAX>(X, X, N);
     }
 
     redc<WORD_MAX>(X, X, N, d, t);
@@ -511,25 +549,22 @@ void pow2m(uint32_t* X, uint32_t* Exp, uint32_t* N)
 
 
 /* Test if number p passes Fermat Primality Test base 2. */
-template<uint8_t WORD_MAX>
-bool fermat_prime(uint32_t* p)
+template<uint8_t WORD_MAX, typename Word>
+inline bool fermat_prime(Word* p)
 {
-    uint32_t e[WORD_MAX];
-    uint32_t r[WORD_MAX];
-    uint32_t table[WINDOW_SIZE * 32];
+    Word e[WORD_MAX];
+    Word r[WORD_MAX];
+    Word table[WINDOW_SIZE * WORD_MAX];
 
     sub_ui<WORD_MAX>(e, p, 1);
     pow2m<WORD_MAX>(r, e, p, table);
 
-    uint32_t result = r[0] - 1;
+    Word result = r[0] - 1;
 
-    //#pragma unroll
     for (uint8_t i = 1; i < WORD_MAX; ++i)
     {
         if (r[i])
             return false;
-
-        //result |= r[i];
     }
 
 
@@ -537,19 +572,33 @@ bool fermat_prime(uint32_t* p)
 }
 
 
-/* Test if number p passes Fermat Primality Test base 2. */
-uint1024_t fermat_prime(const uint1024_t& p)
+/* Calculate 2^(p - 1) mod p for an odd p > 1. The result is 1 if p passes Fermat Primality Test base 2.
+ * Runs on 64-bit words if the compiler has 128-bit integers. */
+inline uint1024_t fermat_prime(const uint1024_t& p)
 {
-    uint1024_t r;
-    uint32_t e[32];
-    uint32_t table[WINDOW_SIZE * 32];
+#if defined(__SIZEOF_INT128__)
+    using Word = uint64_t;
+#else
+    using Word = uint32_t;
+#endif
+    constexpr uint8_t WORD_MAX = 1024 / Fermat_word<Word>::BITS;
+
+    Word pp[WORD_MAX];
+    Word e[WORD_MAX];
+    Word rr[WORD_MAX];
+
+    /* uint1024_t is little endian 32-bit words, the same bytes as little endian 64-bit words */
+    std::memcpy(pp, p.begin(), sizeof(pp));
 
-    uint32_t* rr = (uint32_t*)r.begin();
-    uint32_t* pp = (uint32_t*)p.begin();
+    sub_ui<WORD_MAX>(e, pp, 1);
+    pow2m<WORD_MAX>(rr, e, pp);
 
-    sub_ui<32>(e, pp, 1);
-    pow2m<32>(rr, e, pp, table);
-    //pow2m<32>(rr, e, pp);
+    uint1024_t r;
+    std::memcpy(r.begin(), rr, sizeof(rr));
 
     return r;
-}
\ No newline at end of file
+}
+
+}
+
+#endif
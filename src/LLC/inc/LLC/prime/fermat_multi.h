@@ -0,0 +1,78 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_PRIME_FERMAT_MULTI_H
+#define NEXUS_LLC_PRIME_FERMAT_MULTI_H
+
+#include <LLC/types/uint1024.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/** Namespace LLC (Lower Level Crypto) **/
+namespace LLC
+{
+
+	/** Fermat test kernels. AVX2 tests 4 numbers at once, AVX512 and AVX512IFMA test 8 numbers at once. **/
+	enum class FermatKernel : uint8_t
+	{
+		SCALAR     = 0,
+		AVX2       = 1,
+		AVX512     = 2,
+		AVX512IFMA = 3
+	};
+
+
+	/** FermatSupported
+	 *
+	 *  Checks if a kernel can run on this cpu (and was compiled in).
+	 *
+	 **/
+	bool FermatSupported(FermatKernel kernel);
+
+
+	/** FermatBestKernel
+	 *
+	 *  The fastest kernel supported by this cpu. Detected once at runtime.
+	 *
+	 **/
+	FermatKernel FermatBestKernel();
+
+
+	/** FermatLanes
+	 *
+	 *  Number of numbers a kernel tests at once.
+	 *
+	 **/
+	uint32_t FermatLanes(FermatKernel kernel);
+
+
+	/** FermatMulti
+	 *
+	 *  Calculates 2^(p - 1) mod p for nCount odd numbers p > 1. The result is identical
+	 *  to fermat_prime(pModuli[i]) from LLC/prime/fermat.h for every number.
+	 *
+	 *  @param[in] pModuli The numbers to test
+	 *  @param[out] pResults nCount remainders
+	 *  @param[in] nCount Number of numbers
+	 *
+	 **/
+	void FermatMulti(const uint1024_t* pModuli, uint1024_t* pResults, size_t nCount);
+
+
+	/** FermatMulti
+	 *
+	 *  Same as above with the given kernel (tests and benchmarks). Falls back to scalar if the kernel is not supported.
+	 *
+	 **/
+	void FermatMulti(FermatKernel kernel, const uint1024_t* pModuli, uint1024_t* pResults, size_t nCount);
+
+}
+
+#endif
@@ -726,23 +726,13 @@ const base_uint<BITS> operator/(const base_uint<BITS>& lhs, uint64_t rhs)
 template<uint32_t BITS>
 uint32_t operator%(const base_uint<BITS>& lhs, uint16_t rhs)
 {
-    uint32_t x = 0;
-    uint32_t y = 0;
-    uint32_t z = 0;
+    /* the remainder is below 2^16, one 64-bit division per word */
+    uint64_t y = 0;
 
-    for (int8_t i = (BITS >> 5) - 1; i >= 0; --i)
-    {
-        x = lhs.get(i);
-        y = (y << 16) | (x >> 16);
-        z = y / rhs;
-        y -= z * rhs;
-        x <<= 16;
-        y = (y << 16) | (x >> 16);
-        z = y / rhs;
-        y -= z * rhs;
-    }
+    for (int32_t i = (BITS >> 5) - 1; i >= 0; --i)
+        y = ((y << 32) | lhs.get(i)) % rhs;
 
-    return y;
+    return static_cast<uint32_t>(y);
 }
 
 
@@ -182,6 +182,17 @@ void KeccakF1600_StateComplementBit(void* state, uint32_t position)
 /* ---------------------------------------------------------------- */
 
 void KeccakF1600_StatePermute(void* argState)
+{
+#if defined(LLC_KECCAK_COMPACT)
+    KeccakF1600_StatePermute_Compact(argState);
+#else
+    KeccakF1600_StatePermute_Opt64(argState);
+#endif
+}
+
+/* ---------------------------------------------------------------- */
+
+void KeccakF1600_StatePermute_Compact(void* argState)
 {
     tSmaUtilInt x, y, round;
     tKeccakLane        temp;
@@ -0,0 +1,278 @@
+/*
+The Keccak sponge function, designed by Guido Bertoni, Joan Daemen,
+Michaël Peeters and Gilles Van Assche. For more information, feedback or
+questions, please refer to our website: http://keccak.noekeon.org/
+Implementation by the designers and Ronny Van Keer,
+hereby denoted as "the implementer".
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+/* Fully unrolled 64-bit Keccak-f[1600] with lane complementing ("Bebigokimisa").
+ * The lanes be, bi, go, ki, mi and sa are kept complemented during the permutation,
+ * which replaces most of the NOT operations of chi. The state outside of
+ * KeccakF1600_StatePermute_Opt64 is in normal representation, so this is a drop in
+ * replacement of the compact permutation (see Keccak-compact64.cpp). */
+
+#include <inttypes.h>
+
+#include <LLC/hash/SK/KeccakF-1600-interface.h>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#define ROL64(a, offset) _rotl64(a, offset)
+#else
+#define ROL64(a, offset) ((((uint64_t)a) << offset) ^ (((uint64_t)a) >> (64-offset)))
+#endif
+
+static const uint64_t KeccakF1600RoundConstants[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+/* ---------------------------------------------------------------- */
+
+/* one round from A to E, the column parities C of E are computed for the next round */
+#define thetaRhoPiChiIotaPrepareTheta(i, A, E) \
+    Da = Cu^ROL64(Ce, 1); \
+    De = Ca^ROL64(Ci, 1); \
+    Di = Ce^ROL64(Co, 1); \
+    Do = Ci^ROL64(Cu, 1); \
+    Du = Co^ROL64(Ca, 1); \
+\
+    A##ba ^= Da; \
+    Bba = A##ba; \
+    A##ge ^= De; \
+    Bbe = ROL64(A##ge, 44); \
+    A##ki ^= Di; \
+    Bbi = ROL64(A##ki, 43); \
+    E##ba =   Bba ^(  Bbe |  Bbi ); \
+    E##ba ^= KeccakF1600RoundConstants[i]; \
+    Ca = E##ba; \
+    A##mo ^= Do; \
+    Bbo = ROL64(A##mo, 21); \
+    E##be =   Bbe ^((~Bbi)|  Bbo ); \
+    Ce = E##be; \
+    A##su ^= Du; \
+    Bbu = ROL64(A##su, 14); \
+    E##bi =   Bbi ^(  Bbo &  Bbu ); \
+    Ci = E##bi; \
+    E##bo =   Bbo ^(  Bbu |  Bba ); \
+    Co = E##bo; \
+    E##bu =   Bbu ^(  Bba &  Bbe ); \
+    Cu = E##bu; \
+\
+    A##bo ^= Do; \
+    Bga = ROL64(A##bo, 28); \
+    A##gu ^= Du; \
+    Bge = ROL64(A##gu, 20); \
+    A##ka ^= Da; \
+    Bgi = ROL64(A##ka, 3); \
+    E##ga =   Bga ^(  Bge |  Bgi ); \
+    Ca ^= E##ga; \
+    A##me ^= De; \
+    Bgo = ROL64(A##me, 45); \
+    E##ge =   Bge ^(  Bgi &  Bgo ); \
+    Ce ^= E##ge; \
+    A##si ^= Di; \
+    Bgu = ROL64(A##si, 61); \
+    E##gi =   Bgi ^(  Bgo |(~Bgu)); \
+    Ci ^= E##gi; \
+    E##go =   Bgo ^(  Bgu |  Bga ); \
+    Co ^= E##go; \
+    E##gu =   Bgu ^(  Bga &  Bge ); \
+    Cu ^= E##gu; \
+\
+    A##be ^= De; \
+    Bka = ROL64(A##be, 1); \
+    A##gi ^= Di; \
+    Bke = ROL64(A##gi, 6); \
+    A##ko ^= Do; \
+    Bki = ROL64(A##ko, 25); \
+    E##ka =   Bka ^(  Bke |  Bki ); \
+    Ca ^= E##ka; \
+    A##mu ^= Du; \
+    Bko = ROL64(A##mu, 8); \
+    E##ke =   Bke ^(  Bki &  Bko ); \
+    Ce ^= E##ke; \
+    A##sa ^= Da; \
+    Bku = ROL64(A##sa, 18); \
+    E##ki =   Bki ^((~Bko)&  Bku ); \
+    Ci ^= E##ki; \
+    E##ko = (~Bko)^(  Bku |  Bka ); \
+    Co ^= E##ko; \
+    E##ku =   Bku ^(  Bka &  Bke ); \
+    Cu ^= E##ku; \
+\
+    A##bu ^= Du; \
+    Bma = ROL64(A##bu, 27); \
+    A##ga ^= Da; \
+    Bme = ROL64(A##ga, 36); \
+    A##ke ^= De; \
+    Bmi = ROL64(A##ke, 10); \
+    E##ma =   Bma ^(  Bme &  Bmi ); \
+    Ca ^= E##ma; \
+    A##mi ^= Di; \
+    Bmo = ROL64(A##mi, 15); \
+    E##me =   Bme ^(  Bmi |  Bmo ); \
+    Ce ^= E##me; \
+    A##so ^= Do; \
+    Bmu = ROL64(A##so, 56); \
+    E##mi =   Bmi ^((~Bmo)|  Bmu ); \
+    Ci ^= E##mi; \
+    E##mo = (~Bmo)^(  Bmu &  Bma ); \
+    Co ^= E##mo; \
+    E##mu =   Bmu ^(  Bma |  Bme ); \
+    Cu ^= E##mu; \
+\
+    A##bi ^= Di; \
+    Bsa = ROL64(A##bi, 62); \
+    A##go ^= Do; \
+    Bse = ROL64(A##go, 55); \
+    A##ku ^= Du; \
+    Bsi = ROL64(A##ku, 39); \
+    E##sa =   Bsa ^((~Bse)&  Bsi ); \
+    Ca ^= E##sa; \
+    A##ma ^= Da; \
+    Bso = ROL64(A##ma, 41); \
+    E##se = (~Bse)^(  Bsi |  Bso ); \
+    Ce ^= E##se; \
+    A##se ^= De; \
+    Bsu = ROL64(A##se, 2); \
+    E##si =   Bsi ^(  Bso &  Bsu ); \
+    Ci ^= E##si; \
+    E##so =   Bso ^(  Bsu |  Bsa ); \
+    Co ^= E##so; \
+    E##su =   Bsu ^(  Bsa &  Bse ); \
+    Cu ^= E##su;
+
+#define copyFromState(X, state) \
+    X##ba = state[ 0]; \
+    X##be = state[ 1]; \
+    X##bi = state[ 2]; \
+    X##bo = state[ 3]; \
+    X##bu = state[ 4]; \
+    X##ga = state[ 5]; \
+    X##ge = state[ 6]; \
+    X##gi = state[ 7]; \
+    X##go = state[ 8]; \
+    X##gu = state[ 9]; \
+    X##ka = state[10]; \
+    X##ke = state[11]; \
+    X##ki = state[12]; \
+    X##ko = state[13]; \
+    X##ku = state[14]; \
+    X##ma = state[15]; \
+    X##me = state[16]; \
+    X##mi = state[17]; \
+    X##mo = state[18]; \
+    X##mu = state[19]; \
+    X##sa = state[20]; \
+    X##se = state[21]; \
+    X##si = state[22]; \
+    X##so = state[23]; \
+    X##su = state[24];
+
+#define copyToState(state, X) \
+    state[ 0] = X##ba; \
+    state[ 1] = X##be; \
+    state[ 2] = X##bi; \
+    state[ 3] = X##bo; \
+    state[ 4] = X##bu; \
+    state[ 5] = X##ga; \
+    state[ 6] = X##ge; \
+    state[ 7] = X##gi; \
+    state[ 8] = X##go; \
+    state[ 9] = X##gu; \
+    state[10] = X##ka; \
+    state[11] = X##ke; \
+    state[12] = X##ki; \
+    state[13] = X##ko; \
+    state[14] = X##ku; \
+    state[15] = X##ma; \
+    state[16] = X##me; \
+    state[17] = X##mi; \
+    state[18] = X##mo; \
+    state[19] = X##mu; \
+    state[20] = X##sa; \
+    state[21] = X##se; \
+    state[22] = X##si; \
+    state[23] = X##so; \
+    state[24] = X##su;
+
+/* the lanes be, bi, go, ki, mi and sa */
+#define complementLanes(state) \
+    state[ 1] = ~state[ 1]; \
+    state[ 2] = ~state[ 2]; \
+    state[ 8] = ~state[ 8]; \
+    state[12] = ~state[12]; \
+    state[17] = ~state[17]; \
+    state[20] = ~state[20];
+
+/* ---------------------------------------------------------------- */
+
+void KeccakF1600_StatePermute_Opt64(void* argState)
+{
+    uint64_t* state = reinterpret_cast<uint64_t*>(argState);
+
+    uint64_t Aba, Abe, Abi, Abo, Abu;
+    uint64_t Aga, Age, Agi, Ago, Agu;
+    uint64_t Aka, Ake, Aki, Ako, Aku;
+    uint64_t Ama, Ame, Ami, Amo, Amu;
+    uint64_t Asa, Ase, Asi, Aso, Asu;
+    uint64_t Bba, Bbe, Bbi, Bbo, Bbu;
+    uint64_t Bga, Bge, Bgi, Bgo, Bgu;
+    uint64_t Bka, Bke, Bki, Bko, Bku;
+    uint64_t Bma, Bme, Bmi, Bmo, Bmu;
+    uint64_t Bsa, Bse, Bsi, Bso, Bsu;
+    uint64_t Ca, Ce, Ci, Co, Cu;
+    uint64_t Da, De, Di, Do, Du;
+    uint64_t Eba, Ebe, Ebi, Ebo, Ebu;
+    uint64_t Ega, Ege, Egi, Ego, Egu;
+    uint64_t Eka, Eke, Eki, Eko, Eku;
+    uint64_t Ema, Eme, Emi, Emo, Emu;
+    uint64_t Esa, Ese, Esi, Eso, Esu;
+
+    complementLanes(state)
+    copyFromState(A, state)
+
+    Ca = Aba^Aga^Aka^Ama^Asa;
+    Ce = Abe^Age^Ake^Ame^Ase;
+    Ci = Abi^Agi^Aki^Ami^Asi;
+    Co = Abo^Ago^Ako^Amo^Aso;
+    Cu = Abu^Agu^Aku^Amu^Asu;
+
+    thetaRhoPiChiIotaPrepareTheta( 0, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 1, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 2, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 3, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 4, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 5, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 6, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 7, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 8, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 9, E, A)
+    thetaRhoPiChiIotaPrepareTheta(10, A, E)
+    thetaRhoPiChiIotaPrepareTheta(11, E, A)
+    thetaRhoPiChiIotaPrepareTheta(12, A, E)
+    thetaRhoPiChiIotaPrepareTheta(13, E, A)
+    thetaRhoPiChiIotaPrepareTheta(14, A, E)
+    thetaRhoPiChiIotaPrepareTheta(15, E, A)
+    thetaRhoPiChiIotaPrepareTheta(16, A, E)
+    thetaRhoPiChiIotaPrepareTheta(17, E, A)
+    thetaRhoPiChiIotaPrepareTheta(18, A, E)
+    thetaRhoPiChiIotaPrepareTheta(19, E, A)
+    thetaRhoPiChiIotaPrepareTheta(20, A, E)
+    thetaRhoPiChiIotaPrepareTheta(21, E, A)
+    thetaRhoPiChiIotaPrepareTheta(22, A, E)
+    thetaRhoPiChiIotaPrepareTheta(23, E, A)
+
+    copyToState(state, A)
+    complementLanes(state)
+}
@@ -0,0 +1,20 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+/* compiled with -mavx512f, only called after the cpu check in sk1024_multi.cpp */
+#include <LLC/hash/SK/sk1024_lanes.h>
+
+namespace LLC
+{
+	typedef uint64_t SK1024VectorAVX512 __attribute__ ((vector_size(64)));
+
+	void SK1024Multi_AVX512(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes)
+	{
+		SK1024Lanes<SK1024VectorAVX512, 8>(pMessages, nSize, pHashes);
+	}
+}
@@ -0,0 +1,279 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_HASH_SK_SK1024_LANES_H
+#define NEXUS_LLC_HASH_SK_SK1024_LANES_H
+
+/* Lane generic SK1024 (Skein1024-1024 followed by Keccak[r=576, c=1024, 0x05]-1024).
+ *
+ * V is a GCC/Clang vector of LANES 64-bit words, lane l of every vector belongs to message l.
+ * This header is only included by the translation units compiled with the matching
+ * instruction set (sk1024_avx2.cpp, sk1024_avx512.cpp). Everything is in an unnamed
+ * namespace so that the differently compiled copies never get merged by the linker. */
+
+#include <LLC/types/uint1024.h>
+#include <LLC/hash/SK/skein.h>
+#include <LLC/hash/SK/skein_iv.h>
+
+#include <cstring>
+#include <cstdint>
+
+/* the key schedule and lane indexes have to become constants, the compiler doesn't unroll these loops at -O2 */
+#if defined(__clang__)
+#define SK_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define SK_UNROLL _Pragma("GCC unroll 24")
+#else
+#define SK_UNROLL
+#endif
+
+namespace
+{
+
+	template<int ROT, typename V>
+	inline V RotL(V x)
+	{
+		return (x << ROT) | (x >> (64 - ROT));
+	}
+
+	template<typename V>
+	inline V RotL(V x, int nRot)
+	{
+		return (x << nRot) | (x >> (64 - nRot));
+	}
+
+
+	/* Threefish-1024 mix of the word pairs (0,1) (2,3) .. (14,15) after the word permutation of the round */
+#define SK_MIX1024(p0,p1,p2,p3,p4,p5,p6,p7,p8,p9,pA,pB,pC,pD,pE,pF,ROT)              \
+	X[p0] += X[p1]; X[p1] = RotL<ROT##_0>(X[p1]); X[p1] ^= X[p0];                      \
+	X[p2] += X[p3]; X[p3] = RotL<ROT##_1>(X[p3]); X[p3] ^= X[p2];                      \
+	X[p4] += X[p5]; X[p5] = RotL<ROT##_2>(X[p5]); X[p5] ^= X[p4];                      \
+	X[p6] += X[p7]; X[p7] = RotL<ROT##_3>(X[p7]); X[p7] ^= X[p6];                      \
+	X[p8] += X[p9]; X[p9] = RotL<ROT##_4>(X[p9]); X[p9] ^= X[p8];                      \
+	X[pA] += X[pB]; X[pB] = RotL<ROT##_5>(X[pB]); X[pB] ^= X[pA];                      \
+	X[pC] += X[pD]; X[pD] = RotL<ROT##_6>(X[pD]); X[pD] ^= X[pC];                      \
+	X[pE] += X[pF]; X[pF] = RotL<ROT##_7>(X[pF]); X[pF] ^= X[pE];
+
+
+	/* Threefish-1024 key injection, nSub is the subkey number */
+	template<typename V>
+	inline void Inject1024(V* X, const V* ks, const uint64_t* ts, uint32_t nSub)
+	{
+		SK_UNROLL
+		for(uint32_t i = 0; i < 16; ++i)
+			X[i] += ks[(nSub + i) % 17];
+
+		X[13] += ts[nSub % 3];
+		X[14] += ts[(nSub + 1) % 3];
+		X[15] += (uint64_t)nSub;
+	}
+
+
+	/* Skein1024 UBI block: chaining value C is updated with the message block w. Tweak is the same for all lanes. */
+	template<typename V>
+	inline void ProcessBlock1024(V* C, const V* w, uint64_t nTweak0, uint64_t nTweak1)
+	{
+		V ks[17];
+		V X[16];
+		const uint64_t ts[3] = { nTweak0, nTweak1, nTweak0 ^ nTweak1 };
+
+		ks[16] = C[0] ^ (uint64_t)SKEIN_KS_PARITY;
+		for(uint32_t i = 0; i < 16; ++i)
+		{
+			ks[i] = C[i];
+			if(i > 0)
+				ks[16] ^= C[i];
+
+			X[i] = w[i];
+		}
+
+		Inject1024(X, ks, ts, 0);
+		SK_UNROLL
+		for(uint32_t nSub = 1; nSub < SKEIN1024_ROUNDS_TOTAL / 4; nSub += 2)
+		{
+			SK_MIX1024( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15, R1024_0)
+			SK_MIX1024( 0, 9, 2,13, 6,11, 4,15,10, 7,12, 3,14, 5, 8, 1, R1024_1)
+			SK_MIX1024( 0, 7, 2, 5, 4, 3, 6, 1,12,15,14,13, 8,11,10, 9, R1024_2)
+			SK_MIX1024( 0,15, 2,11, 6,13, 4, 9,14, 1, 8, 5,10, 3,12, 7, R1024_3)
+			Inject1024(X, ks, ts, nSub);
+			SK_MIX1024( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15, R1024_4)
+			SK_MIX1024( 0, 9, 2,13, 6,11, 4,15,10, 7,12, 3,14, 5, 8, 1, R1024_5)
+			SK_MIX1024( 0, 7, 2, 5, 4, 3, 6, 1,12,15,14,13, 8,11,10, 9, R1024_6)
+			SK_MIX1024( 0,15, 2,11, 6,13, 4, 9,14, 1, 8, 5,10, 3,12, 7, R1024_7)
+			Inject1024(X, ks, ts, nSub + 1);
+		}
+
+		/* feed forward */
+		for(uint32_t i = 0; i < 16; ++i)
+			C[i] = X[i] ^ w[i];
+	}
+
+#undef SK_MIX1024
+
+
+	const uint64_t KeccakRoundConstants[24] =
+	{
+		0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+		0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+		0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+		0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+		0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+		0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+	};
+
+	const int KeccakRho[24] =
+	{
+		 1,  3,  6, 10, 15, 21, 28, 36, 45, 55,  2, 14, 27, 41, 56,  8, 25, 43, 62, 18, 39, 61, 20, 44
+	};
+
+	const int KeccakPi[24] =
+	{
+		10,  7, 11, 17, 18,  3,  5, 16,  8, 21, 24,  4, 15, 23, 19, 13, 12,  2, 20, 14, 22,  9,  6,  1
+	};
+
+
+	/* Keccak-f[1600], lane index is x + 5 * y */
+	template<typename V>
+	inline void KeccakF1600(V* A)
+	{
+		V C[5];
+		V D;
+		V T;
+
+		for(uint32_t nRound = 0; nRound < 24; ++nRound)
+		{
+			/* theta */
+			for(uint32_t x = 0; x < 5; ++x)
+				C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+
+			for(uint32_t x = 0; x < 5; ++x)
+			{
+				D = C[(x + 4) % 5] ^ RotL<1>(C[(x + 1) % 5]);
+				for(uint32_t y = 0; y < 25; y += 5)
+					A[y + x] ^= D;
+			}
+
+			/* rho and pi */
+			T = A[1];
+			SK_UNROLL
+			for(uint32_t i = 0; i < 24; ++i)
+			{
+				const int j = KeccakPi[i];
+				const V tmp = A[j];
+				A[j] = RotL(T, KeccakRho[i]);
+				T = tmp;
+			}
+
+			/* chi */
+			for(uint32_t y = 0; y < 25; y += 5)
+			{
+				for(uint32_t x = 0; x < 5; ++x)
+					C[x] = A[y + x];
+
+				for(uint32_t x = 0; x < 5; ++x)
+					A[y + x] = C[x] ^ (~C[(x + 1) % 5] & C[(x + 2) % 5]);
+			}
+
+			/* iota */
+			A[0] ^= KeccakRoundConstants[nRound];
+		}
+	}
+
+
+	/* Hashes LANES messages of nSize bytes. Little endian only (x86). */
+	template<typename V, uint32_t LANES>
+	inline void SK1024Lanes(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes)
+	{
+		static_assert(sizeof(V) == LANES * sizeof(uint64_t), "vector size doesn't match the lane count");
+
+		uint64_t words[16][LANES];
+		V C[16];
+		V w[16];
+
+		/* Skein1024 with 1024 bit output starts from the precomputed IV */
+		for(uint32_t i = 0; i < 16; ++i)
+			C[i] = V{} + (uint64_t)SKEIN1024_IV_1024[i];
+
+		/* message blocks, the last one is zero padded. An empty message is one zero block */
+		size_t nProcessed = 0;
+		uint64_t nTweak1 = SKEIN_T1_FLAG_FIRST | SKEIN_T1_BLK_TYPE_MSG;
+		do
+		{
+			size_t nBlockSize = nSize - nProcessed;
+			if(nBlockSize > SKEIN1024_BLOCK_BYTES)
+				nBlockSize = SKEIN1024_BLOCK_BYTES;
+
+			std::memset(words, 0, sizeof(words));
+			for(uint32_t nLane = 0; nLane < LANES; ++nLane)
+			{
+				uint8_t block[SKEIN1024_BLOCK_BYTES] = { 0 };
+				if(nBlockSize > 0)
+					std::memcpy(block, pMessages[nLane] + nProcessed, nBlockSize);
+
+				for(uint32_t i = 0; i < 16; ++i)
+					std::memcpy(&words[i][nLane], block + 8 * i, 8);
+			}
+			for(uint32_t i = 0; i < 16; ++i)
+				std::memcpy(&w[i], words[i], sizeof(V));
+
+			nProcessed += nBlockSize;
+			if(nProcessed == nSize)
+				nTweak1 |= SKEIN_T1_FLAG_FINAL;
+
+			ProcessBlock1024(C, w, (uint64_t)nProcessed, nTweak1);
+			nTweak1 &= ~SKEIN_T1_FLAG_FIRST;
+		}
+		while(nProcessed < nSize);
+
+		/* output block, counter 0 */
+		for(uint32_t i = 0; i < 16; ++i)
+			w[i] = V{};
+		ProcessBlock1024(C, w, 8, SKEIN_T1_FLAG_FIRST | SKEIN_T1_BLK_TYPE_OUT_FINAL);
+
+		/* Keccak, rate 72 bytes = 9 lanes. The 128 byte skein hash is absorbed in two blocks */
+		V A[25];
+		for(uint32_t i = 0; i < 25; ++i)
+			A[i] = V{};
+
+		for(uint32_t i = 0; i < 9; ++i)
+			A[i] ^= C[i];
+		KeccakF1600(A);
+
+		for(uint32_t i = 0; i < 7; ++i)
+			A[i] ^= C[i + 9];
+		A[7] ^= (uint64_t)0x05;								/* delimited suffix */
+		A[8] ^= (uint64_t)0x80 << 56;						/* last bit of the rate */
+		KeccakF1600(A);
+
+		/* squeeze 9 + 7 lanes */
+		V H[16];
+		for(uint32_t i = 0; i < 9; ++i)
+			H[i] = A[i];
+		KeccakF1600(A);
+		for(uint32_t i = 0; i < 7; ++i)
+			H[i + 9] = A[i];
+
+		for(uint32_t i = 0; i < 16; ++i)
+			std::memcpy(words[i], &H[i], sizeof(V));
+
+		for(uint32_t nLane = 0; nLane < LANES; ++nLane)
+		{
+			uint8_t hash[128];
+			for(uint32_t i = 0; i < 16; ++i)
+				std::memcpy(hash + 8 * i, &words[i][nLane], 8);
+
+			std::memcpy((uint8_t*)&pHashes[nLane], hash, sizeof(hash));
+		}
+	}
+
+}
+
+#undef SK_UNROLL
+
+#endif
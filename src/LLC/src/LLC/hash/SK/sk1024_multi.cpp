@@ -0,0 +1,94 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#include <LLC/hash/SK_multi.h>
+#include <LLC/hash/SK.h>
+
+/* LLC_SK1024_SIMD is set by the build for x86-64 GCC/Clang builds, which compile sk1024_avx2.cpp and sk1024_avx512.cpp */
+namespace LLC
+{
+#if defined(LLC_SK1024_SIMD)
+	void SK1024Multi_AVX2(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes);
+	void SK1024Multi_AVX512(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes);
+#endif
+
+
+	bool SK1024Supported(SK1024Kernel kernel)
+	{
+		switch(kernel)
+		{
+		case SK1024Kernel::SCALAR:
+			return true;
+#if defined(LLC_SK1024_SIMD)
+		case SK1024Kernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+		case SK1024Kernel::AVX512:
+			return __builtin_cpu_supports("avx512f");
+#endif
+		default:
+			return false;
+		}
+	}
+
+
+	SK1024Kernel SK1024BestKernel()
+	{
+		static const SK1024Kernel kernel = SK1024Supported(SK1024Kernel::AVX512) ? SK1024Kernel::AVX512 :
+			(SK1024Supported(SK1024Kernel::AVX2) ? SK1024Kernel::AVX2 : SK1024Kernel::SCALAR);
+
+		return kernel;
+	}
+
+
+	uint32_t SK1024Lanes(SK1024Kernel kernel)
+	{
+		switch(kernel)
+		{
+		case SK1024Kernel::AVX2:
+			return 4;
+		case SK1024Kernel::AVX512:
+			return 8;
+		default:
+			return 1;
+		}
+	}
+
+
+	void SK1024Multi(const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes, size_t nCount)
+	{
+		SK1024Multi(SK1024BestKernel(), pMessages, nSize, pHashes, nCount);
+	}
+
+
+	void SK1024Multi(SK1024Kernel kernel, const uint8_t* const* pMessages, size_t nSize, uint1024_t* pHashes, size_t nCount)
+	{
+		if(!SK1024Supported(kernel))
+			kernel = SK1024Kernel::SCALAR;
+
+		size_t nIndex = 0;
+
+#if defined(LLC_SK1024_SIMD)
+		if(kernel == SK1024Kernel::AVX512)
+		{
+			for(; nIndex + 8 <= nCount; nIndex += 8)
+				SK1024Multi_AVX512(pMessages + nIndex, nSize, pHashes + nIndex);
+		}
+
+		/* AVX512 cpus run the remaining 4 messages with AVX2 */
+		if(kernel != SK1024Kernel::SCALAR && SK1024Supported(SK1024Kernel::AVX2))
+		{
+			for(; nIndex + 4 <= nCount; nIndex += 4)
+				SK1024Multi_AVX2(pMessages + nIndex, nSize, pHashes + nIndex);
+		}
+#endif
+
+		/* remaining messages one by one */
+		for(; nIndex < nCount; ++nIndex)
+			pHashes[nIndex] = SK1024(pMessages[nIndex], pMessages[nIndex] + nSize);
+	}
+}
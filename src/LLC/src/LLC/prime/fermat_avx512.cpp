@@ -0,0 +1,45 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+/* compiled with -mavx512f, only called after the cpu check in fermat_multi.cpp */
+#include <LLC/prime/fermat_lanes.h>
+
+#include <immintrin.h>
+
+namespace
+{
+	typedef uint64_t FermatVectorAVX512 __attribute__ ((vector_size(64)));
+
+	/* 37 digits of 28 bits, vpmuludq multiplies the low 32 bits of every lane */
+	struct FermatAVX512
+	{
+		using V = FermatVectorAVX512;
+
+		static constexpr uint32_t LANES = 8;
+		static constexpr uint32_t BITS = 28;
+		static constexpr uint32_t DIGITS = 37;
+
+		static inline void Mac(V& lo, V&, V x, V y)
+		{
+			lo += (V)_mm512_mul_epu32((__m512i)x, (__m512i)y);
+		}
+
+		static inline V MulLo(V x, V y)
+		{
+			return (V)_mm512_mul_epu32((__m512i)x, (__m512i)y) & ((uint64_t(1) << BITS) - 1);
+		}
+	};
+}
+
+namespace LLC
+{
+	void FermatMulti_AVX512(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults)
+	{
+		FermatLanes<FermatAVX512>(pModuli, pR, pResults);
+	}
+}
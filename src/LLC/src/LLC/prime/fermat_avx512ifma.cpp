@@ -0,0 +1,46 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+/* compiled with -mavx512f -mavx512ifma, only called after the cpu check in fermat_multi.cpp */
+#include <LLC/prime/fermat_lanes.h>
+
+#include <immintrin.h>
+
+namespace
+{
+	typedef uint64_t FermatVectorAVX512IFMA __attribute__ ((vector_size(64)));
+
+	/* 20 digits of 52 bits, vpmadd52luq/vpmadd52huq add the low/high 52 bits of the 104-bit product */
+	struct FermatAVX512IFMA
+	{
+		using V = FermatVectorAVX512IFMA;
+
+		static constexpr uint32_t LANES = 8;
+		static constexpr uint32_t BITS = 52;
+		static constexpr uint32_t DIGITS = 20;
+
+		static inline void Mac(V& lo, V& hi, V x, V y)
+		{
+			lo = (V)_mm512_madd52lo_epu64((__m512i)lo, (__m512i)x, (__m512i)y);
+			hi = (V)_mm512_madd52hi_epu64((__m512i)hi, (__m512i)x, (__m512i)y);
+		}
+
+		static inline V MulLo(V x, V y)
+		{
+			return (V)_mm512_madd52lo_epu64(_mm512_setzero_si512(), (__m512i)x, (__m512i)y);
+		}
+	};
+}
+
+namespace LLC
+{
+	void FermatMulti_AVX512IFMA(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults)
+	{
+		FermatLanes<FermatAVX512IFMA>(pModuli, pR, pResults);
+	}
+}
@@ -0,0 +1,246 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLC_PRIME_FERMAT_LANES_H
+#define NEXUS_LLC_PRIME_FERMAT_LANES_H
+
+/* Lane generic Fermat test 2^(p - 1) mod p with Montgomery multiplication.
+ *
+ * L describes the kernel: L::V is a GCC/Clang vector of L::LANES 64-bit words, lane l of every
+ * vector belongs to number l. Numbers are L::DIGITS digits of L::BITS bits, one digit per 64-bit
+ * word. L::Mac(lo, hi, x, y) adds x * y to the digit accumulators lo and hi (the part above BITS
+ * bits may go to either), L::MulLo(x, y) returns x * y mod 2^BITS.
+ *
+ * R = 2^(DIGITS * BITS) > 16p, so every value < 4p stays < 2p after a montgomery multiplication
+ * and the exponent loop needs neither the final subtraction nor a comparison. All lanes run
+ * the same instructions, only the doubling for set exponent bits is masked.
+ *
+ * This header is only included by the translation units compiled with the matching
+ * instruction set (fermat_avx2.cpp, fermat_avx512.cpp, fermat_avx512ifma.cpp). Everything is in
+ * an unnamed namespace so that the differently compiled copies never get merged by the linker. */
+
+#include <cstdint>
+
+#if defined(__clang__)
+#define FERMAT_LANES_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define FERMAT_LANES_UNROLL _Pragma("GCC unroll 40")
+#else
+#define FERMAT_LANES_UNROLL
+#endif
+
+namespace
+{
+
+	/* -x^-1 mod 2^64, newton iteration from 4 correct bits. */
+	inline uint64_t NegInverse(uint64_t x)
+	{
+		uint64_t a = x;
+		x = (((x + 2) & 4) << 1) + x;
+		for(uint32_t nBits = 4; nBits < 64; nBits <<= 1)
+			x *= 2 - a * x;
+
+		return 0 - x;
+	}
+
+
+	/* Digits of a little endian 1024-bit number into lane nLane of x. */
+	template<typename L>
+	inline void ToDigits(typename L::V* x, const uint64_t* pWords, uint32_t nLane)
+	{
+		constexpr uint64_t MASK = (uint64_t(1) << L::BITS) - 1;
+
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+		{
+			uint32_t nBit = i * L::BITS;
+			uint32_t nWord = nBit >> 6;
+			uint32_t nShift = nBit & 63;
+
+			uint64_t nDigit = 0;
+			if(nWord < 16)
+				nDigit = pWords[nWord] >> nShift;
+			if(nShift + L::BITS > 64 && nWord + 1 < 16)
+				nDigit |= pWords[nWord + 1] << (64 - nShift);
+
+			x[i][nLane] = nDigit & MASK;
+		}
+	}
+
+
+	/* Lane nLane of the normalized digits x as little endian 1024-bit number. */
+	template<typename L>
+	inline void FromDigits(uint64_t* pWords, const typename L::V* x, uint32_t nLane)
+	{
+		for(uint32_t i = 0; i < 16; ++i)
+			pWords[i] = 0;
+
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+		{
+			uint32_t nBit = i * L::BITS;
+			uint32_t nWord = nBit >> 6;
+			uint32_t nShift = nBit & 63;
+
+			uint64_t nDigit = x[i][nLane];
+			if(nWord < 16)
+				pWords[nWord] |= nDigit << nShift;
+			if(nShift + L::BITS > 64 && nWord + 1 < 16)
+				pWords[nWord + 1] |= nDigit >> (64 - nShift);
+		}
+	}
+
+
+	/* z = x with the carries propagated, every digit < 2^BITS. The carry out of the top digit is dropped. */
+	template<typename L>
+	inline void Normalize(typename L::V* z, const typename L::V* x)
+	{
+		using V = typename L::V;
+		constexpr uint64_t MASK = (uint64_t(1) << L::BITS) - 1;
+
+		V c = V{};
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+		{
+			V t = x[i] + c;
+			z[i] = t & MASK;
+			c = t >> L::BITS;
+		}
+	}
+
+
+	/* z = x * y / R mod p for x, y < 4p with normalized digits, z < 2p with normalized digits. z may be x or y. */
+	template<typename L>
+	inline void MulRedc(typename L::V* z, const typename L::V* x, const typename L::V* y, const typename L::V* n, typename L::V d)
+	{
+		using V = typename L::V;
+
+		/* operand scanning, the digits of every row are independent accumulators */
+		V A[L::DIGITS << 1] = {};
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+		{
+			V* a = &A[i];
+
+			FERMAT_LANES_UNROLL
+			for(uint32_t j = 0; j < L::DIGITS; ++j)
+				L::Mac(a[j], a[j + 1], x[i], y[j]);
+
+			/* choose m so the low digit of the row becomes zero */
+			V m = L::MulLo(a[0], d);
+
+			FERMAT_LANES_UNROLL
+			for(uint32_t j = 0; j < L::DIGITS; ++j)
+				L::Mac(a[j], a[j + 1], m, n[j]);
+
+			a[1] += a[0] >> L::BITS;
+		}
+
+		Normalize<L>(z, &A[L::DIGITS]);
+	}
+
+
+	/* x = 2x in the lanes where mask is all ones. x < 2p, the result < 4p still fits the digits. */
+	template<typename L>
+	inline void DoubleMasked(typename L::V* x, typename L::V mask)
+	{
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+			x[i] += x[i] & mask;
+
+		Normalize<L>(x, x);
+	}
+
+
+	/* x = 2x mod p for x < p, exact. */
+	template<typename L>
+	inline void DoubleMod(typename L::V* x, const typename L::V* n)
+	{
+		using V = typename L::V;
+		constexpr uint64_t MASK = (uint64_t(1) << L::BITS) - 1;
+
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+			x[i] += x[i];
+
+		Normalize<L>(x, x);
+
+		/* t = x - p, keep it in the lanes without borrow */
+		V t[L::DIGITS];
+		V borrow = V{};
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+		{
+			V s = x[i] - n[i] - borrow;
+			t[i] = s & MASK;
+			borrow = s >> 63;
+		}
+
+		V keep = borrow - 1;
+		for(uint32_t i = 0; i < L::DIGITS; ++i)
+			x[i] = (t[i] & keep) | (x[i] & ~keep);
+	}
+
+
+	/* pResults[l] = 2^(p - 1) mod p for the L::LANES odd numbers p = pModuli[l] > 1.
+	 * pR[l] is 2^1024 mod p. Every number is 16 little endian 64-bit words. */
+	template<typename L>
+	inline void FermatLanes(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults)
+	{
+		using V = typename L::V;
+
+		static_assert(sizeof(V) == L::LANES * sizeof(uint64_t), "vector size doesn't match the lane count");
+		static_assert(L::DIGITS * L::BITS >= 1024 + 4, "R has to be larger than 16p");
+		static_assert((L::DIGITS - 1) * L::BITS < 1024 + 64, "the digits have to fit the 1024-bit words");
+
+		V n[L::DIGITS];
+		V x[L::DIGITS];
+		V e[16];
+		V d = V{};
+
+		uint32_t nBits = 0;
+		for(uint32_t nLane = 0; nLane < L::LANES; ++nLane)
+		{
+			const uint64_t* p = &pModuli[nLane * 16];
+
+			ToDigits<L>(n, p, nLane);
+			ToDigits<L>(x, &pR[nLane * 16], nLane);
+			d[nLane] = NegInverse(p[0]) & ((uint64_t(1) << L::BITS) - 1);
+
+			/* exponent p - 1, p is odd */
+			for(uint32_t i = 0; i < 16; ++i)
+			{
+				e[i][nLane] = (i == 0) ? (p[0] & ~uint64_t(1)) : p[i];
+				if(e[i][nLane] != 0)
+				{
+					uint32_t nLaneBits = i * 64 + 64 - __builtin_clzll(e[i][nLane]);
+					if(nLaneBits > nBits)
+						nBits = nLaneBits;
+				}
+			}
+		}
+
+		/* 1 in montgomery form is R mod p */
+		for(uint32_t i = 1024; i < L::DIGITS * L::BITS; ++i)
+			DoubleMod<L>(x, n);
+
+		/* lanes with shorter exponents square their 1 until their top bit */
+		for(int32_t i = nBits - 1; i >= 0; --i)
+		{
+			MulRedc<L>(x, x, x, n, d);
+
+			V bit = (e[i >> 6] >> (i & 63)) & 1;
+			DoubleMasked<L>(x, V{} - bit);
+		}
+
+		/* out of montgomery form. The result is < p + 1 and can't be p, 2^k is never 0 mod p */
+		V one[L::DIGITS] = {};
+		one[0] = V{} + uint64_t(1);
+		MulRedc<L>(x, x, one, n, d);
+
+		for(uint32_t nLane = 0; nLane < L::LANES; ++nLane)
+			FromDigits<L>(&pResults[nLane * 16], x, nLane);
+	}
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*__________________________________________________________________________________________
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+			(c) Copyright The Nexus Developers 2014 - 2019
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+			"ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#include <LLC/prime/fermat_multi.h>
+#include <LLC/prime/fermat.h>
+
+#include <cstring>
+
+/* LLC_FERMAT_SIMD is set by the build for x86-64 GCC/Clang builds, which compile fermat_avx2.cpp, fermat_avx512.cpp and fermat_avx512ifma.cpp */
+namespace LLC
+{
+#if defined(LLC_FERMAT_SIMD)
+	void FermatMulti_AVX2(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults);
+	void FermatMulti_AVX512(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults);
+	void FermatMulti_AVX512IFMA(const uint64_t* pModuli, const uint64_t* pR, uint64_t* pResults);
+#endif
+
+
+	bool FermatSupported(FermatKernel kernel)
+	{
+		switch(kernel)
+		{
+		case FermatKernel::SCALAR:
+			return true;
+#if defined(LLC_FERMAT_SIMD)
+		case FermatKernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+		case FermatKernel::AVX512:
+			return __builtin_cpu_supports("avx512f");
+		case FermatKernel::AVX512IFMA:
+			return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+#endif
+		default:
+			return false;
+		}
+	}
+
+
+	/* The AVX2 kernel (4 lanes of 28-bit digits) is only level with the scalar 64-bit engine, it isn't picked by default */
+	FermatKernel FermatBestKernel()
+	{
+		static const FermatKernel kernel = FermatSupported(FermatKernel::AVX512IFMA) ? FermatKernel::AVX512IFMA :
+			(FermatSupported(FermatKernel::AVX512) ? FermatKernel::AVX512 : FermatKernel::SCALAR);
+
+		return kernel;
+	}
+
+
+	uint32_t FermatLanes(FermatKernel kernel)
+	{
+		switch(kernel)
+		{
+		case FermatKernel::AVX2:
+			return 4;
+		case FermatKernel::AVX512:
+		case FermatKernel::AVX512IFMA:
+			return 8;
+		default:
+			return 1;
+		}
+	}
+
+
+	void FermatMulti(const uint1024_t* pModuli, uint1024_t* pResults, size_t nCount)
+	{
+		FermatMulti(FermatBestKernel(), pModuli, pResults, nCount);
+	}
+
+
+#if defined(LLC_FERMAT_SIMD)
+	/* Fewest numbers for which a kernel call is faster than the scalar tests. An IFMA call costs about two scalar tests, an AVX-512 call five. */
+	static uint32_t FermatMinBatch(FermatKernel kernel)
+	{
+		switch(kernel)
+		{
+		case FermatKernel::AVX512IFMA:
+			return 2;
+		case FermatKernel::AVX512:
+			return 5;
+		default:
+			return FermatLanes(kernel);
+		}
+	}
+
+
+	/* Runs one kernel call on nCount <= nLanes numbers, the unused lanes repeat the first number. */
+	static void FermatBatch(FermatKernel kernel, uint32_t nLanes, const uint1024_t* pModuli, uint1024_t* pResults, size_t nCount)
+	{
+		uint64_t moduli[8 * 16];
+		uint64_t r[8 * 16];
+		uint64_t results[8 * 16];
+		uint64_t t[33];
+
+		for(uint32_t nLane = 0; nLane < nLanes; ++nLane)
+		{
+			/* uint1024_t is little endian 32-bit words, the same bytes as little endian 64-bit words */
+			uint64_t* p = &moduli[nLane * 16];
+			std::memcpy(p, pModuli[nLane < nCount ? nLane : 0].begin(), 16 * sizeof(uint64_t));
+
+			/* 2^1024 mod p, the kernel continues from there to its own R */
+			calcBar<16>(&r[nLane * 16], p, t);
+		}
+
+		switch(kernel)
+		{
+		case FermatKernel::AVX2:
+			FermatMulti_AVX2(moduli, r, results);
+			break;
+		case FermatKernel::AVX512:
+			FermatMulti_AVX512(moduli, r, results);
+			break;
+		default:
+			FermatMulti_AVX512IFMA(moduli, r, results);
+			break;
+		}
+
+		for(size_t i = 0; i < nCount; ++i)
+			std::memcpy(pResults[i].begin(), &results[i * 16], 16 * sizeof(uint64_t));
+	}
+#endif
+
+
+	void FermatMulti(FermatKernel kernel, const uint1024_t* pModuli, uint1024_t* pResults, size_t nCount)
+	{
+		if(!FermatSupported(kernel))
+			kernel = FermatKernel::SCALAR;
+
+		size_t nIndex = 0;
+
+#if defined(LLC_FERMAT_SIMD)
+		/* a remainder that doesn't fill the lanes still runs in the kernel if that is cheaper */
+		if(kernel != FermatKernel::SCALAR)
+		{
+			uint32_t nLanes = FermatLanes(kernel);
+			uint32_t nMinBatch = FermatMinBatch(kernel);
+			while(nIndex + nMinBatch <= nCount)
+			{
+				size_t nBatch = nCount - nIndex < nLanes ? nCount - nIndex : nLanes;
+				FermatBatch(kernel, nLanes, pModuli + nIndex, pResults + nIndex, nBatch);
+				nIndex += nBatch;
+			}
+		}
+#endif
+
+		/* remaining numbers one by one */
+		for(; nIndex < nCount; ++nIndex)
+			pResults[nIndex] = fermat_prime(pModuli[nIndex]);
+	}
+}
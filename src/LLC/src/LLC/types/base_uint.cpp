@@ -9,6 +9,20 @@ ________________________________________________________________________________
 #include <limits>
 #include <stdexcept>
 
+/* 64-bit limb arithmetic where the compiler has 128-bit integers, LLC_BASE_UINT_32 keeps the 32-bit word loops */
+#if defined(__SIZEOF_INT128__) && !defined(LLC_BASE_UINT_32)
+#define LLC_BASE_UINT_64
+#endif
+
+#if defined(LLC_BASE_UINT_64) && defined(__x86_64__)
+#include <x86intrin.h>
+#define LLC_BASE_UINT_ADDCARRY
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace
 {
     uint8_t phexdigit[256] =
@@ -21,6 +35,364 @@ namespace
         0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
         0,0xa,0xb,0xc,0xd,0xe,0xf,0,0,0,0,0,0,0,0,0
     };
+
+
+    /* Index of the highest set bit, x != 0. */
+    inline uint32_t HighBit(uint32_t x)
+    {
+    #if defined(__GNUC__)
+        return 31 - __builtin_clz(x);
+    #else
+        uint32_t n = 0;
+        while(x >>= 1)
+            ++n;
+
+        return n;
+    #endif
+    }
+
+
+    /* a == b for nWidth 32-bit words, 128 bits at a time with SSE2. */
+    inline bool Equal(const uint32_t* a, const uint32_t* b, uint32_t nWidth)
+    {
+        uint32_t i = 0;
+        uint32_t nDiff = 0;
+
+    #if defined(__SSE2__)
+        __m128i x = _mm_setzero_si128();
+        for(; i + 4 <= nWidth; i += 4)
+            x = _mm_or_si128(x, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i))));
+
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xffff)
+            return false;
+    #endif
+
+        for(; i < nWidth; ++i)
+            nDiff |= a[i] ^ b[i];
+
+        return nDiff == 0;
+    }
+
+
+    /* -1, 0 or 1 as a is less than, equal to or greater than b. With SSE2 the highest differing word is
+     * found 128 bits at a time, target comparisons of hashes mostly differ in the top words. */
+    inline int32_t Compare(const uint32_t* a, const uint32_t* b, uint32_t nWidth)
+    {
+        int32_t i = nWidth - 1;
+
+    #if defined(__SSE2__)
+        /* the words above the last full 128 bits first */
+        for(; i >= 0 && ((i + 1) & 3) != 0; --i)
+        {
+            if(a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+
+        for(; i >= 3; i -= 4)
+        {
+            __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i - 3)), _mm_loadu_si128((const __m128i*)(b + i - 3)));
+            uint32_t nMask = ~static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(eq))) & 0xf;
+            if(nMask != 0)
+            {
+                int32_t n = i - 3 + HighBit(nMask);
+                return a[n] < b[n] ? -1 : 1;
+            }
+        }
+    #else
+        for(; i >= 0; --i)
+        {
+            if(a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+    #endif
+
+        return 0;
+    }
+
+
+#if defined(LLC_BASE_UINT_64)
+    /* Limb primitives. They are constexpr, the loops below use the add with carry intrinsics at runtime where available. */
+    using Wide = unsigned __int128;
+
+
+    /* a + b + carry, carry out in nCarry. */
+    constexpr uint64_t AddCarry(uint64_t a, uint64_t b, uint8_t& nCarry)
+    {
+        Wide n = Wide(a) + b + nCarry;
+        nCarry = static_cast<uint8_t>(n >> 64);
+
+        return static_cast<uint64_t>(n);
+    }
+
+
+    /* a - b - borrow, borrow out in nBorrow. */
+    constexpr uint64_t SubBorrow(uint64_t a, uint64_t b, uint8_t& nBorrow)
+    {
+        Wide n = Wide(a) - b - nBorrow;
+        nBorrow = static_cast<uint8_t>(n >> 64) & 1;
+
+        return static_cast<uint64_t>(n);
+    }
+
+
+    /* a * b + c + d, the high limb in nHigh. Can't overflow: (2^64 - 1)^2 + 2 (2^64 - 1) < 2^128. */
+    constexpr uint64_t MulAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t& nHigh)
+    {
+        Wide n = Wide(a) * b + c + d;
+        nHigh = static_cast<uint64_t>(n >> 64);
+
+        return static_cast<uint64_t>(n);
+    }
+
+
+    static_assert([]{ uint8_t c = 1; return AddCarry(~uint64_t(0), 0, c) == 0 && c == 1; }(), "AddCarry");
+    static_assert([]{ uint8_t b = 0; return SubBorrow(0, 1, b) == ~uint64_t(0) && b == 1; }(), "SubBorrow");
+    static_assert([]{ uint64_t h = 0; return MulAdd(~uint64_t(0), ~uint64_t(0), ~uint64_t(0), ~uint64_t(0), h) == ~uint64_t(0) && h == ~uint64_t(0); }(), "MulAdd");
+
+
+    /* The 32-bit words of a base_uint as 64-bit limbs, limb i is words 2i and 2i + 1. Odd widths
+     * (base_uint<1056>) have a half used top limb, its upper word is zero after loading and dropped
+     * when stored. */
+    template<uint32_t WIDTH>
+    struct Limbs
+    {
+        enum { SIZE = (WIDTH + 1) / 2 };
+
+        uint64_t n[SIZE];
+
+
+        explicit Limbs(const uint32_t* pn)
+        {
+            for(uint32_t i = 0; i < WIDTH / 2; ++i)
+                n[i] = pn[2 * i] | uint64_t(pn[2 * i + 1]) << 32;
+
+            if(WIDTH & 1)
+                n[SIZE - 1] = pn[WIDTH - 1];
+        }
+
+
+        void Store(uint32_t* pn) const
+        {
+            for(uint32_t i = 0; i < WIDTH / 2; ++i)
+            {
+                pn[2 * i] = static_cast<uint32_t>(n[i]);
+                pn[2 * i + 1] = static_cast<uint32_t>(n[i] >> 32);
+            }
+
+            if(WIDTH & 1)
+                pn[WIDTH - 1] = static_cast<uint32_t>(n[SIZE - 1]);
+        }
+
+
+        /* Number of limbs up to the highest non zero one. */
+        uint32_t Used() const
+        {
+            uint32_t i = SIZE;
+            while(i > 0 && n[i - 1] == 0)
+                --i;
+
+            return i;
+        }
+
+
+        void Add(const Limbs& b)
+        {
+        #if defined(LLC_BASE_UINT_ADDCARRY)
+            unsigned char c = 0;
+            for(uint32_t i = 0; i < SIZE; ++i)
+            {
+                unsigned long long r;
+                c = _addcarry_u64(c, n[i], b.n[i], &r);
+                n[i] = r;
+            }
+        #else
+            uint8_t c = 0;
+            for(uint32_t i = 0; i < SIZE; ++i)
+                n[i] = AddCarry(n[i], b.n[i], c);
+        #endif
+        }
+
+
+        void Sub(const Limbs& b)
+        {
+        #if defined(LLC_BASE_UINT_ADDCARRY)
+            unsigned char c = 0;
+            for(uint32_t i = 0; i < SIZE; ++i)
+            {
+                unsigned long long r;
+                c = _subborrow_u64(c, n[i], b.n[i], &r);
+                n[i] = r;
+            }
+        #else
+            uint8_t c = 0;
+            for(uint32_t i = 0; i < SIZE; ++i)
+                n[i] = SubBorrow(n[i], b.n[i], c);
+        #endif
+        }
+
+
+        /* The carry stops early, most additions of a 64-bit number touch one limb. */
+        void Add(uint64_t b)
+        {
+            uint8_t c = 0;
+            n[0] = AddCarry(n[0], b, c);
+            for(uint32_t i = 1; c != 0 && i < SIZE; ++i)
+                n[i] = AddCarry(n[i], 0, c);
+        }
+
+
+        void Sub(uint64_t b)
+        {
+            uint8_t c = 0;
+            n[0] = SubBorrow(n[0], b, c);
+            for(uint32_t i = 1; c != 0 && i < SIZE; ++i)
+                n[i] = SubBorrow(n[i], 0, c);
+        }
+
+
+        /* Product of a and b truncated to SIZE limbs. Rows start at the lowest used limb of a. */
+        void Mul(const Limbs& a, const Limbs& b)
+        {
+            for(uint32_t i = 0; i < SIZE; ++i)
+                n[i] = 0;
+
+            uint32_t nUsed = a.Used();
+            for(uint32_t i = 0; i < nUsed; ++i)
+            {
+                if(a.n[i] == 0)
+                    continue;
+
+                uint64_t nCarry = 0;
+                for(uint32_t j = 0; i + j < SIZE; ++j)
+                    n[i + j] = MulAdd(a.n[i], b.n[j], n[i + j], nCarry, nCarry);
+            }
+        }
+
+
+        void Mul(uint64_t b)
+        {
+            uint64_t nCarry = 0;
+            for(uint32_t i = 0; i < SIZE; ++i)
+                n[i] = MulAdd(n[i], b, 0, nCarry, nCarry);
+        }
+
+
+        void ShiftLeft(uint32_t nShift)
+        {
+            uint32_t k = nShift / 64;
+            nShift %= 64;
+
+            for(int32_t i = SIZE - 1; i >= 0; --i)
+            {
+                uint64_t nLimb = 0;
+                if(i - int32_t(k) >= 0)
+                    nLimb = n[i - k] << nShift;
+                if(nShift != 0 && i - int32_t(k) - 1 >= 0)
+                    nLimb |= n[i - k - 1] >> (64 - nShift);
+
+                n[i] = nLimb;
+            }
+        }
+
+
+        void ShiftRight(uint32_t nShift)
+        {
+            uint32_t k = nShift / 64;
+            nShift %= 64;
+
+            for(uint32_t i = 0; i < SIZE; ++i)
+            {
+                uint64_t nLimb = 0;
+                if(i + k < SIZE)
+                    nLimb = n[i + k] >> nShift;
+                if(nShift != 0 && i + k + 1 < SIZE)
+                    nLimb |= n[i + k + 1] << (64 - nShift);
+
+                n[i] = nLimb;
+            }
+        }
+
+
+        /* Divides by d != 0, returns the remainder. */
+        uint64_t Div(uint64_t d)
+        {
+            uint64_t nRemainder = 0;
+            for(int32_t i = Used() - 1; i >= 0; --i)
+            {
+                Wide x = Wide(nRemainder) << 64 | n[i];
+                n[i] = static_cast<uint64_t>(x / d);
+                nRemainder = static_cast<uint64_t>(x % d);
+            }
+
+            return nRemainder;
+        }
+
+
+        /* this = u / v for v with at least two used limbs, Knuth's algorithm D. */
+        void Div(const Limbs& u, const Limbs& v)
+        {
+            for(uint32_t i = 0; i < SIZE; ++i)
+                n[i] = 0;
+
+            const int32_t m = u.Used();
+            const int32_t nv = v.Used();
+            if(m < nv)
+                return;
+
+            /* normalize so the top limb of the divisor has its high bit set */
+            uint32_t s = __builtin_clzll(v.n[nv - 1]);
+            uint64_t vn[SIZE];
+            uint64_t un[SIZE + 1];
+            for(int32_t i = nv - 1; i > 0; --i)
+                vn[i] = (v.n[i] << s) | (s == 0 ? 0 : v.n[i - 1] >> (64 - s));
+            vn[0] = v.n[0] << s;
+
+            un[m] = s == 0 ? 0 : u.n[m - 1] >> (64 - s);
+            for(int32_t i = m - 1; i > 0; --i)
+                un[i] = (u.n[i] << s) | (s == 0 ? 0 : u.n[i - 1] >> (64 - s));
+            un[0] = u.n[0] << s;
+
+            for(int32_t j = m - nv; j >= 0; --j)
+            {
+                /* estimate the quotient limb from the top two limbs, at most one too large after the correction */
+                Wide nNum = Wide(un[j + nv]) << 64 | un[j + nv - 1];
+                Wide q = nNum / vn[nv - 1];
+                Wide r = nNum % vn[nv - 1];
+                while((q >> 64) != 0 || q * vn[nv - 2] > ((r << 64) | un[j + nv - 2]))
+                {
+                    --q;
+                    r += vn[nv - 1];
+                    if((r >> 64) != 0)
+                        break;
+                }
+
+                /* un[j..j + nv] -= q * vn */
+                uint64_t nQuotient = static_cast<uint64_t>(q);
+                uint64_t nCarry = 0;
+                uint8_t nBorrow = 0;
+                for(int32_t i = 0; i < nv; ++i)
+                {
+                    uint64_t nProduct = MulAdd(nQuotient, vn[i], nCarry, 0, nCarry);
+                    un[i + j] = SubBorrow(un[i + j], nProduct, nBorrow);
+                }
+                un[j + nv] = SubBorrow(un[j + nv], nCarry, nBorrow);
+
+                /* q was one too large, add the divisor back */
+                if(nBorrow != 0)
+                {
+                    --nQuotient;
+
+                    uint8_t c = 0;
+                    for(int32_t i = 0; i < nv; ++i)
+                        un[i + j] = AddCarry(un[i + j], vn[i], c);
+                    un[j + nv] += c;
+                }
+
+                n[j] = nQuotient;
+            }
+        }
+    };
+#endif
 }
 
 
@@ -217,6 +589,11 @@ base_uint<BITS>& base_uint<BITS>::operator&=(const base_uint<BITS>& b)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator<<=(uint32_t shift)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.ShiftLeft(shift);
+    a.Store(pn);
+#else
     base_uint<BITS> a(*this);
     for (int32_t i = 0; i < WIDTH; ++i)
         pn[i] = 0;
@@ -230,6 +607,7 @@ base_uint<BITS>& base_uint<BITS>::operator<<=(uint32_t shift)
         if (i + k < WIDTH)
             pn[i + k] |= (a.pn[i] << shift);
     }
+#endif
 
     return *this;
 }
@@ -240,6 +618,11 @@ base_uint<BITS>& base_uint<BITS>::operator<<=(uint32_t shift)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator>>=(uint32_t shift)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.ShiftRight(shift);
+    a.Store(pn);
+#else
     base_uint<BITS> a(*this);
 
     for (int32_t i = 0; i < WIDTH; ++i)
@@ -254,6 +637,7 @@ base_uint<BITS>& base_uint<BITS>::operator>>=(uint32_t shift)
         if (i - k >= 0)
             pn[i - k] |= (a.pn[i] >> shift);
     }
+#endif
 
     return *this;
 }
@@ -263,6 +647,11 @@ base_uint<BITS>& base_uint<BITS>::operator>>=(uint32_t shift)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator+=(const base_uint<BITS>& b)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.Add(Limbs<WIDTH>(b.pn));
+    a.Store(pn);
+#else
     uint64_t carry = 0;
     for (uint8_t i = 0; i < WIDTH; ++i)
     {
@@ -270,6 +659,7 @@ base_uint<BITS>& base_uint<BITS>::operator+=(const base_uint<BITS>& b)
         pn[i] = n & 0xffffffff;
         carry = n >> 32;
     }
+#endif
 
     return *this;
 }
@@ -279,9 +669,15 @@ base_uint<BITS>& base_uint<BITS>::operator+=(const base_uint<BITS>& b)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator+=(uint64_t b64)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.Add(b64);
+    a.Store(pn);
+#else
     base_uint<BITS> b;
     b = b64;
     *this += b;
+#endif
 
     return *this;
 }
@@ -291,7 +687,13 @@ base_uint<BITS>& base_uint<BITS>::operator+=(uint64_t b64)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator-=(const base_uint<BITS>& b)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.Sub(Limbs<WIDTH>(b.pn));
+    a.Store(pn);
+#else
     *this += -b;
+#endif
 
     return *this;
 }
@@ -301,9 +703,15 @@ base_uint<BITS>& base_uint<BITS>::operator-=(const base_uint<BITS>& b)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator-=(uint64_t b64)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.Sub(b64);
+    a.Store(pn);
+#else
     base_uint<BITS> b;
     b = b64;
     *this += -b;
+#endif
 
     return *this;
 }
@@ -313,6 +721,14 @@ base_uint<BITS>& base_uint<BITS>::operator-=(uint64_t b64)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator*=(const base_uint<BITS>& b)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    Limbs<WIDTH> r(pn);
+    r.Mul(a, Limbs<WIDTH>(b.pn));
+    r.Store(pn);
+
+    return *this;
+#else
     base_uint<BITS> a;
     a = 0u;
 
@@ -329,6 +745,7 @@ base_uint<BITS>& base_uint<BITS>::operator*=(const base_uint<BITS>& b)
     *this = a;
 
     return *this;
+#endif
 }
 
 
@@ -336,6 +753,13 @@ base_uint<BITS>& base_uint<BITS>::operator*=(const base_uint<BITS>& b)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator*=(uint64_t rhs)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> a(pn);
+    a.Mul(rhs);
+    a.Store(pn);
+
+    return *this;
+#else
     base_uint<BITS> a;
     a = 0u;
 
@@ -355,6 +779,7 @@ base_uint<BITS>& base_uint<BITS>::operator*=(uint64_t rhs)
     *this = a;
 
     return *this;
+#endif
 }
 
 
@@ -363,6 +788,23 @@ base_uint<BITS>& base_uint<BITS>::operator*=(uint64_t rhs)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator/=(const base_uint<BITS>& b)
 {
+#if defined(LLC_BASE_UINT_64)
+    Limbs<WIDTH> u(pn);
+    Limbs<WIDTH> v(b.pn);
+
+    uint32_t nUsed = v.Used();
+    if (nUsed == 0)
+        throw std::domain_error("Division by zero");
+
+    if (nUsed == 1)
+        u.Div(v.n[0]);
+    else
+        u.Div(Limbs<WIDTH>(pn), v);
+
+    u.Store(pn);
+
+    return *this;
+#else
     base_uint<BITS> div = b;     // make a copy, so we can shift.
     base_uint<BITS> num = *this; // make a copy, so we can subtract.
     *this = 0;                   // the quotient.
@@ -393,6 +835,7 @@ base_uint<BITS>& base_uint<BITS>::operator/=(const base_uint<BITS>& b)
 
     // num now contains the remainder of the division.
     return *this;
+#endif
 }
 
 
@@ -400,7 +843,16 @@ base_uint<BITS>& base_uint<BITS>::operator/=(const base_uint<BITS>& b)
 template<uint32_t BITS>
 base_uint<BITS>& base_uint<BITS>::operator/=(uint64_t b)
 {
+#if defined(LLC_BASE_UINT_64)
+    if (b == 0)
+        throw std::domain_error("Division by zero");
+
+    Limbs<WIDTH> a(pn);
+    a.Div(b);
+    a.Store(pn);
+#else
     *this /= base_uint<BITS>(b);
+#endif
 
     // num now contains the remainder of the division.
     return *this;
@@ -462,15 +914,7 @@ const base_uint<BITS> base_uint<BITS>::operator--(int)
 template<uint32_t BITS>
 bool base_uint<BITS>::operator<(const base_uint<BITS>& rhs) const
 {
-    for (int8_t i = WIDTH - 1; i >= 0; --i)
-    {
-        if (this->pn[i] < rhs.pn[i])
-            return true;
-        else if (this->pn[i] > rhs.pn[i])
-            return false;
-    }
-
-    return false;
+    return Compare(pn, rhs.pn, WIDTH) < 0;
 }
 
 
@@ -478,15 +922,7 @@ bool base_uint<BITS>::operator<(const base_uint<BITS>& rhs) const
 template<uint32_t BITS>
 bool base_uint<BITS>::operator<=(const base_uint<BITS>& rhs) const
 {
-    for (int8_t i = WIDTH - 1; i >= 0; --i)
-    {
-        if (this->pn[i] < rhs.pn[i])
-            return true;
-        else if (this->pn[i] > rhs.pn[i])
-            return false;
-    }
-
-    return true;
+    return Compare(pn, rhs.pn, WIDTH) <= 0;
 }
 
 
@@ -494,15 +930,7 @@ bool base_uint<BITS>::operator<=(const base_uint<BITS>& rhs) const
 template<uint32_t BITS>
 bool base_uint<BITS>::operator>(const base_uint<BITS>& rhs) const
 {
-    for (int8_t i = WIDTH - 1; i >= 0; --i)
-    {
-        if (this->pn[i] > rhs.pn[i])
-            return true;
-        else if (this->pn[i] < rhs.pn[i])
-            return false;
-    }
-
-    return false;
+    return Compare(pn, rhs.pn, WIDTH) > 0;
 }
 
 
@@ -510,15 +938,7 @@ bool base_uint<BITS>::operator>(const base_uint<BITS>& rhs) const
 template<uint32_t BITS>
 bool base_uint<BITS>::operator>=(const base_uint<BITS>& rhs) const
 {
-    for (int8_t i = WIDTH - 1; i >= 0; --i)
-    {
-        if (this->pn[i] > rhs.pn[i])
-            return true;
-        else if (this->pn[i] < rhs.pn[i])
-            return false;
-    }
-
-    return true;
+    return Compare(pn, rhs.pn, WIDTH) >= 0;
 }
 
 
@@ -526,11 +946,7 @@ bool base_uint<BITS>::operator>=(const base_uint<BITS>& rhs) const
 template<uint32_t BITS>
 bool base_uint<BITS>::operator==(const base_uint<BITS>& rhs) const
 {
-    for (uint8_t i = 0; i < WIDTH; ++i)
-        if (this->pn[i] != rhs.pn[i])
-            return false;
-
-    return true;
+    return Equal(pn, rhs.pn, WIDTH);
 }
 
 
@@ -642,17 +1058,14 @@ uint8_t base_uint<BITS>::GetType() const
 template<uint32_t BITS>
 const std::vector<uint8_t> base_uint<BITS>::GetBytes() const
 {
-    std::vector<uint8_t> DATA;
+    std::vector<uint8_t> DATA(WIDTH * 4);
 
     for (int index = 0; index < WIDTH; ++index)
     {
-        std::vector<uint8_t> BYTES(4, 0);
-        BYTES[0] = static_cast<uint8_t>(pn[index] >> 24);
-        BYTES[1] = static_cast<uint8_t>(pn[index] >> 16);
-        BYTES[2] = static_cast<uint8_t>(pn[index] >> 8);
-        BYTES[3] = static_cast<uint8_t>(pn[index]);
-
-        DATA.insert(DATA.end(), BYTES.begin(), BYTES.end());
+        DATA[index * 4] = static_cast<uint8_t>(pn[index] >> 24);
+        DATA[index * 4 + 1] = static_cast<uint8_t>(pn[index] >> 16);
+        DATA[index * 4 + 2] = static_cast<uint8_t>(pn[index] >> 8);
+        DATA[index * 4 + 3] = static_cast<uint8_t>(pn[index]);
     }
 
     return DATA;
@@ -665,8 +1078,8 @@ void base_uint<BITS>::SetBytes(const std::vector<uint8_t> DATA)
 {
     for (int index = 0; index < WIDTH; ++index)
     {
-        std::vector<uint8_t> BYTES(DATA.begin() + (index * 4), DATA.begin() + (index * 4) + 4);
-        pn[index] = (BYTES[0] << 24) + (BYTES[1] << 16) + (BYTES[2] << 8) + (BYTES[3]);
+        const uint8_t* BYTES = &DATA[index * 4];
+        pn[index] = (uint32_t(BYTES[0]) << 24) + (BYTES[1] << 16) + (BYTES[2] << 8) + (BYTES[3]);
     }
 }
 
@@ -782,14 +1195,7 @@ uint32_t base_uint<BITS>::bits() const
     for (int32_t pos = WIDTH - 1; pos >= 0; --pos)
     {
         if (pn[pos])
-        {
-            for (int32_t nbits = 31; nbits > 0; --nbits)
-            {
-                if (pn[pos] & 1U << nbits)
-                    return 32 * pos + nbits + 1;
-            }
-            return 32 * pos + 1;
-        }
+            return 32 * pos + HighBit(pn[pos]) + 1;
     }
 
     return 0;
@@ -810,8 +1216,17 @@ base_uint<BITS>& base_uint<BITS>::SetCompact(uint32_t nCompact)
     }
     else
     {
-        *this = nWord;
-        *this <<= 8 * (nSize - 3);
+        /* the 23-bit word lands in at most two words, no full width shift */
+        for (uint8_t i = 0; i < WIDTH; ++i)
+            pn[i] = 0;
+
+        uint32_t nShift = 8 * (nSize - 3);
+        uint64_t nShifted = uint64_t(nWord) << (nShift & 31);
+        uint32_t k = nShift >> 5;
+        if (k < WIDTH)
+            pn[k] = static_cast<uint32_t>(nShifted);
+        if (k + 1 < WIDTH)
+            pn[k + 1] = static_cast<uint32_t>(nShifted >> 32);
     }
 
     return *this;
@@ -5,6 +5,7 @@
 #include "LLC/hash/SK.h"
 #include "utils.hpp"
 #include <memory>
+#include <vector>
 
 #define BEGIN(a)            ((char*)&(a))
 #define END(a)              ((char*)&((&(a))[1]))
@@ -32,6 +33,9 @@ namespace LLP
 		/** End of Header.     END(nNonce).
 			All the components to build an SK1024 Block Hash. **/
 
+		/** Prime channel: offsets of the cluster as submitted by the miner (TAO::Ledger::GetOffsets format), not part of the header. **/
+		std::vector<std::uint8_t> vOffsets;
+
 		std::vector<std::uint8_t> serialize() const
 		{
 			auto const VERSION = nexuspool::uint2bytes(nVersion);
@@ -0,0 +1,41 @@
+#ifndef NEXUS_LLP_BLOCK_HASH_CONTEXT_H
+#define NEXUS_LLP_BLOCK_HASH_CONTEXT_H
+
+#include "LLC/types/uint1024.h"
+#include "LLC/hash/SK/skein.h"
+#include "LLP/block.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace nexuspool
+{
+namespace LLP
+{
+
+	/** Hashing context of a hash channel job. Shares of a job only differ in nNonce, so the Skein1024 state
+		over the constant header prefix (nVersion .. nBits) is computed once and only the block holding the
+		nonce is processed per share. The mainnet and pool targets are cached as well. **/
+	class Block_hash_context
+	{
+	public:
+		using Sptr = std::shared_ptr<Block_hash_context const>;
+
+		Block_hash_context(CBlock const& block, std::uint32_t pool_nbits);
+
+		// same result as CBlock::GetHash() of the job block with the given nonce
+		uint1024_t get_hash(std::uint64_t nonce) const;
+
+		uint1024_t const& get_mainnet_target() const { return m_mainnet_target; }
+		uint1024_t const& get_pool_target() const { return m_pool_target; }
+
+	private:
+
+		Skein1024_Ctxt_t m_skein_midstate;
+		uint1024_t m_mainnet_target;
+		uint1024_t m_pool_target;
+	};
+
+}
+}
+
+#endif
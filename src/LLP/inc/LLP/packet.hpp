@@ -138,20 +138,49 @@ namespace nexuspool
 				return network::Shared_payload{};
 			}
 
-			network::Payload BYTES(1, m_header);
+			auto bytes = get_header_bytes();
 
 			/** Handle for Data Packets. **/
-			if (m_header < 128 && m_length > 0)
+			if (is_data_packet())
 			{
-				BYTES.push_back((m_length >> 24)); 
-				BYTES.push_back((m_length >> 16));
-				BYTES.push_back((m_length >> 8));  
-				BYTES.push_back(m_length);
+				bytes->insert(bytes->end(), m_data->begin(), m_data->end());
+			}
+
+			return bytes;
+		}
+
+		// header (and length) and data as separate buffers, the data is not copied
+		network::Payload_sequence get_payload_sequence()
+		{
+			if (!is_valid())
+			{
+				return network::Payload_sequence{};
+			}
 
-				BYTES.insert(BYTES.end(), m_data->begin(), m_data->end());
+			if (is_data_packet())
+			{
+				return network::Payload_sequence{ get_header_bytes(), m_data };
 			}
+			return network::Payload_sequence{ get_header_bytes() };
+		}
+
+		inline bool is_data_packet() const
+		{
+			return m_header < 128 && m_length > 0;
+		}
 
-			return std::make_shared<network::Payload>(BYTES);
+		network::Shared_payload get_header_bytes() const
+		{
+			auto bytes = std::make_shared<network::Payload>(1, m_header);
+			if (is_data_packet())
+			{
+				bytes->reserve(5 + m_length);
+				bytes->push_back((m_length >> 24));
+				bytes->push_back((m_length >> 16));
+				bytes->push_back((m_length >> 8));
+				bytes->push_back(m_length);
+			}
+			return bytes;
 		}
 
 		inline Packet get_packet(std::uint8_t header) const
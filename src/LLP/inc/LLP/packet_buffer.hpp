@@ -0,0 +1,154 @@
+#ifndef NEXUSPOOL_LLP_PACKET_BUFFER_HPP
+#define NEXUSPOOL_LLP_PACKET_BUFFER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include "network/types.hpp"
+
+namespace nexuspool
+{
+	/** Read only view into a received buffer. Keeps the buffer alive as long as the view exists. **/
+	class Payload_view
+	{
+	public:
+
+		Payload_view() = default;
+		Payload_view(network::Shared_payload owner, std::size_t offset, std::size_t size)
+			: m_owner{ std::move(owner) }
+			, m_offset{ offset }
+			, m_size{ size }
+		{
+		}
+
+		std::uint8_t const* data() const { return m_owner ? m_owner->data() + m_offset : nullptr; }
+		std::uint8_t const* begin() const { return data(); }
+		std::uint8_t const* end() const { return data() + m_size; }
+		std::size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		std::uint8_t operator[](std::size_t index) const { return data()[index]; }
+
+		// copy of the viewed bytes
+		network::Payload to_payload() const { return network::Payload(begin(), end()); }
+
+	private:
+
+		network::Shared_payload m_owner;
+		std::size_t m_offset{ 0 };
+		std::size_t m_size{ 0 };
+	};
+
+	/** Received LLP packet. The data is a view into the receive buffer of the connection (no copy). **/
+	struct Packet_view
+	{
+		std::uint8_t m_header{ 255 };
+		std::uint32_t m_length{ 0 };
+		Payload_view m_data;
+
+		inline bool is_valid() const
+		{
+			// m_header == 0 because of LOGIN message
+			return ((m_header == 0 && m_length == 0) || (m_header < 128 && m_length > 0) || (m_header >= 128 && m_header < 255 && m_length == 0));
+		}
+	};
+
+	/** Reassembles LLP packets from the byte stream of one connection.
+		Received data is accumulated across reads, incomplete packets are kept until the rest arrives.
+		The buffer is reused as long as no Packet_view of it is alive, otherwise only the unread bytes are moved to a new buffer. **/
+	class Packet_buffer
+	{
+	public:
+
+		static constexpr std::size_t default_max_size{ 1024 * 1024 };
+
+		explicit Packet_buffer(std::size_t max_size = default_max_size)
+			: m_buffer{ std::make_shared<network::Payload>() }
+			, m_read_index{ 0 }
+			, m_max_size{ max_size }
+		{
+		}
+
+		// returns false if the unprocessed data would exceed max_size (connection should be closed)
+		bool append(std::uint8_t const* data, std::size_t size)
+		{
+			auto const pending_size = get_pending_size();
+			if (pending_size + size > m_max_size)
+			{
+				return false;
+			}
+
+			if (m_buffer.use_count() > 1)
+			{
+				// packet views still point into the buffer -> don't touch it
+				auto buffer = std::make_shared<network::Payload>();
+				buffer->reserve(std::max(m_buffer->capacity(), pending_size + size));
+				buffer->assign(m_buffer->begin() + m_read_index, m_buffer->end());
+				m_buffer = std::move(buffer);
+			}
+			else if (m_read_index > 0)
+			{
+				m_buffer->erase(m_buffer->begin(), m_buffer->begin() + m_read_index);
+			}
+			m_read_index = 0;
+
+			m_buffer->insert(m_buffer->end(), data, data + size);
+			return true;
+		}
+
+		bool append(network::Payload const& data)
+		{
+			return append(data.data(), data.size());
+		}
+
+		// extracts the next complete packet. Returns false if there is no complete packet available
+		bool next_packet(Packet_view& packet)
+		{
+			auto const pending_size = get_pending_size();
+			if (pending_size == 0)
+			{
+				return false;
+			}
+
+			auto const* const data = m_buffer->data() + m_read_index;
+			std::uint8_t const header = data[0];
+			// request packets are only 1 byte
+			if (header >= 128)
+			{
+				packet = Packet_view{ header, 0, Payload_view{} };
+				m_read_index += 1;
+				return true;
+			}
+
+			// data packet -> header (1 byte) + 4 byte length + data
+			if (pending_size < 5)
+			{
+				return false;
+			}
+			std::uint32_t const length = (data[1] << 24) + (data[2] << 16) + (data[3] << 8) + data[4];
+			if (pending_size - 5 < length)
+			{
+				return false;
+			}
+
+			packet = Packet_view{ header, length, Payload_view{ m_buffer, m_read_index + 5, length } };
+			m_read_index += 5 + length;
+			return true;
+		}
+
+		std::size_t get_pending_size() const { return m_buffer->size() - m_read_index; }
+
+		void clear()
+		{
+			m_buffer = std::make_shared<network::Payload>();
+			m_read_index = 0;
+		}
+
+	private:
+
+		network::Shared_payload m_buffer;
+		std::size_t m_read_index;
+		std::size_t m_max_size;
+	};
+}
+
+#endif
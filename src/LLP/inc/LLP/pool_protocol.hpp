@@ -1,9 +1,17 @@
 #ifndef NEXUSPOOL_LLP_POOL_PROTOCOL_HPP
 #define NEXUSPOOL_LLP_POOL_PROTOCOL_HPP
 
+#include <cstdint>
+#include <vector>
+#include "network/types.hpp"
+#include "LLP/block.hpp"
+#include "LLP/utils.hpp"
+
 namespace nexuspool
 {
-#define POOL_PROTOCOL_VERSION 2
+#define POOL_PROTOCOL_VERSION 3
+#define POOL_PROTOCOL_VERSION_JSON 2		// WORK and SUBMIT_BLOCK data as json
+#define POOL_PROTOCOL_VERSION_SUPPORTED POOL_PROTOCOL_VERSION_JSON		// older miners get an update warning at login
 
 enum class Pool_protocol_result : std::uint8_t 
 {
@@ -16,6 +24,184 @@ enum class Pool_protocol_result : std::uint8_t
 	Login_warn_no_display_name
 };
 
+// Protocol version 3 -> fixed layout binary data for WORK and SUBMIT_BLOCK packets.
+// Integers use the same byte order as the LLP utils (uint2bytes, uint2bytes64), the block header is block.serialize().
+//
+// WORK
+//   BYTE 0        : protocol version
+//   BYTE 1 - 4    : work_id
+//   BYTE 5 - 8    : pool nbits
+//   BYTE 9 - 16   : nonce_start
+//   BYTE 17 - 24  : nonce_end (exclusive)
+//   BYTE 25 - 240 : block header
+//
+// SUBMIT_BLOCK
+//   BYTE 0        : protocol version
+//   BYTE 1 - 4    : work_id
+//   BYTE 5 - 12   : nonce
+//   BYTE 13       : flags (Submit_block_flags)
+//   merkle_root (64 byte)                     if Submit_block_flags::merkle_root
+//   offset count (1 byte) + offsets (1 byte)  if Submit_block_flags::offsets
+//
+// Offsets (prime channel) are in TAO::Ledger::GetOffsets format: the gap of every prime of the cluster to the one
+// before, followed by the 4 byte fractional difficulty. The pool then Fermat tests only these positions and
+// rejects the share if any of them is composite. Without offsets the pool walks the whole cluster.
+namespace pool_protocol_v3
+{
+	static constexpr std::uint8_t version{ 3U };
+	static constexpr std::size_t block_header_size{ 216U };
+	static constexpr std::size_t work_id_index{ 1U };
+	static constexpr std::size_t work_pool_nbits_index{ 5U };
+	static constexpr std::size_t work_nonce_start_index{ 9U };
+	static constexpr std::size_t work_nonce_end_index{ 17U };
+	static constexpr std::size_t work_block_index{ 25U };
+	static constexpr std::size_t work_size{ work_block_index + block_header_size };
+	static constexpr std::size_t submit_block_min_size{ 14U };
+	static constexpr std::size_t merkle_root_size{ 64U };
+
+	enum Submit_block_flags : std::uint8_t
+	{
+		merkle_root = 0x01,
+		offsets = 0x02
+	};
+
+	struct Work
+	{
+		std::uint32_t m_work_id{ 0U };
+		std::uint32_t m_pool_nbits{ 0U };
+		std::uint64_t m_nonce_start{ 0U };
+		std::uint64_t m_nonce_end{ 0U };
+		LLP::CBlock m_block;
+	};
+
+	struct Submit_block
+	{
+		std::uint32_t m_work_id{ 0U };
+		std::uint64_t m_nonce{ 0U };
+		bool m_has_merkle_root{ false };
+		uint512_t m_merkle_root{ 0 };
+		std::vector<std::uint8_t> m_offsets;
+	};
+
+	inline void write_uint32(network::Payload& data, std::size_t index, std::uint32_t value)
+	{
+		data[index] = static_cast<std::uint8_t>(value >> 24);
+		data[index + 1] = static_cast<std::uint8_t>(value >> 16);
+		data[index + 2] = static_cast<std::uint8_t>(value >> 8);
+		data[index + 3] = static_cast<std::uint8_t>(value);
+	}
+
+	inline void write_uint64(network::Payload& data, std::size_t index, std::uint64_t value)
+	{
+		write_uint32(data, index, static_cast<std::uint32_t>(value));
+		write_uint32(data, index + 4, static_cast<std::uint32_t>(value >> 32));
+	}
+
+	inline std::uint32_t read_uint32(std::uint8_t const* data)
+	{
+		return (static_cast<std::uint32_t>(data[0]) << 24) + (static_cast<std::uint32_t>(data[1]) << 16) + 
+			(static_cast<std::uint32_t>(data[2]) << 8) + data[3];
+	}
+
+	inline std::uint64_t read_uint64(std::uint8_t const* data)
+	{
+		return read_uint32(data) | (static_cast<std::uint64_t>(read_uint32(data + 4)) << 32);
+	}
+
+	inline network::Payload encode_work(Work const& work)
+	{
+		network::Payload data(work_block_index);
+		data[0] = version;
+		write_uint32(data, work_id_index, work.m_work_id);
+		write_uint32(data, work_pool_nbits_index, work.m_pool_nbits);
+		write_uint64(data, work_nonce_start_index, work.m_nonce_start);
+		write_uint64(data, work_nonce_end_index, work.m_nonce_end);
+		auto const block_data = work.m_block.serialize();
+		data.insert(data.end(), block_data.begin(), block_data.end());
+		return data;
+	}
+
+	inline bool decode_work(network::Payload const& data, Work& work)
+	{
+		if (data.size() != work_size || data[0] != version)
+		{
+			return false;
+		}
+
+		work.m_work_id = bytes2uint(data, work_id_index);
+		work.m_pool_nbits = bytes2uint(data, work_pool_nbits_index);
+		work.m_nonce_start = bytes2uint64(data, work_nonce_start_index);
+		work.m_nonce_end = bytes2uint64(data, work_nonce_end_index);
+		work.m_block = LLP::deserialize_block(std::vector<std::uint8_t>(data.begin() + work_block_index, data.end()));
+		return true;
+	}
+
+	inline network::Payload encode_submit_block(Submit_block const& submit_block)
+	{
+		network::Payload data(submit_block_min_size);
+		data[0] = version;
+		write_uint32(data, 1, submit_block.m_work_id);
+		write_uint64(data, 5, submit_block.m_nonce);
+		std::uint8_t flags{ 0U };
+		if (submit_block.m_has_merkle_root)
+		{
+			flags |= Submit_block_flags::merkle_root;
+			auto const merkle_root = submit_block.m_merkle_root.GetBytes();
+			data.insert(data.end(), merkle_root.begin(), merkle_root.end());
+		}
+		if (!submit_block.m_offsets.empty())
+		{
+			flags |= Submit_block_flags::offsets;
+			data.push_back(static_cast<std::uint8_t>(submit_block.m_offsets.size()));
+			data.insert(data.end(), submit_block.m_offsets.begin(), submit_block.m_offsets.end());
+		}
+		data[13] = flags;
+		return data;
+	}
+
+	inline bool decode_submit_block(std::uint8_t const* data, std::size_t size, Submit_block& submit_block)
+	{
+		if (size < submit_block_min_size || data[0] != version)
+		{
+			return false;
+		}
+
+		submit_block.m_work_id = read_uint32(data + 1);
+		submit_block.m_nonce = read_uint64(data + 5);
+		auto const flags = data[13];
+		std::size_t index{ submit_block_min_size };
+		submit_block.m_has_merkle_root = (flags & Submit_block_flags::merkle_root) != 0;
+		if (submit_block.m_has_merkle_root)
+		{
+			if (size < index + merkle_root_size)
+			{
+				return false;
+			}
+			submit_block.m_merkle_root.SetBytes(std::vector<std::uint8_t>(data + index, data + index + merkle_root_size));
+			index += merkle_root_size;
+		}
+
+		submit_block.m_offsets.clear();
+		if ((flags & Submit_block_flags::offsets) != 0)
+		{
+			if (size < index + 1 || size < index + 1 + data[index])
+			{
+				return false;
+			}
+			auto const offset_count = data[index];
+			submit_block.m_offsets.assign(data + index + 1, data + index + 1 + offset_count);
+			index += 1 + offset_count;
+		}
+
+		return index == size;
+	}
+
+	inline bool decode_submit_block(network::Payload const& data, Submit_block& submit_block)
+	{
+		return decode_submit_block(data.data(), data.size(), submit_block);
+	}
+}
+
 }
 
 #endif
@@ -0,0 +1,36 @@
+#include "LLP/block_hash_context.hpp"
+#include "LLC/hash/SK/KeccakHash.h"
+
+namespace nexuspool
+{
+namespace LLP
+{
+Block_hash_context::Block_hash_context(CBlock const& block, std::uint32_t pool_nbits)
+{
+	// the header is hashed from BEGIN(nVersion) to END(nNonce), everything in front of nNonce is constant per job
+	auto const prefix_size = static_cast<std::size_t>(BEGIN(block.nNonce) - BEGIN(block.nVersion));
+	Skein1024_Init(&m_skein_midstate, 1024);
+	Skein1024_Update(&m_skein_midstate, (uint8_t*)BEGIN(block.nVersion), prefix_size);
+
+	m_mainnet_target.SetCompact(block.nBits);
+	m_pool_target.SetCompact(pool_nbits);
+}
+
+uint1024_t Block_hash_context::get_hash(std::uint64_t nonce) const
+{
+	uint1024_t skein;
+	Skein1024_Ctxt_t ctx = m_skein_midstate;
+	Skein1024_Update(&ctx, (uint8_t*)&nonce, sizeof(nonce));
+	Skein1024_Final(&ctx, (uint8_t*)&skein);
+
+	uint1024_t keccak;
+	Keccak_HashInstance ctx_keccak;
+	Keccak_HashInitialize<576, 1024>(&ctx_keccak, 1024, 0x05);
+	Keccak_HashUpdate(&ctx_keccak, (uint8_t*)&skein, 1024);
+	Keccak_HashFinal(&ctx_keccak, (uint8_t*)&keccak);
+
+	return keccak;
+}
+
+}
+}
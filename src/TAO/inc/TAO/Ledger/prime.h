@@ -17,6 +17,10 @@ ________________________________________________________________________________
 
 #include <LLC/types/uint1024.h>
 
+#include <bitset>
+#include <cstddef>
+#include <vector>
+
 /* Global TAO namespace. */
 namespace TAO
 {
@@ -25,6 +29,14 @@ namespace TAO
     namespace Ledger
     {
 
+        /** Offsets from a number covered by SmallPrimeSieve. **/
+        const uint32_t SIEVE_RANGE = 256;
+
+
+        /** Number of small primes tested by SmallPrimeSieve. **/
+        const uint32_t SIEVE_PRIMES = 256;
+
+
         /** SetBits
          *
          *  Convert Double to unsigned int Representative.
@@ -46,7 +58,9 @@ namespace TAO
          *  of Fermat Remainder from last Composite Number [0 - 1]
          *
          *  @param[in] hashPrime The prime to check.
-         *  @param[in] vOffsets Optional offsets for quicker checking.
+         *  @param[in] vOffsets Optional offsets for quicker checking. Prime gaps followed by the
+         *                      4 byte fractional difficulty (GetOffsets), only these positions are tested
+         *                      and a composite at any of them gives 0.
          *
          *  @return The double value of prime difficulty.
          *
@@ -54,6 +68,19 @@ namespace TAO
         double GetPrimeDifficulty(const uint1024_t& hashPrime, const std::vector<uint8_t>& vOffsets, const bool fVerify = true);
 
 
+        /** GetPrimeDifficulties
+         *
+         *  Determines the difficulty of several primes at once, same as GetPrimeDifficulty
+         *  without offsets. The Fermat tests of all clusters run in batches.
+         *
+         *  @param[in] pPrimes The primes to check.
+         *  @param[out] pDifficulties nCount prime difficulties.
+         *  @param[in] nCount Number of primes.
+         *
+         **/
+        void GetPrimeDifficulties(const uint1024_t* pPrimes, double* pDifficulties, size_t nCount);
+
+
         /** GetOffsets
          *
          *  Return list of offsets for use in optimized prime proof of work calculations.
@@ -105,6 +132,7 @@ namespace TAO
         /** FermatTest
          *
          *  Used after Miller-Rabin and Divisor tests to verify primality.
+         *  Odd numbers use the fixed width Montgomery engine from LLC/prime/fermat.h.
          *
          *  @param[in] hashTest The prime to check
          *
@@ -114,6 +142,31 @@ namespace TAO
         uint1024_t FermatTest(const uint1024_t& hashTest);
 
 
+        /** FermatTestBatch
+         *
+         *  FermatTest of several numbers. Odd numbers run in lockstep on the SIMD lanes
+         *  (LLC/prime/fermat_multi.h) where the cpu supports it.
+         *
+         *  @param[in] pTests The numbers to check
+         *  @param[out] pResults nCount remainders of the fermat test.
+         *  @param[in] nCount Number of numbers
+         *
+         **/
+        void FermatTestBatch(const uint1024_t* pTests, uint1024_t* pResults, size_t nCount);
+
+
+        /** FermatTestBigNum
+         *
+         *  FermatTest using OpenSSL BN_mod_exp. Handles even numbers, used as reference in tests.
+         *
+         *  @param[in] hashTest The prime to check
+         *
+         *  @return The remainder of the fermat test.
+         *
+         **/
+        uint1024_t FermatTestBigNum(const uint1024_t& hashTest);
+
+
         /** MillerRabin
          *
          *  Wrapper for is_prime from OpenSSL
@@ -137,6 +190,20 @@ namespace TAO
          *
          **/
         bool SmallDivisors(const uint1024_t& hashTest);
+
+
+        /** SmallPrimeSieve
+         *
+         *  Sieves hashBase + n for 0 <= n < SIEVE_RANGE with the first SIEVE_PRIMES primes.
+         *  hashBase is reduced once modulo word sized products of these primes, the
+         *  multiples of every prime in the range follow from the small remainders.
+         *
+         *  @param[in] hashBase The number to sieve from, the base prime of a cluster.
+         *
+         *  @return Bit n is set if hashBase + n has a small prime divisor (or is a small prime itself).
+         *
+         **/
+        std::bitset<SIEVE_RANGE> SmallPrimeSieve(const uint1024_t& hashBase);
     }
 }
 
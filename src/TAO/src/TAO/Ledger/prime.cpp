@@ -13,8 +13,14 @@ ________________________________________________________________________________
 
 #include "TAO/Ledger/prime.h"
 #include <LLC/types/bignum.h>
+#include <LLC/prime/fermat.h>
+#include <LLC/prime/fermat_multi.h>
 #include <openssl/bn.h>
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 //#include <Util/include/debug.h>
 //#include <Util/include/softfloat.h>
 
@@ -27,7 +33,8 @@ namespace TAO
 namespace Ledger
 {
 
-    static const uint16_t nSmallPrimes[11] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31 };
+    /* SmallDivisors tests the first eleven primes, 2 to 31. */
+    static const uint32_t nSmallDivisors = 11;
 
     /* Convert Double to unsigned int Representative. */
     uint32_t SetBits(double nDiff)
@@ -40,123 +47,391 @@ namespace Ledger
     }
 
 
-    /* Determines the difficulty of the Given Prime Number. */
-    double GetPrimeDifficulty(const uint1024_t& hashPrime, const std::vector<uint8_t>& vOffsets, const bool fVerify)
+    namespace
+    {
+    /* The first SIEVE_PRIMES primes in groups whose product is below 2^27. A 1024-bit number is reduced
+     * modulo a product as sum of its 32-bit words times 2^(32k) mod product: every term is below 2^59,
+     * the 32 terms of a number fit 64 bits without a division until the end. */
+    struct SievePrimes
+    {
+        /* The primes in ascending order. */
+        std::vector<uint32_t> vPrimes;
+
+        /* Group i is vPrimes[vFirst[i]] up to vPrimes[vFirst[i + 1]]. */
+        std::vector<uint32_t> vFirst;
+
+        /* Product of the primes of every group. */
+        std::vector<uint32_t> vProducts;
+
+        /* 2^(32k) mod product, 32 words per group. */
+        std::vector<uint32_t> vPowers;
+
+
+        SievePrimes()
+        {
+            for(uint32_t n = 2; vPrimes.size() < SIEVE_PRIMES; ++n)
+            {
+                bool fPrime = true;
+                for(uint32_t i = 0; i < vPrimes.size() && vPrimes[i] * vPrimes[i] <= n; ++i)
+                {
+                    if(n % vPrimes[i] == 0)
+                    {
+                        fPrime = false;
+                        break;
+                    }
+                }
+
+                if(fPrime)
+                    vPrimes.push_back(n);
+            }
+
+            uint64_t nProduct = 1;
+            for(uint32_t i = 0; i < vPrimes.size(); ++i)
+            {
+                if(i == 0 || nProduct * vPrimes[i] >= (uint64_t(1) << 27))
+                {
+                    if(i != 0)
+                        vProducts.push_back(static_cast<uint32_t>(nProduct));
+
+                    vFirst.push_back(i);
+                    nProduct = 1;
+                }
+
+                nProduct *= vPrimes[i];
+            }
+            vProducts.push_back(static_cast<uint32_t>(nProduct));
+            vFirst.push_back(static_cast<uint32_t>(vPrimes.size()));
+
+            for(const uint32_t nMod : vProducts)
+            {
+                uint64_t nPower = 1;
+                for(uint32_t k = 0; k < 32; ++k)
+                {
+                    vPowers.push_back(static_cast<uint32_t>(nPower));
+                    nPower = (nPower << 32) % nMod;
+                }
+            }
+        }
+
+
+        /* The number modulo the product of group i. */
+        uint32_t Reduce(const uint32_t* pWords, uint32_t i) const
+        {
+            const uint32_t* pPowers = &vPowers[i * 32];
+
+            uint64_t nSum = 0;
+            for(uint32_t k = 0; k < 32; ++k)
+                nSum += uint64_t(pWords[k]) * pPowers[k];
+
+            return static_cast<uint32_t>(nSum % vProducts[i]);
+        }
+    };
+
+
+    /* Built once on first use. */
+    const SievePrimes& GetSievePrimes()
+    {
+        static const SievePrimes primes;
+        return primes;
+    }
+
+
+    /* A prime cluster that is walked in steps. The candidates of a step of all clusters are fermat tested together. */
+    struct Cluster
+    {
+        /* The base prime. */
+        uint1024_t hashPrime;
+
+        /* Offsets of the other primes of the cluster from the base prime. */
+        std::vector<uint32_t> vPrimes;
+
+        /* Every candidate up to hashPrime + nTested has been tested. */
+        uint32_t nTested = 0;
+
+        /* Small prime divisors of the offsets from the base prime. */
+        std::bitset<SIEVE_RANGE> vSieve;
+
+        /* False if the base isn't prime. */
+        bool fPrime = true;
+
+        /* Fermat remainder of the composite after the cluster. */
+        uint1024_t hashRemainder;
+
+
+        /* Offset of the last prime of the cluster. */
+        uint32_t Last() const
+        {
+            return vPrimes.empty() ? 0 : vPrimes.back();
+        }
+    };
+    }
+
+
+    /* Breaks the remainder of last composite in Prime Cluster into an integer. */
+    static uint32_t FractionalDifficulty(const uint1024_t& hashComposite, const uint1024_t& hashRemainder)
     {
-        /* Return 0 if base is not prime. */
-        if(fVerify && !PrimeCheck(hashPrime))
-            return 0.0;
+        uint1056_t a(hashComposite);
+        uint1056_t b(hashRemainder);
+
+        return ((a - b << 24) / a).getuint32();
+    }
+
+
+    /* Calculate the rarity of cluster from proportion of fermat remainder of last prime + 2. */
+    static double ClusterDifficulty(uint32_t nClusterSize, uint32_t nFraction)
+    {
+        /*cv::softdouble nRemainder = cv::softdouble(1000000.0) / cv::softdouble(nFraction);
+        if(nRemainder > cv::softdouble(1.0) || nRemainder < cv::softdouble(0.0))
+            nRemainder = cv::softdouble(0.0);*/
+        double nRemainder = 0.0;
+        if (nFraction != 0)
+            nRemainder = 1000000.0 / nFraction;
+        if (nRemainder > 1.0 || nRemainder < 0.0)
+            nRemainder = 0.0;
+
+        return double(nClusterSize + nRemainder);
+    }
+
+
+    /* Walks the clusters of the base primes. Largest prime gap is +12 for dense clusters, so every
+     * candidate up to +12 after the last prime found is tested. Small divisors are sieved once per
+     * cluster, the fermat tests of one step of all clusters run as one batch. */
+    static void WalkClusters(std::vector<Cluster>& vClusters, const bool fVerify)
+    {
+        std::vector<uint1024_t> vTests;
+        std::vector<uint1024_t> vResults;
+        std::vector<std::pair<size_t, uint32_t>> vCandidates;
+
+        for(Cluster& cluster : vClusters)
+            cluster.vSieve = SmallPrimeSieve(cluster.hashPrime);
+
+        /* Check the base primes. */
+        if(fVerify)
+        {
+            for(size_t i = 0; i < vClusters.size(); ++i)
+            {
+                if(vClusters[i].vSieve[0])
+                    vClusters[i].fPrime = false;
+                else
+                {
+                    vTests.push_back(vClusters[i].hashPrime);
+                    vCandidates.emplace_back(i, 0);
+                }
+            }
+
+            vResults.resize(vTests.size());
+            FermatTestBatch(vTests.data(), vResults.data(), vTests.size());
+            for(size_t i = 0; i < vCandidates.size(); ++i)
+            {
+                if(vResults[i] != 1)
+                    vClusters[vCandidates[i].first].fPrime = false;
+            }
+        }
+
+        /* Walk the clusters until no new prime is found in reach. */
+        std::vector<size_t> vActive;
+        for(size_t i = 0; i < vClusters.size(); ++i)
+        {
+            if(vClusters[i].fPrime)
+                vActive.push_back(i);
+        }
+
+        while(!vActive.empty())
+        {
+            vTests.clear();
+            vCandidates.clear();
+            for(const size_t nCluster : vActive)
+            {
+                Cluster& cluster = vClusters[nCluster];
+
+                uint32_t nEnd = cluster.Last() + 12;
+                for(uint32_t nOffset = cluster.nTested + 2; nOffset <= nEnd; nOffset += 2)
+                {
+                    /* Clusters reaching past the sieve fall back to the small divisors. */
+                    bool fCandidate = nOffset < SIEVE_RANGE ? !cluster.vSieve[nOffset] : SmallDivisors(cluster.hashPrime + nOffset);
+                    if(fCandidate)
+                    {
+                        vTests.push_back(cluster.hashPrime + nOffset);
+                        vCandidates.emplace_back(nCluster, nOffset);
+                    }
+                }
+
+                cluster.nTested = nEnd;
+            }
+
+            /* Candidates of a cluster are in ascending order. */
+            vResults.resize(vTests.size());
+            FermatTestBatch(vTests.data(), vResults.data(), vTests.size());
+            for(size_t i = 0; i < vCandidates.size(); ++i)
+            {
+                if(vResults[i] == 1)
+                    vClusters[vCandidates[i].first].vPrimes.push_back(vCandidates[i].second);
+            }
+
+            vActive.erase(std::remove_if(vActive.begin(), vActive.end(),
+                [&vClusters](const size_t nCluster) { return vClusters[nCluster].Last() + 12 <= vClusters[nCluster].nTested; }),
+                vActive.end());
+        }
+
+        /* Remainders of the composites after the clusters. */
+        vTests.clear();
+        vCandidates.clear();
+        for(size_t i = 0; i < vClusters.size(); ++i)
+        {
+            if(vClusters[i].fPrime)
+            {
+                vTests.push_back(vClusters[i].hashPrime + (vClusters[i].Last() + 14));
+                vCandidates.emplace_back(i, 0);
+            }
+        }
+
+        vResults.resize(vTests.size());
+        FermatTestBatch(vTests.data(), vResults.data(), vTests.size());
+        for(size_t i = 0; i < vCandidates.size(); ++i)
+            vClusters[vCandidates[i].first].hashRemainder = vResults[i];
+    }
 
-        /* Keep track of the cluster size. */
-        uint32_t nClusterSize = 1;
 
+    /* Determines the difficulty of the Given Prime Number. */
+    double GetPrimeDifficulty(const uint1024_t& hashPrime, const std::vector<uint8_t>& vOffsets, const bool fVerify)
+    {
         /* Check for optimized tritium version. */
-        uint1024_t hashNext = hashPrime;
         if(!vOffsets.empty())
         {
-            /* Loop through offsets pattern. */
+            /* Offsets pattern followed by the 4 byte fractional difficulty. */
             uint32_t nSize = vOffsets.size();
+            if(nSize < 4)
+                return 0.0;
+
+            /* Set the offset positions. */
+            std::vector<uint32_t> vPositions(1, 0);
             for(uint32_t n = 0; n < nSize - 4; ++n)
             {
                 /* Get the offset. */
                 uint8_t nOffset = vOffsets[n];
 
-                /* Check for valid offsets. */
-                if(nOffset > 12)
+                /* Check for valid offsets. Zero would count a prime twice, odd offsets are even numbers. */
+                if(nOffset > 12 || nOffset == 0 || (nOffset & 1))
                     return 0.0;
 
                 /* Set the next offset position. */
-                hashNext += nOffset;
-
-                /* Check prime at offset. */
-                if(!fVerify || PrimeCheck(hashNext))
-                    ++nClusterSize;
-
+                vPositions.push_back(vPositions.back() + nOffset);
             }
 
             /* Get fractional difficulty. */
             uint32_t nFraction = 0;
-            std::copy((uint8_t*)&vOffsets[nSize - 4], (uint8_t*)&vOffsets[nSize - 1], (uint8_t*)&nFraction);
+            std::copy((uint8_t*)&vOffsets[nSize - 4], (uint8_t*)&vOffsets[nSize - 4] + 4, (uint8_t*)&nFraction);
 
-            /* If verifying check the fractional difficulty. */
-            if(fVerify && GetFractionalDifficulty(hashNext + 14) != nFraction)
-                return 0.0;
+            /* Keep track of the cluster size. */
+            uint32_t nClusterSize = nSize - 3;
+            if(!fVerify)
+                return ClusterDifficulty(nClusterSize, nFraction);
 
-            /* Calculate the rarity of cluster from proportion of fermat remainder of last prime + 2. */
-            /*cv::softdouble nRemainder = cv::softdouble(1000000.0) / cv::softdouble(nFraction);
-            if(nRemainder > cv::softdouble(1.0) || nRemainder < cv::softdouble(0.0))
-                nRemainder = cv::softdouble(0.0);*/
-            double nRemainder = 0.0;
-            if (nFraction != 0)
-                nRemainder = 1000000.0 / nFraction;
-            if (nRemainder > 1.0 || nRemainder < 0.0)
-                nRemainder = 0.0;
-
-            return double(nClusterSize + nRemainder);
-        }
-        else
-        {
-            /* Set temporary variables for the checks. */
-            uint1024_t hashLast = hashPrime;
+            /* Every claimed prime has to pass the sieve before any fermat test. */
+            const std::bitset<SIEVE_RANGE> vSieve = SmallPrimeSieve(hashPrime);
 
-            /* Largest prime gap is +12 for dense clusters. */
-            for(hashNext = hashPrime + 2; hashNext <= hashLast + 12; hashNext += 2)
+            std::vector<uint1024_t> vTests;
+            for(const uint32_t nPosition : vPositions)
             {
-                /* Check if this interval is prime. */
-                if(PrimeCheck(hashNext))
+                uint1024_t hashNext = hashPrime + nPosition;
+                if(nPosition < SIEVE_RANGE ? vSieve[nPosition] : !SmallDivisors(hashNext))
+                    return 0.0;
+
+                vTests.push_back(hashNext);
+            }
+
+            /* The composite after the cluster gives the fractional difficulty. */
+            vTests.push_back(vTests.back() + 14);
+
+            /* Fermat test base and offsets in batches of the kernel lanes (one by one without SIMD).
+             * A composite at a claimed position rejects the share, the remaining batches are skipped. */
+            const size_t nLanes = LLC::FermatLanes(LLC::FermatBestKernel());
+            const size_t nPrimes = vTests.size() - 1;
+
+            std::vector<uint1024_t> vResults(vTests.size());
+            for(size_t nIndex = 0; nIndex < vTests.size(); nIndex += nLanes)
+            {
+                size_t nBatch = std::min(nLanes, vTests.size() - nIndex);
+                FermatTestBatch(&vTests[nIndex], &vResults[nIndex], nBatch);
+
+                for(size_t i = nIndex; i < nIndex + nBatch && i < nPrimes; ++i)
                 {
-                    hashLast = hashNext;
-                    ++nClusterSize;
+                    if(vResults[i] != 1)
+                        return 0.0;
                 }
             }
 
-            /* Calculate the rarity of cluster from proportion of fermat remainder of last prime + 2. */
-           /* cv::softdouble nRemainder = cv::softdouble(1000000.0) / cv::softdouble(GetFractionalDifficulty(hashNext));
-            if(nRemainder > cv::softdouble(1.0) || nRemainder < cv::softdouble(0.0))
-                nRemainder = cv::softdouble(0.0);*/
+            /* Check the fractional difficulty. */
+            if(FractionalDifficulty(vTests.back(), vResults.back()) != nFraction)
+                return 0.0;
+
+            return ClusterDifficulty(nClusterSize, nFraction);
+        }
+        else
+        {
+            std::vector<Cluster> vClusters(1);
+            vClusters[0].hashPrime = hashPrime;
+            WalkClusters(vClusters, fVerify);
 
-            double nRemainder = 0.0;
-            uint32_t fractional_difficulty = GetFractionalDifficulty(hashNext);
-            if (fractional_difficulty != 0)
-                nRemainder = 1000000.0 / fractional_difficulty;
-            if (nRemainder > 1.0 || nRemainder < 0.0)
-                nRemainder = 0.0;
+            /* Return 0 if base is not prime. */
+            const Cluster& cluster = vClusters[0];
+            if(!cluster.fPrime)
+                return 0.0;
 
-            return double(nClusterSize + nRemainder);
+            return ClusterDifficulty(static_cast<uint32_t>(1 + cluster.vPrimes.size()),
+                FractionalDifficulty(hashPrime + (cluster.Last() + 14), cluster.hashRemainder));
         }
 
         return 0.0;
     }
 
 
+    /* Determines the difficulty of several primes at once. */
+    void GetPrimeDifficulties(const uint1024_t* pPrimes, double* pDifficulties, size_t nCount)
+    {
+        std::vector<Cluster> vClusters(nCount);
+        for(size_t i = 0; i < nCount; ++i)
+            vClusters[i].hashPrime = pPrimes[i];
+
+        WalkClusters(vClusters, true);
+
+        for(size_t i = 0; i < nCount; ++i)
+        {
+            const Cluster& cluster = vClusters[i];
+            if(!cluster.fPrime)
+                pDifficulties[i] = 0.0;
+            else
+                pDifficulties[i] = ClusterDifficulty(static_cast<uint32_t>(1 + cluster.vPrimes.size()),
+                    FractionalDifficulty(cluster.hashPrime + (cluster.Last() + 14), cluster.hashRemainder));
+        }
+    }
+
+
     /* Return list of offsets for use in optimized prime proof of work calculations. */
     void GetOffsets(const uint1024_t& hashPrime, std::vector<uint8_t> &vOffsets)
     {
+        std::vector<Cluster> vClusters(1);
+        vClusters[0].hashPrime = hashPrime;
+        WalkClusters(vClusters, true);
+
         /* Check first prime. */
-        if(!PrimeCheck(hashPrime))
+        const Cluster& cluster = vClusters[0];
+        if(!cluster.fPrime)
             return;
 
         /* Erase offsets if any */
         vOffsets.clear();
-        uint8_t nOffset = 2;
 
-        /* Set temporary variables for the checks. */
-        uint1024_t hashLast = hashPrime;
-        for(uint1024_t hashNext = hashPrime + 2; nOffset <= 12; hashNext += 2, nOffset += 2)
+        /* Add the distance of every prime to the one before to the vector. */
+        uint32_t nLast = 0;
+        for(const uint32_t nPrime : cluster.vPrimes)
         {
-            /* Check if this interval is prime. */
-            if(PrimeCheck(hashNext))
-            {
-                hashLast = hashNext;
-
-                /* Add offset to vector. */
-                vOffsets.push_back(nOffset);
-                nOffset = 0;
-            }
+            vOffsets.push_back(static_cast<uint8_t>(nPrime - nLast));
+            nLast = nPrime;
         }
 
         /* Get fractional difficulty. */
-        uint32_t nFraction = GetFractionalDifficulty(hashLast + nOffset);
+        uint32_t nFraction = FractionalDifficulty(hashPrime + (nLast + 14), cluster.hashRemainder);
         vOffsets.insert(vOffsets.end(), (uint8_t*)&nFraction, (uint8_t*)&nFraction + 4);
     }
 
@@ -174,10 +449,7 @@ namespace Ledger
         //LLC::CBigNum a(nComposite);
         //LLC::CBigNum b(FermatTest(nComposite));
 
-        uint1056_t a(hashComposite);
-        uint1056_t b(FermatTest(hashComposite));
-
-        return ((a - b << 24) / a).getuint32();
+        return FractionalDifficulty(hashComposite, FermatTest(hashComposite));
 	}
 
 
@@ -198,6 +470,41 @@ namespace Ledger
 
     /* Used after Miller-Rabin and Divisor tests to verify primality. */
     uint1024_t FermatTest(const uint1024_t& hashTest)
+    {
+        /* Montgomery needs an odd modulus. */
+        if(!(hashTest.Get64(0) & 1) || hashTest == 1)
+            return FermatTestBigNum(hashTest);
+
+        return LLC::fermat_prime(hashTest);
+    }
+
+
+    /* FermatTest of several numbers. */
+    void FermatTestBatch(const uint1024_t* pTests, uint1024_t* pResults, size_t nCount)
+    {
+        /* The lanes need an odd modulus as well, the others go through FermatTest. */
+        std::vector<uint1024_t> vOdd;
+        std::vector<size_t> vIndex;
+        for(size_t i = 0; i < nCount; ++i)
+        {
+            if(!(pTests[i].Get64(0) & 1) || pTests[i] == 1)
+                pResults[i] = FermatTestBigNum(pTests[i]);
+            else
+            {
+                vOdd.push_back(pTests[i]);
+                vIndex.push_back(i);
+            }
+        }
+
+        std::vector<uint1024_t> vResults(vOdd.size());
+        LLC::FermatMulti(vOdd.data(), vResults.data(), vOdd.size());
+        for(size_t i = 0; i < vIndex.size(); ++i)
+            pResults[vIndex[i]] = vResults[i];
+    }
+
+
+    /* FermatTest using OpenSSL BN_mod_exp. */
+    uint1024_t FermatTestBigNum(const uint1024_t& hashTest)
     {
         LLC::CAutoBN_CTX pctx;
 
@@ -225,40 +532,48 @@ namespace Ledger
      *  eleven primes. */
     bool SmallDivisors(const uint1024_t& hashTest)
     {
-        if(hashTest % nSmallPrimes[0] == 0)
-            return false;
+        const SievePrimes& primes = GetSievePrimes();
 
-        if(hashTest % nSmallPrimes[1] == 0)
-            return false;
-
-        if(hashTest % nSmallPrimes[2] == 0)
-            return false;
+        uint32_t pWords[32];
+        std::memcpy(pWords, hashTest.begin(), sizeof(pWords));
 
-        if(hashTest % nSmallPrimes[3] == 0)
-            return false;
-
-        if(hashTest % nSmallPrimes[4] == 0)
-            return false;
-
-        if(hashTest % nSmallPrimes[5] == 0)
-            return false;
+        for(uint32_t i = 0; primes.vFirst[i] < nSmallDivisors; ++i)
+        {
+            uint32_t nRemainder = primes.Reduce(pWords, i);
+            for(uint32_t n = primes.vFirst[i]; n < primes.vFirst[i + 1] && n < nSmallDivisors; ++n)
+            {
+                if(nRemainder % primes.vPrimes[n] == 0)
+                    return false;
+            }
+        }
 
-        if(hashTest % nSmallPrimes[6] == 0)
-            return false;
+        return true;
+    }
 
-        if(hashTest % nSmallPrimes[7] == 0)
-            return false;
 
-        if(hashTest % nSmallPrimes[8] == 0)
-            return false;
+    /* Sieves the offsets from a number with the first SIEVE_PRIMES primes. */
+    std::bitset<SIEVE_RANGE> SmallPrimeSieve(const uint1024_t& hashBase)
+    {
+        const SievePrimes& primes = GetSievePrimes();
 
-        if(hashTest % nSmallPrimes[9] == 0)
-            return false;
+        uint32_t pWords[32];
+        std::memcpy(pWords, hashBase.begin(), sizeof(pWords));
 
-        if(hashTest % nSmallPrimes[10] == 0)
-            return false;
+        std::bitset<SIEVE_RANGE> vSieve;
+        for(uint32_t i = 0; i < primes.vProducts.size(); ++i)
+        {
+            uint32_t nRemainder = primes.Reduce(pWords, i);
+            for(uint32_t n = primes.vFirst[i]; n < primes.vFirst[i + 1]; ++n)
+            {
+                /* first offset n with hashBase + n divisible by the prime, then every multiple */
+                uint32_t nPrime = primes.vPrimes[n];
+                uint32_t nMod = nRemainder % nPrime;
+                for(uint32_t nOffset = (nMod == 0 ? 0 : nPrime - nMod); nOffset < SIEVE_RANGE; nOffset += nPrime)
+                    vSieve.set(nOffset);
+            }
+        }
 
-        return true;
+        return vSieve;
     }
 }
 }
@@ -2,7 +2,7 @@
 #define NEXUSPOOL_API_CREATE_COMPONENT_HPP
 
 #include "api/component.hpp"
-#include "persistance/data_reader.hpp"
+#include "persistance/data_reader_factory.hpp"
 #include "common/pool_api_data_exchange.hpp"
 #include "config/config_api.hpp"
 #include "chrono/timer_factory.hpp"
@@ -16,7 +16,7 @@ namespace api
 {
 
 Component::Uptr create_component(std::shared_ptr<spdlog::logger> logger,
-    persistance::Data_reader::Uptr data_reader,
+    persistance::Data_reader_factory::Sptr data_reader_factory,
     config::Config_api::Sptr config_api,
     common::Pool_api_data_exchange::Sptr pool_api_data_exchange,
     chrono::Timer_factory::Sptr timer_factory);
@@ -21,17 +21,23 @@ namespace api
 {
 
 Component_impl::Component_impl(std::shared_ptr<spdlog::logger> logger,
-	persistance::Data_reader::Uptr data_reader,
+	persistance::Data_reader_factory::Sptr data_reader_factory,
 	config::Config_api::Sptr config_api,
 	common::Pool_api_data_exchange::Sptr pool_api_data_exchange,
 	chrono::Timer_factory::Sptr timer_factory)
 	: m_logger{ std::move(logger) }
-	, m_shared_data_reader{ std::make_shared<Shared_data_reader>(std::move(data_reader)) }
 	, m_config_api{ std::move(config_api) }
 	, m_pool_api_data_exchange{ std::move(pool_api_data_exchange) }
 	, m_timer_factory{ std::move(timer_factory) }
 	, m_server_stopped{ false }
 {
+	// every data_reader opens its own read only db connection
+	std::vector<persistance::Data_reader::Uptr> data_readers;
+	for (std::uint16_t i = 0; i < m_config_api->get_db_reader_count(); ++i)
+	{
+		data_readers.push_back(data_reader_factory->create_data_reader());
+	}
+	m_shared_data_reader = std::make_shared<Shared_data_reader>(std::move(data_readers));
 }
 
 void Component_impl::start()
@@ -2,7 +2,7 @@
 #define NEXUSPOOL_API_COMPONENT_IMPL_HPP
 
 #include "api/component.hpp"
-#include "persistance/data_reader.hpp"
+#include "persistance/data_reader_factory.hpp"
 #include "common/pool_api_data_exchange.hpp"
 #include "config/config_api.hpp"
 #include "chrono/timer_factory.hpp"
@@ -26,7 +26,7 @@ class Component_impl : public Component
 public:
 
     Component_impl(std::shared_ptr<spdlog::logger> logger,
-        persistance::Data_reader::Uptr data_reader,
+        persistance::Data_reader_factory::Sptr data_reader_factory,
         config::Config_api::Sptr config_api,
         common::Pool_api_data_exchange::Sptr pool_api_data_exchange,
         chrono::Timer_factory::Sptr timer_factory);
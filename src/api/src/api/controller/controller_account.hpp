@@ -48,10 +48,12 @@ public:
             return createResponse(Status::CODE_400, "invalid account");
         }
 
-        if (m_data_reader->does_account_exists(account))
+        // one data_reader for all reads of the request
+        auto data_reader = m_data_reader->checkout();
+        if (data_reader->does_account_exists(account))
         {
             auto dto = Account_dto::createShared();
-            auto const account_data = m_data_reader->get_account(account);
+            auto const account_data = data_reader->get_account(account);
 
             dto->account = account_data.m_address;
             dto->created_at = account_data.m_created_at;
@@ -79,12 +81,13 @@ public:
             return createResponse(Status::CODE_400, "invalid account");
         }
 
-        if (m_data_reader->does_account_exists(account))
+        auto data_reader = m_data_reader->checkout();
+        if (data_reader->does_account_exists(account))
         {
             auto dto = Account_payouts_dto::createShared();
-            auto const account_data = m_data_reader->get_account(account);
+            auto const account_data = data_reader->get_account(account);
 
-            auto const payments = m_data_reader->get_payments(account);
+            auto const payments = data_reader->get_payments(account);
             for (auto const& payment : payments)
             {
                 dto->payouts->push_back(Payout_dto::createShared(payment.m_payment_date_time.c_str(), payment.m_amount, payment.m_shares, payment.m_tx_id.c_str(), payment.m_round));
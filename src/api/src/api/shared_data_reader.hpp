@@ -6,74 +6,120 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <condition_variable>
 
 namespace spdlog { class logger; }
 namespace nexuspool
 {
 namespace api
 {
+// Pool of data_readers shared by the API request threads.
+// Every data_reader has its own read only db connection with its own prepared commands, the db in WAL mode serves
+// them concurrently. A request thread waits only if all data_readers are in use
 class Shared_data_reader
 {
 public:
 
     using Sptr = std::shared_ptr<Shared_data_reader>;
 
-    Shared_data_reader(persistance::Data_reader::Uptr data_reader)
-        : m_data_reader{std::move(data_reader)}
+    // data_reader checked out of the pool. Returns it to the pool at the end of the scope
+    class Reader
+    {
+    public:
+
+        Reader(Shared_data_reader& pool, persistance::Data_reader::Uptr data_reader)
+            : m_pool{ pool }
+            , m_data_reader{ std::move(data_reader) }
+        {}
+
+        Reader(Reader&&) = default;
+        Reader(Reader const&) = delete;
+        Reader& operator=(Reader const&) = delete;
+
+        ~Reader()
+        {
+            if (m_data_reader)
+            {
+                m_pool.checkin(std::move(m_data_reader));
+            }
+        }
+
+        persistance::Data_reader* operator->() const { return m_data_reader.get(); }
+
+    private:
+
+        Shared_data_reader& m_pool;
+        persistance::Data_reader::Uptr m_data_reader;
+    };
+
+    explicit Shared_data_reader(std::vector<persistance::Data_reader::Uptr> data_readers)
+        : m_data_readers{ std::move(data_readers) }
     {}
 
+    // for requests with several reads. The single reads below check out a data_reader per call
+    Reader checkout()
+    {
+        std::unique_lock lock(m_readers_mutex);
+        m_reader_available.wait(lock, [this] { return !m_data_readers.empty(); });
+        auto data_reader = std::move(m_data_readers.back());
+        m_data_readers.pop_back();
+        return Reader{ *this, std::move(data_reader) };
+    }
+
     bool does_account_exists(std::string account)
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->does_account_exists(std::move(account));
+        return checkout()->does_account_exists(std::move(account));
     }
 
     std::vector<persistance::Block_data> get_latest_blocks()
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_latest_blocks();
+        return checkout()->get_latest_blocks();
     }
 
     persistance::Account_data get_account(std::string account)
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_account(std::move(account));
+        return checkout()->get_account(std::move(account));
     }
 
     persistance::Config_data get_config()
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_config();
+        return checkout()->get_config();
     }
 
     std::vector<persistance::Payment_data> get_payments(std::string account)
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_payments(std::move(account));
+        return checkout()->get_payments(std::move(account));
     }
 
     double get_pool_hashrate()
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_pool_hashrate();
+        return checkout()->get_pool_hashrate();
     }
 
     persistance::Statistics_block_finder get_longest_chain_finder()
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_longest_chain_finder();
+        return checkout()->get_longest_chain_finder();
     }
 
     std::vector<persistance::Statistics_top_block_finder> get_top_block_finders(std::uint16_t num_finders)
     {
-        std::scoped_lock lock(m_db_mutex);
-        return m_data_reader->get_top_block_finders(num_finders);
+        return checkout()->get_top_block_finders(num_finders);
     }
 
 private:
 
-    persistance::Data_reader::Uptr m_data_reader;
-    std::mutex m_db_mutex;
+    void checkin(persistance::Data_reader::Uptr data_reader)
+    {
+        {
+            std::scoped_lock lock(m_readers_mutex);
+            m_data_readers.push_back(std::move(data_reader));
+        }
+        m_reader_available.notify_one();
+    }
+
+    std::vector<persistance::Data_reader::Uptr> m_data_readers;     // data_readers not checked out
+    std::mutex m_readers_mutex;
+    std::condition_variable m_reader_available;
 
 };
 
@@ -0,0 +1,123 @@
+#ifndef NEXUSPOOL_COMMON_BOUNDED_QUEUE_HPP
+#define NEXUSPOOL_COMMON_BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace nexuspool {
+namespace common {
+
+// Multi producer / multi consumer queue with a fixed capacity.
+// Producers either don't block (try_push) or wait for free space (push), consumers block in pop() until an element
+// is available or the queue is closed.
+template<typename T>
+class Bounded_queue
+{
+public:
+
+	explicit Bounded_queue(std::size_t capacity)
+		: m_capacity{ capacity }
+		, m_closed{ false }
+	{
+	}
+
+	// returns false if the queue is full or closed
+	bool try_push(T&& element)
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			if (m_closed || m_queue.size() >= m_capacity)
+			{
+				return false;
+			}
+			m_queue.push_back(std::move(element));
+		}
+		m_condition.notify_one();
+		return true;
+	}
+
+	// waits while the queue is full (backpressure). returns false if the queue is closed
+	bool push(T&& element)
+	{
+		{
+			std::unique_lock lock(m_mutex);
+			m_not_full.wait(lock, [this] { return m_closed || m_queue.size() < m_capacity; });
+			if (m_closed)
+			{
+				return false;
+			}
+			m_queue.push_back(std::move(element));
+		}
+		m_condition.notify_one();
+		return true;
+	}
+
+	// returns false if the queue has been closed and all elements are consumed
+	bool pop(T& element)
+	{
+		std::unique_lock lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_closed || !m_queue.empty(); });
+		if (m_queue.empty())
+		{
+			return false;
+		}
+		element = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+		m_not_full.notify_one();
+		return true;
+	}
+
+	// takes up to max_elements at once (batch processing). Blocks like pop() until at least one element is available.
+	// returns the number of elements, 0 if the queue has been closed and all elements are consumed
+	std::size_t pop(std::vector<T>& elements, std::size_t max_elements)
+	{
+		elements.clear();
+		std::unique_lock lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_closed || !m_queue.empty(); });
+		while (!m_queue.empty() && elements.size() < max_elements)
+		{
+			elements.push_back(std::move(m_queue.front()));
+			m_queue.pop_front();
+		}
+		lock.unlock();
+		m_not_full.notify_all();
+		return elements.size();
+	}
+
+	// wakes up all consumers and waiting producers, no new elements are accepted
+	void close()
+	{
+		{
+			std::scoped_lock lock(m_mutex);
+			m_closed = true;
+		}
+		m_condition.notify_all();
+		m_not_full.notify_all();
+	}
+
+	std::size_t size() const
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_queue.size();
+	}
+
+	std::size_t capacity() const { return m_capacity; }
+
+private:
+
+	std::size_t const m_capacity;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::condition_variable m_not_full;
+	std::deque<T> m_queue;
+	bool m_closed;
+};
+
+}
+}
+
+#endif
@@ -39,6 +39,10 @@ public:
 	virtual std::uint16_t get_hashrate_interval() const = 0;
 	virtual bool get_miner_notifications() const = 0;
 	virtual bool get_legacy_mode() const = 0;
+	virtual std::uint16_t get_io_threads() const = 0;
+	virtual std::uint16_t get_validation_threads() const = 0;
+	virtual std::uint16_t get_share_flush_interval() const = 0;
+	virtual std::uint16_t get_vardiff_shares_per_minute() const = 0;
 };
 
 Config::Sptr create_config();
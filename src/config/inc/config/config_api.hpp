@@ -27,6 +27,7 @@ public:
 	virtual std::string get_auth_pw() const = 0;
 	virtual common::Mining_mode get_mining_mode() const = 0;
 	virtual std::uint16_t get_reward_calc_update_interval() const = 0;
+	virtual std::uint16_t get_db_reader_count() const = 0;
 	virtual std::vector<Hardware_config>& get_devices() = 0;
 	virtual std::string get_nxs_api_user() const = 0;
 	virtual std::string get_nxs_api_pw() const = 0;
@@ -20,6 +20,7 @@ struct Persistance_config
 {
 	Persistance_type m_type{ Persistance_type::database};
 	std::string m_file{};
+	std::uint32_t m_write_queue_size{ 10000U };		// max queued writes before the writing threads have to wait
 };
 
 struct Pool_config
@@ -1,5 +1,6 @@
 #include "config/config_api_impl.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -14,6 +15,7 @@ Config_api_impl::Config_api_impl()
 	, m_public_ip{ "127.0.0.1" }
 	, m_wallet_ip{ "127.0.0.1" }
 	, m_reward_calc_update_interval{ 300 }
+	, m_db_reader_count{ 4 }
 	, m_auth_user{}
 	, m_auth_pw{}
 	, m_mining_mode{ common::Mining_mode::HASH }
@@ -63,6 +65,11 @@ bool Config_api_impl::read_config(std::string const& api_config_file)
 		{
 			m_reward_calc_update_interval = j["reward_calc_update_interval"];
 		}
+		if (j.contains("db_readers"))
+		{
+			// at least one reader, otherwise the API can't read from the db
+			m_db_reader_count = std::max<std::uint16_t>(j["db_readers"].get<std::uint16_t>(), 1);
+		}
 
 		for (auto& devices_json : j["devices"])
 		{
@@ -25,6 +25,7 @@ public:
 	std::string get_auth_pw() const override { return m_auth_pw; }
 	common::Mining_mode get_mining_mode() const override { return m_mining_mode; }
 	std::uint16_t get_reward_calc_update_interval() const override { return m_reward_calc_update_interval; }
+	std::uint16_t get_db_reader_count() const override { return m_db_reader_count; }
 	std::vector<Hardware_config>& get_devices() override { return m_devices; }
 	std::string get_nxs_api_user() const override { return m_nxs_api_user; }
 	std::string get_nxs_api_pw() const override { return m_nxs_api_pw; }
@@ -37,6 +38,7 @@ private:
 	std::string m_public_ip;
 	std::string m_wallet_ip;
 	std::uint16_t m_reward_calc_update_interval;
+	std::uint16_t m_db_reader_count;
 	std::string m_auth_user;
 	std::string m_auth_pw;
 	common::Mining_mode	m_mining_mode;
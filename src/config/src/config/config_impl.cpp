@@ -29,6 +29,10 @@ namespace config
 		, m_hashrate_interval{300}
 		, m_miner_notifications{true}
 		, m_legacy_mode{false}
+		, m_io_threads{0}	// 0 = number of hardware threads
+		, m_validation_threads{0}	// 0 = number of hardware threads
+		, m_share_flush_interval{10}
+		, m_vardiff_shares_per_minute{0}	// 0 = vardiff disabled
 	{
 	}
 
@@ -112,6 +116,11 @@ namespace config
 				m_persistance_config.m_type = Persistance_type::sqlite;
 			}
 
+			if (j.at("persistance").count("write_queue_size") != 0)
+			{
+				j.at("persistance").at("write_queue_size").get_to(m_persistance_config.m_write_queue_size);
+			}
+
 			// advanced configs
 			if (j.count("connection_retry_interval") != 0)
 			{
@@ -141,6 +150,22 @@ namespace config
 			{
 				j.at("legacy_mode").get_to(m_legacy_mode);
 			}
+			if (j.count("io_threads") != 0)
+			{
+				j.at("io_threads").get_to(m_io_threads);
+			}
+			if (j.count("validation_threads") != 0)
+			{
+				j.at("validation_threads").get_to(m_validation_threads);
+			}
+			if (j.count("share_flush_interval") != 0)
+			{
+				j.at("share_flush_interval").get_to(m_share_flush_interval);
+			}
+			if (j.count("vardiff_shares_per_minute") != 0)
+			{
+				j.at("vardiff_shares_per_minute").get_to(m_vardiff_shares_per_minute);
+			}
 
 			if (j.count("logfile") != 0)
 			{
@@ -37,6 +37,10 @@ public:
 	std::uint16_t get_hashrate_interval() const override { return m_hashrate_interval; }
 	bool get_miner_notifications() const override { return m_miner_notifications; }
 	bool get_legacy_mode() const override { return m_legacy_mode; }
+	std::uint16_t get_io_threads() const override { return m_io_threads; }
+	std::uint16_t get_validation_threads() const override { return m_validation_threads; }
+	std::uint16_t get_share_flush_interval() const override { return m_share_flush_interval; }
+	std::uint16_t get_vardiff_shares_per_minute() const override { return m_vardiff_shares_per_minute; }
 
 private:
 
@@ -61,6 +65,10 @@ private:
 	std::uint16_t m_hashrate_interval;
 	bool m_miner_notifications;
 	bool m_legacy_mode;
+	std::uint16_t m_io_threads;
+	std::uint16_t m_validation_threads;
+	std::uint16_t m_share_flush_interval;
+	std::uint16_t m_vardiff_shares_per_minute;
 
 };
 
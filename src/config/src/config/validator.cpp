@@ -132,6 +132,13 @@ bool Validator::check(std::string const& config_file)
         {
             m_mandatory_fields.push_back(Validator_error{ "persistance/file", "" });
         }
+        if (j.count("persistance") != 0 && j.at("persistance").count("write_queue_size") != 0)
+        {
+            if (!j.at("persistance").at("write_queue_size").is_number_unsigned() || j.at("persistance").at("write_queue_size") == 0)
+            {
+                m_optional_fields.push_back(Validator_error{ "persistance/write_queue_size", "Must be a number > 0" });
+            }
+        }
 
         //advanced config
 		if (j.count("connection_retry_interval") != 0)
@@ -169,6 +176,34 @@ bool Validator::check(std::string const& config_file)
                 m_optional_fields.push_back(Validator_error{ "get_hashrate_interval", "Not a number" });
             }
         }
+        if (j.count("io_threads") != 0)
+        {
+            if (!j.at("io_threads").is_number())
+            {
+                m_optional_fields.push_back(Validator_error{ "io_threads", "Not a number" });
+            }
+        }
+        if (j.count("validation_threads") != 0)
+        {
+            if (!j.at("validation_threads").is_number())
+            {
+                m_optional_fields.push_back(Validator_error{ "validation_threads", "Not a number" });
+            }
+        }
+        if (j.count("share_flush_interval") != 0)
+        {
+            if (!j.at("share_flush_interval").is_number())
+            {
+                m_optional_fields.push_back(Validator_error{ "share_flush_interval", "Not a number" });
+            }
+        }
+        if (j.count("vardiff_shares_per_minute") != 0)
+        {
+            if (!j.at("vardiff_shares_per_minute").is_number())
+            {
+                m_optional_fields.push_back(Validator_error{ "vardiff_shares_per_minute", "Not a number" });
+            }
+        }
 
         if (j.count("log_level") != 0)
         {
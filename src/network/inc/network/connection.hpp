@@ -37,8 +37,16 @@ public:
     //  If the connection is in state connected, transmit() asynchronously initiates a transmission of the payload over this connection.
     virtual void transmit(Shared_payload tx_buffer) = 0;
 
+    //  Transmit several payloads as one message (e.g. header and body) without concatenating them.
+    //  All payloads queued on the connection are written with a single gathered write.
+    virtual void transmit(Payload_sequence tx_buffers) = 0;
+
     // Closes the connection
     virtual void close() = 0;
+
+    //  Runs the handler asynchronously on the strand of the connection, serialised with the connection handler.
+    //  Lets work finished on other threads continue without synchronising with the connection handler.
+    virtual void post(std::function<void()> handler) = 0;
 };
 
 
@@ -84,6 +84,7 @@ inline std::string code_to_string(Code code)
 
 using Payload = std::vector<std::uint8_t>;
 using Shared_payload = std::shared_ptr<Payload>;
+using Payload_sequence = std::vector<Shared_payload>;
 
 enum class Transport_protocol { tcp = 0, udp = 1, none = 3 };
 
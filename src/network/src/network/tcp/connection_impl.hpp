@@ -3,9 +3,15 @@
 
 #include "asio/io_service.hpp"
 #include "asio/write.hpp"
+#include "asio/strand.hpp"
+#include "asio/bind_executor.hpp"
+#include "asio/post.hpp"
+#include "asio/dispatch.hpp"
 #include "network/connection.hpp"
 #include "network/tcp/protocol_description.hpp"
-#include <queue>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 #include <memory>
 
 namespace nexuspool {
@@ -39,7 +45,9 @@ public:
     Endpoint const& remote_endpoint() const override { return m_remote_endpoint; }
     Endpoint const& local_endpoint() const override { return m_local_endpoint; }
     void transmit(Shared_payload tx_buffer) override;
+    void transmit(Payload_sequence tx_buffers) override;
     void close() override;
+    void post(std::function<void()> handler) override;
 
     // interface towards socket
     Result::Code connect();
@@ -54,10 +62,15 @@ private:
     void close_internal(Result::Code code);
 
     std::shared_ptr<::asio::io_context> m_io_context;
+    // serialises all handlers of this connection, the io_context may be run by multiple threads
+    ::asio::strand<::asio::io_context::executor_type> m_strand;
     std::shared_ptr<Protocol_socket> m_asio_socket;
     Endpoint m_remote_endpoint;
     Endpoint m_local_endpoint;
-    std::queue<Shared_payload> m_tx_queue;
+    // payloads queued while a write is in progress
+    Payload_sequence m_tx_queue;
+    bool m_tx_active;
+    Shared_payload m_receive_buffer;
     Connection::Handler m_connection_handler;
 };
 
@@ -67,10 +80,13 @@ inline Connection_impl<ProtocolDescriptionType>::Connection_impl(
     std::shared_ptr<::asio::io_context> io_context, Endpoint remote_endpoint,
     Endpoint local_endpoint, Connection::Handler handler)
     : m_io_context{std::move(io_context)}
+    , m_strand{::asio::make_strand(*m_io_context)}
     , m_asio_socket{std::make_shared<Protocol_socket>(*m_io_context)}
     , m_remote_endpoint{std::move(remote_endpoint)}
     , m_local_endpoint{std::move(local_endpoint)}
     , m_tx_queue{}
+    , m_tx_active{false}
+    , m_receive_buffer{}
     , m_connection_handler{std::move(handler)}
 {
 }
@@ -80,10 +96,13 @@ inline Connection_impl<ProtocolDescriptionType>::Connection_impl(
     std::shared_ptr<::asio::io_context> io_context,
     std::shared_ptr<Protocol_socket> asio_socket, Endpoint remote_endpoint)
     : m_io_context{std::move(io_context)}
+    , m_strand{::asio::make_strand(*m_io_context)}
     , m_asio_socket{std::move(asio_socket)}
     , m_remote_endpoint{std::move(remote_endpoint)}
     , m_local_endpoint{}     // will be set later, this constructor is called in accept/listen case
     , m_tx_queue{}
+    , m_tx_active{false}
+    , m_receive_buffer{}
 	, m_connection_handler{} // will be set later, this constructor is called in accept/listen case
 {
 }
@@ -129,7 +148,7 @@ inline Result::Code Connection_impl<ProtocolDescriptionType>::connect()
 
     std::weak_ptr<Connection_impl<ProtocolDescriptionType>> weak_self = this->shared_from_this();
     this->m_asio_socket->async_connect(get_endpoint_base<Protocol_endpoint>(m_remote_endpoint),
-                                       [weak_self](::asio::error_code const& error)
+                                       ::asio::bind_executor(m_strand, [weak_self](::asio::error_code const& error)
 	{
 		auto self = weak_self.lock();
 		if (self && self->m_connection_handler)
@@ -143,7 +162,7 @@ inline Result::Code Connection_impl<ProtocolDescriptionType>::connect()
                 self->change(Result::Code::connection_declined);
             }
 		}
-	});
+	}));
 
     return Result::ok;
 }
@@ -151,7 +170,7 @@ inline Result::Code Connection_impl<ProtocolDescriptionType>::connect()
 template<typename ProtocolDescriptionType>
 inline void Connection_impl<ProtocolDescriptionType>::receive()
 {
-    m_asio_socket->async_receive(asio::null_buffers(), [weak_self = get_weak_self()](auto error, auto) 
+    m_asio_socket->async_receive(asio::null_buffers(), ::asio::bind_executor(m_strand, [weak_self = get_weak_self()](auto error, auto) 
 	{
         auto self = weak_self.lock();
         if (self && self->m_connection_handler) 
@@ -167,12 +186,17 @@ inline void Connection_impl<ProtocolDescriptionType>::receive()
                     return;
                 }
 
-                Shared_payload receive_buffer = std::make_shared<std::vector<std::uint8_t>>(length);
-                receive_buffer->resize(length);
+                // reuse the receive buffer if the handler didn't keep it
+                if (!self->m_receive_buffer || self->m_receive_buffer.use_count() > 1)
+                {
+                    self->m_receive_buffer = std::make_shared<std::vector<std::uint8_t>>();
+                }
+                self->m_receive_buffer->resize(length);
 
-                self->m_asio_socket->receive(asio::buffer(*receive_buffer, receive_buffer->size()), 0, error);
+                self->m_asio_socket->receive(asio::buffer(*self->m_receive_buffer, self->m_receive_buffer->size()), 0, error);
                 if (!error)
                 {
+                    auto receive_buffer = self->m_receive_buffer;
                     self->m_connection_handler(Result::receive_ok, std::move(receive_buffer));
                     self->receive();
                 }
@@ -193,7 +217,7 @@ inline void Connection_impl<ProtocolDescriptionType>::receive()
                 self->change(Result::Code::connection_aborted);
             }
         }
-    });
+    }));
 }
 
 template<typename ProtocolDescriptionType>
@@ -214,50 +238,107 @@ template<typename ProtocolDescriptionType>
 inline void Connection_impl<ProtocolDescriptionType>::handle_accept(Connection::Handler connection_handler)
 {
     assert(connection_handler);
-    m_connection_handler = std::move(connection_handler);
+    // set outside of the strand like the remote endpoint, local_endpoint() is read from any thread
     m_local_endpoint = Endpoint(m_asio_socket->local_endpoint());
-    change(Result::Code::connection_ok);
+    ::asio::dispatch(m_strand, [self = this->shared_from_this(), connection_handler = std::move(connection_handler)]() mutable
+    {
+        self->m_connection_handler = std::move(connection_handler);
+        self->change(Result::Code::connection_ok);
+    });
 }
 
 
 template<typename ProtocolDescriptionType>
 void Connection_impl<ProtocolDescriptionType>::transmit(Shared_payload tx_buffer)
 {
-    // only for non closed connection
-    if (m_connection_handler) 
+    // transmit can be called from any thread -> the tx_queue is only accessed inside the strand
+    ::asio::post(m_strand, [self = this->shared_from_this(), tx_buffer = std::move(tx_buffer)]() mutable
     {
-        m_tx_queue.emplace(tx_buffer);
-        if (m_tx_queue.size() == 1) 
+        // only for non closed connection
+        if (self->m_connection_handler)
         {
-            transmit_trigger();
+            self->m_tx_queue.emplace_back(std::move(tx_buffer));
+            if (!self->m_tx_active)
+            {
+                self->transmit_trigger();
+            }
         }
-    }
+    });
+}
+
+template<typename ProtocolDescriptionType>
+void Connection_impl<ProtocolDescriptionType>::transmit(Payload_sequence tx_buffers)
+{
+    ::asio::post(m_strand, [self = this->shared_from_this(), tx_buffers = std::move(tx_buffers)]() mutable
+    {
+        // only for non closed connection
+        if (self->m_connection_handler && !tx_buffers.empty())
+        {
+            if (self->m_tx_queue.empty())
+            {
+                self->m_tx_queue = std::move(tx_buffers);
+            }
+            else
+            {
+                std::move(tx_buffers.begin(), tx_buffers.end(), std::back_inserter(self->m_tx_queue));
+            }
+
+            if (!self->m_tx_active)
+            {
+                self->transmit_trigger();
+            }
+        }
+    });
 }
 
 template<typename ProtocolDescriptionType>
 void Connection_impl<ProtocolDescriptionType>::transmit_trigger()
 {
-    auto const payload = m_tx_queue.front();
-    ::asio::async_write(*m_asio_socket, ::asio::buffer(*payload, payload->size()),
-        // don't forget to keep the payload until transmission has been completed!!!
-        [weak_self = get_weak_self(), payload](auto, auto) 
+    // drain the whole queue with one gathered write
+    std::vector<::asio::const_buffer> buffers;
+    buffers.reserve(m_tx_queue.size());
+    for (auto const& payload : m_tx_queue)
+    {
+        if (payload && !payload->empty())
+        {
+            buffers.emplace_back(::asio::buffer(*payload));
+        }
+    }
+
+    m_tx_active = true;
+    ::asio::async_write(*m_asio_socket, buffers,
+        // don't forget to keep the payloads until transmission has been completed!!!
+        ::asio::bind_executor(m_strand, [weak_self = get_weak_self(), payloads = std::move(m_tx_queue)](auto, auto) 
         {
             auto self = weak_self.lock();
             if ((self != nullptr) && self->m_connection_handler) 
             {
-                self->m_tx_queue.pop();
+                self->m_tx_active = false;
                 if (!self->m_tx_queue.empty()) 
                 {
                     self->transmit_trigger();
                 }
             }
-        });
+        }));
+    m_tx_queue.clear();
 }
 
 template<typename ProtocolDescriptionType>
 inline void Connection_impl<ProtocolDescriptionType>::close()
 {
-    close_internal(Result::Code::connection_closed);
+    ::asio::post(m_strand, [self = this->shared_from_this()]()
+    {
+        self->close_internal(Result::Code::connection_closed);
+    });
+}
+
+template<typename ProtocolDescriptionType>
+inline void Connection_impl<ProtocolDescriptionType>::post(std::function<void()> handler)
+{
+    ::asio::post(m_strand, [self = this->shared_from_this(), handler = std::move(handler)]()
+    {
+        handler();
+    });
 }
 
 template<typename ProtocolDescriptionType>
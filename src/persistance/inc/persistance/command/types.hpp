@@ -19,39 +19,28 @@ enum class Class : std::uint8_t
 // List of available commands
 enum class Type : std::uint8_t
 {
-	get_banned_user_and_ip = 0,
-	get_banned_api_ip,
-	account_exists,
-	get_account,
-	get_active_accounts_from_round,
-	get_blocks,
-	create_account,
-	get_latest_round,
-	get_round,
-	get_payments,
+	create_account = 0,
 	add_payment,
 	create_round,
 	update_account,
 	create_config,
-	get_config,
 	update_config,
 	reset_shares_from_accounts,
 	add_block,
 	update_block_rewards,
-	get_blocks_from_round,
 	update_round,
-	get_total_shares_from_accounts,
-	get_not_paid_data_from_round,
 	account_paid,
-	get_unpaid_rounds,
 	update_block_hash,
-	get_blocks_without_hash_from_round,
 	update_reward_of_payment,
 	delete_empty_payments,
-	get_pool_hashrate,
-	get_longest_chain_finder,
-	get_top_block_finders,
-	update_block_share_difficulty
+	update_block_share_difficulty,
+	add_shares_to_account,
+	begin_transaction,
+	commit_transaction,
+	rollback_transaction,
+	savepoint,
+	release_savepoint,
+	rollback_to_savepoint
 };
 
 
@@ -18,6 +18,8 @@ public:
 
     virtual Data_reader_factory::Sptr get_data_reader_factory() = 0;
     virtual Data_writer_factory::Sptr get_data_writer_factory() = 0;
+    // writes all queued data and stops the storage thread of the data_writer
+    virtual void stop() = 0;
 
 };
 
@@ -2,8 +2,10 @@
 #define NEXUSPOOL_PERSISTANCE_DATA_WRITER_HPP
 
 #include <persistance/types.hpp>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace nexuspool
 {
@@ -33,14 +35,67 @@ public:
     virtual bool update_reward_of_payment(double reward, std::string account, std::uint32_t round_number) = 0;
     virtual bool delete_empty_payments() = 0;
     virtual bool update_block_share_difficulty(std::uint32_t height, double share_difficulty) = 0;
+    // adds the shares to the accounts within one transaction
+    virtual bool add_shares_to_accounts(std::vector<Account_share_data> data) = 0;
+
+    // Transactions can be nested, an inner transaction is a savepoint of the outer one.
+    // rollback_transaction only reverts the writes of the innermost transaction
+    virtual bool begin_transaction() = 0;
+    virtual bool commit_transaction() = 0;
+    virtual bool rollback_transaction() = 0;
+};
+
+// Transaction scope. Reverts all writes done within the scope if it isn't committed
+class Transaction
+{
+public:
+
+    explicit Transaction(Data_writer& data_writer)
+        : m_data_writer{ data_writer }
+        , m_open{ data_writer.begin_transaction() }
+    {}
+
+    ~Transaction()
+    {
+        if (m_open)
+        {
+            m_data_writer.rollback_transaction();
+        }
+    }
+
+    Transaction(Transaction const&) = delete;
+    Transaction& operator=(Transaction const&) = delete;
+
+    bool is_open() const { return m_open; }
+
+    bool commit()
+    {
+        // a failed commit is rolled back when the scope ends
+        if (m_open && m_data_writer.commit_transaction())
+        {
+            m_open = false;
+            return true;
+        }
+        return false;
+    }
+
+private:
+
+    Data_writer& m_data_writer;
+    bool m_open;
 };
 
 // Wrapper for unique data_writer. Ensures thread safety
+// All writes are queued and executed in order on the storage thread, which writes the queued writes batched in one
+// transaction. The methods below wait for their result, write_async() returns immediately.
+// If the queue is full the callers wait until the storage thread catches up.
 class Shared_data_writer
 {
 public:
 
     using Sptr = std::shared_ptr<Shared_data_writer>;
+    using Write = std::function<bool(Data_writer& data_writer)>;
+    using Result_handler = std::function<void(bool result)>;
 
     virtual ~Shared_data_writer() = default;
 
@@ -59,6 +114,19 @@ public:
     virtual bool update_reward_of_payment(double reward, std::string account, std::uint32_t round_number) = 0;
     virtual bool delete_empty_payments() = 0;
     virtual bool update_block_share_difficulty(std::uint32_t height, double share_difficulty) = 0;
+    // adds the shares to the accounts within one transaction
+    virtual bool add_shares_to_accounts(std::vector<Account_share_data> data) = 0;
+
+    // Executes all data_writer calls of the write in one transaction, which is reverted if the write returns false.
+    // Used for the round end and payout bookkeeping, which writes a row per account
+    virtual bool write_transaction(Write write) = 0;
+
+    // The handler is optional and is called with the result on the storage thread
+    virtual void write_async(Write write, Result_handler handler) = 0;
+    // waits until all writes queued before are written
+    virtual void flush() = 0;
+    // writes the remaining queued writes and stops the storage thread. Writes after stop fail
+    virtual void stop() = 0;
 };
 }
 }
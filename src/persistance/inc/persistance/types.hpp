@@ -22,6 +22,15 @@ struct Account_data
 	bool is_empty() const { return (m_address.empty()); }
 };
 
+// Shares (and latest hashrate) of an account collected since the last flush to storage
+struct Account_share_data
+{
+	std::string m_address{};
+	double m_shares{ 0 };
+	double m_hashrate{ 0 };
+	bool m_update_hashrate{ false };
+};
+
 struct Account_data_for_payment
 {
 	std::string m_address{};
@@ -30,5 +30,10 @@ Data_writer_factory::Sptr Component_impl::get_data_writer_factory()
     return m_data_writer_factory;
 }
 
+void Component_impl::stop()
+{
+    m_data_writer_factory->create_shared_data_writer()->stop();
+}
+
 }
 }
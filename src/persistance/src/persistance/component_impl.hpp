@@ -17,6 +17,7 @@ public:
 
     Data_reader_factory::Sptr get_data_reader_factory() override;
     Data_writer_factory::Sptr get_data_writer_factory() override;
+    void stop() override;
 
 private:
 
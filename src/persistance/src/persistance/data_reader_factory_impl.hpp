@@ -4,8 +4,6 @@
 #include "persistance/data_reader_factory.hpp"
 #include "persistance/data_reader_impl.hpp"
 #include "persistance/sqlite/storage_manager_impl.hpp"
-
-#include "persistance/sqlite/command/command_factory_impl.hpp"
 #include "config/types.hpp"
 #include <spdlog/spdlog.h>
 
@@ -50,8 +48,7 @@ private:
         }
         storage_manager->start();
 
-        return std::make_unique<Data_reader_impl>(m_logger, m_data_storage_factory->create_data_storage(), 
-            std::make_shared<command::Command_factory_impl>(m_logger, std::move(storage_manager)));
+        return std::make_unique<Data_reader_impl>(m_logger, std::move(storage_manager));
     }
 };
 
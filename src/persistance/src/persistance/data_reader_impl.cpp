@@ -1,334 +1,153 @@
 #include "persistance/data_reader_impl.hpp"
-#include "persistance/command/types.hpp"
-#include "persistance/command/command_factory.hpp"
-#include "persistance/sqlite/command/command_impl.hpp"
-#include "persistance/sqlite/utils.hpp"
-#include <array>
 
 namespace nexuspool
 {
 namespace persistance
 {
 
-using ::nexuspool::persistance::command::Type;
-
-Data_reader_impl::Data_reader_impl(std::shared_ptr<spdlog::logger> logger,
-	persistance::Data_storage::Sptr data_storage,
-	std::shared_ptr<persistance::command::Command_factory> command_factory)
+Data_reader_impl::Statements::Statements(std::shared_ptr<spdlog::logger> logger, sqlite3* handle)
+	: m_get_banned_ip{ logger, handle, "SELECT ip FROM banned_connections_api WHERE ip = ?;" }
+	, m_get_banned_user_ip{ logger, handle, "SELECT user FROM banned_users_connections WHERE user = ? AND ip = ?;" }
+	, m_account_exists{ logger, handle, "SELECT COUNT(name) FROM account WHERE name = ?;" }
+	, m_get_account{ logger, handle, "SELECT name, created_at, last_active, connection_count, shares, hashrate, display_name FROM account WHERE name = ?;" }
+	, m_get_blocks{ logger, handle, "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block ORDER BY height DESC LIMIT 100;" }
+	, m_get_latest_round{ logger, handle, "SELECT round_number, total_shares, total_reward, blocks, start_date_time, end_date_time, is_active, is_paid FROM round ORDER BY round_number DESC LIMIT 1;" }
+	, m_get_round{ logger, handle, "SELECT round_number, total_shares, total_reward, blocks, start_date_time, end_date_time, is_active, is_paid FROM round WHERE round_number = ?;" }
+	, m_get_payments{ logger, handle, "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE name = ?;" }
+	, m_get_config{ logger, handle, "SELECT version, difficulty_divider, fee, mining_mode, round_duration_hours FROM config;" }
+	, m_get_active_accounts_from_round{ logger, handle, "SELECT name, shares FROM account WHERE shares > 0;" }
+	, m_get_blocks_from_round{ logger, handle, "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block WHERE round = ?;" }
+	, m_get_total_shares_from_accounts{ logger, handle, "SELECT SUM(shares) FROM account" }
+	, m_get_not_paid_data_from_round{ logger, handle, "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE round = ? AND payment_date_time = ''" }
+	, m_get_unpaid_rounds{ logger, handle, "SELECT round_number FROM round WHERE is_paid = 0 AND is_active = 0" }
+	, m_get_blocks_without_hash_from_round{ logger, handle, "SELECT height FROM block WHERE hash = '' AND round = ?" }
+	, m_get_pool_hashrate{ logger, handle, "SELECT SUM(hashrate) FROM account WHERE datetime(last_active) >= datetime('now', '-10 Minute')" }
+	, m_get_longest_chain_finder{ logger, handle, "SELECT height, share_difficulty, block_finder, round, account.display_name FROM block INNER JOIN account ON block.block_finder=account.name WHERE block.orphan = 0 ORDER BY share_difficulty DESC LIMIT 1" }
+	, m_get_top_block_finders{ logger, handle, "SELECT COUNT(*) as num_blocks, account.display_name FROM block INNER JOIN account ON block.block_finder=account.name GROUP BY block_finder ORDER BY num_blocks DESC LIMIT ?" }
+{
+}
+
+Data_reader_impl::Data_reader_impl(std::shared_ptr<spdlog::logger> logger, Storage_manager::Uptr storage_manager)
 	: m_logger{std::move(logger)}
-	, m_data_storage{std::move(data_storage)}
-	, m_command_factory{std::move(command_factory)}
+	, m_storage_manager{std::move(storage_manager)}
+	, m_statements{std::make_unique<Statements>(m_logger, m_storage_manager->get_handle<sqlite3*>())}
+{
+}
+
+Data_reader_impl::~Data_reader_impl()
 {
-	m_get_banned_ip_cmd = m_command_factory->create_command(Type::get_banned_api_ip);
-	m_get_banned_user_ip_cmd = m_command_factory->create_command(Type::get_banned_user_and_ip);
-	m_account_exists_cmd = m_command_factory->create_command(Type::account_exists);
-	m_get_account_cmd = m_command_factory->create_command(Type::get_account);
-	m_get_blocks_cmd = m_command_factory->create_command(Type::get_blocks);
-	m_get_latest_round_cmd = m_command_factory->create_command(Type::get_latest_round);
-	m_get_round_cmd = m_command_factory->create_command(Type::get_round);
-	m_get_payments_cmd = m_command_factory->create_command(Type::get_payments);
-	m_get_config_cmd = m_command_factory->create_command(Type::get_config);
-	m_get_active_accounts_from_round_cmd = m_command_factory->create_command(Type::get_active_accounts_from_round);
-	m_get_blocks_from_round_cmd = m_command_factory->create_command(Type::get_blocks_from_round);
-	m_get_total_shares_from_accounts_cmd = m_command_factory->create_command(Type::get_total_shares_from_accounts);
-	m_get_not_paid_data_from_round_cmd = m_command_factory->create_command(Type::get_not_paid_data_from_round);
-	m_get_unpaid_rounds_cmd = m_command_factory->create_command(Type::get_unpaid_rounds);
-	m_get_blocks_without_hash_from_round_cmd = m_command_factory->create_command(Type::get_blocks_without_hash_from_round);
-	m_get_pool_hashrate_cmd = m_command_factory->create_command(Type::get_pool_hashrate);
-	m_get_longest_chain_finder_cmd = m_command_factory->create_command(Type::get_longest_chain_finder);
-	m_get_top_block_finders_cmd = m_command_factory->create_command(Type::get_top_block_finders);
+	m_statements.reset();
+	m_storage_manager->stop();
 }
 
 bool Data_reader_impl::is_connection_banned(std::string address)
 {
-	m_get_banned_ip_cmd->set_params(std::move(address));
-	auto return_value = m_data_storage->execute_command(m_get_banned_ip_cmd);
-	auto result = std::any_cast<Result_sqlite>(m_get_banned_ip_cmd->get_result());
-	return return_value ? (result.m_rows.empty() ? false : true) : false;
+	std::string ip;
+	return m_statements->m_get_banned_ip.get_row(ip, address);
 }
 
 bool Data_reader_impl::is_user_and_connection_banned(std::string user, std::string address)
 {
-	std::array<std::string, 2> params{ std::move(user), std::move(address) };
-	m_get_banned_user_ip_cmd->set_params(std::move(params));
-	auto return_value =  m_data_storage->execute_command(m_get_banned_user_ip_cmd);
-	auto result = std::any_cast<Result_sqlite>(m_get_banned_user_ip_cmd->get_result());
-	return return_value ? (result.m_rows.empty() ? false : true) : false;
+	std::string banned_user;
+	return m_statements->m_get_banned_user_ip.get_row(banned_user, user, address);
 }
 
 bool Data_reader_impl::does_account_exists(std::string account)
 {
-	m_account_exists_cmd->set_params(std::move(account));
-	if (!m_data_storage->execute_command(m_account_exists_cmd))
-	{
-		return false;
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_account_exists_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return false;
-	}
-
-	auto account_count = std::get<std::int32_t>(result.m_rows.front()[0].m_data);
-
+	std::int32_t account_count{ 0 };
+	m_statements->m_account_exists.get_row(account_count, account);
 	return account_count ? true : false;
 }
 
 Account_data Data_reader_impl::get_account(std::string account)
 {
-	Account_data account_data{};
-	m_get_account_cmd->set_params(std::move(account));
-	if (!m_data_storage->execute_command(m_get_account_cmd))
-	{
-		return account_data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_account_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return account_data;	// return empty result
-	}
-	auto result_row = result.m_rows.front();
-	account_data = convert_to_account_data(std::move(result_row));
-
+	Account_data account_data{};	// stays empty if there is no result
+	m_statements->m_get_account.get_row(account_data, account);
 	return account_data;
 }
 
 std::vector<Block_data> Data_reader_impl::get_latest_blocks()
 {
-	std::vector<Block_data> blocks{};
-	if (!m_data_storage->execute_command(m_get_blocks_cmd))
-	{
-		return blocks;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_blocks_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		blocks.push_back(convert_to_block_data(std::move(row)));
-	}
-
-	return blocks;
+	return m_statements->m_get_blocks.get_rows();
 }
 
 Round_data Data_reader_impl::get_latest_round()
 {
-	Round_data round_data{};
-	if (!m_data_storage->execute_command(m_get_latest_round_cmd))
-	{
-		return round_data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_latest_round_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return round_data;	// return empty result
-	}
-	auto result_row = result.m_rows.front();
-	round_data = convert_to_round_data(std::move(result_row));
-
+	Round_data round_data{};	// stays empty if there is no result
+	m_statements->m_get_latest_round.get_row(round_data);
 	return round_data;
 }
 
 Round_data Data_reader_impl::get_round(std::uint32_t round)
 {
-	Round_data round_data{};
-	m_get_round_cmd->set_params(static_cast<std::int64_t>(round));
-	if (!m_data_storage->execute_command(m_get_round_cmd))
-	{
-		return round_data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_round_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return round_data;	// return empty result
-	}
-	auto result_row = result.m_rows.front();
-	round_data = convert_to_round_data(std::move(result_row));
-
+	Round_data round_data{};	// stays empty if there is no result
+	m_statements->m_get_round.get_row(round_data, static_cast<std::int64_t>(round));
 	return round_data;
 }
 
 std::vector<Payment_data> Data_reader_impl::get_payments(std::string account)
 {
-	std::vector<Payment_data> payments{};
-	m_get_payments_cmd->set_params(std::move(account));
-	if (!m_data_storage->execute_command(m_get_payments_cmd))
-	{
-		return payments;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_payments_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		payments.push_back(convert_to_payment_data(std::move(row)));
-	}
-
-	return payments;
+	return m_statements->m_get_payments.get_rows(account);
 }
 
 Config_data Data_reader_impl::get_config()
 {
-	Config_data config_data{};
-	if (!m_data_storage->execute_command(m_get_config_cmd))
-	{
-		return config_data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_config_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return config_data;	// return empty result
-	}
-
-	auto result_row = result.m_rows.front();
-	config_data = convert_to_config_data(std::move(result_row));
-
+	Config_data config_data{};	// stays empty if there is no result
+	m_statements->m_get_config.get_row(config_data);
 	return config_data;
 }
 
 std::vector<Account_data_for_payment> Data_reader_impl::get_active_accounts_from_round()
 {
-	std::vector<Account_data_for_payment> accounts_data{};
-	if (!m_data_storage->execute_command(m_get_active_accounts_from_round_cmd))
-	{
-		return accounts_data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_active_accounts_from_round_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		accounts_data.push_back(Account_data_for_payment{ std::get<std::string>(row[0].m_data), std::get<double>(row[1].m_data) });
-	}
-
-	return accounts_data;
+	return m_statements->m_get_active_accounts_from_round.get_rows();
 }
 
 std::vector<Block_data> Data_reader_impl::get_blocks_from_round(std::uint32_t round)
 {
-	std::vector<Block_data> blocks{};
-	m_get_blocks_from_round_cmd->set_params(static_cast<std::int64_t>(round));
-	if (!m_data_storage->execute_command(m_get_blocks_from_round_cmd))
-	{
-		return blocks;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_blocks_from_round_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		blocks.push_back(convert_to_block_data(std::move(row)));
-	}
-
-	return blocks;
+	return m_statements->m_get_blocks_from_round.get_rows(static_cast<std::int64_t>(round));
 }
 
 double Data_reader_impl::get_total_shares_from_accounts()
 {
-	if (!m_data_storage->execute_command(m_get_total_shares_from_accounts_cmd))
-	{
-		return 0;
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_total_shares_from_accounts_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return 0;
-	}
-
-	return std::get<std::double_t>(result.m_rows.front()[0].m_data);
+	double total_shares{ 0 };
+	m_statements->m_get_total_shares_from_accounts.get_row(total_shares);
+	return total_shares;
 }
 
 std::vector<Payment_data> Data_reader_impl::get_not_paid_data_from_round(std::uint32_t round)
 {
-	std::vector<Payment_data> payments{};
-	m_get_not_paid_data_from_round_cmd->set_params(static_cast<std::int64_t>(round));
-	if (!m_data_storage->execute_command(m_get_not_paid_data_from_round_cmd))
-	{
-		return payments;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_not_paid_data_from_round_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		payments.push_back(convert_to_payment_data(std::move(row)));
-	}
-
-	return payments;
+	return m_statements->m_get_not_paid_data_from_round.get_rows(static_cast<std::int64_t>(round));
 }
 
 std::vector<std::uint32_t> Data_reader_impl::get_unpaid_rounds()
 {
-	std::vector<std::uint32_t> rounds{};
-	if (!m_data_storage->execute_command(m_get_unpaid_rounds_cmd))
-	{
-		return rounds;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_unpaid_rounds_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		rounds.push_back(static_cast<std::uint32_t>(std::get<std::int64_t>(row[0].m_data)));
-	}
-
-	return rounds;
+	return m_statements->m_get_unpaid_rounds.get_rows();
 }
 
 std::vector<std::uint32_t> Data_reader_impl::get_blocks_without_hash_from_round(std::uint32_t round)
 {
-	std::vector<std::uint32_t> heights{};
-	m_get_blocks_without_hash_from_round_cmd->set_params(static_cast<std::int64_t>(round));
-	if (!m_data_storage->execute_command(m_get_blocks_without_hash_from_round_cmd))
-	{
-		return heights;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_blocks_without_hash_from_round_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		heights.push_back(static_cast<std::uint32_t>(std::get<std::int32_t>(row[0].m_data)));
-	}
-
-	return heights;
+	return m_statements->m_get_blocks_without_hash_from_round.get_rows(static_cast<std::int64_t>(round));
 }
 
 double Data_reader_impl::get_pool_hashrate()
 {
-	auto return_value = m_data_storage->execute_command(m_get_pool_hashrate_cmd);
-	auto result = std::any_cast<Result_sqlite>(m_get_pool_hashrate_cmd->get_result());
-	return std::get<std::double_t>(result.m_rows.front()[0].m_data);
+	double hashrate{ 0 };
+	m_statements->m_get_pool_hashrate.get_row(hashrate);
+	return hashrate;
 }
 
 Statistics_block_finder Data_reader_impl::get_longest_chain_finder()
 {
-	Statistics_block_finder data{};
-	if (!m_data_storage->execute_command(m_get_longest_chain_finder_cmd))
-	{
-		return data;	// return empty result
-	}
-	auto result = std::any_cast<Result_sqlite>(m_get_longest_chain_finder_cmd->get_result());
-	if (result.m_rows.empty())
-	{
-		return data;	// return empty result
-	}
-	data = convert_to_statistics_block_finder(result.m_rows.front());
-
+	Statistics_block_finder data{};	// stays empty if there is no result
+	m_statements->m_get_longest_chain_finder.get_row(data);
 	return data;
 }
 
 std::vector<Statistics_top_block_finder> Data_reader_impl::get_top_block_finders(std::uint16_t num_finders)
 {
-	std::vector<Statistics_top_block_finder> block_finders{};
-	m_get_top_block_finders_cmd->set_params(static_cast<std::int32_t>(num_finders));
-	if (!m_data_storage->execute_command(m_get_top_block_finders_cmd))
-	{
-		return block_finders;	// return empty result
-	}
-
-	auto result = std::any_cast<Result_sqlite>(m_get_top_block_finders_cmd->get_result());
-	for (auto& row : result.m_rows)
-	{
-		block_finders.push_back(convert_to_statistics_top_block_finder(std::move(row)));
-	}
-
-	return block_finders;
+	return m_statements->m_get_top_block_finders.get_rows(static_cast<std::int32_t>(num_finders));
 }
 
 
 }
-}
\ No newline at end of file
+}
@@ -2,8 +2,8 @@
 #define NEXUSPOOL_PERSISTANCE_DATA_READER_IMPL_HPP
 
 #include "persistance/data_reader.hpp"
-#include "persistance/data_storage.hpp"
-#include "persistance/command/command.hpp"
+#include "persistance/storage_manager.hpp"
+#include "persistance/sqlite/statement.hpp"
 #include <spdlog/spdlog.h>
 #include <sqlite/sqlite3.h>
 
@@ -14,16 +14,13 @@ namespace nexuspool
 {
 namespace persistance
 {
-    namespace command { class Command_factory; }
-    using ::nexuspool::persistance::command::Command;
 
 class Data_reader_impl : public Data_reader
 {
 public:
 
-    Data_reader_impl(std::shared_ptr<spdlog::logger> logger,
-        persistance::Data_storage::Sptr data_storage, 
-        std::shared_ptr<persistance::command::Command_factory> command_factory);
+    Data_reader_impl(std::shared_ptr<spdlog::logger> logger, Storage_manager::Uptr storage_manager);
+    ~Data_reader_impl();
 
     bool is_connection_banned(std::string address) override;
     bool is_user_and_connection_banned(std::string user, std::string address) override;
@@ -46,29 +43,34 @@ public:
 
 private:
 
-    std::shared_ptr<spdlog::logger> m_logger;
-    persistance::Data_storage::Sptr m_data_storage;
-    std::shared_ptr<persistance::command::Command_factory> m_command_factory;
+    // prepared on the db connection of the storage_manager
+    struct Statements
+    {
+        Statements(std::shared_ptr<spdlog::logger> logger, sqlite3* handle);
+
+        sqlite::Statement<std::string, std::string> m_get_banned_ip;
+        sqlite::Statement<std::string, std::string, std::string> m_get_banned_user_ip;
+        sqlite::Statement<std::int32_t, std::string> m_account_exists;
+        sqlite::Statement<Account_data, std::string> m_get_account;
+        sqlite::Statement<Block_data> m_get_blocks;
+        sqlite::Statement<Round_data> m_get_latest_round;
+        sqlite::Statement<Round_data, std::int64_t> m_get_round;
+        sqlite::Statement<Payment_data, std::string> m_get_payments;
+        sqlite::Statement<Config_data> m_get_config;
+        sqlite::Statement<Account_data_for_payment> m_get_active_accounts_from_round;
+        sqlite::Statement<Block_data, std::int64_t> m_get_blocks_from_round;
+        sqlite::Statement<double> m_get_total_shares_from_accounts;
+        sqlite::Statement<Payment_data, std::int64_t> m_get_not_paid_data_from_round;
+        sqlite::Statement<std::uint32_t> m_get_unpaid_rounds;
+        sqlite::Statement<std::uint32_t, std::int64_t> m_get_blocks_without_hash_from_round;
+        sqlite::Statement<double> m_get_pool_hashrate;
+        sqlite::Statement<Statistics_block_finder> m_get_longest_chain_finder;
+        sqlite::Statement<Statistics_top_block_finder, std::int32_t> m_get_top_block_finders;
+    };
 
-    // needed commands
-    std::shared_ptr<Command> m_get_banned_ip_cmd;
-    std::shared_ptr<Command> m_get_banned_user_ip_cmd;
-    std::shared_ptr<Command> m_account_exists_cmd;
-    std::shared_ptr<Command> m_get_account_cmd;
-    std::shared_ptr<Command> m_get_blocks_cmd;
-    std::shared_ptr<Command> m_get_latest_round_cmd;
-    std::shared_ptr<Command> m_get_round_cmd;
-    std::shared_ptr<Command> m_get_payments_cmd;
-    std::shared_ptr<Command> m_get_config_cmd;
-    std::shared_ptr<Command> m_get_active_accounts_from_round_cmd;
-    std::shared_ptr<Command> m_get_blocks_from_round_cmd;
-    std::shared_ptr<Command> m_get_total_shares_from_accounts_cmd;
-    std::shared_ptr<Command> m_get_not_paid_data_from_round_cmd;
-    std::shared_ptr<Command> m_get_unpaid_rounds_cmd;
-    std::shared_ptr<Command> m_get_blocks_without_hash_from_round_cmd;
-    std::shared_ptr<Command> m_get_pool_hashrate_cmd;
-    std::shared_ptr<Command> m_get_longest_chain_finder_cmd;
-    std::shared_ptr<Command> m_get_top_block_finders_cmd;
+    std::shared_ptr<spdlog::logger> m_logger;
+    Storage_manager::Uptr m_storage_manager;
+    std::unique_ptr<Statements> m_statements;   // finalized before the db connection is closed
 };
 
 }
@@ -56,7 +56,7 @@ private:
             auto data_writer = std::make_unique<Data_writer_impl>(m_logger, m_data_storage_factory->create_data_storage(),
                 std::make_shared<command::Command_factory_impl>(m_logger, std::move(storage_manager)));
 
-            m_shared_data_writer = std::make_shared<Shared_data_writer_impl>(std::move(data_writer));
+            m_shared_data_writer = std::make_shared<Shared_data_writer_impl>(m_logger, std::move(data_writer), m_config.m_write_queue_size);
         }
 
         return m_shared_data_writer;
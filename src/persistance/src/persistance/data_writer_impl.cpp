@@ -2,9 +2,11 @@
 #include "persistance/command/types.hpp"
 #include "persistance/command/command_factory.hpp"
 #include "persistance/sqlite/command/command_impl.hpp"
-#include "persistance/sqlite/utils.hpp"
 #include "common/utils.hpp"
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <future>
 
 namespace nexuspool
 {
@@ -19,6 +21,7 @@ Data_writer_impl::Data_writer_impl(std::shared_ptr<spdlog::logger> logger,
 	: m_logger{ std::move(logger) }
 	, m_data_storage{ std::move(data_storage) }
 	, m_command_factory{ std::move(command_factory) }
+	, m_transaction_depth{ 0U }
 {
 	m_create_account_cmd = m_command_factory->create_command(Type::create_account);
 	m_add_payment_cmd = m_command_factory->create_command(Type::add_payment);
@@ -35,6 +38,13 @@ Data_writer_impl::Data_writer_impl(std::shared_ptr<spdlog::logger> logger,
 	m_update_reward_of_payment_cmd = m_command_factory->create_command(Type::update_reward_of_payment);
 	m_delete_empty_payments_cmd = m_command_factory->create_command(Type::delete_empty_payments);
 	m_update_block_share_difficulty_cmd = m_command_factory->create_command(Type::update_block_share_difficulty);
+	m_add_shares_to_account_cmd = m_command_factory->create_command(Type::add_shares_to_account);
+	m_begin_transaction_cmd = m_command_factory->create_command(Type::begin_transaction);
+	m_commit_transaction_cmd = m_command_factory->create_command(Type::commit_transaction);
+	m_rollback_transaction_cmd = m_command_factory->create_command(Type::rollback_transaction);
+	m_savepoint_cmd = m_command_factory->create_command(Type::savepoint);
+	m_release_savepoint_cmd = m_command_factory->create_command(Type::release_savepoint);
+	m_rollback_to_savepoint_cmd = m_command_factory->create_command(Type::rollback_to_savepoint);
 }
 
 bool Data_writer_impl::create_account(std::string account, std::string display_name)
@@ -148,100 +158,294 @@ bool Data_writer_impl::update_block_share_difficulty(std::uint32_t height, doubl
 	return m_data_storage->execute_command(m_update_block_share_difficulty_cmd);
 }
 
+bool Data_writer_impl::add_shares_to_accounts(std::vector<Account_share_data> data)
+{
+	if (data.empty())
+	{
+		return true;
+	}
+
+	if (!begin_transaction())
+	{
+		return false;
+	}
+
+	auto const last_active = common::get_datetime_string(std::chrono::system_clock::now());
+	for (auto& account : data)
+	{
+		m_add_shares_to_account_cmd->set_params(command::Command_add_shares_to_account_params{
+			last_active,
+			account.m_shares,
+			account.m_hashrate,
+			account.m_update_hashrate ? 1 : 0,
+			std::move(account.m_address) });
+		if (!m_data_storage->execute_command(m_add_shares_to_account_cmd))
+		{
+			m_logger->error("Failed to add shares to accounts. Rollback transaction");
+			rollback_transaction();
+			return false;
+		}
+	}
+
+	if (!commit_transaction())
+	{
+		rollback_transaction();
+		return false;
+	}
+	return true;
+}
+
+bool Data_writer_impl::begin_transaction()
+{
+	// a transaction within a transaction is a savepoint
+	if (!m_data_storage->execute_command(m_transaction_depth == 0 ? m_begin_transaction_cmd : m_savepoint_cmd))
+	{
+		return false;
+	}
+	m_transaction_depth++;
+	return true;
+}
+
+bool Data_writer_impl::commit_transaction()
+{
+	assert(m_transaction_depth > 0);
+	// a failed commit keeps the transaction open, the caller has to rollback
+	if (!m_data_storage->execute_command(m_transaction_depth == 1 ? m_commit_transaction_cmd : m_release_savepoint_cmd))
+	{
+		return false;
+	}
+	m_transaction_depth--;
+	return true;
+}
+
+bool Data_writer_impl::rollback_transaction()
+{
+	assert(m_transaction_depth > 0);
+	m_transaction_depth--;
+	if (m_transaction_depth == 0)
+	{
+		return m_data_storage->execute_command(m_rollback_transaction_cmd);
+	}
+
+	// rollback to a savepoint keeps it on the transaction stack
+	auto const result = m_data_storage->execute_command(m_rollback_to_savepoint_cmd);
+	return m_data_storage->execute_command(m_release_savepoint_cmd) && result;
+}
+
 // --------------------------------------------------------------------------------------
 
-Shared_data_writer_impl::Shared_data_writer_impl(Data_writer::Uptr data_writer)
-	: m_data_writer{ std::move(data_writer) }
+Shared_data_writer_impl::Shared_data_writer_impl(std::shared_ptr<spdlog::logger> logger, Data_writer::Uptr data_writer, std::size_t queue_size)
+	: m_logger{ std::move(logger) }
+	, m_data_writer{ std::move(data_writer) }
+	, m_queue{ queue_size }
+	, m_thread{ [this] { run(); } }
 {}
 
+Shared_data_writer_impl::~Shared_data_writer_impl()
+{
+	stop();
+}
+
 bool Shared_data_writer_impl::create_account(std::string account, std::string display_name)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->create_account(std::move(account), std::move(display_name));
+	return execute([account = std::move(account), display_name = std::move(display_name)](Data_writer& data_writer) { return data_writer.create_account(account, display_name); });
 }
 
 bool Shared_data_writer_impl::add_payment(Payment_data data)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->add_payment(std::move(data));
+	return execute([data = std::move(data)](Data_writer& data_writer) { return data_writer.add_payment(data); });
 }
 
 bool Shared_data_writer_impl::create_round(std::string round_end_date_time)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->create_round(std::move(round_end_date_time));
+	return execute([round_end_date_time = std::move(round_end_date_time)](Data_writer& data_writer) { return data_writer.create_round(round_end_date_time); });
 }
 
 bool Shared_data_writer_impl::update_account(Account_data data)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_account(std::move(data));
+	return execute([data = std::move(data)](Data_writer& data_writer) { return data_writer.update_account(data); });
 }
 
 bool Shared_data_writer_impl::create_config(std::string mining_mode, int fee, int difficulty_divider, int round_duration_hours)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->create_config(std::move(mining_mode), fee, difficulty_divider, round_duration_hours);
+	return execute([mining_mode = std::move(mining_mode), fee, difficulty_divider, round_duration_hours](Data_writer& data_writer) { return data_writer.create_config(mining_mode, fee, difficulty_divider, round_duration_hours); });
 }
 
 bool Shared_data_writer_impl::update_config(std::string mining_mode, int fee, int difficulty_divider, int round_duration_hours)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_config(std::move(mining_mode), fee, difficulty_divider, round_duration_hours);
+	return execute([mining_mode = std::move(mining_mode), fee, difficulty_divider, round_duration_hours](Data_writer& data_writer) { return data_writer.update_config(mining_mode, fee, difficulty_divider, round_duration_hours); });
 }
 
 bool Shared_data_writer_impl::reset_shares_from_accounts()
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->reset_shares_from_accounts();
+	return execute([](Data_writer& data_writer) { return data_writer.reset_shares_from_accounts(); });
 }
 
 bool Shared_data_writer_impl::add_block(Block_data data)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->add_block(std::move(data));
+	return execute([data = std::move(data)](Data_writer& data_writer) { return data_writer.add_block(data); });
 }
 
 bool Shared_data_writer_impl::update_block_rewards(std::string hash, bool orphan, double reward)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_block_rewards(std::move(hash), orphan, reward);
+	return execute([hash = std::move(hash), orphan, reward](Data_writer& data_writer) { return data_writer.update_block_rewards(hash, orphan, reward); });
 }
 
 bool Shared_data_writer_impl::update_round(Round_data round)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_round(std::move(round));
+	return execute([round = std::move(round)](Data_writer& data_writer) { return data_writer.update_round(round); });
 }
 
 bool Shared_data_writer_impl::account_paid(std::uint32_t round_number, std::string account, std::string tx_id)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->account_paid(round_number, std::move(account), std::move(tx_id));
+	return execute([round_number, account = std::move(account), tx_id = std::move(tx_id)](Data_writer& data_writer) { return data_writer.account_paid(round_number, account, tx_id); });
 }
 
 bool Shared_data_writer_impl::update_block_hash(std::uint32_t height, std::string block_hash)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_block_hash(height, std::move(block_hash));
+	return execute([height, block_hash = std::move(block_hash)](Data_writer& data_writer) { return data_writer.update_block_hash(height, block_hash); });
 }
 
 bool Shared_data_writer_impl::update_reward_of_payment(double reward, std::string account, std::uint32_t round_number)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_reward_of_payment(reward, std::move(account), round_number);
+	return execute([reward, account = std::move(account), round_number](Data_writer& data_writer) { return data_writer.update_reward_of_payment(reward, account, round_number); });
 }
 
 bool Shared_data_writer_impl::delete_empty_payments()
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->delete_empty_payments();
+	return execute([](Data_writer& data_writer) { return data_writer.delete_empty_payments(); });
 }
 
 bool Shared_data_writer_impl::update_block_share_difficulty(std::uint32_t height, double share_difficulty)
 {
-	std::scoped_lock lock(m_writer_mutex);
-	return m_data_writer->update_block_share_difficulty(height, share_difficulty);
+	return execute([height, share_difficulty](Data_writer& data_writer) { return data_writer.update_block_share_difficulty(height, share_difficulty); });
+}
+
+bool Shared_data_writer_impl::add_shares_to_accounts(std::vector<Account_share_data> data)
+{
+	return execute([data = std::move(data)](Data_writer& data_writer) { return data_writer.add_shares_to_accounts(data); });
+}
+
+bool Shared_data_writer_impl::write_transaction(Write write)
+{
+	return execute([write = std::move(write)](Data_writer& data_writer)
+	{
+		// within a batch of the storage thread this is a savepoint, only the writes of this transaction are reverted
+		Transaction transaction{ data_writer };
+		return transaction.is_open() && write(data_writer) && transaction.commit();
+	});
+}
+
+void Shared_data_writer_impl::write_async(Write write, Result_handler handler)
+{
+	// called from a handler. Waiting for free space in the queue would block the storage thread itself
+	if (std::this_thread::get_id() == m_thread.get_id())
+	{
+		auto const result = write(*m_data_writer);
+		if (handler)
+		{
+			handler(result);
+		}
+		return;
+	}
+
+	if (!m_queue.push(Write_request{ std::move(write), handler }))
+	{
+		m_logger->error("Storage writer is stopped. Write rejected");
+		if (handler)
+		{
+			handler(false);
+		}
+	}
+}
+
+void Shared_data_writer_impl::flush()
+{
+	// the writes are executed in order -> all writes queued before are written when this one is done
+	execute([](Data_writer&) { return true; });
+}
+
+void Shared_data_writer_impl::stop()
+{
+	// the storage thread writes the remaining queued writes before it exits
+	m_queue.close();
+	if (m_thread.joinable() && std::this_thread::get_id() != m_thread.get_id())
+	{
+		m_thread.join();
+	}
+}
+
+bool Shared_data_writer_impl::execute(Write write)
+{
+	// called from a handler, the writes queued before are already written
+	if (std::this_thread::get_id() == m_thread.get_id())
+	{
+		return write(*m_data_writer);
+	}
+
+	std::promise<bool> promise;
+	auto result = promise.get_future();
+	if (!m_queue.push(Write_request{ std::move(write), [&promise](bool write_result) { promise.set_value(write_result); } }))
+	{
+		m_logger->error("Storage writer is stopped. Write rejected");
+		return false;
+	}
+	return result.get();
+}
+
+void Shared_data_writer_impl::run()
+{
+	std::vector<Write_request> requests;
+	while (m_queue.pop(requests, batch_size) > 0)
+	{
+		write_batch(requests);
+	}
+}
+
+void Shared_data_writer_impl::write_batch(std::vector<Write_request>& requests)
+{
+	// all queued writes in one transaction -> one disk sync instead of one per write.
+	// Every write has its own savepoint, a failing write only reverts its own writes
+	bool transaction = requests.size() > 1 && m_data_writer->begin_transaction();
+	std::vector<char> results(requests.size());
+	for (std::size_t i = 0; i < requests.size(); ++i)
+	{
+		if (!transaction)
+		{
+			results[i] = requests[i].m_write(*m_data_writer);
+			continue;
+		}
+
+		bool const savepoint = m_data_writer->begin_transaction();
+		results[i] = savepoint && requests[i].m_write(*m_data_writer) && m_data_writer->commit_transaction();
+		if (results[i] || (savepoint && m_data_writer->rollback_transaction()))
+		{
+			continue;
+		}
+
+		// sqlite rolls back the whole transaction on SQLITE_FULL, IOERR or NOMEM and the savepoint is gone.
+		// The writes before are lost, the remaining writes are written without transaction
+		m_logger->error("Transaction of {} writes rolled back by the database", requests.size());
+		m_data_writer->rollback_transaction();
+		std::fill(results.begin(), results.begin() + i, false);
+		transaction = false;
+	}
+
+	if (transaction && !m_data_writer->commit_transaction())
+	{
+		m_logger->error("Failed to commit {} writes. Rollback transaction", requests.size());
+		m_data_writer->rollback_transaction();
+		results.assign(results.size(), false);
+	}
+
+	// handlers are called after the commit, the written data is visible to all db connections
+	for (std::size_t i = 0; i < requests.size(); ++i)
+	{
+		if (requests[i].m_handler)
+		{
+			requests[i].m_handler(results[i] != 0);
+		}
+	}
 }
 
 }
@@ -4,12 +4,15 @@
 #include "persistance/data_writer.hpp"
 #include "persistance/data_storage.hpp"
 #include "persistance/command/command.hpp"
+#include "common/bounded_queue.hpp"
 #include <spdlog/spdlog.h>
 #include <sqlite/sqlite3.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace nexuspool
 {
@@ -41,6 +44,10 @@ public:
     bool update_reward_of_payment(double reward, std::string account, std::uint32_t round_number) override;
     bool delete_empty_payments() override;
     bool update_block_share_difficulty(std::uint32_t height, double share_difficulty) override;
+    bool add_shares_to_accounts(std::vector<Account_share_data> data) override;
+    bool begin_transaction() override;
+    bool commit_transaction() override;
+    bool rollback_transaction() override;
 
 private:
 
@@ -64,13 +71,22 @@ private:
     std::shared_ptr<Command> m_update_reward_of_payment_cmd;
     std::shared_ptr<Command> m_delete_empty_payments_cmd;
     std::shared_ptr<Command> m_update_block_share_difficulty_cmd;
+    std::shared_ptr<Command> m_add_shares_to_account_cmd;
+    std::shared_ptr<Command> m_begin_transaction_cmd;
+    std::shared_ptr<Command> m_commit_transaction_cmd;
+    std::shared_ptr<Command> m_rollback_transaction_cmd;
+    std::shared_ptr<Command> m_savepoint_cmd;
+    std::shared_ptr<Command> m_release_savepoint_cmd;
+    std::shared_ptr<Command> m_rollback_to_savepoint_cmd;
+    std::uint32_t m_transaction_depth;
  };
 
 class Shared_data_writer_impl : public Shared_data_writer
 {
 public:
 
-    Shared_data_writer_impl(Data_writer::Uptr data_writer);
+    Shared_data_writer_impl(std::shared_ptr<spdlog::logger> logger, Data_writer::Uptr data_writer, std::size_t queue_size);
+    ~Shared_data_writer_impl();
 
     bool create_account(std::string account, std::string display_name) override;
     bool add_payment(Payment_data data) override;
@@ -87,11 +103,32 @@ public:
     bool update_reward_of_payment(double reward, std::string account, std::uint32_t round_number) override;
     bool delete_empty_payments() override;
     bool update_block_share_difficulty(std::uint32_t height, double share_difficulty) override;
+    bool add_shares_to_accounts(std::vector<Account_share_data> data) override;
+    bool write_transaction(Write write) override;
+    void write_async(Write write, Result_handler handler) override;
+    void flush() override;
+    void stop() override;
 
 private:
 
-    std::mutex m_writer_mutex;
-    Data_writer::Uptr m_data_writer;
+    // max writes per transaction
+    static constexpr std::size_t batch_size{ 256U };
+
+    struct Write_request
+    {
+        Write m_write;
+        Result_handler m_handler;
+    };
+
+    // queues the write and waits for its result
+    bool execute(Write write);
+    void run();
+    void write_batch(std::vector<Write_request>& requests);
+
+    std::shared_ptr<spdlog::logger> m_logger;
+    Data_writer::Uptr m_data_writer;        // only used by the storage thread
+    common::Bounded_queue<Write_request> m_queue;
+    std::thread m_thread;
 };
 
 }
@@ -23,44 +23,6 @@ public:
         : m_logger{std::move(logger)}
         , m_storage_manager{std::move(storage_manager)}
     {
-        m_commands.emplace(std::make_pair(Type::get_banned_user_and_ip, 
-            std::make_shared<Command_banned_user_and_ip_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_banned_api_ip,
-            std::make_shared<Command_banned_api_ip_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::account_exists,
-            std::make_shared<Command_account_exists_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_account,
-            std::make_shared<Command_get_account_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_blocks,
-            std::make_shared<Command_get_blocks_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_latest_round,
-            std::make_shared<Command_get_latest_round_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_round,
-            std::make_shared<Command_get_round_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_payments,
-            std::make_shared<Command_get_payments_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_config,
-            std::make_shared<Command_get_config_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_active_accounts_from_round,
-            std::make_shared<Command_get_active_accounts_from_round_impl>(m_storage_manager->get_handle<sqlite3*>())));     
-        m_commands.emplace(std::make_pair(Type::get_blocks_from_round,
-            std::make_shared<Command_get_blocks_from_round_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_total_shares_from_accounts,
-            std::make_shared<Command_get_total_shares_from_accounts_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_not_paid_data_from_round,
-            std::make_shared<Command_get_not_paid_data_from_round_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_unpaid_rounds,
-            std::make_shared<Command_get_unpaid_rounds_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_blocks_without_hash_from_round,
-            std::make_shared<Command_get_blocks_without_hash_from_round_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_pool_hashrate,
-            std::make_shared<Command_get_pool_hashrate_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_longest_chain_finder,
-            std::make_shared<Command_get_longest_chain_finder_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        m_commands.emplace(std::make_pair(Type::get_top_block_finders,
-            std::make_shared<Command_get_top_block_finders_impl>(m_storage_manager->get_handle<sqlite3*>())));
-        
-        // Write commands
         m_commands.emplace(std::make_pair(Type::create_account,
             std::make_shared<Command_create_account_impl>(m_storage_manager->get_handle<sqlite3*>())));
         m_commands.emplace(std::make_pair(Type::add_payment,
@@ -91,6 +53,20 @@ public:
             std::make_shared<Command_delete_empty_payments_impl>(m_storage_manager->get_handle<sqlite3*>())));   
         m_commands.emplace(std::make_pair(Type::update_block_share_difficulty,
             std::make_shared<Command_update_block_share_difficulty_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::add_shares_to_account,
+            std::make_shared<Command_add_shares_to_account_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::begin_transaction,
+            std::make_shared<Command_begin_transaction_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::commit_transaction,
+            std::make_shared<Command_commit_transaction_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::rollback_transaction,
+            std::make_shared<Command_rollback_transaction_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::savepoint,
+            std::make_shared<Command_savepoint_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::release_savepoint,
+            std::make_shared<Command_release_savepoint_impl>(m_storage_manager->get_handle<sqlite3*>())));
+        m_commands.emplace(std::make_pair(Type::rollback_to_savepoint,
+            std::make_shared<Command_rollback_to_savepoint_impl>(m_storage_manager->get_handle<sqlite3*>())));
     }
 
     ~Command_factory_impl()
@@ -108,62 +84,6 @@ private:
         Command::Sptr result{};
         switch (command_type)
         {
-        case Type::get_banned_user_and_ip:
-            result = std::any_cast<std::shared_ptr<Command_banned_user_and_ip_impl>>(m_commands[command_type]); 
-            break;
-        case Type::get_banned_api_ip: 
-            result = std::any_cast<std::shared_ptr<Command_banned_api_ip_impl>>(m_commands[command_type]); 
-            break;
-        case Type::account_exists:
-            result = std::any_cast<std::shared_ptr<Command_account_exists_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_account:
-            result = std::any_cast<std::shared_ptr<Command_get_account_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_blocks:
-            result = std::any_cast<std::shared_ptr<Command_get_blocks_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_latest_round:
-            result = std::any_cast<std::shared_ptr<Command_get_latest_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_round:
-            result = std::any_cast<std::shared_ptr<Command_get_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_payments:
-            result = std::any_cast<std::shared_ptr<Command_get_payments_impl>>(m_commands[command_type]);
-            break;      
-        case Type::get_config:
-            result = std::any_cast<std::shared_ptr<Command_get_config_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_active_accounts_from_round:
-            result = std::any_cast<std::shared_ptr<Command_get_active_accounts_from_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_blocks_from_round:
-            result = std::any_cast<std::shared_ptr<Command_get_blocks_from_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_total_shares_from_accounts:
-            result = std::any_cast<std::shared_ptr<Command_get_total_shares_from_accounts_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_not_paid_data_from_round:
-            result = std::any_cast<std::shared_ptr<Command_get_not_paid_data_from_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_unpaid_rounds:
-            result = std::any_cast<std::shared_ptr<Command_get_unpaid_rounds_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_blocks_without_hash_from_round:
-            result = std::any_cast<std::shared_ptr<Command_get_blocks_without_hash_from_round_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_pool_hashrate:
-            result = std::any_cast<std::shared_ptr<Command_get_pool_hashrate_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_longest_chain_finder:
-            result = std::any_cast<std::shared_ptr<Command_get_longest_chain_finder_impl>>(m_commands[command_type]);
-            break;
-        case Type::get_top_block_finders:
-            result = std::any_cast<std::shared_ptr<Command_get_top_block_finders_impl>>(m_commands[command_type]);
-            break;
-            
-            // Write commands
         case Type::create_account:
             result = std::any_cast<std::shared_ptr<Command_create_account_impl>>(m_commands[command_type]);
             break;
@@ -209,6 +129,27 @@ private:
         case Type::update_block_share_difficulty:
             result = std::any_cast<std::shared_ptr<Command_update_block_share_difficulty_impl>>(m_commands[command_type]);
             break;
+        case Type::add_shares_to_account:
+            result = std::any_cast<std::shared_ptr<Command_add_shares_to_account_impl>>(m_commands[command_type]);
+            break;
+        case Type::begin_transaction:
+            result = std::any_cast<std::shared_ptr<Command_begin_transaction_impl>>(m_commands[command_type]);
+            break;
+        case Type::commit_transaction:
+            result = std::any_cast<std::shared_ptr<Command_commit_transaction_impl>>(m_commands[command_type]);
+            break;
+        case Type::rollback_transaction:
+            result = std::any_cast<std::shared_ptr<Command_rollback_transaction_impl>>(m_commands[command_type]);
+            break;
+        case Type::savepoint:
+            result = std::any_cast<std::shared_ptr<Command_savepoint_impl>>(m_commands[command_type]);
+            break;
+        case Type::release_savepoint:
+            result = std::any_cast<std::shared_ptr<Command_release_savepoint_impl>>(m_commands[command_type]);
+            break;
+        case Type::rollback_to_savepoint:
+            result = std::any_cast<std::shared_ptr<Command_rollback_to_savepoint_impl>>(m_commands[command_type]);
+            break;
         }        
 
        return result;
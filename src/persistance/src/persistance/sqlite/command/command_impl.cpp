@@ -58,387 +58,6 @@ void Command_base_database_sqlite::reset()
 	sqlite3_clear_bindings(m_stmt);
 }
 
-// -----------------------------------------------------------------------------------------------
-
-Command_banned_user_and_ip_impl::Command_banned_user_and_ip_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle,
-		"SELECT user, ip FROM banned_users_connections WHERE user = :user AND ip = :ip;",
-		-1, &m_stmt, NULL);
-}
-
-std::any Command_banned_user_and_ip_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::string}, {Column_sqlite::string }} };
-	return command;
-}
-
-void Command_banned_user_and_ip_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::array<std::string, 2>>(m_params);
-	bind_param(m_stmt, ":user", casted_params[0]);
-	bind_param(m_stmt, ":ip", casted_params[1]);
-}
-
-// -----------------------------------------------------------------------------------------------
-
-Command_banned_api_ip_impl::Command_banned_api_ip_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT ip FROM banned_connections_api WHERE ip = :ip;", -1, &m_stmt, NULL);
-}
-
-std::any Command_banned_api_ip_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::string}} };
-	return command;
-}
-
-void Command_banned_api_ip_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::string>(m_params);
-	bind_param(m_stmt, ":ip", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-
-Command_account_exists_impl::Command_account_exists_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT COUNT(name) FROM account WHERE name = :name;", -1, &m_stmt, NULL);
-}
-
-std::any Command_account_exists_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::int32}} };
-	return command;
-}
-
-void Command_account_exists_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::string>(m_params);
-	bind_param(m_stmt, ":name", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_account_impl::Command_get_account_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT name, created_at, last_active, connection_count, shares, hashrate, display_name FROM account WHERE name = :name;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_account_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		{Column_sqlite::string},
-		{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::double_t},
-		{Column_sqlite::double_t},
-		{Column_sqlite::string}} };
-	return command;
-}
-
-void Command_get_account_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::string>(m_params);
-	bind_param(m_stmt, ":name", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-
-Command_get_blocks_impl::Command_get_blocks_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	if (sqlite3_prepare_v2(m_handle, "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block ORDER BY height DESC LIMIT 100;", -1, &m_stmt, NULL) != SQLITE_OK)
-	{
-		std::cout << sqlite3_errmsg(m_handle) << std::endl;
-	}
-}
-
-std::any Command_get_blocks_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string}, 
-		{Column_sqlite::int32}, 
-		{Column_sqlite::string},
-		{Column_sqlite::double_t},
-		{Column_sqlite::int32},
-		{Column_sqlite::string}, 
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::double_t}} };
-	return command;
-}
-// -----------------------------------------------------------------------------------------------
-
-Command_get_latest_round_impl::Command_get_latest_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT round_number, total_shares, total_reward, blocks, start_date_time, end_date_time, is_active, is_paid FROM round ORDER BY round_number DESC LIMIT 1;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_latest_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::int64},
-		{Column_sqlite::double_t},
-		{Column_sqlite::double_t},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::int32}} };
-	return command;
-}
-
-// -----------------------------------------------------------------------------------------------
-
-Command_get_round_impl::Command_get_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT round_number, total_shares, total_reward, blocks, start_date_time, end_date_time, is_active, is_paid FROM round WHERE round_number = :round_number;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::int64},
-		{Column_sqlite::double_t},
-		{Column_sqlite::double_t},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::int32}} };
-	return command;
-}
-
-void Command_get_round_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::int64_t>(m_params);
-	bind_param(m_stmt, ":round_number", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-
-Command_get_payments_impl::Command_get_payments_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE name = :name;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_payments_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		{Column_sqlite::double_t},
-		{Column_sqlite::double_t},
-		{Column_sqlite::string},
-		{Column_sqlite::int64},
-		{Column_sqlite::string}} };
-	return command;
-}
-
-void Command_get_payments_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::string>(m_params);
-	bind_param(m_stmt, ":name", casted_params);
-}
-// -----------------------------------------------------------------------------------------------
-
-Command_get_config_impl::Command_get_config_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT version, difficulty_divider, fee, mining_mode, round_duration_hours FROM config;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_config_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::int32}} };
-	return command;
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_active_accounts_from_round_impl::Command_get_active_accounts_from_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT name, shares FROM account WHERE shares > 0;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_active_accounts_from_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		{Column_sqlite::double_t}} };
-	return command;
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_blocks_from_round_impl::Command_get_blocks_from_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block WHERE round = :round;", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_blocks_from_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::double_t},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::int32},
-		{Column_sqlite::string},
-		{Column_sqlite::double_t}} };
-	return command;
-}
-
-void Command_get_blocks_from_round_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::int64_t>(m_params);
-	bind_param(m_stmt, ":round", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_total_shares_from_accounts_impl::Command_get_total_shares_from_accounts_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT SUM(shares) FROM account", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_total_shares_from_accounts_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::double_t}} };
-	return command;
-}
-// -----------------------------------------------------------------------------------------------
-Command_get_not_paid_data_from_round_impl::Command_get_not_paid_data_from_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE round = :round AND payment_date_time = ''", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_not_paid_data_from_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::string},
-		 {Column_sqlite::double_t},
-		 {Column_sqlite::double_t},
-		 {Column_sqlite::string},
-		 {Column_sqlite::int64},
-		 {Column_sqlite::string}}};
-	return command;
-}
-
-void Command_get_not_paid_data_from_round_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::int64_t>(m_params);
-	bind_param(m_stmt, ":round", casted_params);
-}
-// -----------------------------------------------------------------------------------------------
-Command_get_unpaid_rounds_impl::Command_get_unpaid_rounds_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT round_number FROM round WHERE is_paid = 0 AND is_active = 0", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_unpaid_rounds_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::int64}} };
-	return command;
-}
-// -----------------------------------------------------------------------------------------------
-
-Command_get_blocks_without_hash_from_round_impl::Command_get_blocks_without_hash_from_round_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT height FROM block WHERE hash = '' AND round = :round", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_blocks_without_hash_from_round_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::int32}} };
-	return command;
-}
-
-void Command_get_blocks_without_hash_from_round_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::int64_t>(m_params);
-	bind_param(m_stmt, ":round", casted_params);
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_pool_hashrate_impl::Command_get_pool_hashrate_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT SUM(hashrate) FROM account WHERE datetime(last_active) >= datetime('now', '-10 Minute')", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_pool_hashrate_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt}, {{Column_sqlite::double_t}} };
-	return command;
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_longest_chain_finder_impl::Command_get_longest_chain_finder_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT height, share_difficulty, block_finder, round, account.display_name FROM block INNER JOIN account ON block.block_finder=account.name WHERE block.orphan = 0 ORDER BY share_difficulty DESC LIMIT 1", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_longest_chain_finder_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::int32},
-		 {Column_sqlite::double_t},
-		 {Column_sqlite::string},
-		 {Column_sqlite::int64},
-		 {Column_sqlite::string}} };
-	return command;
-}
-
-// -----------------------------------------------------------------------------------------------
-Command_get_top_block_finders_impl::Command_get_top_block_finders_impl(sqlite3* handle)
-	: Command_base_database_sqlite{ handle }
-{
-	sqlite3_prepare_v2(m_handle, "SELECT COUNT(*) as num_blocks, account.display_name FROM block INNER JOIN account ON block.block_finder=account.name GROUP BY block_finder ORDER BY num_blocks DESC LIMIT :limit", -1, &m_stmt, NULL);
-}
-
-std::any Command_get_top_block_finders_impl::get_command() const
-{
-	Command_type_sqlite command{ {m_stmt},
-		{{Column_sqlite::int32},
-		 {Column_sqlite::string}} };
-	return command;
-}
-
-void Command_get_top_block_finders_impl::set_params(std::any params)
-{
-	m_params = std::move(params);
-	auto casted_params = std::any_cast<std::int32_t>(m_params);
-	bind_param(m_stmt, ":limit", casted_params);
-}
-
 // -----------------------------------------------------------------------------------------------
 // Write commands
 // -----------------------------------------------------------------------------------------------
@@ -725,6 +344,77 @@ void Command_update_block_share_difficulty_impl::set_params(std::any params)
 	bind_param(m_stmt, ":share_difficulty", casted_params.m_share_difficulty);
 }
 
+// -----------------------------------------------------------------------------------------------
+Command_add_shares_to_account_impl::Command_add_shares_to_account_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string add_shares_to_account{ R"(UPDATE account SET 
+			last_active = :last_active, shares = shares + :shares, 
+			hashrate = CASE WHEN :update_hashrate = 1 THEN :hashrate ELSE hashrate END
+			WHERE name = :name)" };
+
+	sqlite3_prepare_v2(m_handle, add_shares_to_account.c_str(), -1, &m_stmt, NULL);
+}
+
+void Command_add_shares_to_account_impl::set_params(std::any params)
+{
+	m_params = std::move(params);
+	auto casted_params = std::any_cast<Command_add_shares_to_account_params>(m_params);
+	bind_param(m_stmt, ":last_active", casted_params.m_last_active);
+	bind_param(m_stmt, ":shares", casted_params.m_shares);
+	bind_param(m_stmt, ":hashrate", casted_params.m_hashrate);
+	bind_param(m_stmt, ":update_hashrate", casted_params.m_update_hashrate);
+	bind_param(m_stmt, ":name", casted_params.m_name);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_begin_transaction_impl::Command_begin_transaction_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string begin_transaction{ R"(BEGIN TRANSACTION)" };
+	sqlite3_prepare_v2(m_handle, begin_transaction.c_str(), -1, &m_stmt, NULL);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_commit_transaction_impl::Command_commit_transaction_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string commit_transaction{ R"(COMMIT TRANSACTION)" };
+	sqlite3_prepare_v2(m_handle, commit_transaction.c_str(), -1, &m_stmt, NULL);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_rollback_transaction_impl::Command_rollback_transaction_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string rollback_transaction{ R"(ROLLBACK TRANSACTION)" };
+	sqlite3_prepare_v2(m_handle, rollback_transaction.c_str(), -1, &m_stmt, NULL);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_savepoint_impl::Command_savepoint_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string savepoint{ R"(SAVEPOINT nested)" };
+	sqlite3_prepare_v2(m_handle, savepoint.c_str(), -1, &m_stmt, NULL);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_release_savepoint_impl::Command_release_savepoint_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string release_savepoint{ R"(RELEASE SAVEPOINT nested)" };
+	sqlite3_prepare_v2(m_handle, release_savepoint.c_str(), -1, &m_stmt, NULL);
+}
+
+// -----------------------------------------------------------------------------------------------
+Command_rollback_to_savepoint_impl::Command_rollback_to_savepoint_impl(sqlite3* handle)
+	: Command_base_database_sqlite{ handle }
+{
+	std::string rollback_to_savepoint{ R"(ROLLBACK TO SAVEPOINT nested)" };
+	sqlite3_prepare_v2(m_handle, rollback_to_savepoint.c_str(), -1, &m_stmt, NULL);
+}
+
 
 }
 }
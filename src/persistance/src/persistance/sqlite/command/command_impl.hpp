@@ -37,198 +37,6 @@ protected:
 };
 
 
-class Command_banned_user_and_ip_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_banned_user_and_ip_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_banned_user_and_ip; }
-	void set_params(std::any params) override;
-};
-
-class Command_banned_api_ip_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_banned_api_ip_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_banned_api_ip; }
-	void set_params(std::any params) override;
-};
-
-class Command_account_exists_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_account_exists_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::account_exists; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_account_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_account_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_account; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_blocks_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_blocks_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_blocks; }
-};
-
-class Command_get_latest_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_latest_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_latest_round; }
-};
-
-class Command_get_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_round; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_payments_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_payments_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_payments; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_config_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_config_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_config; }
-};
-
-class Command_get_active_accounts_from_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_active_accounts_from_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_active_accounts_from_round; }
-};
-
-class Command_get_blocks_from_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_blocks_from_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_blocks_from_round; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_total_shares_from_accounts_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_total_shares_from_accounts_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_total_shares_from_accounts; }
-};
-
-class Command_get_not_paid_data_from_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_not_paid_data_from_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_not_paid_data_from_round; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_unpaid_rounds_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_unpaid_rounds_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_unpaid_rounds; }
-};
-
-class Command_get_blocks_without_hash_from_round_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_blocks_without_hash_from_round_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_blocks_without_hash_from_round; }
-	void set_params(std::any params) override;
-};
-
-class Command_get_pool_hashrate_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_pool_hashrate_impl(sqlite3* handle);
-
-	Type get_type() const override { return Type::get_pool_hashrate; }
-	std::any get_command() const override;
-
-};
-
-class Command_get_longest_chain_finder_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_longest_chain_finder_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_longest_chain_finder; }
-};
-
-class Command_get_top_block_finders_impl : public Command_base_database_sqlite
-{
-public:
-
-	explicit Command_get_top_block_finders_impl(sqlite3* handle);
-
-	std::any get_command() const override;
-	Type get_type() const override { return Type::get_top_block_finders; }
-	void set_params(std::any params) override;
-};
-
-
 // ------------------------------------------------------------------------------------
 // Write commands
 struct Command_create_account_params
@@ -244,7 +52,7 @@ public:
 	explicit Command_create_account_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::create_account; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -265,7 +73,7 @@ public:
 	explicit Command_add_payment_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::add_payment; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -276,7 +84,7 @@ public:
 	explicit Command_create_round_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::create_round; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -297,7 +105,7 @@ public:
 	explicit Command_update_account_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_account; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -316,7 +124,7 @@ public:
 	explicit Command_create_config_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::create_config; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -327,7 +135,7 @@ public:
 	explicit Command_update_config_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_config; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -338,7 +146,7 @@ public:
 	explicit Command_reset_shares_from_accounts_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::reset_shares_from_accounts; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 };
 
 struct Command_add_block_params
@@ -361,7 +169,7 @@ public:
 	explicit Command_add_block_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::add_block; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
  };
 
@@ -379,7 +187,7 @@ public:
 	explicit Command_update_block_rewards_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_block_rewards; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -400,7 +208,7 @@ public:
 	explicit Command_update_round_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_round; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -418,7 +226,7 @@ public:
 	explicit Command_account_paid_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::account_paid; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -435,7 +243,7 @@ public:
 	explicit Command_update_block_hash_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_block_hash; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -453,7 +261,7 @@ public:
 	explicit Command_update_reward_of_payment_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_reward_of_payment; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
@@ -464,7 +272,7 @@ public:
 	explicit Command_delete_empty_payments_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::delete_empty_payments; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 
 };
 
@@ -481,10 +289,90 @@ public:
 	explicit Command_update_block_share_difficulty_impl(sqlite3* handle);
 
 	Type get_type() const override { return Type::update_block_share_difficulty; }
-	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, {}, Command_type_sqlite::Type::no_result }; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
 	void set_params(std::any params) override;
 };
 
+struct Command_add_shares_to_account_params
+{
+	std::string m_last_active;
+	double m_shares;
+	double m_hashrate;
+	int m_update_hashrate;
+	std::string m_name;
+};
+
+class Command_add_shares_to_account_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_add_shares_to_account_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::add_shares_to_account; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+	void set_params(std::any params) override;
+};
+
+class Command_begin_transaction_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_begin_transaction_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::begin_transaction; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
+class Command_commit_transaction_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_commit_transaction_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::commit_transaction; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
+class Command_rollback_transaction_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_rollback_transaction_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::rollback_transaction; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
+class Command_savepoint_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_savepoint_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::savepoint; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
+class Command_release_savepoint_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_release_savepoint_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::release_savepoint; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
+class Command_rollback_to_savepoint_impl : public Command_base_database_sqlite
+{
+public:
+
+	explicit Command_rollback_to_savepoint_impl(sqlite3* handle);
+
+	Type get_type() const override { return Type::rollback_to_savepoint; }
+	std::any get_command() const override { return Command_type_sqlite{ {m_stmt}, Command_type_sqlite::Type::no_result }; }
+};
+
 }
 }
 }
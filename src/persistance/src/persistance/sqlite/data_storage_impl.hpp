@@ -24,7 +24,6 @@ public:
 
 private:
 
-	bool exec_statement_with_result(Command_type_sqlite sql_command, Result_sqlite& result);
 	bool exec_statement(Command_type_sqlite sql_command);
 	bool exec_statements(Command_type_sqlite sql_command);
 
@@ -0,0 +1,144 @@
+#ifndef NEXUSPOOL_PERSISTANCE_SQLITE_STATEMENT_HPP
+#define NEXUSPOOL_PERSISTANCE_SQLITE_STATEMENT_HPP
+
+#include "persistance/sqlite/utils.hpp"
+#include "sqlite/sqlite3.h"
+#include <spdlog/spdlog.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace nexuspool {
+namespace persistance {
+namespace sqlite {
+
+// Parameters are bound by their position in the statement (first '?' or ':name' is 1)
+inline void bind(sqlite3_stmt* stmt, int index, std::string const& value)
+{
+	// the string outlives the step, sqlite doesn't need its own copy
+	sqlite3_bind_text(stmt, index, value.c_str(), static_cast<int>(value.size()), SQLITE_STATIC);
+}
+
+inline void bind(sqlite3_stmt* stmt, int index, double value)
+{
+	sqlite3_bind_double(stmt, index, value);
+}
+
+template<typename T>
+std::enable_if_t<std::is_integral_v<T>> bind(sqlite3_stmt* stmt, int index, T value)
+{
+	sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value));
+}
+
+// Columns are read by their position in the result row (first column is 0). NULL reads as empty string or 0
+inline void column(sqlite3_stmt* stmt, int index, std::string& value)
+{
+	auto const text = reinterpret_cast<char const*>(sqlite3_column_text(stmt, index));
+	value.assign(text ? text : "", static_cast<std::size_t>(sqlite3_column_bytes(stmt, index)));
+}
+
+inline void column(sqlite3_stmt* stmt, int index, double& value)
+{
+	value = sqlite3_column_double(stmt, index);
+}
+
+template<typename T>
+std::enable_if_t<std::is_integral_v<T>> column(sqlite3_stmt* stmt, int index, T& value)
+{
+	value = static_cast<T>(sqlite3_column_int64(stmt, index));
+}
+
+// Prepared statement with compile time types for its parameters and result rows.
+// Row is either a single column (integral, double, std::string) or a struct with a columns() overload in sqlite/utils.hpp
+template<typename Row, typename... Params>
+class Statement
+{
+public:
+
+	Statement(std::shared_ptr<spdlog::logger> logger, sqlite3* handle, char const* sql)
+		: m_logger{ std::move(logger) }
+		, m_stmt{ nullptr }
+	{
+		if (sqlite3_prepare_v2(handle, sql, -1, &m_stmt, NULL) != SQLITE_OK)
+		{
+			m_logger->error("Failed to prepare statement {}. {}", sql, sqlite3_errmsg(handle));
+		}
+	}
+
+	~Statement() { sqlite3_finalize(m_stmt); }
+
+	Statement(Statement const&) = delete;
+	Statement& operator=(Statement const&) = delete;
+
+	// Reads the first result row. Returns false if there is none
+	bool get_row(Row& row, Params const&... params)
+	{
+		bind_params(params...);
+		auto const result = sqlite3_step(m_stmt);
+		if (result == SQLITE_ROW)
+		{
+			decode(row);
+		}
+		else if (result != SQLITE_DONE)
+		{
+			m_logger->error("Sqlite step failure");
+		}
+		sqlite3_reset(m_stmt);
+		return result == SQLITE_ROW;
+	}
+
+	// Reads all result rows. Empty on failure
+	std::vector<Row> get_rows(Params const&... params)
+	{
+		std::vector<Row> rows;
+		bind_params(params...);
+		int result;
+		while ((result = sqlite3_step(m_stmt)) == SQLITE_ROW)
+		{
+			decode(rows.emplace_back());
+		}
+		if (result != SQLITE_DONE)
+		{
+			m_logger->error("Sqlite step failure");
+			rows.clear();
+		}
+		sqlite3_reset(m_stmt);
+		return rows;
+	}
+
+private:
+
+	void bind_params(Params const&... params)
+	{
+		[[maybe_unused]] int index{ 1 };
+		(bind(m_stmt, index++, params), ...);
+	}
+
+	void decode(Row& row)
+	{
+		if constexpr (std::is_arithmetic_v<Row> || std::is_same_v<Row, std::string>)
+		{
+			column(m_stmt, 0, row);
+		}
+		else
+		{
+			std::apply([this](auto&... members)
+			{
+				int index{ 0 };
+				(column(m_stmt, index++, members), ...);
+			}, columns(row));
+		}
+	}
+
+	std::shared_ptr<spdlog::logger> m_logger;
+	sqlite3_stmt* m_stmt;
+};
+
+}
+}
+}
+
+#endif
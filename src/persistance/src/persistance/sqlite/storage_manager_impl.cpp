@@ -1,9 +1,65 @@
 #include "persistance/sqlite/storage_manager_impl.hpp"
 #include <spdlog/spdlog.h>
 #include <sqlite/sqlite3.h>
+#include <string>
 
 namespace nexuspool {
 namespace persistance {
+namespace
+{
+bool execute(sqlite3* handle, char const* sql)
+{
+	return sqlite3_exec(handle, sql, NULL, NULL, NULL) == SQLITE_OK;
+}
+
+bool has_column(sqlite3* handle, std::string const& table, std::string const& column)
+{
+	// preparing fails for an unknown column
+	sqlite3_stmt* stmt{ nullptr };
+	auto const sql = "SELECT " + column + " FROM " + table + " LIMIT 0;";
+	auto const result = sqlite3_prepare_v2(handle, sql.c_str(), -1, &stmt, 0) == SQLITE_OK;
+	sqlite3_finalize(stmt);
+	return result;
+}
+
+bool add_block_share_difficulty(sqlite3* handle)
+{
+	// dbs created with version 1.1 or later already have the column
+	if (has_column(handle, "block", "share_difficulty"))
+	{
+		return true;
+	}
+	return execute(handle, "ALTER TABLE block ADD COLUMN share_difficulty REAL;") &&
+		execute(handle, "UPDATE config SET version = '1.1';");
+}
+
+bool add_indexes(sqlite3* handle)
+{
+	// one index per hot query of the commands, without them every lookup scans the whole table
+	return execute(handle, R"(
+		CREATE INDEX IF NOT EXISTS block_round_hash ON block(round, hash);
+		CREATE INDEX IF NOT EXISTS block_hash ON block(hash);
+		CREATE INDEX IF NOT EXISTS block_height ON block(height);
+		CREATE INDEX IF NOT EXISTS payment_name_round ON payment(name, round);
+		CREATE INDEX IF NOT EXISTS payment_round_payment_date_time ON payment(round, payment_date_time);
+		CREATE INDEX IF NOT EXISTS account_shares ON account(shares, name) WHERE shares > 0;)");
+}
+
+// Schema migrations in ascending version order. The version of the latest applied migration is stored in the
+// user_version of the db. Dbs created before the versioning have user_version 0 and may already contain parts of the
+// schema, therefore every migration has to be idempotent. New schema changes are appended with the next version
+struct Migration
+{
+	int m_version;
+	char const* m_description;
+	bool (*m_apply)(sqlite3* handle);
+};
+
+Migration const migrations[]{
+	{ 1, "share_difficulty of blocks", add_block_share_difficulty },
+	{ 2, "indexes for block, payment and account queries", add_indexes }
+};
+}
 
 Storage_manager_sqlite::Storage_manager_sqlite(std::shared_ptr<spdlog::logger> logger, std::string db_name, bool readonly)
     : m_logger{ std::move(logger) }
@@ -95,7 +151,11 @@ void Storage_manager_sqlite::start()
 		  round_duration_hours INTEGER NOT NULL
 		);)", NULL, NULL, NULL);
 
-	update_db_schema();
+	// the reading connections only use the schema the writing connection created
+	if (!m_readonly)
+	{
+		update_db_schema();
+	}
 }
 
 void Storage_manager_sqlite::stop()
@@ -107,19 +167,31 @@ void Storage_manager_sqlite::stop()
 void Storage_manager_sqlite::update_db_schema()
 {
 	sqlite3_stmt* stmt;
-	sqlite3_prepare_v2(m_handle, "SELECT version FROM config;", -1, &stmt, 0);
-	int ret;
-	std::string version;
-	while ((ret = sqlite3_step(stmt)) == SQLITE_ROW)
+	sqlite3_prepare_v2(m_handle, "PRAGMA user_version;", -1, &stmt, 0);
+	int version{ 0 };
+	if (sqlite3_step(stmt) == SQLITE_ROW)
 	{
-		version = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+		version = sqlite3_column_int(stmt, 0);
 	}
+	sqlite3_finalize(stmt);
 
-	if (version == "1.0")
+	for (auto const& migration : migrations)
 	{
-		m_logger->info("Updating DB schema to version 1.1");
-		sqlite3_exec(m_handle, R"(ALTER TABLE block ADD COLUMN share_difficulty REAL;)", NULL, NULL, NULL);
-		sqlite3_exec(m_handle, R"(UPDATE config SET version = '1.1';)", NULL, NULL, NULL);
+		if (migration.m_version <= version)
+		{
+			continue;
+		}
+
+		m_logger->info("Updating DB schema to version {} ({})", migration.m_version, migration.m_description);
+		// the migration and its version are committed together, an aborted migration is repeated on the next start
+		auto const set_version = "PRAGMA user_version = " + std::to_string(migration.m_version) + ";";
+		if (!execute(m_handle, "BEGIN TRANSACTION;") || !migration.m_apply(m_handle) ||
+			!execute(m_handle, set_version.c_str()) || !execute(m_handle, "COMMIT;"))
+		{
+			m_logger->critical("Failed to update DB schema to version {}: {}", migration.m_version, sqlite3_errmsg(m_handle));
+			execute(m_handle, "ROLLBACK;");
+			std::exit(1);   // the commands don't work with an outdated schema
+		}
 	}
 }
 
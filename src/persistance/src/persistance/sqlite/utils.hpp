@@ -2,23 +2,58 @@
 #define NEXUSPOOL_PERSISTANCE_SQLITE_UTILS_HPP
 
 #include "persistance/types.hpp"
-#include "persistance/sqlite/types.hpp"
-#include "sqlite/sqlite3.h"
-#include <chrono>
-#include <string>
+#include <tuple>
 
-namespace nexuspool 
+namespace nexuspool
 {
-namespace persistance 
+namespace persistance
 {
 
-Account_data convert_to_account_data(Row_sqlite row);
-Block_data convert_to_block_data(Row_sqlite row);
-Round_data convert_to_round_data(Row_sqlite row);
-Payment_data convert_to_payment_data(Row_sqlite row);
-Config_data convert_to_config_data(Row_sqlite row);
-Statistics_block_finder convert_to_statistics_block_finder(Row_sqlite row);
-Statistics_top_block_finder convert_to_statistics_top_block_finder(Row_sqlite row);
+// Members of the result structs in the column order of the SELECT statements which read them.
+// sqlite::Statement decodes the columns of a result row directly into these members
+
+inline auto columns(Account_data& data)
+{
+	return std::tie(data.m_address, data.m_created_at, data.m_last_active, data.m_connections, data.m_shares,
+		data.m_hashrate, data.m_display_name);
+}
+
+inline auto columns(Account_data_for_payment& data)
+{
+	return std::tie(data.m_address, data.m_shares);
+}
+
+inline auto columns(Block_data& data)
+{
+	return std::tie(data.m_hash, data.m_height, data.m_type, data.m_difficulty, data.m_orphan, data.m_block_finder,
+		data.m_round, data.m_block_found_time, data.m_mainnet_reward);
+}
+
+inline auto columns(Round_data& data)
+{
+	return std::tie(data.m_round, data.m_total_shares, data.m_total_rewards, data.m_blocks, data.m_start_date_time,
+		data.m_end_date_time, data.m_is_active, data.m_is_paid);
+}
+
+inline auto columns(Payment_data& data)
+{
+	return std::tie(data.m_account, data.m_amount, data.m_shares, data.m_payment_date_time, data.m_round, data.m_tx_id);
+}
+
+inline auto columns(Config_data& data)
+{
+	return std::tie(data.m_version, data.m_difficulty_divider, data.m_fee, data.m_mining_mode, data.m_round_duration_hours);
+}
+
+inline auto columns(Statistics_block_finder& data)
+{
+	return std::tie(data.m_height, data.m_difficulty, data.m_account, data.m_round, data.m_display_name);
+}
+
+inline auto columns(Statistics_top_block_finder& data)
+{
+	return std::tie(data.m_num_blocks, data.m_display_name);
+}
 
 }
 }
@@ -13,6 +13,7 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -26,6 +27,7 @@ namespace nexuspool
 	Pool::Pool()
 		: m_io_context{ std::make_shared<::asio::io_context>() }
 		, m_signals{ std::make_shared<::asio::signal_set>(*m_io_context) }
+		, m_stopped{ false }
 	{
 		m_config = config::create_config();
 		m_api_config = config::create_api_config();
@@ -55,6 +57,12 @@ namespace nexuspool
 
 	void Pool::stop()
 	{
+		// the storage is stopped with the first stop, a second share flush would write to a stopped storage thread
+		if (m_stopped.exchange(true))
+		{
+			return;
+		}
+
 		if (m_api_component)
 		{
 			m_api_component->stop();
@@ -65,6 +73,12 @@ namespace nexuspool
 			m_pool_manager->stop();
 		}
 
+		// the pool_manager writes the remaining shares during stop -> stop the storage after it
+		if (m_persistance_component)
+		{
+			m_persistance_component->stop();
+		}
+
 		m_io_context->stop();
 	}
 
@@ -143,7 +157,7 @@ namespace nexuspool
 			m_api_config->set_nxs_api_pw(m_config->get_pool_config().m_nxs_api_pw);
 
 			m_api_component = api::create_component(m_logger,
-				m_persistance_component->get_data_reader_factory()->create_data_reader(), 
+				m_persistance_component->get_data_reader_factory(), 
 				m_api_config, 
 				m_pool_api_data_exchange, 
 				m_timer_component->get_timer_factory());
@@ -164,6 +178,27 @@ namespace nexuspool
 		}
 
 		m_pool_manager->start();
+
+		std::uint32_t io_threads = m_config->get_io_threads();
+		if (io_threads == 0)
+		{
+			io_threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+		m_logger->info("Running io_context with {} threads", io_threads);
+
+		// the calling thread is also running the io_context
+		for (std::uint32_t i = 1; i < io_threads; ++i)
+		{
+			m_io_threads.emplace_back([this]() { m_io_context->run(); });
+		}
 		m_io_context->run();
+
+		for (auto& io_thread : m_io_threads)
+		{
+			if (io_thread.joinable())
+			{
+				io_thread.join();
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -8,8 +8,11 @@
 #include <spdlog/spdlog.h>
 #include <asio/signal_set.hpp>
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace asio { class io_context; }
 namespace nexuspool
@@ -41,6 +44,7 @@ private:
 	chrono::Component::Uptr m_timer_component;
 	std::shared_ptr<network::Socket> m_listen_socket;
 	std::shared_ptr<::asio::io_context> m_io_context;
+	std::vector<std::thread> m_io_threads;		// additional threads running the io_context
 	std::shared_ptr<spdlog::logger> m_logger;
 	std::shared_ptr<common::Pool_api_data_exchange> m_pool_api_data_exchange;
 	std::shared_ptr<Pool_manager> m_pool_manager;
@@ -50,6 +54,7 @@ private:
 	std::unique_ptr<api::Component> m_api_component;
 
 	std::shared_ptr<::asio::signal_set> m_signals;
+	std::atomic_bool m_stopped;		// stop() runs from the signal handler and again from the destructor
 };
 
 }
@@ -11,6 +11,7 @@ namespace nexuspool
 {
 namespace LLP { class CBlock; }
 class Pool_manager;
+class Work_message;
 
 class Miner_connection
 {
@@ -20,10 +21,14 @@ public:
     virtual ~Miner_connection() = default;
 
     virtual void stop() = 0;
-    virtual void send_work(LLP::CBlock const& block) = 0;
+    // work_message is serialized once for all miners, only the fields of the job (work_id, nonce_range, pool nbits) are patched per miner
+    virtual void send_work(std::shared_ptr<Work_message const> work_message, Nonce_range const& nonce_range) = 0;
+    // false if the miner doesn't take work from the work template -> no nonce range is assigned to it
+    virtual bool takes_work() const = 0;
     virtual network::Connection::Handler connection_handler() = 0;
     virtual void get_hashrate() = 0;
-    virtual void send_pool_notification(std::string message) = 0;
+    // notification is an already serialized POOL_NOTIFICATION packet shared by all miners
+    virtual void send_pool_notification(network::Shared_payload notification) = 0;
 };
 
 Miner_connection::Sptr create_miner_connection(std::shared_ptr<spdlog::logger> logger,
@@ -2,6 +2,7 @@
 #define NEXUSPOOL_POOL_MANAGER_HPP
 
 #include "LLP/block.hpp"
+#include "LLP/block_hash_context.hpp"
 #include "pool/types.hpp"
 #include "reward/component.hpp"
 #include "persistance/data_writer_factory.hpp"
@@ -10,6 +11,7 @@
 #include "chrono/timer_factory.hpp"
 #include "config/config.hpp"
 #include "network/socket_factory.hpp"
+#include "network/connection.hpp"
 #include "common/pool_api_data_exchange.hpp"
 
 #include <memory>
@@ -36,7 +38,8 @@ public:
 
     // Methods towards miner_connection
     virtual void get_block(Get_block_handler&& handler) = 0;
-    virtual void submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler) = 0;
+    // the handler of a validated share runs on the strand of the miner connection
+    virtual void submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context, network::Connection::Sptr connection, Submit_block_handler handler) = 0;
     virtual std::uint32_t get_pool_nbits() const = 0;
 };
 
@@ -7,6 +7,7 @@
 #include "pool/types.hpp"
 #include "persistance/types.hpp"
 #include "LLP/block.hpp"
+#include "LLP/block_hash_context.hpp"
 
 namespace nexuspool
 {
@@ -21,6 +22,17 @@ struct Session_user
 	std::chrono::steady_clock::time_point m_login_time;
 };
 
+// Work sent to a miner. Submitted shares reference the job with its work_id
+struct Session_job
+{
+	std::uint32_t m_work_id{ 0U };		// 0 is invalid
+	std::shared_ptr<LLP::CBlock const> m_block;
+	Nonce_range m_nonce_range;			// invalid range -> no nonce range assigned (legacy miners)
+	std::uint32_t m_pool_nbits{ 0U };
+	double m_share_weight{ 1.0 };		// shares credited for one accepted share of this job (vardiff)
+	LLP::Block_hash_context::Sptr m_hash_context;	// hash channel only
+};
+
 // Holds relevant user data and miner_connection
 class Session
 {
@@ -34,11 +46,16 @@ public:
 	virtual void update_user_data(Session_user const& user_data) = 0;
 	virtual std::chrono::steady_clock::time_point get_update_time() const = 0;
 	virtual void set_update_time(std::chrono::steady_clock::time_point update_time) = 0;
-	virtual bool add_share() = 0;
+	// share_weight of the job the share was submitted for
+	virtual bool add_share(double share_weight) = 0;
 	virtual void reset_shares() = 0;
 	virtual void update_hashrate(double hashrate, std::uint32_t pool_nbits, std::uint32_t network_nbits) = 0;
-	virtual void set_block(LLP::CBlock const& block) = 0;
-	virtual std::unique_ptr<LLP::CBlock> get_block() = 0;
+	// retargets the share difficulty (vardiff) before new work is sent. Returns the nbits for the work of this session
+	virtual std::uint32_t retarget_difficulty(std::uint32_t pool_nbits, std::uint32_t network_nbits) = 0;
+	// the job stores the share weight of the latest retarget. The most recent jobs are kept, jobs of a lower height expire when a job for a new height is added. Returns the work_id
+	virtual std::uint32_t add_job(std::shared_ptr<LLP::CBlock const> block, Nonce_range const& nonce_range, std::uint32_t pool_nbits) = 0;
+	virtual bool get_job(std::uint32_t work_id, Session_job& job) const = 0;
+	virtual bool get_latest_job(Session_job& job) const = 0;
 	virtual bool is_inactive() const = 0;
 	virtual void set_inactive() = 0;
 	virtual bool is_need_work() const = 0;
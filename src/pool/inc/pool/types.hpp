@@ -11,8 +11,6 @@
 
 namespace nexuspool
 {
-    using Get_block_handler = std::function<void(LLP::CBlock const& block)>;
-
     enum class Submit_block_result : std::uint8_t
     {
         accept = 0, 
@@ -21,7 +19,19 @@ namespace nexuspool
     };
     using Submit_block_handler = std::function<void(Submit_block_result result)>;
 
-    using Session_key = uint256_t;
+    using Session_key = std::uint64_t;     // compact, sequential id of a session. 0 is invalid
+
+    // Disjoint part of the nonce space of a work template assigned to one session
+    struct Nonce_range
+    {
+        std::uint64_t m_start{ 0U };
+        std::uint64_t m_end{ 0U };     // exclusive
+
+        bool is_valid() const { return m_end > m_start; }
+        bool contains(std::uint64_t nonce) const { return nonce >= m_start && nonce < m_end; }
+    };
+
+    using Get_block_handler = std::function<void(LLP::CBlock const& block)>;
 }
 
 #endif
\ No newline at end of file
@@ -4,8 +4,11 @@
 #include <cstdint>
 #include <chrono>
 #include <array>
+#include <algorithm>
+#include <functional>
 #include "common/types.hpp"
 #include "LLP/utils.hpp"
+#include "LLC/types/uint1024.h"
 #include <spdlog/spdlog.h>
 
 namespace nexuspool
@@ -13,17 +16,22 @@ namespace nexuspool
 class Hashrate_helper
 {
 public:
-	Hashrate_helper(common::Mining_mode mining_mode)
+
+	using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+	Hashrate_helper(common::Mining_mode mining_mode, Clock clock = std::chrono::steady_clock::now)
 		: m_mining_mode{ mining_mode }
-		, m_t1{ std::chrono::steady_clock::now() }
-		, m_t2{ std::chrono::steady_clock::now() }
+		, m_clock{ std::move(clock) }
+		, m_t1{ m_clock() }
+		, m_t2{ m_t1 }
 		, m_share_timepoints{}
 		, m_current_timepoint_index{ 0U }
 	{}
 
-	void add_share()
+	// returns true if a window of shares is complete and the average share time has been updated
+	bool add_share()
 	{
-		m_t2 = std::chrono::steady_clock::now();
+		m_t2 = m_clock();
 		m_share_timepoints[m_current_timepoint_index] = std::chrono::duration_cast<std::chrono::milliseconds>(m_t2 - m_t1);
 		m_current_timepoint_index++;
 		m_t1 = m_t2;
@@ -37,7 +45,23 @@ public:
 				total_time += time;
 			}
 			m_average_time = total_time / m_share_timepoints.size();
-		}	
+			return true;
+		}
+		return false;
+	}
+
+	std::chrono::milliseconds get_average_share_time() const { return m_average_time; }
+
+	std::chrono::milliseconds get_time_since_last_share() const
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(m_clock() - m_t1);
+	}
+
+	// start a new window of shares (the last average share time is kept)
+	void reset_window()
+	{
+		m_t1 = m_clock();
+		m_current_timepoint_index = 0U;
 	}
 
 	double get_hashrate(std::uint32_t pool_nbits, std::uint32_t network_nbits, double prime_shares_to_blocks_ratio)
@@ -54,12 +78,128 @@ public:
 private:
 
 	common::Mining_mode m_mining_mode;
+	Clock m_clock;
 	std::chrono::steady_clock::time_point m_t1, m_t2;
 	std::array<std::chrono::milliseconds, 5U> m_share_timepoints;
 	std::chrono::milliseconds m_average_time{ 0 };
 	std::size_t m_current_timepoint_index;
 };
 
+// Variable share difficulty of one session (hash channel). The difficulty is retargeted in steps, one step doubles
+// the difficulty, so that the average time between the shares of the miner stays inside [target / 2, target * 2].
+class Vardiff
+{
+public:
+
+	static constexpr int min_step{ -8 };
+	static constexpr int max_step{ 16 };
+	// a miner without shares for idle_factor * target share time gets easier work
+	static constexpr int idle_factor{ 4 };
+
+	// shares_per_minute == 0 disables vardiff
+	explicit Vardiff(std::uint32_t shares_per_minute)
+		: m_target_share_time{ shares_per_minute > 0 ? 60000 / shares_per_minute : 0 }
+		, m_average_share_time{ 0 }
+		, m_step{ 0 }
+	{}
+
+	bool is_enabled() const { return m_target_share_time.count() > 0; }
+	int get_step() const { return m_step; }
+	// limits the step to the applied step (share difficulty is never harder than the network difficulty)
+	void set_step(int step) { m_step = std::clamp(step, min_step, max_step); }
+
+	// average time between the shares of the last complete share window
+	void set_average_share_time(std::chrono::milliseconds average_share_time) { m_average_share_time = average_share_time; }
+
+	// called before new work is sent to the miner. Returns true if the step has changed
+	bool retarget(std::chrono::milliseconds time_since_last_share)
+	{
+		if (!is_enabled())
+		{
+			return false;
+		}
+
+		auto step = m_step;
+		if (m_average_share_time.count() > 0)
+		{
+			if (m_average_share_time < m_target_share_time / 2)
+			{
+				step++;
+			}
+			else if (m_average_share_time > m_target_share_time * 2)
+			{
+				step--;
+			}
+		}
+		else if (time_since_last_share > m_target_share_time * idle_factor)
+		{
+			step--;
+		}
+
+		// every share window is only used once
+		m_average_share_time = std::chrono::milliseconds{ 0 };
+		step = std::clamp(step, min_step, max_step);
+		auto const changed = step != m_step;
+		m_step = step;
+		return changed;
+	}
+
+private:
+
+	std::chrono::milliseconds m_target_share_time;
+	std::chrono::milliseconds m_average_share_time;
+	int m_step;
+};
+
+// nbits for a share difficulty 'step' steps harder (negative = easier) than pool_nbits (hash channel).
+// The share difficulty is never harder than the network difficulty, step is updated to the applied step.
+// A step clamped to the network difficulty is less than a doubling -> weight shares with get_share_weight()
+inline std::uint32_t get_vardiff_nbits(std::uint32_t pool_nbits, std::uint32_t network_nbits, int& step)
+{
+	if (step == 0)
+	{
+		return pool_nbits;
+	}
+
+	uint1024_t target, network_target;
+	target.SetCompact(pool_nbits);
+	network_target.SetCompact(network_nbits);
+	if (step > 0)
+	{
+		int applied_step = 0;
+		while (applied_step < step && target > network_target)
+		{
+			target >>= 1;
+			applied_step++;
+			// pool_nbits may not be an exact multiple of the network target (compact format)
+			if (target < network_target)
+			{
+				target = network_target;
+			}
+		}
+		step = applied_step;
+	}
+	else
+	{
+		int applied_step = 0;
+		// stop before the target overflows
+		while (applied_step > step && ((target << 1) >> 1) == target)
+		{
+			target <<= 1;
+			applied_step--;
+		}
+		step = applied_step;
+	}
+
+	return target.GetCompact();
+}
+
+// difficulty of share_nbits relative to pool_nbits (hash channel)
+inline double get_share_weight(std::uint32_t pool_nbits, std::uint32_t share_nbits)
+{
+	return get_difficulty(share_nbits, 2) / get_difficulty(pool_nbits, 2);
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "pool/broadcast.hpp"
+#include "LLP/packet.hpp"
+#include "LLP/pool_protocol.hpp"
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <iterator>
+#include <string_view>
+
+namespace nexuspool
+{
+
+namespace
+{
+void append(network::Payload& payload, std::string_view text)
+{
+	payload.insert(payload.end(), text.begin(), text.end());
+}
+
+void append_number(network::Payload& payload, std::uint64_t value)
+{
+	char buffer[20];
+	auto const result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+	payload.insert(payload.end(), std::begin(buffer), result.ptr);
+}
+}
+
+Work_message::Work_message(LLP::CBlock const& block, std::uint32_t pool_nbits)
+	: m_block{ std::make_shared<LLP::CBlock const>(block) }
+	, m_pool_nbits{ pool_nbits }
+	, m_packet_json_block{}
+	, m_packet_binary_head{}
+	, m_packet_binary_block{}
+{
+	// the pool nbits (prepended to the block) and the block nonce differ per miner
+	auto const block_bytes = m_block->serialize();
+	auto const block_nonce_index = block_bytes.size() - sizeof(m_block->nNonce);
+	m_packet_json_block = std::make_shared<network::Payload>();
+	m_packet_json_block->reserve(block_nonce_index * 4);
+	for (std::size_t i = 0; i < block_nonce_index; ++i)
+	{
+		m_packet_json_block->push_back(',');
+		append_number(*m_packet_json_block, block_bytes[i]);
+	}
+
+	pool_protocol_v3::Work work;
+	work.m_pool_nbits = m_pool_nbits;
+	work.m_block = *m_block;
+	Packet packet_binary{ Packet::WORK, pool_protocol_v3::encode_work(work) };
+	auto const packet_binary_bytes = packet_binary.get_bytes();
+	auto const binary_block_index = packet_header_size + pool_protocol_v3::work_block_index;
+	m_packet_binary_head.assign(packet_binary_bytes->begin(), packet_binary_bytes->begin() + binary_block_index);
+	m_packet_binary_block = std::make_shared<network::Payload>(packet_binary_bytes->begin() + binary_block_index,
+		packet_binary_bytes->end() - sizeof(LLP::CBlock::nNonce));
+}
+
+network::Payload_sequence Work_message::get_payload(Session_job const& job, std::uint8_t protocol_version) const
+{
+	if (protocol_version >= pool_protocol_v3::version)
+	{
+		return get_payload_binary(job);
+	}
+	return get_payload_json(job);
+}
+
+network::Payload_sequence Work_message::get_payload_binary(Session_job const& job) const
+{
+	auto head = std::make_shared<network::Payload>(m_packet_binary_head);
+	pool_protocol_v3::write_uint32(*head, packet_header_size + pool_protocol_v3::work_id_index, job.m_work_id);
+	pool_protocol_v3::write_uint32(*head, packet_header_size + pool_protocol_v3::work_pool_nbits_index, job.m_pool_nbits);
+	pool_protocol_v3::write_uint64(*head, packet_header_size + pool_protocol_v3::work_nonce_start_index, job.m_nonce_range.m_start);
+	pool_protocol_v3::write_uint64(*head, packet_header_size + pool_protocol_v3::work_nonce_end_index, job.m_nonce_range.m_end);
+
+	// the block nonce of every miner starts at its nonce range
+	auto block_nonce = std::make_shared<network::Payload>(sizeof(LLP::CBlock::nNonce));
+	pool_protocol_v3::write_uint64(*block_nonce, 0U, job.m_nonce_range.m_start);
+
+	return network::Payload_sequence{ std::move(head), m_packet_binary_block, std::move(block_nonce) };
+}
+
+network::Payload_sequence Work_message::get_payload_json(Session_job const& job) const
+{
+	auto const& nonce_range = job.m_nonce_range;
+	// same layout as nlohmann::json::dump() of {"work_id", "block" (binary), "nonce_start", "nonce_end"}
+	// the pool nbits of every miner depend on its share difficulty (vardiff)
+	auto head = std::make_shared<network::Payload>(packet_header_size);
+	append(*head, R"({"block":{"bytes":[)");
+	auto const pool_nbits_bytes = nexuspool::uint2bytes(job.m_pool_nbits);
+	for (std::size_t i = 0; i < pool_nbits_bytes.size(); ++i)
+	{
+		if (i > 0)
+		{
+			head->push_back(',');
+		}
+		append_number(*head, pool_nbits_bytes[i]);
+	}
+
+	// the block nonce of every miner starts at its nonce range
+	auto tail = std::make_shared<network::Payload>();
+	tail->reserve(128U);
+	for (auto const nonce_byte : nexuspool::uint2bytes64(nonce_range.m_start))
+	{
+		tail->push_back(',');
+		append_number(*tail, nonce_byte);
+	}
+	append(*tail, R"(],"subtype":null},"nonce_end":)");
+	append_number(*tail, nonce_range.m_end);
+	append(*tail, R"(,"nonce_start":)");
+	append_number(*tail, nonce_range.m_start);
+	append(*tail, R"(,"work_id":)");
+	append_number(*tail, job.m_work_id);
+	tail->push_back('}');
+
+	// LLP header with the big endian length of the json
+	auto const length = static_cast<std::uint32_t>(head->size() - packet_header_size + m_packet_json_block->size() + tail->size());
+	(*head)[0] = Packet::WORK;
+	(*head)[1] = static_cast<std::uint8_t>(length >> 24);
+	(*head)[2] = static_cast<std::uint8_t>(length >> 16);
+	(*head)[3] = static_cast<std::uint8_t>(length >> 8);
+	(*head)[4] = static_cast<std::uint8_t>(length);
+
+	return network::Payload_sequence{ std::move(head), m_packet_json_block, std::move(tail) };
+}
+
+network::Shared_payload create_pool_notification(std::string const& message)
+{
+	nlohmann::json j;
+	j["message"] = message;
+	auto const j_string = j.dump();
+
+	Packet packet{ Packet::POOL_NOTIFICATION, network::Payload{ j_string.begin(), j_string.end() } };
+	return packet.get_bytes();
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef NEXUSPOOL_BROADCAST_HPP
+#define NEXUSPOOL_BROADCAST_HPP
+
+#include "LLP/block.hpp"
+#include "network/types.hpp"
+#include "pool/types.hpp"
+#include "pool/session.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nexuspool
+{
+
+// WORK packet of a work template, serialized once for all miners (json for protocol v2, binary for v3).
+// get_payload() returns the packet as buffer sequence. The block bytes without the per miner fields (work_id, pool nbits,
+// nNonce of the block and the assigned nonce range) are shared by all miners, only the small parts containing
+// the per miner fields are serialized for each miner. The json is byte identical to nlohmann::json::dump().
+class Work_message
+{
+public:
+
+	using Sptr = std::shared_ptr<Work_message const>;
+
+	Work_message(LLP::CBlock const& block, std::uint32_t pool_nbits);
+
+	LLP::CBlock const& get_block() const { return *m_block; }
+	std::shared_ptr<LLP::CBlock const> get_shared_block() const { return m_block; }
+	std::uint32_t get_pool_nbits() const { return m_pool_nbits; }
+
+	// payload for the job of one miner
+	network::Payload_sequence get_payload(Session_job const& job, std::uint8_t protocol_version) const;
+
+private:
+
+	// LLP header (1 byte) + length (4 byte)
+	static constexpr std::size_t packet_header_size{ 5U };
+
+	network::Payload_sequence get_payload_json(Session_job const& job) const;
+	network::Payload_sequence get_payload_binary(Session_job const& job) const;
+
+	std::shared_ptr<LLP::CBlock const> m_block;		// shared with the jobs of the sessions
+	std::uint32_t m_pool_nbits;
+	// json block bytes after the pool nbits up to the block nonce, each byte with its leading ','
+	network::Shared_payload m_packet_json_block;
+	// binary packet up to the block (patched per miner) and the block without nNonce (shared)
+	network::Payload m_packet_binary_head;
+	network::Shared_payload m_packet_binary_block;
+};
+
+// POOL_NOTIFICATION packet, serialized once for all miners
+network::Shared_payload create_pool_notification(std::string const& message);
+
+}
+
+#endif
@@ -3,8 +3,10 @@
 #include "LLP/block.hpp"
 #include "LLP/pool_protocol.hpp"
 #include "pool/types.hpp"
+#include "pool/broadcast.hpp"
 #include <spdlog/spdlog.h>
 #include <string>
+#include <algorithm>
 
 namespace nexuspool
 {
@@ -29,10 +31,11 @@ Miner_connection_impl::Miner_connection_impl(std::shared_ptr<spdlog::logger> log
 	Session_registry::Sptr session_registry)
     : m_logger{ std::move(logger) }
 	, m_connection{ std::move(connection) }
+	, m_closed{ false }
+	, m_packet_buffer{}
 	, m_pool_manager{std::move(pool_manager)}
 	, m_session_key{session_key}
 	, m_session_registry{std::move(session_registry)}
-	, m_pool_nbits{ 0 }
 	, m_miner_protocol_version{0U}
 {
 }
@@ -58,7 +61,7 @@ network::Connection::Handler Miner_connection_impl::connection_handler()
 			result == network::Result::connection_error)
 		{
 			self->m_logger->error("Connection to {} was not successful. Result: {}", self->m_connection->remote_endpoint().to_string(), network::Result::code_to_string(result));
-			self->m_connection.reset();
+			self->m_closed = true;
 		}
 		else if (result == network::Result::connection_closed)
 		{
@@ -67,7 +70,7 @@ network::Connection::Handler Miner_connection_impl::connection_handler()
 			{
 				session->set_inactive();
 			}
-			self->m_connection.reset();
+			self->m_closed = true;
 		}
 		else if (result == network::Result::connection_ok)
 		{
@@ -83,16 +86,29 @@ network::Connection::Handler Miner_connection_impl::connection_handler()
 void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffer)
 {
 	// if we don't have a connection to the wallet we cant do anything useful.
-	if (!m_connection)
+	if (m_closed)
 	{
 		return;
 	}
 
-	auto remaining_size = receive_buffer->size();
+	// packets can be split over several reads -> the packet_buffer keeps incomplete packets
+	if (!m_packet_buffer.append(*receive_buffer))
+	{
+		m_logger->error("Receive buffer of {} exceeded. Close connection", m_connection->remote_endpoint().to_string());
+		m_connection->close();
+		return;
+	}
+
 	auto session = m_session_registry->get_session(m_session_key);
-	do
+	if (!session)
+	{
+		m_logger->trace("process_data, session invalid");
+		return;
+	}
+
+	Packet_view packet;
+	while (m_packet_buffer.next_packet(packet))
 	{
-		auto packet = extract_packet_from_buffer(receive_buffer, remaining_size, receive_buffer->size() - remaining_size);
 		if (!packet.is_valid())
 		{
 			// log invalid packet
@@ -100,21 +116,15 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 			continue;
 		}
 
-		if (!session)
-		{
-			m_logger->trace("process_data, session invalid");
-			return;
-		}
-
 		if (packet.m_header == Packet::PING)
 		{
 			Packet response;
 			response = response.get_packet(Packet::PING);
-			m_connection->transmit(response.get_bytes());
+			m_connection->transmit(response.get_payload_sequence());
 		}
 		else if (packet.m_header == Packet::LOGIN)
 		{
-			process_login(std::move(packet), session);
+			process_login(packet, session);
 		}
 		//miner has submitted a block to the pool
 		else if (packet.m_header == Packet::SUBMIT_BLOCK)
@@ -124,19 +134,33 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 			{
 				m_logger->error("Miner {} not logged in! Reject block.", user_data.m_account.m_display_name);
 				Packet response{ Packet::REJECT, nullptr };
-				m_connection->transmit(response.get_bytes());
+				m_connection->transmit(response.get_payload_sequence());
+			}
+			// miners up to protocol v2 expect new work after every share, v3 miners keep hashing their jobs
+			if (m_miner_protocol_version < pool_protocol_v3::version)
+			{
+				session->needs_work(true);
 			}
-			// miner needs new work
-			session->needs_work(true);
 
 			auto pool_manager_shared = m_pool_manager.lock();
 			if (pool_manager_shared)
 			{
+				std::uint32_t work_id{ 0U };	// 0 -> latest job (protocol v1)
 				std::uint64_t nonce{ 0U };
-				if (m_miner_protocol_version >= POOL_PROTOCOL_VERSION)
+				pool_protocol_v3::Submit_block submit_block;
+				if (m_miner_protocol_version >= pool_protocol_v3::version)
+				{
+					if (!pool_protocol_v3::decode_submit_block(packet.m_data.data(), packet.m_data.size(), submit_block))
+					{
+						m_logger->error("Invalid paket for submit_block received!");
+						continue;
+					}
+					work_id = submit_block.m_work_id;
+					nonce = submit_block.m_nonce;
+				}
+				else if (m_miner_protocol_version >= POOL_PROTOCOL_VERSION_JSON)
 				{
-					nonce = process_submit_block_protocol_2(packet);
-					if (nonce == 0U)
+					if (!process_submit_block_protocol_2(packet, work_id, nonce))
 					{
 						m_logger->error("Invalid paket for submit_block received!");
 						continue;
@@ -149,30 +173,55 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 						m_logger->error("Invalid paket length for submit_block received! Received {} bytes", packet.m_length);
 						continue;
 					}
-					std::vector<uint8_t> block_data{ packet.m_data->begin(), packet.m_data->end() - 8 };
-					nonce = bytes2uint64(std::vector<uint8_t>(packet.m_data->end() - 8, packet.m_data->end()));
+					nonce = pool_protocol_v3::read_uint64(packet.m_data.end() - 8);
+				}
+
+				Session_job job;
+				auto const job_found = work_id != 0U ? session->get_job(work_id, job) : session->get_latest_job(job);
+				if (!job_found)
+				{
+					m_logger->debug("Miner {} submitted share for unknown or expired work_id {}. Reject block.", session->get_user_data().m_account.m_address, work_id);
+					Packet response{ Packet::REJECT, nullptr };
+					m_connection->transmit(response.get_payload_sequence());
+					continue;
+				}
+
+				// the nonce has to be inside the nonce range assigned to this job. Every WORK message carries the nonce range
+				// (nonce_start/nonce_end of the json, the binary v3 fields) and the block nonce starts at the beginning of it
+				auto const& nonce_range = job.m_nonce_range;
+				if (nonce_range.is_valid() && !nonce_range.contains(nonce))
+				{
+					m_logger->warn("Miner {} submitted nonce {} outside of assigned nonce range. Reject block.", session->get_user_data().m_account.m_address, nonce);
+					Packet response{ Packet::REJECT, nullptr };
+					m_connection->transmit(response.get_payload_sequence());
+					continue;
 				}
 
-				auto block = session->get_block();
-				if (!block)
+				if (submit_block.m_has_merkle_root && submit_block.m_merkle_root != job.m_block->hashMerkleRoot)
 				{
-					m_logger->debug("Miner has no block in current session set.");
-					return; // exit early
+					m_logger->warn("Miner {} submitted block with different merkle root. Reject block.", session->get_user_data().m_account.m_address);
+					Packet response{ Packet::REJECT, nullptr };
+					m_connection->transmit(response.get_payload_sequence());
+					continue;
 				}
 
+				auto block = std::make_unique<LLP::CBlock>(*job.m_block);
 				block->nNonce = nonce;	// update nonce
-				//TODO compare block merkle_root with received merkle_root (block_data)
+				// prime miners can submit the offsets of their cluster, then only these positions are verified
+				if (block->nChannel == 1)
+				{
+					block->vOffsets = std::move(submit_block.m_offsets);
+				}
 
 				std::weak_ptr<Miner_connection_impl> weak_self = shared_from_this();
-				pool_manager_shared->submit_block(std::move(block), m_session_key, [weak_self](auto result)
+				pool_manager_shared->submit_block(std::move(block), m_session_key, job.m_pool_nbits, job.m_hash_context, m_connection, [weak_self, share_weight = job.m_share_weight](auto result)
 					{
 						auto self = weak_self.lock();
 						if (!self)
 						{
-							self->m_logger->debug("SUBMIT_BLOCK handler, miner_connection invalid.");
 							return;
 						}
-						if (!self->m_connection)
+						if (self->m_closed)
 						{
 							self->m_logger->debug("SUBMIT_BLOCK handler, miner_connection connection invalid.");
 							return;
@@ -181,20 +230,20 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 						Packet response;
 						if (result == Submit_block_result::accept)
 						{
-							self->process_accepted();
+							self->process_accepted(share_weight);
 							response = response.get_packet(Packet::ACCEPT);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 						}
 						else if (result == Submit_block_result::reject)
 						{
 							response = response.get_packet(Packet::REJECT);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 						}
 						else
 						{
-							self->process_accepted();
+							self->process_accepted(share_weight);
 							response = response.get_packet(Packet::BLOCK);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 						}
 					});
 			}
@@ -205,7 +254,7 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 			// only update hashrate if user is logged in and the account has already been created
 			if (user_data.m_logged_in && !user_data.m_new_account)
 			{
-				auto const hashrate = bytes2double(*packet.m_data);
+				auto const hashrate = bytes2double(packet.m_data.to_payload());
 				session->update_hashrate(hashrate, 0, 0);
 			}
 		}
@@ -227,13 +276,12 @@ void Miner_connection_impl::process_data(network::Shared_payload&& receive_buffe
 			continue;
 		}
 	}
-	while (remaining_size != 0);
 
 	// received a valid paket from miner -> update session
 	session->set_update_time(std::chrono::steady_clock::now());
 }
 
-void Miner_connection_impl::process_accepted()
+void Miner_connection_impl::process_accepted(double share_weight)
 {
 	auto session = m_session_registry->get_session(m_session_key);
 	if (!session)
@@ -263,7 +311,7 @@ void Miner_connection_impl::process_accepted()
 	}
 
 	// add share
-	if (!session->add_share())
+	if (!session->add_share(share_weight))
 	{
 		m_logger->error("Failed to update account for miner {}", user_data.m_account.m_address);
 	}
@@ -271,9 +319,9 @@ void Miner_connection_impl::process_accepted()
 	session->set_update_time(std::chrono::steady_clock::now());
 }
 
-void Miner_connection_impl::send_work(LLP::CBlock const& block)
+void Miner_connection_impl::send_work(std::shared_ptr<Work_message const> work_message, Nonce_range const& nonce_range)
 {
-	if (!m_connection)
+	if (m_closed)
 	{
 		return;
 	}
@@ -284,43 +332,30 @@ void Miner_connection_impl::send_work(LLP::CBlock const& block)
 		m_logger->debug("SEND_WORK, session invalid.");
 		return;
 	}
-	auto pool_manager_shared = m_pool_manager.lock();
-	if (!pool_manager_shared)
-	{
-		return;
-	}
 
-	session->set_block(block);
+	// share difficulty of this miner
+	Session_job job;
+	job.m_pool_nbits = session->retarget_difficulty(work_message->get_pool_nbits(), work_message->get_block().nBits);
+	job.m_block = work_message->get_shared_block();
+	job.m_nonce_range = nonce_range;
+	job.m_work_id = session->add_job(job.m_block, job.m_nonce_range, job.m_pool_nbits);
 
-	//prepend pool nbits to the packet
-	m_pool_nbits = pool_manager_shared->get_pool_nbits();
-	auto pool_nbits_bytes = nexuspool::uint2bytes(m_pool_nbits);
-	auto block_data = block.serialize();
-	block_data.insert(block_data.begin(), pool_nbits_bytes.begin(), pool_nbits_bytes.end());
-
-	nlohmann::json j;
-	j["work_id"] = 1;
-	j["block"] = nlohmann::json::binary( block_data );
-	auto j_string = j.dump();
-
-	network::Payload work_data{ j_string.begin(), j_string.end() };
-	Packet response{ Packet::WORK, std::make_shared<network::Payload>(work_data) };
-
-	m_connection->transmit(response.get_bytes());
+	m_connection->transmit(work_message->get_payload(job, m_miner_protocol_version));
 }
 
 void Miner_connection_impl::get_hashrate()
 {
-	if (!m_connection)
+	if (m_closed)
 	{
 		return;
 	}
 
-	Packet packet{ Packet::GET_HASHRATE, nullptr };
-	m_connection->transmit(packet.get_bytes());
+	// same request for all miners
+	static network::Shared_payload const get_hashrate_request = Packet{ Packet::GET_HASHRATE, nullptr }.get_bytes();
+	m_connection->transmit(get_hashrate_request);
 }
 
-void Miner_connection_impl::process_login(Packet login_packet, std::shared_ptr<Session> session)
+void Miner_connection_impl::process_login(Packet_view const& login_packet, std::shared_ptr<Session> session)
 {
 	auto user_data = session->get_user_data();
 	// check if already logged in
@@ -334,14 +369,17 @@ void Miner_connection_impl::process_login(Packet login_packet, std::shared_ptr<S
 	nlohmann::json login_response_json;
 	login_response_json["result_code"] = Pool_protocol_result::Success;
 	login_response_json["result_message"] = "";
+	login_response_json["protocol_version"] = POOL_PROTOCOL_VERSION;
 
 	std::string nxs_address, display_name;
 	try
 	{
-		nlohmann::json j = nlohmann::json::parse(login_packet.m_data->begin(), login_packet.m_data->end());
+		nlohmann::json j = nlohmann::json::parse(login_packet.m_data.begin(), login_packet.m_data.end());
 		nxs_address = j.at("username");
 		display_name = j.at("display_name");
-		m_miner_protocol_version = j.at("protocol_version");
+		std::uint32_t const miner_protocol_version = j.at("protocol_version");
+		// newer miners fall back to the protocol version of the pool
+		m_miner_protocol_version = static_cast<std::uint8_t>(std::min<std::uint32_t>(miner_protocol_version, POOL_PROTOCOL_VERSION));
 	}
 	catch (std::exception& e)
 	{
@@ -349,8 +387,8 @@ void Miner_connection_impl::process_login(Packet login_packet, std::shared_ptr<S
 		return;
 	}
 
-	// protocol version check
-	if (m_miner_protocol_version < POOL_PROTOCOL_VERSION)
+	// protocol version check. The pool advertises its newest version, supported older versions don't get a warning
+	if (m_miner_protocol_version < POOL_PROTOCOL_VERSION_SUPPORTED)
 	{
 		login_response_json["result_code"] = Pool_protocol_result::Protocol_version_warn;
 		login_response_json["result_message"] = "Please update miner. Pool protocol_version is " + std::to_string(POOL_PROTOCOL_VERSION);
@@ -386,14 +424,14 @@ void Miner_connection_impl::process_login(Packet login_packet, std::shared_ptr<S
 
 	network::Payload login_data{ login_response_json_string.begin(), login_response_json_string.end() };
 	Packet response{ Packet::LOGIN_V2_SUCCESS, std::make_shared<network::Payload>(login_data) };
-	m_connection->transmit(response.get_bytes());
+	m_connection->transmit(response.get_payload_sequence());
 }
 
 void Miner_connection_impl::send_login_fail(std::string json_string)
 {
 	network::Payload login_data{ json_string.begin(), json_string.end() };
 	Packet login_fail_response{ Packet::LOGIN_V2_FAIL, std::make_shared<network::Payload>(login_data)};
-	m_connection->transmit(login_fail_response.get_bytes());
+	m_connection->transmit(login_fail_response.get_payload_sequence());
 }
 
 void Miner_connection_impl::check_and_update_display_name(std::string display_name, nlohmann::json& login_response)
@@ -406,30 +444,25 @@ void Miner_connection_impl::check_and_update_display_name(std::string display_na
 	}
 }
 
-void Miner_connection_impl::send_pool_notification(std::string message)
+void Miner_connection_impl::send_pool_notification(network::Shared_payload notification)
 {
-	nlohmann::json j;
-	j["message"] = message;
-	auto j_string = j.dump();
-
-	Packet response{ Packet::POOL_NOTIFICATION, std::make_shared<network::Payload>(network::Payload{ j_string.begin(), j_string.end() }) };
-//	m_connection->transmit(response.get_bytes());		TODO: enable when miner 1.5 released
+//	m_connection->transmit(std::move(notification));		TODO: enable when miner 1.5 released
 }
 
-std::uint64_t Miner_connection_impl::process_submit_block_protocol_2(Packet packet)
+bool Miner_connection_impl::process_submit_block_protocol_2(Packet_view const& packet, std::uint32_t& work_id, std::uint64_t& nonce)
 {
-	std::uint64_t nonce{0U};
 	try
 	{
-		nlohmann::json j = nlohmann::json::parse(packet.m_data->begin(), packet.m_data->end());
-		std::uint32_t const work_id = j.at("work_id");
+		nlohmann::json j = nlohmann::json::parse(packet.m_data.begin(), packet.m_data.end());
+		work_id = j.at("work_id");
 		nonce = j.at("nonce");
 	}
 	catch (std::exception& e)
 	{
 		m_logger->error("Invalid SUBMIT_BLOCK json received. Exception: {}", e.what());
+		return false;
 	}
-	return nonce;
+	return true;
 }
 
 }
\ No newline at end of file
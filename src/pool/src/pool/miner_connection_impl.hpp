@@ -3,6 +3,7 @@
 
 #include "pool/miner_connection.hpp"
 #include "LLP/packet.hpp"
+#include "LLP/packet_buffer.hpp"
 #include <nlohmann/json.hpp>
 #include <memory>
 #include <atomic>
@@ -22,32 +23,34 @@ public:
         Session_registry::Sptr session_registry);
 
     void stop() override;
-    void send_work(LLP::CBlock const& block) override;
+    void send_work(std::shared_ptr<Work_message const> work_message, Nonce_range const& nonce_range) override;
+    bool takes_work() const override { return true; }
     network::Connection::Handler connection_handler() override;
     void get_hashrate() override;
-    void send_pool_notification(std::string message) override;
+    void send_pool_notification(network::Shared_payload notification) override;
 
 private:
 
     void process_data(network::Shared_payload&& receive_buffer);
 
     // checks if a new account should be created, add share for session
-    void process_accepted();
+    void process_accepted(double share_weight);
 
     // to support 1.5 (new protocol) -> can be dropped if all miners have updated
-    std::uint64_t process_submit_block_protocol_2(Packet packet);
+    bool process_submit_block_protocol_2(Packet_view const& packet, std::uint32_t& work_id, std::uint64_t& nonce);
 
-    void process_login(Packet login_packet, std::shared_ptr<Session> session);
+    void process_login(Packet_view const& login_packet, std::shared_ptr<Session> session);
     void send_login_fail(std::string json_string);
     void check_and_update_display_name(std::string display_name, nlohmann::json& login_response);
 
     std::shared_ptr<spdlog::logger> m_logger;
-    network::Connection::Sptr m_connection;
+    network::Connection::Sptr const m_connection;     // never reset -> can be used from the pool_manager and validator threads
+    std::atomic_bool m_closed;                  // connection closed or failed, set on the connection strand
+    Packet_buffer m_packet_buffer;          // reassembles the packets received from the miner
     std::weak_ptr<Pool_manager> m_pool_manager;
     Session_key m_session_key;
     Session_registry::Sptr m_session_registry;
-    std::uint32_t m_pool_nbits;
-    std::uint8_t m_miner_protocol_version;
+    std::atomic<std::uint8_t> m_miner_protocol_version;       // negotiated at login, read by send_work from the pool_manager
 };
 
 }
@@ -17,6 +17,8 @@ Miner_connection_legacy_impl::Miner_connection_legacy_impl(std::shared_ptr<spdlo
 	chrono::Timer::Uptr get_block_timer)
 	: m_logger{ std::move(logger) }
 	, m_connection{ std::move(connection) }
+	, m_closed{ false }
+	, m_packet_buffer{}
 	, m_pool_manager{ std::move(pool_manager) }
 	, m_session_key{ session_key }
 	, m_session_registry{ std::move(session_registry) }
@@ -49,7 +51,7 @@ network::Connection::Handler Miner_connection_legacy_impl::connection_handler()
 			result == network::Result::connection_error)
 		{
 			self->m_logger->error("Connection to {} was not successful. Result: {}", self->m_connection->remote_endpoint().to_string(), network::Result::code_to_string(result));
-			self->m_connection.reset();
+			self->m_closed = true;
 		}
 		else if (result == network::Result::connection_closed)
 		{
@@ -58,7 +60,7 @@ network::Connection::Handler Miner_connection_legacy_impl::connection_handler()
 			{
 				session->set_inactive();
 			}
-			self->m_connection.reset();
+			self->m_closed = true;
 			self->m_get_block_timer->stop();
 		}
 		else if (result == network::Result::connection_ok)
@@ -76,16 +78,29 @@ network::Connection::Handler Miner_connection_legacy_impl::connection_handler()
 void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receive_buffer)
 {
 	// if we don't have a connection to the wallet we cant do anything useful.
-	if (!m_connection)
+	if (m_closed)
 	{
 		return;
 	}
 
-	auto remaining_size = receive_buffer->size();
+	// packets can be split over several reads -> the packet_buffer keeps incomplete packets
+	if (!m_packet_buffer.append(*receive_buffer))
+	{
+		m_logger->error("Miner_connection_legacy: Receive buffer of {} exceeded. Close connection", m_connection->remote_endpoint().to_string());
+		m_connection->close();
+		return;
+	}
+
 	auto session = m_session_registry->get_session(m_session_key);
-	do
+	if (!session)
+	{
+		m_logger->trace("process_data, session invalid");
+		return;
+	}
+
+	Packet_view packet;
+	while (m_packet_buffer.next_packet(packet))
 	{
-		auto packet = extract_packet_from_buffer(receive_buffer, remaining_size, receive_buffer->size() - remaining_size);
 		if (!packet.is_valid())
 		{
 			// log invalid packet
@@ -93,21 +108,15 @@ void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receiv
 			continue;
 		}
 
-		if (!session)
-		{
-			m_logger->trace("process_data, session invalid");
-			return;
-		}
-
 		if (packet.m_header == Packet::PING)
 		{
 			Packet response;
 			response = response.get_packet(Packet::PING);
-			m_connection->transmit(response.get_bytes());
+			m_connection->transmit(response.get_payload_sequence());
 		}
 		else if (packet.m_header == Packet::LOGIN)
 		{
-			process_login(std::move(packet), session);
+			process_login(packet, session);
 		}
 		else if (packet.m_header == Packet::GET_BLOCK)
 		{
@@ -124,29 +133,28 @@ void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receiv
 					m_logger->error("Invalid paket length for submit_block received! Received {} bytes", packet.m_length);
 					continue;
 				}
-				std::vector<uint8_t> block_data{ packet.m_data->begin(), packet.m_data->end() - 8 };
-				auto nonce = bytes2uint64(std::vector<uint8_t>(packet.m_data->end() - 8, packet.m_data->end()));
+				auto nonce = bytes2uint64(std::vector<uint8_t>(packet.m_data.end() - 8, packet.m_data.end()));
 
-				auto block = session->get_block();
-				if (!block)
+				Session_job job;
+				if (!session->get_latest_job(job))
 				{
 					m_logger->debug("Miner has no block in current session set.");
 					return; // exit early
 				}
 
+				auto block = std::make_unique<LLP::CBlock>(*job.m_block);
 				block->nNonce = nonce;	// update nonce
-				//TODO compare block merkle_root with received merkle_root (block_data)
+				//TODO compare block merkle_root with received merkle_root (first 64 bytes of the packet)
 
 				std::weak_ptr<Miner_connection_legacy_impl> weak_self = shared_from_this();
-				pool_manager_shared->submit_block(std::move(block), m_session_key, [weak_self](auto result)
+				pool_manager_shared->submit_block(std::move(block), m_session_key, job.m_pool_nbits, job.m_hash_context, m_connection, [weak_self, share_weight = job.m_share_weight](auto result)
 					{
 						auto self = weak_self.lock();
 						if (!self)
 						{
-							self->m_logger->debug("SUBMIT_BLOCK handler, miner_connection invalid.");
 							return;
 						}
-						if (!self->m_connection)
+						if (self->m_closed)
 						{
 							self->m_logger->debug("SUBMIT_BLOCK handler, miner_connection connection invalid.");
 							return;
@@ -156,9 +164,9 @@ void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receiv
 						if (result == Submit_block_result::accept)
 						{
 							self->m_logger->trace("Share accepted");
-							self->process_accepted();
+							self->process_accepted(share_weight);
 							response = response.get_packet(Packet::ACCEPT);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 							// immediately get a net block for miner
 							auto pool_manager_shared_2 = self->m_pool_manager.lock();
  							if (pool_manager_shared_2)
@@ -169,13 +177,13 @@ void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receiv
 						else if (result == Submit_block_result::reject)
 						{
 							response = response.get_packet(Packet::REJECT);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 						}
 						else
 						{
-							self->process_accepted();
+							self->process_accepted(share_weight);
 							response = response.get_packet(Packet::BLOCK);
-							self->m_connection->transmit(response.get_bytes());
+							self->m_connection->transmit(response.get_payload_sequence());
 						}
 					});
 			}
@@ -197,13 +205,13 @@ void Miner_connection_legacy_impl::process_data(network::Shared_payload&& receiv
 			m_logger->error("Invalid header received.");
 			continue;
 		}
-	} while (remaining_size != 0);
+	}
 
 	// received a valid paket from miner -> update session
 	session->set_update_time(std::chrono::steady_clock::now());
 }
 
-void Miner_connection_legacy_impl::process_accepted()
+void Miner_connection_legacy_impl::process_accepted(double share_weight)
 {
 	auto session = m_session_registry->get_session(m_session_key);
 	if (!session)
@@ -229,7 +237,7 @@ void Miner_connection_legacy_impl::process_accepted()
 	}
 
 	// add share
-	if (!session->add_share())
+	if (!session->add_share(share_weight))
 	{
 		m_logger->error("Failed to update account for miner {}", user_data.m_account.m_address);
 	}
@@ -240,7 +248,7 @@ void Miner_connection_legacy_impl::process_accepted()
 }
 
 
-void Miner_connection_legacy_impl::process_login(Packet login_packet, std::shared_ptr<Session> session)
+void Miner_connection_legacy_impl::process_login(Packet_view const& login_packet, std::shared_ptr<Session> session)
 {
 	auto user_data = session->get_user_data();
 	// check if already logged in
@@ -255,7 +263,7 @@ void Miner_connection_legacy_impl::process_login(Packet login_packet, std::share
 	Packet login_fail_response;
 	login_fail_response = login_fail_response.get_packet(Packet::LOGIN_FAIL);
 
-	auto const nxs_address = std::string(login_packet.m_data->begin(), login_packet.m_data->end());
+	auto const nxs_address = std::string(login_packet.m_data.begin(), login_packet.m_data.end());
 	auto const nxs_address_valid = m_session_registry->valid_nxs_address(nxs_address);
 	if (!nxs_address_valid)
 	{
@@ -263,7 +271,7 @@ void Miner_connection_legacy_impl::process_login(Packet login_packet, std::share
 		//if (m_isDDOS)
 		//	m_ddos->Ban(m_logger, "Invalid Nexus Address on Login");
 
-		m_connection->transmit(login_fail_response.get_bytes());
+		m_connection->transmit(login_fail_response.get_payload_sequence());
 		return;
 	}
 	// check if banned ip/user
@@ -276,22 +284,21 @@ void Miner_connection_legacy_impl::process_login(Packet login_packet, std::share
 	session->login();
 
 	response = response.get_packet(Packet::LOGIN_SUCCESS);
-	m_connection->transmit(response.get_bytes());
+	m_connection->transmit(response.get_payload_sequence());
 }
 
 void Miner_connection_legacy_impl::get_block(std::shared_ptr<Pool_manager> pool_manager)
 {
 	m_pool_nbits = pool_manager->get_pool_nbits();
 	std::weak_ptr<Miner_connection_legacy_impl> weak_self = shared_from_this();
-	pool_manager->get_block([weak_self](auto block)
+	pool_manager->get_block([weak_self](auto const& block)
 		{
 			auto self = weak_self.lock();
 			if (!self)
 			{
-				self->m_logger->debug("GET_BLOCK handler, miner_connection_legacy invalid.");
 				return;
 			}
-			if (!self->m_connection)
+			if (self->m_closed)
 			{
 				self->m_logger->debug("GET_BLOCK handler, miner_connection_legacy connection invalid.");
 				return;
@@ -304,7 +311,8 @@ void Miner_connection_legacy_impl::get_block(std::shared_ptr<Pool_manager> pool_
 				return;
 			}
 			self->m_network_nbits = block.nBits;
-			session->set_block(block);
+			// own wallet block without nonce range
+			session->add_job(std::make_shared<LLP::CBlock const>(block), Nonce_range{}, self->m_pool_nbits);
 
 			//prepend pool nbits to the packet
 			auto pool_nbits_bytes = nexuspool::uint2bytes(self->m_pool_nbits);
@@ -313,7 +321,7 @@ void Miner_connection_legacy_impl::get_block(std::shared_ptr<Pool_manager> pool_
 			block_data.insert(block_data.begin(), pool_nbits_bytes.begin(), pool_nbits_bytes.end());
 			Packet response{ Packet::BLOCK_DATA, std::make_shared<network::Payload>(block_data) };
 
-			self->m_connection->transmit(response.get_bytes());
+			self->m_connection->transmit(response.get_payload_sequence());
 		});
 }
 
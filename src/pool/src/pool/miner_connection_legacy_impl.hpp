@@ -3,6 +3,7 @@
 
 #include "pool/miner_connection.hpp"
 #include "LLP/packet.hpp"
+#include "LLP/packet_buffer.hpp"
 #include "chrono/timer.hpp"
 #include <memory>
 #include <atomic>
@@ -23,30 +24,33 @@ public:
         chrono::Timer::Uptr get_block_timer);
 
     void stop() override;
-    void send_work(LLP::CBlock const& block) override {}        // not supported
+    void send_work(std::shared_ptr<Work_message const> work_message, Nonce_range const& nonce_range) override {}        // not supported
+    bool takes_work() const override { return false; }       // legacy miners request their blocks (GET_BLOCK)
     network::Connection::Handler connection_handler() override;
     void get_hashrate() override {} // not supported
-    void send_pool_notification(std::string message) override {} // not supported
+    void send_pool_notification(network::Shared_payload notification) override {} // not supported
 
 private:
 
     void process_data(network::Shared_payload&& receive_buffer);
 
     // checks if a new account should be created, add share for session
-    void process_accepted();
-    void process_login(Packet login_packet, std::shared_ptr<Session> session);
+    void process_accepted(double share_weight);
+    void process_login(Packet_view const& login_packet, std::shared_ptr<Session> session);
 
     void get_block(std::shared_ptr<Pool_manager> pool_manager);
     chrono::Timer::Handler get_block_handler(std::uint16_t get_block_interval);
 
     std::shared_ptr<spdlog::logger> m_logger;
-    network::Connection::Sptr m_connection;
+    network::Connection::Sptr const m_connection;     // never reset -> can be used from the pool_manager and validator threads
+    std::atomic_bool m_closed;                  // connection closed or failed, set on the connection strand
+    Packet_buffer m_packet_buffer;          // reassembles the packets received from the miner
     std::weak_ptr<Pool_manager> m_pool_manager;
     Session_key m_session_key;
     Session_registry::Sptr m_session_registry;
     chrono::Timer::Uptr m_get_block_timer;
-    std::uint32_t m_pool_nbits;
-    std::uint32_t m_network_nbits;
+    std::atomic<std::uint32_t> m_pool_nbits;
+    std::atomic<std::uint32_t> m_network_nbits;
     std::atomic<std::uint32_t> m_current_height;
 };
 
@@ -11,11 +11,13 @@
 #include "LLP/utils.hpp"
 #include "TAO/Ledger/prime.h"
 #include "TAO/Ledger/difficulty.h"
+#include <asio/post.hpp>
 
 namespace nexuspool
 {
 
 constexpr std::uint32_t payout_time_delay{ 8U };
+constexpr std::size_t validation_queue_size{ 4096U };
 
 Pool_manager::Sptr create_pool_manager(std::shared_ptr<asio::io_context> io_context,
 	std::shared_ptr<spdlog::logger> logger,
@@ -46,6 +48,7 @@ Pool_manager_impl::Pool_manager_impl(std::shared_ptr<asio::io_context> io_contex
 	persistance::Data_reader_factory::Sptr data_reader_factory,
 	common::Pool_api_data_exchange::Sptr pool_api_data_exchange)
 	: m_io_context{std::move(io_context) }
+	, m_strand{ ::asio::make_strand(*m_io_context) }
 	, m_logger{ std::move(logger)}
 	, m_config{std::move(config)}
 	, m_timer_factory{ timer_factory }
@@ -70,21 +73,28 @@ Pool_manager_impl::Pool_manager_impl(std::shared_ptr<asio::io_context> io_contex
 		m_config->get_pool_config().m_fee_address)}
 	, m_listen_socket{}
 	, m_legacy_listen_socket{}
+	, m_share_ledger{std::make_shared<Share_ledger>(m_data_writer_factory->create_shared_data_writer())}
 	, m_session_registry{std::make_shared<Session_registry_impl>(
 		m_data_reader_factory->create_data_reader(), 
 		m_data_writer_factory->create_shared_data_writer(), 
+		m_share_ledger,
 		m_http_component, 
 		m_config->get_session_expiry_time(),
 		m_config->get_mining_mode(),
-		m_config->get_legacy_mode())}
+		m_config->get_legacy_mode(),
+		m_config->get_vardiff_shares_per_minute())}
 	, m_miner_notifications{std::make_unique<Notifications>(m_session_registry, m_config->get_miner_notifications())}
+	, m_share_validator{std::make_unique<Share_validator>(m_io_context, *m_reward_component, m_config->get_validation_threads(), validation_queue_size)}
+	, m_share_filter{}
 	, m_current_height{0}
+	, m_pool_nBits{0}
 	, m_block_map_id{0}
 {
 	m_session_registry_maintenance = m_timer_factory->create_timer();
 	m_end_round_timer = m_timer_factory->create_timer();
 	m_payout_timer = m_timer_factory->create_timer();
 	m_get_hashrate_timer = m_timer_factory->create_timer();
+	m_share_flush_timer = m_timer_factory->create_timer();
 }
 
 void Pool_manager_impl::start()
@@ -98,6 +108,7 @@ void Pool_manager_impl::start()
 	// connect to wallet
 	m_wallet_connection = std::make_shared<Wallet_connection_impl>(
 		m_io_context, 
+		m_strand,
 		m_logger, 
 		self, 
 		mining_mode, 
@@ -134,7 +145,7 @@ void Pool_manager_impl::start()
 	else
 	{
 		// start timer for end_round
-		m_end_round_timer->start(chrono::Seconds(std::chrono::duration_cast<std::chrono::seconds>(round_end_time - time_now).count()), end_round_handler());
+		m_end_round_timer->start(chrono::Seconds(std::chrono::duration_cast<std::chrono::seconds>(round_end_time - time_now).count()), run_in_strand(end_round_handler()));
 		// set payout_time for api
 		auto payout_time = round_end_time;
 		payout_time += std::chrono::hours(payout_time_delay);
@@ -194,9 +205,10 @@ void Pool_manager_impl::start()
 	m_listen_socket->listen(socket_handler);
 
 	m_session_registry_maintenance->start(chrono::Seconds(m_config->get_session_expiry_time()), 
-		session_registry_maintenance_handler(m_config->get_session_expiry_time()));
+		run_in_strand(session_registry_maintenance_handler(m_config->get_session_expiry_time())));
 
-	m_get_hashrate_timer->start(chrono::Seconds(m_config->get_hashrate_interval()), get_hashrate_handler(m_config->get_hashrate_interval()));
+	m_get_hashrate_timer->start(chrono::Seconds(m_config->get_hashrate_interval()), run_in_strand(get_hashrate_handler(m_config->get_hashrate_interval())));
+	m_share_flush_timer->start(chrono::Seconds(m_config->get_share_flush_interval()), run_in_strand(share_flush_handler(m_config->get_share_flush_interval())));
 }
 
 void Pool_manager_impl::stop()
@@ -205,8 +217,11 @@ void Pool_manager_impl::stop()
 	m_session_registry_maintenance->stop();
 	m_end_round_timer->stop();
 	m_get_hashrate_timer->stop();
+	m_share_flush_timer->stop();
 	m_payout_timer->stop();
+	m_share_validator->stop();
 	m_session_registry->stop();	// clear sessions and deletes miner_connection objects
+	m_share_ledger->flush();		// write the remaining shares (and the reset hashrates of the deleted sessions)
 	m_wallet_connection->stop();
 	m_listen_socket->stop_listen();
 }
@@ -220,32 +235,19 @@ void Pool_manager_impl::set_current_height(std::uint32_t height)
 		m_logger->trace("New height, clear pending blocks from previous height");
 		m_block_map.clear();
 		m_block_map_id = 0;
+		m_share_filter.clear();
 		m_session_registry->reset_work_status_of_sessions();
+		// the block for the new height is requested by the wallet_connection -> work is sent out in set_block
+		m_work_template.reset(height);
+		return;
 	}
 
 	// send miners new work
-	auto const sessions_size = m_session_registry->get_sessions_size();
-	for (auto i = 0; i < sessions_size; ++i)
-	{
-		auto session = m_session_registry->get_session_with_no_work();
-		if (session)
-		{
-			m_wallet_connection->get_block([session](auto block)
-				{
-					auto miner_connection = session->get_connection();
-					auto miner_connection_shared = miner_connection.lock();
-					if (miner_connection_shared)
-					{
-						miner_connection_shared->send_work(block);
-					}
-				});
-		}
-	}
+	send_work_to_sessions();
 }
 
 void Pool_manager_impl::set_block(LLP::CBlock const& block)
 {
-	std::scoped_lock(m_block_mutex);
 	m_block = block;
 
 	//pool nbits determines the difficulty for the pool.  
@@ -271,6 +273,49 @@ void Pool_manager_impl::set_block(LLP::CBlock const& block)
 	{
 		m_pool_nBits = block.nBits;
 	}
+
+	if (!m_work_template.set_block(block, m_pool_nBits))
+	{
+		m_logger->debug("Work template: received block with height {} for current height {}", block.nHeight, m_work_template.get_height());
+		return;
+	}
+
+	send_work_to_sessions();
+}
+
+void Pool_manager_impl::send_work_to_sessions()
+{
+	if (!m_work_template.is_valid())
+	{
+		return;
+	}
+
+	// the work message is serialized once per template, only the nonce range is patched per miner
+	Work_message::Sptr work_message;
+	Nonce_range nonce_range;
+	auto const sessions_size = m_session_registry->get_sessions_size();
+	for (auto i = 0; i < sessions_size; ++i)
+	{
+		auto session = m_session_registry->get_session_with_no_work();
+		if (!session)
+		{
+			break;
+		}
+
+		auto miner_connection_shared = session->get_connection().lock();
+		if (!miner_connection_shared || !miner_connection_shared->takes_work())
+		{
+			continue;
+		}
+
+		if (!m_work_template.get_work(work_message, nonce_range))
+		{
+			session->needs_work(true);
+			break;
+		}
+
+		miner_connection_shared->send_work(work_message, nonce_range);
+	}
 }
 
 void Pool_manager_impl::add_block_to_storage(std::uint32_t block_map_id)
@@ -290,7 +335,14 @@ void Pool_manager_impl::add_block_to_storage(std::uint32_t block_map_id)
 	auto const block_hash = submit_block_data.m_block->nChannel == 1 ? submit_block_data.m_block->GetPrime() : submit_block_data.m_block->GetHash();
 	block_data.m_share_difficulty = TAO::Ledger::GetDifficulty(block_hash, submit_block_data.m_block->nChannel);
 	block_data.m_round = m_reward_component->get_current_round();
-	data_writer->add_block(std::move(block_data));
+	data_writer->write_async([block_data = std::move(block_data)](persistance::Data_writer& writer) { return writer.add_block(block_data); },
+		[logger = m_logger](bool result)
+		{
+			if (!result)
+			{
+				logger->error("Failed to add block to storage");
+			}
+		});
 
 	m_reward_component->block_found();
 	m_miner_notifications->send_block_found();
@@ -298,10 +350,29 @@ void Pool_manager_impl::add_block_to_storage(std::uint32_t block_map_id)
 
 void Pool_manager_impl::get_block(Get_block_handler&& handler)
 {
+	// legacy miners don't know the end of a nonce range -> every legacy miner hashes its own wallet block
 	m_wallet_connection->get_block(std::move(handler));
 }
 
-void Pool_manager_impl::submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler)
+void Pool_manager_impl::submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context, network::Connection::Sptr connection, Submit_block_handler handler)
+{
+	// resubmitted shares are rejected before the expensive validation
+	if (!m_share_filter.insert(block->hashMerkleRoot, block->nNonce))
+	{
+		m_logger->debug("Duplicate share with nonce {} received. Reject block.", block->nNonce);
+		handler(Submit_block_result::reject);
+		return;
+	}
+
+	// the expensive difficulty check (SK1024 / fermat tests) runs on the share_validator threads
+	// pool_nbits is the share difficulty of the miner (vardiff)
+	m_share_validator->validate(std::move(block), pool_nbits, std::move(hash_context), std::move(connection), [self = shared_from_this(), miner_key, handler = std::move(handler)](auto block, auto difficulty_result)
+	{
+		self->process_difficulty_result(std::move(block), miner_key, std::move(handler), difficulty_result);
+	});
+}
+
+void Pool_manager_impl::process_difficulty_result(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler, reward::Difficulty_result difficulty_result)
 {
 	auto session = m_session_registry->get_session(miner_key);
 	if (!session)
@@ -309,7 +380,6 @@ void Pool_manager_impl::submit_block(std::unique_ptr<LLP::CBlock> block, Session
 		m_logger->error("Pool_manager_impl::submit_block session invalid");
 	}
 
-	auto difficulty_result = m_reward_component->check_difficulty(*block, m_pool_nBits);
 	switch (difficulty_result)
 	{
 	case reward::Difficulty_result::accept:
@@ -324,9 +394,17 @@ void Pool_manager_impl::submit_block(std::unique_ptr<LLP::CBlock> block, Session
 		auto nonce = nexuspool::uint2bytes64(block->nNonce);
 		auto block_data = std::make_shared<std::vector<std::uint8_t>>(block->hashMerkleRoot.GetBytes());
 		block_data->insert(block_data->end(), nonce.begin(), nonce.end());
-		m_block_map.emplace(std::make_pair(m_block_map_id.load(), Submit_block_data{ std::move(block), session->get_user_data().m_account.m_address }));
-		m_wallet_connection->submit_block(std::move(block_data), m_block_map_id, std::move(handler));
-		m_block_map_id++;
+		auto blockfinder = session ? session->get_user_data().m_account.m_address : std::string{};
+		Submit_block_data submit_block_data{ std::move(block), std::move(blockfinder) };
+
+		// block_map and wallet_connection are only accessed inside the pool_manager strand
+		::asio::post(m_strand, [self = shared_from_this(), submit_block_data = std::move(submit_block_data), 
+			block_data = std::move(block_data), handler = std::move(handler)]() mutable
+		{
+			auto const block_map_id = self->m_block_map_id++;
+			self->m_block_map.emplace(std::make_pair(block_map_id, std::move(submit_block_data)));
+			self->m_wallet_connection->submit_block(std::move(block_data), block_map_id, std::move(handler));
+		});
 		break;
 	}
 	case reward::Difficulty_result::reject:
@@ -337,10 +415,17 @@ void Pool_manager_impl::submit_block(std::unique_ptr<LLP::CBlock> block, Session
 
 std::uint32_t Pool_manager_impl::get_pool_nbits() const
 {
-	std::scoped_lock(m_block_mutex);
 	return m_pool_nBits;
 }
 
+chrono::Timer::Handler Pool_manager_impl::run_in_strand(chrono::Timer::Handler handler)
+{
+	return[this, handler = std::move(handler)]()
+	{
+		::asio::post(m_strand, handler);
+	};
+}
+
 chrono::Timer::Handler Pool_manager_impl::get_hashrate_handler(std::uint16_t get_hashrate_interval)
 {
 	return[this, get_hashrate_interval]()
@@ -348,7 +433,25 @@ chrono::Timer::Handler Pool_manager_impl::get_hashrate_handler(std::uint16_t get
 		m_session_registry->get_hashrate();
 
 		// restart timer
-		m_get_hashrate_timer->start(chrono::Seconds(get_hashrate_interval), get_hashrate_handler(get_hashrate_interval));
+		m_get_hashrate_timer->start(chrono::Seconds(get_hashrate_interval), run_in_strand(get_hashrate_handler(get_hashrate_interval)));
+	};
+}
+
+chrono::Timer::Handler Pool_manager_impl::share_flush_handler(std::uint16_t share_flush_interval)
+{
+	return[this, share_flush_interval]()
+	{
+		// the storage thread writes the shares, the miner connections don't wait for the database
+		m_share_ledger->flush_async([logger = m_logger](bool result)
+		{
+			if (!result)
+			{
+				logger->error("Failed to write shares to storage. Retry with next flush");
+			}
+		});
+
+		// restart timer
+		m_share_flush_timer->start(chrono::Seconds(share_flush_interval), run_in_strand(share_flush_handler(share_flush_interval)));
 	};
 }
 
@@ -359,9 +462,15 @@ chrono::Timer::Handler Pool_manager_impl::session_registry_maintenance_handler(s
 		m_session_registry->clear_unused_sessions();
 		m_pool_api_data_exchange->set_active_miners(m_session_registry->get_sessions_size());	// update the currently active miners on pool
 
+		auto const validator_metrics = m_share_validator->get_metrics();
+		m_logger->debug("Share validation: queue depth {} (max {}), validated {} ({} inline), latency avg {:.3f} ms max {:.3f} ms",
+			validator_metrics.m_queue_depth, validator_metrics.m_max_queue_depth, validator_metrics.m_validated,
+			validator_metrics.m_validated_inline, validator_metrics.m_average_latency_ms, validator_metrics.m_max_latency_ms);
+		m_logger->debug("Duplicate shares rejected: {}", m_share_filter.get_duplicates());
+
 		// restart timer
 		m_session_registry_maintenance->start(chrono::Seconds(session_registry_maintenance_interval),
-			session_registry_maintenance_handler(session_registry_maintenance_interval));
+			run_in_strand(session_registry_maintenance_handler(session_registry_maintenance_interval)));
 	};
 }
 
@@ -390,7 +499,7 @@ chrono::Timer::Handler Pool_manager_impl::payout_handler(std::uint32_t round)
 		{
 			constexpr std::uint16_t payout_interval{ 10U };
 			m_logger->info("Next payout attempt in {} minutes", payout_interval);
-			m_payout_timer->start(chrono::Seconds(payout_interval * 60), payout_handler(round));
+			m_payout_timer->start(chrono::Seconds(payout_interval * 60), run_in_strand(payout_handler(round)));
 		}
 	};
 }
@@ -398,12 +507,17 @@ chrono::Timer::Handler Pool_manager_impl::payout_handler(std::uint32_t round)
 void Pool_manager_impl::end_round()
 {
 	auto const current_round = m_reward_component->get_current_round();
+	// all shares of the round have to be in storage before the round is evaluated
+	if (!m_share_ledger->flush())
+	{
+		m_logger->error("Failed to write shares to storage before round end");
+	}
 	m_reward_component->end_round(current_round);
 	// end round in registry
 	m_session_registry->end_round();
 
 	// start timer for payout -> payout is delayed (8 hours) to make sure that every block is already confirmed
-	m_payout_timer->start(chrono::Seconds(60 * 60 * payout_time_delay), payout_handler(current_round));
+	m_payout_timer->start(chrono::Seconds(60 * 60 * payout_time_delay), run_in_strand(payout_handler(current_round)));
 
 	// update config in storage
 	m_storage_config_data = storage_config_check();
@@ -421,7 +535,7 @@ void Pool_manager_impl::end_round()
 	std::chrono::system_clock::time_point round_start_time, round_end_time;
 	m_reward_component->get_start_end_round_times(round_start_time, round_end_time);
 	auto time_now = std::chrono::system_clock::now();
-	m_end_round_timer->start(chrono::Seconds(std::chrono::duration_cast<std::chrono::seconds>(round_end_time - time_now).count()), end_round_handler());
+	m_end_round_timer->start(chrono::Seconds(std::chrono::duration_cast<std::chrono::seconds>(round_end_time - time_now).count()), run_in_strand(end_round_handler()));
 }
 
 persistance::Config_data Pool_manager_impl::storage_config_check()
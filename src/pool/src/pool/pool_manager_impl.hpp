@@ -5,8 +5,13 @@
 #include "nexus_http_interface/create_component.hpp"
 #include "network/types.hpp"
 #include "pool/session.hpp"
+#include "pool/work_template.hpp"
+#include "pool/share_validator.hpp"
+#include "pool/share_ledger.hpp"
+#include "pool/share_filter.hpp"
 
-#include <mutex>
+#include <asio/io_context.hpp>
+#include <asio/strand.hpp>
 #include <atomic>
 
 namespace nexuspool
@@ -37,7 +42,7 @@ public:
 
     // Methods towards miner_connection
     void get_block(Get_block_handler&& handler) override;
-    void submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler) override;
+    void submit_block(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context, network::Connection::Sptr connection, Submit_block_handler handler) override;
     std::uint32_t get_pool_nbits() const override;
 
 private:
@@ -46,11 +51,20 @@ private:
     chrono::Timer::Handler end_round_handler();
     chrono::Timer::Handler payout_handler(std::uint32_t round);
     chrono::Timer::Handler get_hashrate_handler(std::uint16_t get_hashrate_interval);
+    chrono::Timer::Handler share_flush_handler(std::uint16_t share_flush_interval);
 
     void end_round();
+    // timer handlers are executed inside the pool_manager strand
+    chrono::Timer::Handler run_in_strand(chrono::Timer::Handler handler);
+    // hand every session which needs work a nonce range of the current work template
+    void send_work_to_sessions();
+    // called after the share_validator has checked the submitted block
+    void process_difficulty_result(std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler, reward::Difficulty_result difficulty_result);
     persistance::Config_data storage_config_check();
 
     std::shared_ptr<::asio::io_context> m_io_context;
+    // serialises the pool_manager and wallet_connection state (height, block, block_map)
+    ::asio::strand<::asio::io_context::executor_type> m_strand;
     std::shared_ptr<spdlog::logger> m_logger;
     config::Config::Sptr m_config;
     persistance::Config_data m_storage_config_data;
@@ -66,19 +80,23 @@ private:
     network::Socket::Sptr m_listen_socket;                  // Miner listen port for connections
     network::Socket::Sptr m_legacy_listen_socket;           // Miner listen port for legacy connections (old protocol)
 
+    Share_ledger::Sptr m_share_ledger;                       // collects shares/hashrates and writes them batched to storage
     std::shared_ptr<Session_registry> m_session_registry;    // holds all sessions -> each session contains a miner_connection
     std::unique_ptr<Notifications> m_miner_notifications;    // sends notification messages to miners
+    std::unique_ptr<Share_validator> m_share_validator;      // validates submitted blocks off the network threads
+    Share_filter m_share_filter;                             // rejects duplicate shares of the current height before validation
     // periodic timer
     chrono::Timer::Uptr m_session_registry_maintenance;
     chrono::Timer::Uptr m_end_round_timer;
     chrono::Timer::Uptr m_payout_timer;
     chrono::Timer::Uptr m_get_hashrate_timer;
+    chrono::Timer::Uptr m_share_flush_timer;
 
     // connection variables
     std::uint32_t m_current_height;
-    std::mutex m_block_mutex;
     LLP::CBlock m_block;
-    std::uint32_t m_pool_nBits;
+    std::atomic<std::uint32_t> m_pool_nBits;       // read by miner_connections from any thread
+    Work_template m_work_template;      // one wallet block per height shared by all miners
 
     // variables for block to storage
     struct Submit_block_data
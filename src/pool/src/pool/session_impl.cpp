@@ -1,6 +1,6 @@
 #include "pool/session_impl.hpp"
 #include "pool/miner_connection.hpp"
-#include "LLC/random.h"
+#include "pool/broadcast.hpp"
 #include "TAO/Register/types/address.h"
 #include "common/types.hpp"
 #include <assert.h>
@@ -8,17 +8,31 @@
 namespace nexuspool
 {
 
-Session_impl::Session_impl(persistance::Shared_data_writer::Sptr data_writer, Shared_data_reader::Sptr data_reader, common::Mining_mode mining_mode, bool legacy_mode)
-	: m_data_writer{ std::move(data_writer) }
+Session_impl::Session_impl(Session_key key,
+	Session_work_queue::Sptr work_queue,
+	persistance::Shared_data_writer::Sptr data_writer, 
+	Shared_data_reader::Sptr data_reader, 
+	Share_ledger::Sptr share_ledger, 
+	common::Mining_mode mining_mode, 
+	bool legacy_mode,
+	std::uint32_t vardiff_shares_per_minute,
+	Hashrate_helper::Clock clock)
+	: m_key{ key }
+	, m_work_queue{ std::move(work_queue) }
+	, m_data_writer{ std::move(data_writer) }
 	, m_data_reader{ std::move(data_reader) }
+	, m_share_ledger{ std::move(share_ledger) }
 	, m_user_data{}
 	, m_miner_connection{}
 	, m_update_time{ std::chrono::steady_clock::now() }
-	, m_hashrate_helper{ mining_mode }
+	, m_hashrate_helper{ mining_mode, std::move(clock) }
+	, m_vardiff{ vardiff_shares_per_minute }
+	, m_share_weight{ 1.0 }
 	, m_legacy_mode{legacy_mode}
-	, m_block{}
+	, m_jobs{}
+	, m_latest_work_id{ 0U }
 	, m_inactive{false}
-	, m_work_needed{true}
+	, m_work_needed{false}
 {
 }
 
@@ -29,55 +43,173 @@ Session_impl::~Session_impl()
 
 void Session_impl::update_connection(std::shared_ptr<Miner_connection> miner_connection)
 {
+	std::scoped_lock lock(m_mutex);
 	m_miner_connection = std::move(miner_connection);
 }
 
-bool Session_impl::add_share()
+std::weak_ptr<Miner_connection> Session_impl::get_connection()
+{
+	std::scoped_lock lock(m_mutex);
+	return m_miner_connection;
+}
+
+Session_user Session_impl::get_user_data() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_user_data;
+}
+
+void Session_impl::update_user_data(Session_user const& user_data)
+{
+	std::scoped_lock lock(m_mutex);
+	m_user_data = user_data;
+}
+
+std::chrono::steady_clock::time_point Session_impl::get_update_time() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_update_time;
+}
+
+void Session_impl::set_update_time(std::chrono::steady_clock::time_point update_time)
+{
+	std::scoped_lock lock(m_mutex);
+	m_update_time = update_time;
+}
+
+std::uint32_t Session_impl::add_job(std::shared_ptr<LLP::CBlock const> block, Nonce_range const& nonce_range, std::uint32_t pool_nbits)
+{
+	std::scoped_lock lock(m_mutex);
+	// jobs of previous heights can't become blocks anymore
+	for (auto& job : m_jobs)
+	{
+		if (job.m_block && job.m_block->nHeight < block->nHeight)
+		{
+			job = Session_job{};
+		}
+	}
+
+	// 0 is invalid
+	auto work_id = m_latest_work_id + 1;
+	if (work_id == 0U)
+	{
+		work_id = 1U;
+	}
+
+	// shares of this job only differ in the nonce -> hash the constant part of the header once
+	LLP::Block_hash_context::Sptr hash_context;
+	if (block->nChannel == 2)
+	{
+		hash_context = std::make_shared<LLP::Block_hash_context const>(*block, pool_nbits);
+	}
+
+	m_jobs[work_id % max_jobs] = Session_job{ work_id, std::move(block), nonce_range, pool_nbits, m_share_weight, std::move(hash_context) };
+	m_latest_work_id = work_id;
+	return work_id;
+}
+
+bool Session_impl::get_job(std::uint32_t work_id, Session_job& job) const
 {
-	m_user_data.m_account = m_data_reader->get_account(m_user_data.m_account.m_address);
-	m_user_data.m_account.m_shares++;
-	m_hashrate_helper.add_share();
-	return m_data_writer->update_account(m_user_data.m_account);
+	std::scoped_lock lock(m_mutex);
+	auto const& stored_job = m_jobs[work_id % max_jobs];
+	if (work_id == 0U || stored_job.m_work_id != work_id || !stored_job.m_block)
+	{
+		return false;
+	}
+
+	job = stored_job;
+	return true;
+}
+
+bool Session_impl::get_latest_job(Session_job& job) const
+{
+	std::scoped_lock lock(m_mutex);
+	auto const& stored_job = m_jobs[m_latest_work_id % max_jobs];
+	if (m_latest_work_id == 0U || stored_job.m_work_id != m_latest_work_id || !stored_job.m_block)
+	{
+		return false;
+	}
+
+	job = stored_job;
+	return true;
+}
+
+void Session_impl::needs_work(bool need_work)
+{
+	// only enqueue on the change to 'needs work' -> a session is at most once in the work queue
+	auto const previous_need_work = m_work_needed.exchange(need_work);
+	if (need_work && !previous_need_work)
+	{
+		m_work_queue->push(m_key);
+	}
+}
+
+bool Session_impl::add_share(double share_weight)
+{
+	std::scoped_lock lock(m_mutex);
+	// the share ledger writes the shares to the database batched
+	m_user_data.m_account.m_shares += share_weight;
+	m_share_ledger->add_share(m_user_data.m_account.m_address, share_weight);
+	if (m_hashrate_helper.add_share())
+	{
+		m_vardiff.set_average_share_time(m_hashrate_helper.get_average_share_time());
+	}
+	return true;
 }
 
 void Session_impl::reset_shares()
 {
-	m_user_data.m_account = m_data_reader->get_account(m_user_data.m_account.m_address);
+	std::scoped_lock lock(m_mutex);
+	// shares in the database are reset by the reward component at round end
 	m_user_data.m_account.m_shares = 0;
-	m_data_writer->update_account(m_user_data.m_account);
 }
 
 void Session_impl::update_hashrate(double hashrate, std::uint32_t pool_nbits, std::uint32_t network_nbits)
 {
-	m_user_data.m_account = m_data_reader->get_account(m_user_data.m_account.m_address);
+	std::scoped_lock lock(m_mutex);
 	if (m_legacy_mode && pool_nbits > 0 && network_nbits > 0)
 	{
 		hashrate = m_hashrate_helper.get_hashrate(pool_nbits, network_nbits, 0.0);
 	}
 
 	m_user_data.m_account.m_hashrate = hashrate;
-	m_data_writer->update_account(m_user_data.m_account);
+	m_share_ledger->set_hashrate(m_user_data.m_account.m_address, hashrate);
+}
+
+std::uint32_t Session_impl::retarget_difficulty(std::uint32_t pool_nbits, std::uint32_t network_nbits)
+{
+	std::scoped_lock lock(m_mutex);
+	if (!m_vardiff.is_enabled())
+	{
+		return pool_nbits;
+	}
+
+	if (m_vardiff.retarget(m_hashrate_helper.get_time_since_last_share()))
+	{
+		// the next share window only contains shares of the new difficulty
+		m_hashrate_helper.reset_window();
+	}
+
+	auto step = m_vardiff.get_step();
+	auto const nbits = get_vardiff_nbits(pool_nbits, network_nbits, step);
+	m_vardiff.set_step(step);
+	// shares are weighted by their difficulty compared to the pool difficulty
+	m_share_weight = get_share_weight(pool_nbits, nbits);
+	return nbits;
 }
 
 bool Session_impl::create_account()
 {
+	std::scoped_lock lock(m_mutex);
 	assert(m_user_data.m_new_account);
 	assert(!m_user_data.m_account.m_address.empty());
 
 	return m_data_writer->create_account(m_user_data.m_account.m_address, m_user_data.m_account.m_display_name);
 }
 
-std::unique_ptr<LLP::CBlock> Session_impl::get_block()
-{
-	if (m_block)
-	{
-		return std::move(m_block);
-	}
-	return nullptr;
-}
-
 void Session_impl::login()
 {
+	std::scoped_lock lock(m_mutex);
 	auto const account_data = m_data_reader->get_account(m_user_data.m_account.m_address);
 
 	if (!account_data.is_empty())
@@ -90,7 +222,7 @@ void Session_impl::login()
 		{
 			m_user_data.m_account.m_display_name = display_name_received;
 			// new display name! update account
-			m_data_writer->update_account(m_user_data.m_account);
+			m_data_writer->write_async([account = m_user_data.m_account](persistance::Data_writer& writer) { return writer.update_account(account); }, {});
 		}
 	}
 
@@ -103,60 +235,90 @@ void Session_impl::login()
 
 Session_registry_impl::Session_registry_impl(persistance::Data_reader::Uptr data_reader,
 	persistance::Shared_data_writer::Sptr data_writer,
+	Share_ledger::Sptr share_ledger,
 	nexus_http_interface::Component::Sptr http_interface,
 	std::uint32_t session_expiry_time,
 	common::Mining_mode mining_mode,
-	bool legacy_mode)
+	bool legacy_mode,
+	std::uint32_t vardiff_shares_per_minute)
 	: m_data_reader{ std::make_shared<Shared_data_reader>(std::move(data_reader)) }
 	, m_data_writer{ std::move(data_writer) }
+	, m_share_ledger{ std::move(share_ledger) }
 	, m_http_interface{std::move(http_interface)}
-	, m_sessions{}
+	, m_shards{}
+	, m_next_session_key{ 1U }		// 0 is reserved for empty slots in the session table
+	, m_sessions_size{ 0U }
+	, m_work_queue{ std::make_shared<Session_work_queue>() }
 	, m_session_expiry_time{ session_expiry_time }
 	, m_mining_mode{mining_mode}
 	, m_legacy_mode{legacy_mode}
+	, m_vardiff_shares_per_minute{ vardiff_shares_per_minute }
 {}
 
 void Session_registry_impl::stop()
 {
-	std::scoped_lock lock(m_sessions_mutex);
+	for (auto& shard : m_shards)
+	{
+		std::unique_lock lock(shard.m_mutex);
+		shard.m_sessions.clear();
+	}
+	m_sessions_size = 0U;
+	m_work_queue->clear();
+}
 
-	m_sessions.clear();
+void Session_registry_impl::for_each_session(std::function<void(std::shared_ptr<Session> const&)> const& handler)
+{
+	for (auto& shard : m_shards)
+	{
+		std::shared_lock lock(shard.m_mutex);
+		shard.m_sessions.for_each([&handler](Session_key, std::shared_ptr<Session> const& session)
+		{
+			handler(session);
+		});
+	}
 }
 
 Session_key Session_registry_impl::create_session()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	auto const session_key = LLC::GetRand256();
-	m_sessions.emplace(std::make_pair(session_key, std::make_shared<Session_impl>(m_data_writer, m_data_reader, m_mining_mode, m_legacy_mode)));
+	auto const session_key = m_next_session_key++;
+	// vardiff steps are only defined for the hash channel
+	auto const vardiff_shares_per_minute = m_mining_mode == common::Mining_mode::HASH ? m_vardiff_shares_per_minute : 0U;
+	auto session = std::make_shared<Session_impl>(session_key, m_work_queue, m_data_writer, m_data_reader, m_share_ledger, 
+		m_mining_mode, m_legacy_mode, vardiff_shares_per_minute);
+	{
+		auto& shard = get_shard(session_key);
+		std::unique_lock lock(shard.m_mutex);
+		shard.m_sessions.insert(session_key, session);
+	}
+	m_sessions_size++;
+	// a new session needs work. Enqueue after insert, otherwise the work queue could drop the key
+	session->needs_work(true);
 	return session_key;
 }
 
 std::shared_ptr<Session> Session_registry_impl::get_session(Session_key key)
 {
-	std::scoped_lock lock(m_sessions_mutex);
-	if (m_sessions.count(key) == 0)
-	{
-		return nullptr;
-	}
-	return m_sessions[key];
+	auto& shard = get_shard(key);
+	std::shared_lock lock(shard.m_mutex);
+	return shard.m_sessions.find(key);
 }
 
 std::shared_ptr<Session> Session_registry_impl::get_session_with_no_work()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	for (auto& session : m_sessions)
+	Session_key key{ 0U };
+	while (m_work_queue->pop(key))
 	{
-		if (session.second->is_inactive())
+		// session could be deleted in the meantime
+		auto session = get_session(key);
+		if (!session || session->is_inactive())
 		{
 			continue;
 		}
- 
-		if (session.second->is_need_work())
+
+		if (session->is_need_work())
 		{
-			session.second->needs_work(false);
-			return session.second;
+			session->needs_work(false);
+			return session;
 		}
 	}
 	return nullptr;
@@ -164,83 +326,84 @@ std::shared_ptr<Session> Session_registry_impl::get_session_with_no_work()
 
 void Session_registry_impl::reset_work_status_of_sessions()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	for (auto& session : m_sessions)
+	for_each_session([](std::shared_ptr<Session> const& session)
 	{
-		session.second->needs_work(true);
-	}
+		session->needs_work(true);
+	});
 }
 
 void Session_registry_impl::clear_unused_sessions()
 {
-	std::scoped_lock lock(m_sessions_mutex);
 	auto time_now = std::chrono::steady_clock::now();
-	auto iter = m_sessions.begin();
-	while (iter != m_sessions.end())
+	for (auto& shard : m_shards)
 	{
-		// delete already inactive sessions. Can happen if the miner disconnects
-		if (iter->second->is_inactive())
+		std::vector<std::shared_ptr<Session>> deleted_sessions;		// destroyed outside of the shard lock
+		std::unique_lock lock(shard.m_mutex);
+		std::vector<Session_key> unused_sessions;
+		shard.m_sessions.for_each([this, &time_now, &unused_sessions](Session_key key, std::shared_ptr<Session> const& session)
 		{
-			iter = m_sessions.erase(iter);
-			continue;
-		}
-
-		// delete sessions were the session is expired (when the pool cuts the connection to miner)
-		if (std::chrono::duration_cast<std::chrono::seconds>(time_now - iter->second->get_update_time()).count() > m_session_expiry_time)
+			// delete already inactive sessions. Can happen if the miner disconnects
+			// delete sessions were the session is expired (when the pool cuts the connection to miner)
+			if (session->is_inactive() ||
+				std::chrono::duration_cast<std::chrono::seconds>(time_now - session->get_update_time()).count() > m_session_expiry_time)
+			{
+				unused_sessions.push_back(key);
+			}
+		});
+
+		for (auto const key : unused_sessions)
 		{
-			iter = m_sessions.erase(iter);
-		}
-		else
-		{
-			++iter;
+			deleted_sessions.push_back(shard.m_sessions.find(key));
+			shard.m_sessions.erase(key);
 		}
+		m_sessions_size -= unused_sessions.size();
 	}
 }
 
 void Session_registry_impl::end_round()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	for (auto& session : m_sessions)
+	for_each_session([](std::shared_ptr<Session> const& session)
 	{
-		session.second->reset_shares();
-	}
+		session->reset_shares();
+	});
 }
 
 std::size_t Session_registry_impl::get_sessions_size()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-	return m_sessions.size();
+	return m_sessions_size;
 }
 
-void Session_registry_impl::get_hashrate()
+std::vector<std::shared_ptr<Miner_connection>> Session_registry_impl::get_connections()
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	for (auto& session : m_sessions)
+	std::vector<std::shared_ptr<Miner_connection>> miner_connections;
+	miner_connections.reserve(m_sessions_size);
+	for_each_session([&miner_connections](std::shared_ptr<Session> const& session)
 	{
-		auto miner_connection = session.second->get_connection();
-		auto miner_connection_shared = miner_connection.lock();
+		auto miner_connection_shared = session->get_connection().lock();
 		if (miner_connection_shared)
 		{
-			miner_connection_shared->get_hashrate();
+			miner_connections.push_back(std::move(miner_connection_shared));
 		}
+	});
+	return miner_connections;
+}
+
+void Session_registry_impl::get_hashrate()
+{
+	// transmit outside of the registry locks
+	for (auto& miner_connection : get_connections())
+	{
+		miner_connection->get_hashrate();
 	}
 }
 
 void Session_registry_impl::send_notification(std::string message)
 {
-	std::scoped_lock lock(m_sessions_mutex);
-
-	for (auto& session : m_sessions)
+	// serialize once for all miners and transmit outside of the registry locks
+	auto const notification = create_pool_notification(message);
+	for (auto& miner_connection : get_connections())
 	{
-		auto miner_connection = session.second->get_connection();
-		auto miner_connection_shared = miner_connection.lock();
-		if (miner_connection_shared)
-		{
-			miner_connection_shared->send_pool_notification(std::move(message));
-		}
+		miner_connection->send_pool_notification(notification);
 	}
 }
 
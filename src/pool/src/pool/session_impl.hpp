@@ -1,10 +1,12 @@
 #ifndef NEXUSPOOL_SESSION_IMPL_HPP
 #define NEXUSPOOL_SESSION_IMPL_HPP
 
-#include <map>
+#include <array>
+#include <vector>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
 #include <chrono>
 #include <atomic>
 #include "LLC/types/uint1024.h"
@@ -14,6 +16,8 @@
 #include "pool/utils.hpp"
 #include "pool/session.hpp"
 #include "pool/shared_data_reader.hpp"
+#include "pool/share_ledger.hpp"
+#include "pool/session_table.hpp"
 #include "LLP/block.hpp"
 
 namespace nexuspool
@@ -25,41 +29,59 @@ class Session_impl : public Session
 {
 public:
 
-	Session_impl(persistance::Shared_data_writer::Sptr data_writer, 
+	Session_impl(Session_key key,
+		Session_work_queue::Sptr work_queue,
+		persistance::Shared_data_writer::Sptr data_writer, 
 		Shared_data_reader::Sptr data_reader, 
+		Share_ledger::Sptr share_ledger,
 		common::Mining_mode mining_mode,
-		bool legacy_mode);
+		bool legacy_mode,
+		std::uint32_t vardiff_shares_per_minute,
+		Hashrate_helper::Clock clock = std::chrono::steady_clock::now);
 	~Session_impl();
 
 	void update_connection(std::shared_ptr<Miner_connection> miner_connection) override;
-	std::weak_ptr<Miner_connection> get_connection() override { return m_miner_connection; }
-	Session_user get_user_data() const override { return m_user_data; }
-	void update_user_data(Session_user const& user_data) override { m_user_data = user_data; }
-	std::chrono::steady_clock::time_point get_update_time() const override { return m_update_time; }
-	void set_update_time(std::chrono::steady_clock::time_point update_time) override { m_update_time = update_time; }
-	bool add_share() override;
+	std::weak_ptr<Miner_connection> get_connection() override;
+	Session_user get_user_data() const override;
+	void update_user_data(Session_user const& user_data) override;
+	std::chrono::steady_clock::time_point get_update_time() const override;
+	void set_update_time(std::chrono::steady_clock::time_point update_time) override;
+	bool add_share(double share_weight) override;
 	void reset_shares() override;
 	void update_hashrate(double hashrate, std::uint32_t pool_nbits, std::uint32_t network_nbits) override;
-	void set_block(LLP::CBlock const& block) override { m_block = std::make_unique<LLP::CBlock>(block); }
-	std::unique_ptr<LLP::CBlock> get_block() override;
+	std::uint32_t retarget_difficulty(std::uint32_t pool_nbits, std::uint32_t network_nbits) override;
+	std::uint32_t add_job(std::shared_ptr<LLP::CBlock const> block, Nonce_range const& nonce_range, std::uint32_t pool_nbits) override;
+	bool get_job(std::uint32_t work_id, Session_job& job) const override;
+	bool get_latest_job(Session_job& job) const override;
 	bool is_inactive() const override { return m_inactive; }
 	void set_inactive() { m_inactive = true; }
 	bool is_need_work() const override { return m_work_needed;  }
-	void needs_work(bool need_work) override { m_work_needed = need_work; }
+	void needs_work(bool need_work) override;
 
 	bool create_account() override;
 	void login() override;
 
 private:
 
+	// jobs are stored in a ring indexed by work_id
+	static constexpr std::size_t max_jobs{ 8U };
+
+	Session_key m_key;
+	Session_work_queue::Sptr m_work_queue;
 	persistance::Shared_data_writer::Sptr m_data_writer;
 	Shared_data_reader::Sptr m_data_reader;
+	Share_ledger::Sptr m_share_ledger;
+	// a session is accessed from its miner_connection, the pool_manager and the session_registry maintenance
+	mutable std::mutex m_mutex;
 	Session_user m_user_data;
 	std::shared_ptr<Miner_connection> m_miner_connection;
 	std::chrono::steady_clock::time_point m_update_time;
 	Hashrate_helper m_hashrate_helper;
+	Vardiff m_vardiff;
+	double m_share_weight;		// share weight at the difficulty of the latest retarget, stored in the jobs
 	bool m_legacy_mode;
-	std::unique_ptr<LLP::CBlock> m_block;
+	std::array<Session_job, max_jobs> m_jobs;
+	std::uint32_t m_latest_work_id;
 	std::atomic_bool m_inactive;
 	std::atomic_bool m_work_needed;
 };
@@ -71,10 +93,12 @@ public:
 
 	Session_registry_impl(persistance::Data_reader::Uptr data_reader,
 		persistance::Shared_data_writer::Sptr data_writer,
+		Share_ledger::Sptr share_ledger,
 		nexus_http_interface::Component::Sptr http_interface,
 		std::uint32_t session_expiry_time,
 		common::Mining_mode mining_mode,
-		bool legacy_mode);
+		bool legacy_mode,
+		std::uint32_t vardiff_shares_per_minute);
 
 	void stop() override;
 
@@ -97,14 +121,32 @@ public:
 
 private:
 
+	static constexpr std::size_t shard_count{ 16U };
+
+	// sessions are spread over shards with their own lock -> concurrent lookups don't serialize on one lock
+	struct Shard
+	{
+		std::shared_mutex m_mutex;
+		Session_table m_sessions;
+	};
+
+	Shard& get_shard(Session_key key) { return m_shards[key % shard_count]; }
+	void for_each_session(std::function<void(std::shared_ptr<Session> const&)> const& handler);
+	// snapshot of the connections of all sessions
+	std::vector<std::shared_ptr<Miner_connection>> get_connections();
+
 	Shared_data_reader::Sptr m_data_reader;			// hold ownership over data_reader/writer
 	persistance::Shared_data_writer::Sptr m_data_writer;
+	Share_ledger::Sptr m_share_ledger;
 	nexus_http_interface::Component::Sptr m_http_interface;
-	std::mutex m_sessions_mutex;
-	std::map<Session_key, std::shared_ptr<Session>> m_sessions;
+	std::array<Shard, shard_count> m_shards;
+	std::atomic<Session_key> m_next_session_key;
+	std::atomic<std::size_t> m_sessions_size;
+	Session_work_queue::Sptr m_work_queue;
 	std::uint32_t m_session_expiry_time;
 	common::Mining_mode m_mining_mode;
 	bool m_legacy_mode;
+	std::uint32_t m_vardiff_shares_per_minute;
 
 };
 
@@ -0,0 +1,162 @@
+#include "pool/session_table.hpp"
+
+namespace nexuspool
+{
+
+Session_table::Session_table()
+	: m_slots(min_capacity)
+	, m_mask{ min_capacity - 1 }
+	, m_size{ 0U }
+{
+}
+
+std::size_t Session_table::get_index(Session_key key) const
+{
+	// session keys are sequential -> fibonacci hashing spreads them over the table
+	return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & m_mask;
+}
+
+std::size_t Session_table::find_slot(Session_key key) const
+{
+	auto index = get_index(key);
+	while (m_slots[index].m_key != 0U)
+	{
+		if (m_slots[index].m_key == key)
+		{
+			return index;
+		}
+		index = (index + 1) & m_mask;
+	}
+	return m_slots.size();
+}
+
+bool Session_table::insert(Session_key key, std::shared_ptr<Session> session)
+{
+	if (key == 0U)
+	{
+		return false;
+	}
+
+	// keep load factor below 0.75
+	if ((m_size + 1) * 4 > m_slots.size() * 3)
+	{
+		rehash(m_slots.size() * 2);
+	}
+
+	auto index = get_index(key);
+	while (m_slots[index].m_key != 0U)
+	{
+		if (m_slots[index].m_key == key)
+		{
+			return false;
+		}
+		index = (index + 1) & m_mask;
+	}
+
+	m_slots[index].m_key = key;
+	m_slots[index].m_session = std::move(session);
+	m_size++;
+	return true;
+}
+
+std::shared_ptr<Session> Session_table::find(Session_key key) const
+{
+	auto const index = find_slot(key);
+	if (index == m_slots.size())
+	{
+		return nullptr;
+	}
+	return m_slots[index].m_session;
+}
+
+bool Session_table::erase(Session_key key)
+{
+	auto index = find_slot(key);
+	if (index == m_slots.size())
+	{
+		return false;
+	}
+
+	m_slots[index] = Slot{};
+	m_size--;
+
+	// backward shift the following entries of the probe sequence -> no tombstones needed
+	auto next = (index + 1) & m_mask;
+	while (m_slots[next].m_key != 0U)
+	{
+		auto const home = get_index(m_slots[next].m_key);
+		// move the entry if its home slot isn't cyclically within (index, next]
+		if (((next - home) & m_mask) >= ((next - index) & m_mask))
+		{
+			m_slots[index] = std::move(m_slots[next]);
+			m_slots[next] = Slot{};
+			index = next;
+		}
+		next = (next + 1) & m_mask;
+	}
+	return true;
+}
+
+void Session_table::clear()
+{
+	m_slots.clear();
+	m_slots.resize(min_capacity);
+	m_mask = min_capacity - 1;
+	m_size = 0U;
+}
+
+void Session_table::for_each(std::function<void(Session_key, std::shared_ptr<Session> const&)> const& handler) const
+{
+	for (auto const& slot : m_slots)
+	{
+		if (slot.m_key != 0U)
+		{
+			handler(slot.m_key, slot.m_session);
+		}
+	}
+}
+
+void Session_table::rehash(std::size_t capacity)
+{
+	std::vector<Slot> old_slots(capacity);
+	old_slots.swap(m_slots);
+	m_mask = capacity - 1;
+	m_size = 0U;
+
+	for (auto& slot : old_slots)
+	{
+		if (slot.m_key != 0U)
+		{
+			insert(slot.m_key, std::move(slot.m_session));
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------------------
+
+void Session_work_queue::push(Session_key key)
+{
+	std::scoped_lock lock(m_mutex);
+	m_queue.push_back(key);
+}
+
+bool Session_work_queue::pop(Session_key& key)
+{
+	std::scoped_lock lock(m_mutex);
+	if (m_queue.empty())
+	{
+		return false;
+	}
+
+	key = m_queue.front();
+	m_queue.pop_front();
+	return true;
+}
+
+void Session_work_queue::clear()
+{
+	std::scoped_lock lock(m_mutex);
+	m_queue.clear();
+}
+
+}
@@ -0,0 +1,71 @@
+#ifndef NEXUSPOOL_SESSION_TABLE_HPP
+#define NEXUSPOOL_SESSION_TABLE_HPP
+
+#include "pool/types.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nexuspool
+{
+class Session;
+
+// Open addressing hash table (linear probing, backward shift deletion) for sessions.
+// Session_key 0 marks an empty slot. Not thread safe, the session_registry guards each table with its own lock.
+class Session_table
+{
+public:
+
+	Session_table();
+
+	bool insert(Session_key key, std::shared_ptr<Session> session);
+	std::shared_ptr<Session> find(Session_key key) const;
+	bool erase(Session_key key);
+	void clear();
+	std::size_t size() const { return m_size; }
+
+	void for_each(std::function<void(Session_key, std::shared_ptr<Session> const&)> const& handler) const;
+
+private:
+
+	struct Slot
+	{
+		Session_key m_key{ 0U };
+		std::shared_ptr<Session> m_session;
+	};
+
+	static constexpr std::size_t min_capacity{ 16U };
+
+	std::size_t get_index(Session_key key) const;
+	std::size_t find_slot(Session_key key) const;		// returns capacity if not found
+	void rehash(std::size_t capacity);
+
+	std::vector<Slot> m_slots;
+	std::size_t m_mask;
+	std::size_t m_size;
+};
+
+// Sessions which need new work. A session enqueues itself once when its work flag changes from false to true.
+class Session_work_queue
+{
+public:
+
+	using Sptr = std::shared_ptr<Session_work_queue>;
+
+	void push(Session_key key);
+	bool pop(Session_key& key);
+	void clear();
+
+private:
+
+	std::mutex m_mutex;
+	std::deque<Session_key> m_queue;
+};
+
+}
+
+#endif
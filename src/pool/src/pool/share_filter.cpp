@@ -0,0 +1,105 @@
+#include "pool/share_filter.hpp"
+
+#include <thread>
+
+namespace nexuspool
+{
+
+Share_filter::Share_filter(std::size_t capacity)
+	: m_capacity{ 1U }
+	, m_slots{}
+	, m_duplicates{ 0U }
+{
+	while (m_capacity < capacity)
+	{
+		m_capacity <<= 1;
+	}
+
+	m_slots = std::make_unique<Slot[]>(m_capacity);
+	clear();
+}
+
+Share_filter::Key Share_filter::get_key(uint512_t const& merkle_root, std::uint64_t nonce)
+{
+	Key key{};
+	for (std::uint32_t i = 0; i < key_words - 1; ++i)
+	{
+		key[i] = merkle_root.Get64(i);
+	}
+	key[key_words - 1] = nonce;
+	return key;
+}
+
+std::uint64_t Share_filter::get_fingerprint(Key const& key)
+{
+	// splitmix64 finalizer over merkle_root and nonce
+	auto fingerprint = key[0] ^ key[1] ^ (key[key_words - 1] * 0x9E3779B97F4A7C15ULL);
+	fingerprint = (fingerprint ^ (fingerprint >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	fingerprint = (fingerprint ^ (fingerprint >> 27)) * 0x94D049BB133111EBULL;
+	fingerprint ^= fingerprint >> 31;
+	return fingerprint <= writing_slot ? fingerprint + 2U : fingerprint;
+}
+
+bool Share_filter::has_key(Slot const& slot, Key const& key)
+{
+	for (std::size_t i = 0; i < key_words; ++i)
+	{
+		if (slot.m_key[i].load(std::memory_order_relaxed) != key[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Share_filter::insert(uint512_t const& merkle_root, std::uint64_t nonce)
+{
+	auto const key = get_key(merkle_root, nonce);
+	auto const fingerprint = get_fingerprint(key);
+	auto const mask = m_capacity - 1;
+	auto index = static_cast<std::size_t>(fingerprint) & mask;
+	for (std::size_t probe = 0; probe < max_probes; ++probe, index = (index + 1) & mask)
+	{
+		auto& slot = m_slots[index];
+		auto expected = slot.m_fingerprint.load(std::memory_order_acquire);
+		if (expected == empty_slot)
+		{
+			if (slot.m_fingerprint.compare_exchange_strong(expected, writing_slot, std::memory_order_acquire))
+			{
+				for (std::size_t i = 0; i < key_words; ++i)
+				{
+					slot.m_key[i].store(key[i], std::memory_order_relaxed);
+				}
+				slot.m_fingerprint.store(fingerprint, std::memory_order_release);
+				return true;
+			}
+			// another thread took the slot in between, expected holds its state
+		}
+
+		// the key is written right after the slot is taken -> wait for it instead of treating a duplicate as new
+		while (expected == writing_slot)
+		{
+			std::this_thread::yield();
+			expected = slot.m_fingerprint.load(std::memory_order_acquire);
+		}
+
+		if (expected == fingerprint && has_key(slot, key))
+		{
+			m_duplicates++;
+			return false;
+		}
+	}
+
+	// probe sequence full
+	return true;
+}
+
+void Share_filter::clear()
+{
+	for (std::size_t i = 0; i < m_capacity; ++i)
+	{
+		m_slots[i].m_fingerprint.store(empty_slot, std::memory_order_relaxed);
+	}
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef NEXUSPOOL_SHARE_FILTER_HPP
+#define NEXUSPOOL_SHARE_FILTER_HPP
+
+#include "LLC/types/uint1024.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace nexuspool
+{
+
+// Detects shares which have already been submitted for the current height, before they are validated.
+// Lock free open addressing set of (merkle_root, nonce) keys, cleared on every new height. The fingerprint of a key
+// only selects the slots, a share is rejected if the full key matches -> colliding shares keep their credit.
+// If the probe sequence of a fingerprint is full the share is treated as new -> never rejects a new share.
+class Share_filter
+{
+public:
+
+	static constexpr std::size_t default_capacity{ 1U << 17 };
+
+	// capacity is rounded up to a power of 2
+	explicit Share_filter(std::size_t capacity = default_capacity);
+
+	// returns false if the share has already been submitted
+	bool insert(uint512_t const& merkle_root, std::uint64_t nonce);
+	void clear();
+
+	std::uint64_t get_duplicates() const { return m_duplicates; }
+
+private:
+
+	static constexpr std::size_t max_probes{ 32U };
+	// fingerprint 0 marks an empty slot, 1 a slot whose key is being written
+	static constexpr std::uint64_t empty_slot{ 0U };
+	static constexpr std::uint64_t writing_slot{ 1U };
+	// 8 words merkle_root, 1 word nonce
+	static constexpr std::size_t key_words{ 9U };
+
+	using Key = std::array<std::uint64_t, key_words>;
+
+	struct Slot
+	{
+		std::atomic<std::uint64_t> m_fingerprint;
+		std::array<std::atomic<std::uint64_t>, key_words> m_key;	// valid once the fingerprint is stored
+	};
+
+	static Key get_key(uint512_t const& merkle_root, std::uint64_t nonce);
+	static std::uint64_t get_fingerprint(Key const& key);
+	static bool has_key(Slot const& slot, Key const& key);
+
+	std::size_t m_capacity;
+	std::unique_ptr<Slot[]> m_slots;
+	std::atomic<std::uint64_t> m_duplicates;
+};
+
+}
+
+#endif
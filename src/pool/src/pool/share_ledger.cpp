@@ -0,0 +1,133 @@
+#include "pool/share_ledger.hpp"
+
+#include <functional>
+
+namespace nexuspool
+{
+
+Share_ledger::Share_ledger(persistance::Shared_data_writer::Sptr data_writer)
+	: m_data_writer{ std::move(data_writer) }
+	, m_shards{}
+{
+}
+
+Share_ledger::Shard& Share_ledger::get_shard(std::string const& address)
+{
+	return m_shards[std::hash<std::string>{}(address) % shard_count];
+}
+
+void Share_ledger::add_share(std::string const& address, double shares)
+{
+	if (address.empty())
+	{
+		return;
+	}
+
+	auto& shard = get_shard(address);
+	std::scoped_lock lock(shard.m_mutex);
+	auto& account = shard.m_accounts[address];
+	account.m_address = address;
+	account.m_shares += shares;
+}
+
+void Share_ledger::set_hashrate(std::string const& address, double hashrate)
+{
+	if (address.empty())
+	{
+		return;
+	}
+
+	auto& shard = get_shard(address);
+	std::scoped_lock lock(shard.m_mutex);
+	auto& account = shard.m_accounts[address];
+	account.m_address = address;
+	account.m_hashrate = hashrate;
+	account.m_update_hashrate = true;
+}
+
+bool Share_ledger::flush()
+{
+	// only one flush at a time, otherwise a failed flush could merge back after a newer succeeded one
+	std::scoped_lock flush_lock(m_flush_mutex);
+
+	// wait for the queued async flushes. A failed one is merged back before collect() and written with this flush,
+	// otherwise it would merge back after the round end and its shares would be credited to the next round
+	m_data_writer->flush();
+
+	auto data = collect();
+	if (data.empty())
+	{
+		return true;
+	}
+
+	if (m_data_writer->add_shares_to_accounts(data))
+	{
+		return true;
+	}
+
+	merge(std::move(data));
+	return false;
+}
+
+void Share_ledger::flush_async(Flush_handler handler)
+{
+	// not queued while flush() waits for the queued async flushes
+	std::scoped_lock flush_lock(m_flush_mutex);
+
+	auto data = std::make_shared<std::vector<persistance::Account_share_data>>(collect());
+	if (data->empty())
+	{
+		handler(true);
+		return;
+	}
+
+	// on failure the data is merged back and written with one of the next flushes
+	m_data_writer->write_async([data](persistance::Data_writer& data_writer) { return data_writer.add_shares_to_accounts(*data); },
+		[self = shared_from_this(), data, handler = std::move(handler)](bool result)
+		{
+			if (!result)
+			{
+				self->merge(std::move(*data));
+			}
+			handler(result);
+		});
+}
+
+std::vector<persistance::Account_share_data> Share_ledger::collect()
+{
+	std::vector<persistance::Account_share_data> data;
+	for (auto& shard : m_shards)
+	{
+		std::unordered_map<std::string, persistance::Account_share_data> accounts;
+		{
+			std::scoped_lock lock(shard.m_mutex);
+			accounts.swap(shard.m_accounts);
+		}
+
+		for (auto& account : accounts)
+		{
+			data.push_back(std::move(account.second));
+		}
+	}
+	return data;
+}
+
+void Share_ledger::merge(std::vector<persistance::Account_share_data> data)
+{
+	for (auto& account_data : data)
+	{
+		auto& shard = get_shard(account_data.m_address);
+		std::scoped_lock lock(shard.m_mutex);
+		auto& account = shard.m_accounts[account_data.m_address];
+		account.m_address = account_data.m_address;
+		account.m_shares += account_data.m_shares;
+		// a newer hashrate has priority over the one of the failed flush
+		if (!account.m_update_hashrate && account_data.m_update_hashrate)
+		{
+			account.m_hashrate = account_data.m_hashrate;
+			account.m_update_hashrate = true;
+		}
+	}
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef NEXUSPOOL_SHARE_LEDGER_HPP
+#define NEXUSPOOL_SHARE_LEDGER_HPP
+
+#include "persistance/data_writer.hpp"
+#include "persistance/types.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nexuspool
+{
+
+// Collects the shares and hashrates of all accounts in memory. The collected data is written
+// to the database with flush() as one transaction, instead of one read/write per submitted share.
+class Share_ledger : public std::enable_shared_from_this<Share_ledger>
+{
+public:
+
+	using Sptr = std::shared_ptr<Share_ledger>;
+	using Flush_handler = std::function<void(bool result)>;
+
+	explicit Share_ledger(persistance::Shared_data_writer::Sptr data_writer);
+
+	void add_share(std::string const& address, double shares);
+	void set_hashrate(std::string const& address, double hashrate);
+
+	// writes all collected data to the database, including the data of failed async flushes queued before.
+	// On failure the data is kept for the next flush
+	bool flush();
+	// same as flush() but doesn't wait for the database. The handler is called on the storage thread
+	void flush_async(Flush_handler handler);
+
+private:
+
+	static constexpr std::size_t shard_count{ 16U };
+
+	struct Shard
+	{
+		std::mutex m_mutex;
+		std::unordered_map<std::string, persistance::Account_share_data> m_accounts;
+	};
+
+	Shard& get_shard(std::string const& address);
+	std::vector<persistance::Account_share_data> collect();
+	void merge(std::vector<persistance::Account_share_data> data);
+
+	persistance::Shared_data_writer::Sptr m_data_writer;
+	std::array<Shard, shard_count> m_shards;
+	std::mutex m_flush_mutex;
+};
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+#include "pool/share_validator.hpp"
+#include "LLC/hash/SK_multi.h"
+#include "LLC/prime/fermat_multi.h"
+#include "TAO/Ledger/prime.h"
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <algorithm>
+
+namespace nexuspool
+{
+
+Share_validator::Share_validator(std::shared_ptr<asio::io_context> io_context,
+	reward::Component const& reward_component,
+	std::uint16_t threads,
+	std::size_t queue_size)
+	: m_io_context{ std::move(io_context) }
+	, m_reward_component{ reward_component }
+	, m_queue{ queue_size }
+	, m_workers{}
+	, m_max_queue_depth{ 0U }
+	, m_validated{ 0U }
+	, m_validated_inline{ 0U }
+	, m_total_latency_us{ 0U }
+	, m_max_latency_us{ 0U }
+{
+	std::uint32_t worker_threads = threads;
+	if (worker_threads == 0)
+	{
+		worker_threads = std::max(1U, std::thread::hardware_concurrency());
+	}
+
+	for (std::uint32_t i = 0; i < worker_threads; ++i)
+	{
+		m_workers.emplace_back([this]() { worker(); });
+	}
+}
+
+Share_validator::~Share_validator()
+{
+	stop();
+}
+
+void Share_validator::stop()
+{
+	m_queue.close();
+	for (auto& worker : m_workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+	m_workers.clear();
+}
+
+void Share_validator::validate(std::unique_ptr<LLP::CBlock> block, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context,
+	network::Connection::Sptr connection, Handler handler)
+{
+	Job job{ std::move(block), pool_nbits, std::move(hash_context), std::move(connection), std::move(handler), std::chrono::steady_clock::now() };
+	if (m_queue.try_push(std::move(job)))
+	{
+		auto const queue_depth = m_queue.size();
+		auto max_queue_depth = m_max_queue_depth.load();
+		while (queue_depth > max_queue_depth && !m_max_queue_depth.compare_exchange_weak(max_queue_depth, queue_depth));
+		return;
+	}
+
+	// queue full (or stopped) -> backpressure, the submitting connection validates the block itself
+	// try_push doesn't move from job if it fails
+	m_validated_inline++;
+	auto const result = check_difficulty(job);
+	complete(std::move(job), result);
+}
+
+Share_validator::Metrics Share_validator::get_metrics() const
+{
+	Metrics metrics;
+	metrics.m_queue_depth = m_queue.size();
+	metrics.m_max_queue_depth = m_max_queue_depth;
+	metrics.m_validated = m_validated;
+	metrics.m_validated_inline = m_validated_inline;
+	if (metrics.m_validated > 0)
+	{
+		metrics.m_average_latency_ms = static_cast<double>(m_total_latency_us) / metrics.m_validated / 1000.0;
+	}
+	metrics.m_max_latency_ms = static_cast<double>(m_max_latency_us) / 1000.0;
+	return metrics;
+}
+
+void Share_validator::worker()
+{
+	// take as many queued shares as the SK1024 / Fermat kernels process at once
+	auto const max_batch_size = std::max(LLC::SK1024Lanes(LLC::SK1024BestKernel()), LLC::FermatLanes(LLC::FermatBestKernel()));
+	std::vector<Job> jobs;
+	std::vector<reward::Difficulty_result> results;
+	while (m_queue.pop(jobs, max_batch_size) > 0)
+	{
+		check_difficulty(jobs, results);
+		for (std::size_t i = 0; i < jobs.size(); ++i)
+		{
+			complete(std::move(jobs[i]), results[i]);
+		}
+	}
+}
+
+reward::Difficulty_result Share_validator::check_difficulty(Job const& job) const
+{
+	if (job.m_hash_context)
+	{
+		return m_reward_component.check_difficulty(*job.m_block, *job.m_hash_context);
+	}
+	return m_reward_component.check_difficulty(*job.m_block, job.m_pool_nbits);
+}
+
+void Share_validator::check_difficulty(std::vector<Job> const& jobs, std::vector<reward::Difficulty_result>& results) const
+{
+	results.resize(jobs.size());
+	std::vector<std::size_t> hash_jobs;
+	std::vector<std::size_t> prime_jobs;
+	for (std::size_t i = 0; i < jobs.size(); ++i)
+	{
+		if (jobs[i].m_hash_context)
+		{
+			hash_jobs.push_back(i);
+		}
+		else if (jobs[i].m_block->nChannel == 1 && jobs[i].m_block->vOffsets.empty())
+		{
+			prime_jobs.push_back(i);
+		}
+		else
+		{
+			results[i] = check_difficulty(jobs[i]);
+		}
+	}
+
+	// prime shares of different miners without offsets, the clusters are walked together
+	if (prime_jobs.size() == 1)
+	{
+		results[prime_jobs.front()] = check_difficulty(jobs[prime_jobs.front()]);
+	}
+	else if (prime_jobs.size() > 1)
+	{
+		std::vector<uint1024_t> primes;
+		for (auto const index : prime_jobs)
+		{
+			primes.push_back(jobs[index].m_block->GetPrime());
+		}
+
+		std::vector<double> difficulties(prime_jobs.size());
+		TAO::Ledger::GetPrimeDifficulties(primes.data(), difficulties.data(), primes.size());
+		for (std::size_t i = 0; i < prime_jobs.size(); ++i)
+		{
+			auto const& job = jobs[prime_jobs[i]];
+			results[prime_jobs[i]] = m_reward_component.check_difficulty(difficulties[i], *job.m_block, job.m_pool_nbits);
+		}
+	}
+
+	// a single share is cheaper with the midstate of its job
+	if (hash_jobs.size() == 1)
+	{
+		results[hash_jobs.front()] = check_difficulty(jobs[hash_jobs.front()]);
+	}
+	else if (hash_jobs.size() > 1)
+	{
+		// the block header from nVersion to nNonce is the SK1024 input
+		std::vector<std::uint8_t const*> headers;
+		for (auto const index : hash_jobs)
+		{
+			headers.push_back(reinterpret_cast<std::uint8_t const*>(BEGIN(jobs[index].m_block->nVersion)));
+		}
+		auto const& block = *jobs[hash_jobs.front()].m_block;
+		auto const header_size = static_cast<std::size_t>(END(block.nNonce) - BEGIN(block.nVersion));
+
+		std::vector<uint1024_t> hashes(hash_jobs.size());
+		LLC::SK1024Multi(headers.data(), header_size, hashes.data(), hashes.size());
+		for (std::size_t i = 0; i < hash_jobs.size(); ++i)
+		{
+			results[hash_jobs[i]] = m_reward_component.check_difficulty(hashes[i], *jobs[hash_jobs[i]].m_hash_context);
+		}
+	}
+}
+
+void Share_validator::complete(Job&& job, reward::Difficulty_result result)
+{
+	auto const latency_us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - job.m_enqueue_time).count());
+	m_validated++;
+	m_total_latency_us += latency_us;
+	auto max_latency_us = m_max_latency_us.load();
+	while (latency_us > max_latency_us && !m_max_latency_us.compare_exchange_weak(max_latency_us, latency_us));
+
+	// hand the result back to the network threads. The strand of the connection serialises it with the received packets
+	auto completion = [handler = std::move(job.m_handler), block = std::make_shared<std::unique_ptr<LLP::CBlock>>(std::move(job.m_block)), result]()
+	{
+		handler(std::move(*block), result);
+	};
+	if (job.m_connection)
+	{
+		job.m_connection->post(std::move(completion));
+		return;
+	}
+	asio::post(*m_io_context, std::move(completion));
+}
+
+}
@@ -0,0 +1,90 @@
+#ifndef NEXUSPOOL_SHARE_VALIDATOR_HPP
+#define NEXUSPOOL_SHARE_VALIDATOR_HPP
+
+#include "LLP/block.hpp"
+#include "LLP/block_hash_context.hpp"
+#include "reward/component.hpp"
+#include "common/bounded_queue.hpp"
+#include "network/connection.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace asio { class io_context; }
+
+namespace nexuspool
+{
+
+// Verifies submitted blocks (SK1024 / Fermat tests) on dedicated worker threads so that
+// expensive share validation doesn't block the network threads.
+class Share_validator
+{
+public:
+
+	// Called on the strand of the submitting connection after the block has been validated (inside the io_context without connection)
+	using Handler = std::function<void(std::unique_ptr<LLP::CBlock> block, reward::Difficulty_result result)>;
+
+	struct Metrics
+	{
+		std::size_t m_queue_depth{ 0U };
+		std::size_t m_max_queue_depth{ 0U };
+		std::uint64_t m_validated{ 0U };
+		std::uint64_t m_validated_inline{ 0U };		// queue was full -> validated by the submitting thread
+		double m_average_latency_ms{ 0.0 };
+		double m_max_latency_ms{ 0.0 };
+	};
+
+	Share_validator(std::shared_ptr<asio::io_context> io_context,
+		reward::Component const& reward_component,
+		std::uint16_t threads,
+		std::size_t queue_size);
+	~Share_validator();
+
+	void stop();
+
+	// hash_context is optional (hash channel jobs), without it the full block header is hashed
+	void validate(std::unique_ptr<LLP::CBlock> block, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context,
+		network::Connection::Sptr connection, Handler handler);
+
+	Metrics get_metrics() const;
+
+private:
+
+	struct Job
+	{
+		std::unique_ptr<LLP::CBlock> m_block;
+		std::uint32_t m_pool_nbits{ 0U };
+		LLP::Block_hash_context::Sptr m_hash_context;
+		network::Connection::Sptr m_connection;
+		Handler m_handler;
+		std::chrono::steady_clock::time_point m_enqueue_time;
+	};
+
+	void worker();
+	reward::Difficulty_result check_difficulty(Job const& job) const;
+	// hash channel shares of the batch are hashed together with the multi lane SK1024,
+	// the Fermat tests of the prime channel shares run together on the multi lane kernels
+	void check_difficulty(std::vector<Job> const& jobs, std::vector<reward::Difficulty_result>& results) const;
+	void complete(Job&& job, reward::Difficulty_result result);
+
+	std::shared_ptr<asio::io_context> m_io_context;
+	reward::Component const& m_reward_component;
+	common::Bounded_queue<Job> m_queue;
+	std::vector<std::thread> m_workers;
+
+	// metrics
+	std::atomic<std::size_t> m_max_queue_depth;
+	std::atomic<std::uint64_t> m_validated;
+	std::atomic<std::uint64_t> m_validated_inline;
+	std::atomic<std::uint64_t> m_total_latency_us;
+	std::atomic<std::uint64_t> m_max_latency_us;
+};
+
+}
+
+#endif
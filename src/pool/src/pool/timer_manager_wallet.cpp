@@ -52,7 +52,7 @@ chrono::Timer::Handler Timer_manager_wallet::get_height_handler(std::uint16_t ge
         if(connection_shared)
         {
             Packet packet_get_height{ Packet::GET_HEIGHT, nullptr };
-            connection_shared->transmit(packet_get_height.get_bytes());
+            connection_shared->transmit(packet_get_height.get_payload_sequence());
 
             // restart timer
             m_get_height_timer->start(chrono::Seconds(get_height_interval), 
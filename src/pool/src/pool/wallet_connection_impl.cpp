@@ -1,11 +1,13 @@
 #include "pool/wallet_connection_impl.hpp"
 #include "pool/pool_manager.hpp"
 #include <spdlog/spdlog.h>
+#include <asio/post.hpp>
 #include <algorithm>
 
 namespace nexuspool
 {
 Wallet_connection_impl::Wallet_connection_impl(std::shared_ptr<asio::io_context> io_context,
+    ::asio::strand<::asio::io_context::executor_type> strand,
     std::shared_ptr<spdlog::logger> logger,
     std::weak_ptr<Pool_manager> pool_manager,
     common::Mining_mode mining_mode,
@@ -14,6 +16,7 @@ Wallet_connection_impl::Wallet_connection_impl(std::shared_ptr<asio::io_context>
     chrono::Timer_factory::Sptr timer_factory, 
     network::Socket::Sptr socket)
     : m_io_context{ std::move(io_context) }
+    , m_strand{ std::move(strand) }
     , m_logger{std::move(logger)}
     , m_pool_manager{std::move(pool_manager)}
     , m_mining_mode{mining_mode}
@@ -51,11 +54,24 @@ void Wallet_connection_impl::retry_connect(network::Endpoint const& wallet_endpo
 
 bool Wallet_connection_impl::connect(network::Endpoint const& wallet_endpoint)
 {
+    // connection retries are triggered from a timer -> m_connection is only changed inside the strand
+    if (!m_stopped && !m_strand.running_in_this_thread() && m_connection)
+    {
+        ::asio::post(m_strand, [self = shared_from_this(), wallet_endpoint]() { self->connect(wallet_endpoint); });
+        return true;
+    }
+
     std::weak_ptr<Wallet_connection_impl> weak_self = shared_from_this();
     auto connection = m_socket->connect(wallet_endpoint, [weak_self, wallet_endpoint](auto result, auto receive_buffer)
         {
             auto self = weak_self.lock();
-            if (self)
+            if (!self)
+            {
+                return;
+            }
+
+            // the wallet_connection state is shared with the pool_manager -> process everything inside the common strand
+            ::asio::post(self->m_strand, [self, wallet_endpoint, result, receive_buffer = std::move(receive_buffer)]() mutable
             {
                 if (result == network::Result::connection_declined ||
                     result == network::Result::connection_aborted ||
@@ -70,7 +86,7 @@ bool Wallet_connection_impl::connect(network::Endpoint const& wallet_endpoint)
                     self->m_logger->info("Connection to wallet established");
 
                     Packet packet{ Packet::SET_CHANNEL, uint2bytes(self->m_mining_mode == common::Mining_mode::PRIME ? 1U : 2U) };
-                    self->m_connection->transmit(packet.get_bytes());
+                    self->m_connection->transmit(packet.get_payload_sequence());
 
                     self->m_timer_manager.start_get_height_timer(self->m_get_height_interval, self->m_connection);
                 }
@@ -84,7 +100,7 @@ bool Wallet_connection_impl::connect(network::Endpoint const& wallet_endpoint)
                     // data received
                     self->process_data(std::move(receive_buffer));
                 }
-            }
+            });
         });
 
     if (!connection)
@@ -93,6 +109,7 @@ bool Wallet_connection_impl::connect(network::Endpoint const& wallet_endpoint)
     }
 
     m_connection = std::move(connection);
+    m_packet_buffer.clear();
     return true;
 }
 
@@ -104,10 +121,17 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
         return;
     }
 
-    auto remaining_size = receive_buffer->size();
-    do
+    // packets can be split over several reads -> the packet_buffer keeps incomplete packets
+    if (!m_packet_buffer.append(*receive_buffer))
+    {
+        m_logger->error("Receive buffer of wallet connection exceeded. Close connection");
+        m_connection->close();
+        return;
+    }
+
+    Packet_view packet;
+    while (m_packet_buffer.next_packet(packet))
     {
-        auto packet = extract_packet_from_buffer(receive_buffer, remaining_size, receive_buffer->size() - remaining_size);
         if (!packet.is_valid())
         {
             // log invalid packet
@@ -125,7 +149,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
             if (!pool_manager_shared)
                 break;
 
-            auto const height = bytes2uint(*packet.m_data);
+            auto const height = bytes2uint(packet.m_data.to_payload());
             if (height > m_current_height)
             {
                 m_current_height = height;
@@ -140,7 +164,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
 
                 // get new block from wallet for pool_manager
                 Packet packet_get_block{ Packet::GET_BLOCK, nullptr };
-                m_connection->transmit(packet_get_block.get_bytes());
+                m_connection->transmit(packet_get_block.get_payload_sequence());
 
                 // update height at pool_manager
                 pool_manager_shared->set_current_height(m_current_height);
@@ -155,7 +179,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
         // Block from wallet received
         else if (packet.m_header == Packet::BLOCK_DATA)
         {
-            auto block = LLP::deserialize_block(std::move(*packet.m_data));
+            auto block = LLP::deserialize_block(packet.m_data.to_payload());
             if (block.nHeight == m_current_height)
             {
                 if (m_get_block_pool_manager) // pool_manager get_block has priority
@@ -187,7 +211,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
                 {
                     //request a new block if the wallet sends garbage height
                     Packet packet_get_block{ Packet::GET_BLOCK, nullptr };
-                    m_connection->transmit(packet_get_block.get_bytes());
+                    m_connection->transmit(packet_get_block.get_payload_sequence());
                 }
             }
             else
@@ -204,7 +228,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
 
             // get_height immediately to get the next block faster than waiting on get_height_timer
             Packet packet_get_height{ Packet::GET_HEIGHT, nullptr };
-            m_connection->transmit(packet_get_height.get_bytes());
+            m_connection->transmit(packet_get_height.get_payload_sequence());
 
             // the oldest handler is the first one who submitted the block
             std::scoped_lock lock(m_submit_block_mutex);
@@ -218,7 +242,7 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
             m_logger->warn("Block Rejected by Nexus Network.");
 
             Packet packet_get_block{ Packet::GET_BLOCK, nullptr };
-            m_connection->transmit(packet_get_block.get_bytes());
+            m_connection->transmit(packet_get_block.get_payload_sequence());
 
             std::scoped_lock lock(m_submit_block_mutex);
             auto handler = m_pending_submit_block_handlers.front();
@@ -230,7 +254,6 @@ void Wallet_connection_impl::process_data(network::Shared_payload&& receive_buff
             m_logger->error("Invalid header received.");
         }
     }
-    while (remaining_size != 0);
 }
 
 void Wallet_connection_impl::submit_block(network::Shared_payload&& block_data, std::uint32_t block_map_id, Submit_block_handler&& handler)
@@ -238,7 +261,7 @@ void Wallet_connection_impl::submit_block(network::Shared_payload&& block_data,
     m_logger->info("Submitting Block...");
 
     m_submit_block_packet = Packet{ Packet::SUBMIT_BLOCK, std::move(block_data) };
-    m_connection->transmit(m_submit_block_packet.get_bytes());
+    m_connection->transmit(m_submit_block_packet.get_payload_sequence());
 
     // store block request handler in pending list (handler comes from miner_connection)
     std::scoped_lock lock(m_submit_block_mutex);
@@ -247,17 +270,21 @@ void Wallet_connection_impl::submit_block(network::Shared_payload&& block_data,
 
 void Wallet_connection_impl::get_block(Get_block_handler&& handler)
 {
-    if (!m_connection)
+    // called from miner_connections -> m_connection is only accessed inside the strand
+    ::asio::post(m_strand, [self = shared_from_this(), handler = std::move(handler)]() mutable
     {
-        return;
-    }
+        if (!self->m_connection)
+        {
+            return;
+        }
 
-    Packet packet_get_block{ Packet::GET_BLOCK, nullptr };
-    m_connection->transmit(packet_get_block.get_bytes());
+        Packet packet_get_block{ Packet::GET_BLOCK, nullptr };
+        self->m_connection->transmit(packet_get_block.get_payload_sequence());
 
-    // store block request handler in pending list (handler comes from miner_connection)
-    std::scoped_lock lock(m_get_block_mutex);
-    m_pending_get_blocks.emplace(std::move(handler));
+        // store block request handler in pending list (handler comes from miner_connection)
+        std::scoped_lock lock(self->m_get_block_mutex);
+        self->m_pending_get_blocks.emplace(std::move(handler));
+    });
 }
 
 }
\ No newline at end of file
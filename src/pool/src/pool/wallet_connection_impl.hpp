@@ -9,16 +9,18 @@
 #include "pool/wallet_connection.hpp"
 #include "LLP/block.hpp"
 #include "LLP/packet.hpp"
+#include "LLP/packet_buffer.hpp"
 #include "pool/types.hpp"
 #include "common/types.hpp"
 
+#include <asio/io_context.hpp>
+#include <asio/strand.hpp>
 #include <memory>
 #include <vector>
 #include <queue>
 #include <mutex>
 #include <atomic>
 
-namespace asio { class io_context; }
 namespace spdlog { class logger; }
 
 namespace nexuspool
@@ -30,6 +32,7 @@ class Wallet_connection_impl : public Wallet_connection, public std::enable_shar
 public:
 
     Wallet_connection_impl(std::shared_ptr<asio::io_context> io_context,
+        ::asio::strand<::asio::io_context::executor_type> strand,
         std::shared_ptr<spdlog::logger> logger,
         std::weak_ptr<Pool_manager> pool_manager,
         common::Mining_mode mining_mode,
@@ -53,6 +56,7 @@ private:
     void retry_connect(network::Endpoint const& wallet_endpoint);
 
     std::shared_ptr<::asio::io_context> m_io_context;
+    ::asio::strand<::asio::io_context::executor_type> m_strand;   // shared with pool_manager
     std::shared_ptr<spdlog::logger> m_logger;
     std::weak_ptr<Pool_manager> m_pool_manager;
     common::Mining_mode m_mining_mode;
@@ -60,6 +64,7 @@ private:
     std::uint16_t const m_get_height_interval;
     network::Socket::Sptr m_socket;
     network::Connection::Sptr m_connection;
+    Packet_buffer m_packet_buffer;      // reassembles the packets received from the wallet
     chrono::Timer_factory::Sptr m_timer_factory;
     Timer_manager_wallet m_timer_manager;
     std::atomic<std::uint32_t> m_current_height;
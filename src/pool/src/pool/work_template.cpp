@@ -0,0 +1,72 @@
+#include "pool/work_template.hpp"
+
+namespace nexuspool
+{
+
+Work_template::Work_template()
+	: m_work_message{}
+	, m_height{ 0U }
+	, m_valid{ false }
+	, m_next_range_index{ 0U }
+{
+}
+
+void Work_template::reset(std::uint32_t height)
+{
+	std::scoped_lock lock(m_mutex);
+	m_height = height;
+	m_valid = false;
+	m_next_range_index = 0U;
+}
+
+bool Work_template::set_block(LLP::CBlock const& block, std::uint32_t pool_nbits)
+{
+	std::scoped_lock lock(m_mutex);
+	if (block.nHeight != m_height)
+	{
+		return false;
+	}
+
+	m_work_message = std::make_shared<Work_message const>(block, pool_nbits);
+	m_valid = true;
+	m_next_range_index = 0U;
+	return true;
+}
+
+bool Work_template::is_valid() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_valid;
+}
+
+std::uint32_t Work_template::get_height() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_height;
+}
+
+Nonce_range Work_template::get_next_nonce_range()
+{
+	auto const range_index = m_next_range_index % max_nonce_ranges;
+	m_next_range_index++;
+
+	Nonce_range nonce_range;
+	nonce_range.m_start = range_index * nonce_range_size;
+	nonce_range.m_end = nonce_range.m_start + nonce_range_size;
+	return nonce_range;
+}
+
+bool Work_template::get_work(Work_message::Sptr& work_message, Nonce_range& nonce_range)
+{
+	std::scoped_lock lock(m_mutex);
+	if (!m_valid)
+	{
+		return false;
+	}
+
+	nonce_range = get_next_nonce_range();
+	work_message = m_work_message;
+	return true;
+}
+
+}
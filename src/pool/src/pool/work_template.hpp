@@ -0,0 +1,55 @@
+#ifndef NEXUSPOOL_WORK_TEMPLATE_HPP
+#define NEXUSPOOL_WORK_TEMPLATE_HPP
+
+#include "LLP/block.hpp"
+#include "pool/types.hpp"
+#include "pool/broadcast.hpp"
+
+#include <mutex>
+#include <cstdint>
+
+namespace nexuspool
+{
+
+// Holds the one block fetched from the wallet for the current height and hands out
+// disjoint nonce ranges of it, so that every miner can work on the same block.
+class Work_template
+{
+public:
+
+	// Size of one nonce range -> 2^20 - 1 complete ranges per height
+	static constexpr std::uint64_t nonce_range_size{ 1ULL << 44 };
+	// The range index wraps after max_nonce_ranges assignments for one block, later ranges repeat the first ones.
+	// This needs about a million work requests within one block. Miners on a repeated range only duplicate work,
+	// their identical shares are rejected by the share filter.
+	static constexpr std::uint64_t max_nonce_ranges{ ~0ULL / nonce_range_size };
+
+	Work_template();
+
+	// new height -> invalidate the current block until the wallet delivers the new one
+	void reset(std::uint32_t height);
+
+	// returns false if the block doesn't belong to the current height
+	bool set_block(LLP::CBlock const& block, std::uint32_t pool_nbits);
+
+	bool is_valid() const;
+	std::uint32_t get_height() const;
+
+	// the pre-serialized WORK message of the template together with a freshly assigned nonce range.
+	// returns false if there is no valid block for the current height yet
+	bool get_work(Work_message::Sptr& work_message, Nonce_range& nonce_range);
+
+private:
+
+	Nonce_range get_next_nonce_range();
+
+	mutable std::mutex m_mutex;
+	Work_message::Sptr m_work_message;
+	std::uint32_t m_height;
+	bool m_valid;
+	std::uint64_t m_next_range_index;
+};
+
+}
+
+#endif
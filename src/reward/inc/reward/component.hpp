@@ -2,6 +2,7 @@
 #define NEXUSPOOL_REWARD_COMPONENT_HPP
 
 #include "LLP/block.hpp"
+#include "LLP/block_hash_context.hpp"
 #include <string>
 #include <memory>
 #include <chrono>
@@ -20,6 +21,12 @@ public:
     virtual ~Component() = default;
 
     virtual Difficulty_result check_difficulty(const LLP::CBlock& block, std::uint32_t pool_nbits) const = 0;
+    // hash channel only. block has to be a block of the job the hash_context was created for
+    virtual Difficulty_result check_difficulty(const LLP::CBlock& block, LLP::Block_hash_context const& hash_context) const = 0;
+    // hash channel block hash that has already been computed (batch hashing)
+    virtual Difficulty_result check_difficulty(uint1024_t const& block_hash, LLP::Block_hash_context const& hash_context) const = 0;
+    // prime channel difficulty of the block that has already been computed (batch Fermat tests)
+    virtual Difficulty_result check_difficulty(double prime_difficulty, const LLP::CBlock& block, std::uint32_t pool_nbits) const = 0;
 
     // Starts a new round
     virtual bool start_round(std::uint16_t round_duration_hours) = 0;
@@ -67,20 +67,9 @@ Difficulty_result Component_impl::check_difficulty(const LLP::CBlock& block, uin
 	//prime channel
 	else if (block.nChannel == 1)
 	{
+		// with the offsets submitted by the miner only the claimed cluster positions are tested
 		uint1024_t block_prime = block.GetPrime();
-		std::vector<uint8_t> offsets;
-		double actual_prime_difficulty = TAO::Ledger::GetPrimeDifficulty(block_prime, offsets);
-		double mainnet_difficulty_target = TAO::Ledger::GetDifficulty(block.nBits, block.nChannel);
-		double pool_difficulty_target = TAO::Ledger::GetDifficulty(pool_nbits, block.nChannel);
-		if (actual_prime_difficulty >= mainnet_difficulty_target)
-		{
-			result = Difficulty_result::block_found;
-		}
-		else if (actual_prime_difficulty >= pool_difficulty_target)
-		{
-			result = Difficulty_result::accept;
-		}
-
+		result = check_difficulty(TAO::Ledger::GetPrimeDifficulty(block_prime, block.vOffsets), block, pool_nbits);
 	}
 	else
 	{
@@ -90,6 +79,51 @@ Difficulty_result Component_impl::check_difficulty(const LLP::CBlock& block, uin
 	return result;
 }
 
+Difficulty_result Component_impl::check_difficulty(const LLP::CBlock& block, LLP::Block_hash_context const& hash_context) const
+{
+	if (block.nChannel != 2)
+	{
+		return Difficulty_result::reject;
+	}
+
+	return check_difficulty(hash_context.get_hash(block.nNonce), hash_context);
+}
+
+Difficulty_result Component_impl::check_difficulty(uint1024_t const& block_hash, LLP::Block_hash_context const& hash_context) const
+{
+	if (block_hash < hash_context.get_mainnet_target())
+	{
+		return Difficulty_result::block_found;
+	}
+	else if (block_hash < hash_context.get_pool_target())
+	{
+		return Difficulty_result::accept;
+	}
+
+	return Difficulty_result::reject;
+}
+
+Difficulty_result Component_impl::check_difficulty(double prime_difficulty, const LLP::CBlock& block, std::uint32_t pool_nbits) const
+{
+	if (block.nChannel != 1)
+	{
+		return Difficulty_result::reject;
+	}
+
+	double mainnet_difficulty_target = TAO::Ledger::GetDifficulty(block.nBits, block.nChannel);
+	double pool_difficulty_target = TAO::Ledger::GetDifficulty(pool_nbits, block.nChannel);
+	if (prime_difficulty >= mainnet_difficulty_target)
+	{
+		return Difficulty_result::block_found;
+	}
+	else if (prime_difficulty >= pool_difficulty_target)
+	{
+		return Difficulty_result::accept;
+	}
+
+	return Difficulty_result::reject;
+}
+
 bool Component_impl::start_round(std::uint16_t round_duration_hours)
 {
 	m_logger->info("Starting new round");
@@ -150,40 +184,57 @@ bool Component_impl::end_round(std::uint32_t round_number)
 
 	update_block_hashes(round_number);
 	round_data.m_total_shares = m_data_reader->get_total_shares_from_accounts();
+	std::vector<persistance::Account_data_for_payment> active_accounts;
 	if (round_data.m_total_shares > 0) // did the pool actually earned something this round?
 	{
 		// get all accounts which contribute to the current round
-		auto const active_accounts = m_data_reader->get_active_accounts_from_round();
+		active_accounts = m_data_reader->get_active_accounts_from_round();
+	}
+	// payments, share reset and round end in one transaction. The first failed write rolls back the transaction
+	auto const written = m_shared_data_writer->write_transaction([&](persistance::Data_writer& data_writer)
+	{
 		for (auto const& active_account : active_accounts)
 		{
 			// add account to payment table (without datetime -> not paid yet)
 			// reward is not set yet
-			m_shared_data_writer->add_payment(persistance::Payment_data{ active_account.m_address, 0.0, active_account.m_shares, "", round_data.m_round, ""});
+			if (!data_writer.add_payment(persistance::Payment_data{ active_account.m_address, 0.0, active_account.m_shares, "", round_data.m_round, "" }))
+			{
+				m_logger->error("Failed to add_payment for account {}", active_account.m_address);
+				return false;
+			}
 		}
 
 		// dev fee should go to a different account -> handle this like a miner payment
-		if (!m_fee_address.empty())
+		if (round_data.m_total_shares > 0 && !m_fee_address.empty())
 		{
 			m_logger->debug("Added pool fee payment for {}", m_fee_address);
-			if(!m_shared_data_writer->add_payment(persistance::Payment_data{ m_fee_address, 0.0, 0.0, "", round_data.m_round, "" }))
+			if (!data_writer.add_payment(persistance::Payment_data{ m_fee_address, 0.0, 0.0, "", round_data.m_round, "" }))
 			{
 				m_logger->error("Failed to add_payment for pool fee");
+				return false;
 			}
 		}
-	}
 
-    // reset shares of all accounts (round end)
-	if (!m_shared_data_writer->reset_shares_from_accounts())
+		// reset shares of all accounts (round end)
+		if (!data_writer.reset_shares_from_accounts())
+		{
+			m_logger->error("Failed to reset the shares from accounts in round {}", round_number);
+			return false;
+		}
+
+		// end round now
+		round_data.m_is_active = false;
+		return data_writer.update_round(round_data);
+	});
+	if (!written)
 	{
-		m_logger->error("Failed to reset the shares from accounts in round {}", round_number);
+		m_logger->error("Failed to write the end of round {}", round_number);
+		return false;
 	}
-	m_current_round = 0;
 
-    // end round now
-	round_data.m_is_active = false;
-	m_shared_data_writer->update_round(round_data);
-
-    return true;
+	// the round stays current until its end is stored
+	m_current_round = 0;
+	return true;
 }
 
 Calculate_rewards_result Component_impl::calculate_rewards(std::uint32_t round_number)
@@ -222,25 +273,39 @@ Calculate_rewards_result Component_impl::calculate_rewards(std::uint32_t round_n
 			{
 				return result;
 			}
-			for (auto& payment : payments)
+			// all rewards and the round update in one transaction
+			auto const written = m_shared_data_writer->write_transaction([&](persistance::Data_writer& data_writer)
 			{
-				// dev fee should go to a seperate account
-				if (!m_fee_address.empty() && m_fee_address == payment.m_account)
+				for (auto& payment : payments)
 				{
-					double const pool_fee = round_data.m_total_rewards * static_cast<double>(m_pool_fee) / 100.0;
-					m_logger->debug("Pool fee payment {} NXS for {}", pool_fee, m_fee_address);
-					if (!m_shared_data_writer->update_reward_of_payment(pool_fee, m_fee_address, round_number))
+					// dev fee should go to a seperate account
+					if (!m_fee_address.empty() && m_fee_address == payment.m_account)
+					{
+						double const pool_fee = round_data.m_total_rewards * static_cast<double>(m_pool_fee) / 100.0;
+						m_logger->debug("Pool fee payment {} NXS for {}", pool_fee, m_fee_address);
+						if (!data_writer.update_reward_of_payment(pool_fee, m_fee_address, round_number))
+						{
+							m_logger->debug("Couldn't update pool fee");
+							return false;
+						}
+						continue;
+					}
+					// calculate reward for account. First reduce the total_rewards with pool_fee % 
+					auto account_reward = (round_data.m_total_rewards * (1.0 - (static_cast<double>(m_pool_fee) / 100.0))) * (payment.m_shares / round_data.m_total_shares);
+					if (!data_writer.update_reward_of_payment(account_reward, payment.m_account, round_number))
 					{
-						m_logger->debug("Couldn't update pool fee");
+						m_logger->debug("Couldn't update reward of account {}", payment.m_account);
+						return false;
 					}
-					continue;
 				}
-				// calculate reward for account. First reduce the total_rewards with pool_fee % 
-				auto account_reward = (round_data.m_total_rewards * (1.0 - (static_cast<double>(m_pool_fee) / 100.0))) * (payment.m_shares / round_data.m_total_shares);
-				m_shared_data_writer->update_reward_of_payment(account_reward, payment.m_account, round_number);
+				return data_writer.update_round(round_data);
+			});
+			if (!written)
+			{
+				m_logger->error("calculate_rewards error. Failed to write the rewards of round {}", round_number);
+				return result;
 			}
 			result = Calculate_rewards_result::finished;
-			m_shared_data_writer->update_round(round_data);
 			return result;
 		}
 	}
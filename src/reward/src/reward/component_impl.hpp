@@ -34,6 +34,9 @@ public:
     ~Component_impl();
 
     Difficulty_result check_difficulty(const LLP::CBlock& block, std::uint32_t pool_nbits) const override;
+    Difficulty_result check_difficulty(const LLP::CBlock& block, LLP::Block_hash_context const& hash_context) const override;
+    Difficulty_result check_difficulty(uint1024_t const& block_hash, LLP::Block_hash_context const& hash_context) const override;
+    Difficulty_result check_difficulty(double prime_difficulty, const LLP::CBlock& block, std::uint32_t pool_nbits) const override;
 
     bool start_round(std::uint16_t round_duration_hours) override;
     bool is_round_active() override;
@@ -35,6 +35,13 @@ double Payout_manager::calculate_reward_of_blocks(std::uint32_t round, bool& cal
 		return 0.0;
 	}
 
+	struct Block_reward
+	{
+		std::string m_hash;
+		bool m_orphan;
+		double m_reward;
+	};
+	std::vector<Block_reward> block_rewards;
 	for (auto& block : blocks)
 	{
 		// all blocks which already have a reward for this round are filtered out
@@ -75,11 +82,7 @@ double Payout_manager::calculate_reward_of_blocks(std::uint32_t round, bool& cal
 			m_current_avg_block_reward = reward_data.m_reward;
 		}
 
-		// update block in db
-		if (!m_shared_data_writer.update_block_rewards(block.m_hash, is_orphan, reward_data.m_reward))
-		{
-			m_logger->error("Couldn't update block in storage for hash {}", block.m_hash);
-		}
+		block_rewards.push_back(Block_reward{ block.m_hash, is_orphan, reward_data.m_reward });
 		if (!is_orphan)
 		{
 			total_rewards += reward_data.m_reward;
@@ -87,6 +90,29 @@ double Payout_manager::calculate_reward_of_blocks(std::uint32_t round, bool& cal
 
 		++blocks_update_count;
 	}
+
+	// update blocks in db
+	if (!block_rewards.empty())
+	{
+		auto const written = m_shared_data_writer.write_transaction([this, &block_rewards](persistance::Data_writer& data_writer)
+		{
+			for (auto const& block_reward : block_rewards)
+			{
+				if (!data_writer.update_block_rewards(block_reward.m_hash, block_reward.m_orphan, block_reward.m_reward))
+				{
+					m_logger->error("Couldn't update block in storage for hash {}", block_reward.m_hash);
+					return false;
+				}
+			}
+			return true;
+		});
+		if (!written)
+		{
+			// nothing of this calculation is stored -> the round isn't finished
+			m_logger->error("Couldn't store the rewards of {} blocks in round {}", block_rewards.size(), round);
+			return total_rewards;
+		}
+	}
 	m_logger->debug("Updated reward_data of {} blocks in round {}. {} blocks are ORPHAN. Total rewards calculated {}", 
 		blocks_update_count, round, blocks_orphaned, total_rewards);
 
@@ -102,6 +128,7 @@ double Payout_manager::calculate_reward_of_blocks(std::uint32_t round, bool& cal
 bool Payout_manager::payout(std::string const& account_from, std::string const& pin, std::uint32_t current_round)
 {
 	nexus_http_interface::Payout_recipients payout_recipients{};
+	std::vector<std::string> nothing_to_pay;
 	auto payments = m_data_reader.get_not_paid_data_from_round(current_round);
 	if (payments.empty())
 	{
@@ -120,7 +147,7 @@ bool Payout_manager::payout(std::string const& account_from, std::string const&
 			{
 				// nothing to pay -> no blocks in this round
 				m_logger->trace("payout: Nothing to pay for account {} in round {}", payment.m_account, current_round);
-				m_shared_data_writer.account_paid(current_round, payment.m_account, "");
+				nothing_to_pay.push_back(payment.m_account);
 				continue;
 			}
 			payout_recipients.push_back(nexus_http_interface::Payout_recipient_data{ payment.m_account, payment.m_amount });
@@ -136,7 +163,7 @@ bool Payout_manager::payout(std::string const& account_from, std::string const&
 			{
 				// nothing to pay -> no blocks in this round
 				m_logger->trace("payout: Nothing to pay for account {} in round {}", payment.m_account, current_round);
-				m_shared_data_writer.account_paid(current_round, payment.m_account, "");
+				nothing_to_pay.push_back(payment.m_account);
 				continue;
 			}
 			payout_recipients.push_back(nexus_http_interface::Payout_recipient_data{ payment.m_account, payment.m_amount });
@@ -144,6 +171,25 @@ bool Payout_manager::payout(std::string const& account_from, std::string const&
 		m_not_fully_paid_round = 0U;
 	}
 
+	if (!nothing_to_pay.empty())
+	{
+		auto const written = m_shared_data_writer.write_transaction([&nothing_to_pay, current_round](persistance::Data_writer& data_writer)
+		{
+			for (auto const& account : nothing_to_pay)
+			{
+				if (!data_writer.account_paid(current_round, account, ""))
+				{
+					return false;
+				}
+			}
+			return true;
+		});
+		if (!written)
+		{
+			m_logger->error("Couldn't store {} accounts without reward in round {} as paid", nothing_to_pay.size(), current_round);
+		}
+	}
+
 	std::string tx_id{};
 	auto result = m_http_interface.payout(account_from, pin, payout_recipients, tx_id);
 	if (!result)
@@ -152,9 +198,20 @@ bool Payout_manager::payout(std::string const& account_from, std::string const&
 		return false;
 	}
 	// update payment storage
-	for (auto& recipient : payout_recipients)
+	auto const written = m_shared_data_writer.write_transaction([&payout_recipients, &tx_id, current_round](persistance::Data_writer& data_writer)
+	{
+		for (auto const& recipient : payout_recipients)
+		{
+			if (!data_writer.account_paid(current_round, recipient.m_address, tx_id))
+			{
+				return false;
+			}
+		}
+		return true;
+	});
+	if (!written)
 	{
-		m_shared_data_writer.account_paid(current_round, recipient.m_address, tx_id);
+		m_logger->error("Couldn't store the payout of round {} with tx_id {}", current_round, tx_id);
 	}
 
 	return true;
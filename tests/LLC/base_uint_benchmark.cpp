@@ -0,0 +1,85 @@
+// Benchmark: base_uint operators on the share path (target comparisons, SetCompact and the pool target shift, the uint1056_t
+// division of the fractional difficulty) and the other arithmetic. Build with LLC_BASE_UINT_32 for the 32-bit word loops
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+#include "LLC/types/uint1024.h"
+
+namespace
+{
+constexpr std::size_t iterations{ 200000U };
+constexpr std::size_t count{ 64U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+void run(char const* name, std::function<void(std::size_t)> const& function)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		function(i);
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-32s %10.1f ns/op\n", name, duration / iterations);
+}
+
+template<typename T>
+std::vector<T> create_numbers(std::mt19937_64& rng, std::uint32_t bits)
+{
+	std::vector<T> numbers(count);
+	for (auto& number : numbers)
+	{
+		for (std::uint32_t i = 0; i < bits; i += 64)
+		{
+			number <<= 64;
+			number += rng();
+		}
+	}
+	return numbers;
+}
+}
+
+int main()
+{
+	std::mt19937_64 rng{ 1024 };
+	auto const a = create_numbers<uint1024_t>(rng, 1024);
+	auto const b = create_numbers<uint1024_t>(rng, 1024);
+	auto const half = create_numbers<uint1024_t>(rng, 512);
+	auto hashes = create_numbers<uint1024_t>(rng, 1024);
+	auto const composites = create_numbers<uint1056_t>(rng, 1024);
+	auto const remainders = create_numbers<uint1056_t>(rng, 1000);
+
+	// a hash under a target differs from it in the top words
+	uint1024_t target;
+	target.SetCompact(0x7d00ffffU);
+	for (auto& hash : hashes)
+	{
+		hash >>= 16;
+	}
+
+	run("uint1024 < (target)", [&](std::size_t i) { g_sink += hashes[i % count] < target; });
+	run("uint1024 == (equal)", [&](std::size_t i) { g_sink += a[i % count] == uint1024_t(a[i % count]); });
+	run("uint1024 SetCompact", [&](std::size_t i) { uint1024_t t; t.SetCompact(0x7d00ffffU - static_cast<std::uint32_t>(i & 0xff)); g_sink += t.Get64(15); });
+	run("uint1024 << 24", [&](std::size_t i) { g_sink += (a[i % count] << 24).Get64(0); });
+	run("uint1024 >> 100", [&](std::size_t i) { g_sink += (a[i % count] >> 100).Get64(0); });
+	run("uint1024 +", [&](std::size_t i) { g_sink += (a[i % count] + b[i % count]).Get64(15); });
+	run("uint1024 -", [&](std::size_t i) { g_sink += (a[i % count] - b[i % count]).Get64(15); });
+	run("uint1024 + 64-bit", [&](std::size_t i) { g_sink += (a[i % count] + i).Get64(0); });
+	run("uint1024 *", [&](std::size_t i) { g_sink += (a[i % count] * b[i % count]).Get64(15); });
+	run("uint1024 * 64-bit", [&](std::size_t i) { g_sink += (a[i % count] * (i | 1)).Get64(15); });
+	run("uint1024 / (1024 / 512 bits)", [&](std::size_t i) { g_sink += (a[i % count] / half[i % count]).Get64(0); });
+	run("uint1024 / 64-bit", [&](std::size_t i) { g_sink += (a[i % count] / (i | 1)).Get64(0); });
+	run("uint1024 % 16-bit", [&](std::size_t i) { g_sink += a[i % count] % static_cast<std::uint16_t>(i | 1); });
+	run("uint1056 fractional difficulty", [&](std::size_t i)
+	{
+		auto const& composite = composites[i % count];
+		g_sink += ((composite - remainders[i % count] << 24) / composite).getuint32();
+	});
+	run("uint1024 bits", [&](std::size_t i) { g_sink += half[i % count].bits(); });
+	run("uint1024 GetBytes", [&](std::size_t i) { g_sink += a[i % count].GetBytes()[0]; });
+
+	std::printf("sink %llu\n", static_cast<unsigned long long>(g_sink & 1U));
+	return 0;
+}
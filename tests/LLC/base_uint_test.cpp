@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "LLC/types/uint1024.h"
+#include <openssl/bn.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+using Bn = std::unique_ptr<BIGNUM, decltype(&BN_free)>;
+using Bn_ctx = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+
+// numbers of all sizes, all bits set and single bits, so that carries, borrows and the quotient corrections are hit
+template<std::uint32_t BITS>
+base_uint<BITS> create_number(std::mt19937& rng, std::uint32_t i)
+{
+	constexpr std::uint32_t width{ BITS / 32 };
+	std::uint32_t w[width]{};
+	std::uint32_t const words = (i % 5 == 0) ? width : 1 + rng() % width;
+	for (std::uint32_t j = 0; j < words; ++j)
+	{
+		w[j] = (i % 7 == 0) ? ~0U : rng();
+	}
+	if (i % 11 == 0)
+	{
+		std::memset(w, 0, sizeof(w));
+		w[words - 1] = 0x80000000U;
+	}
+
+	base_uint<BITS> result;
+	std::memcpy(result.begin(), w, sizeof(w));
+	return result;
+}
+
+template<std::uint32_t BITS>
+Bn to_bn(base_uint<BITS> const& value)
+{
+	return Bn{ BN_lebin2bn(value.begin(), BITS / 8, nullptr), &BN_free };
+}
+
+// value mod 2^BITS
+template<std::uint32_t BITS>
+base_uint<BITS> from_bn(BIGNUM* value, BN_CTX* ctx)
+{
+	Bn modulus{ BN_new(), &BN_free };
+	BN_set_bit(modulus.get(), BITS);
+	BN_nnmod(value, value, modulus.get(), ctx);
+
+	base_uint<BITS> result;
+	BN_bn2lebinpad(value, result.begin(), BITS / 8);
+	return result;
+}
+
+template<std::uint32_t BITS>
+void check_arithmetic(std::uint32_t seed)
+{
+	std::mt19937 rng{ seed };
+	Bn_ctx ctx{ BN_CTX_new(), &BN_CTX_free };
+	Bn r{ BN_new(), &BN_free };
+
+	for (std::uint32_t i = 0; i < 500; ++i)
+	{
+		auto const a = create_number<BITS>(rng, i);
+		auto const b = create_number<BITS>(rng, i / 3 + rng() % 5);
+		auto const bn_a = to_bn(a);
+		auto const bn_b = to_bn(b);
+
+		BN_add(r.get(), bn_a.get(), bn_b.get());
+		EXPECT_EQ(a + b, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " + " << b.GetHex();
+		BN_sub(r.get(), bn_a.get(), bn_b.get());
+		EXPECT_EQ(a - b, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " - " << b.GetHex();
+		BN_mul(r.get(), bn_a.get(), bn_b.get(), ctx.get());
+		EXPECT_EQ(a * b, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " * " << b.GetHex();
+
+		if (!!b)
+		{
+			BN_div(r.get(), nullptr, bn_a.get(), bn_b.get(), ctx.get());
+			EXPECT_EQ(a / b, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " / " << b.GetHex();
+		}
+
+		std::uint64_t const small = b.Get64(0) | 1U;
+		BN_set_word(r.get(), small);
+		BN_div(r.get(), nullptr, bn_a.get(), r.get(), ctx.get());
+		EXPECT_EQ(a / small, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " / " << small;
+		BN_set_word(r.get(), small);
+		BN_mul(r.get(), bn_a.get(), r.get(), ctx.get());
+		EXPECT_EQ(a * small, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " * " << small;
+		BN_add_word(BN_copy(r.get(), bn_a.get()), small);
+		EXPECT_EQ(a + small, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " + " << small;
+		BN_copy(r.get(), bn_a.get());
+		BN_sub(r.get(), r.get(), BN_value_one());
+		EXPECT_EQ(a - 1, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " - 1";
+
+		auto const divisor = static_cast<std::uint16_t>(small);
+		EXPECT_EQ(a % divisor, BN_mod_word(bn_a.get(), divisor)) << a.GetHex() << " % " << divisor;
+
+		std::uint32_t const shift = rng() % (BITS + 40);
+		BN_lshift(r.get(), bn_a.get(), shift);
+		EXPECT_EQ(a << shift, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " << " << shift;
+		BN_rshift(r.get(), bn_a.get(), shift);
+		EXPECT_EQ(a >> shift, from_bn<BITS>(r.get(), ctx.get())) << a.GetHex() << " >> " << shift;
+
+		int const cmp = BN_cmp(bn_a.get(), bn_b.get());
+		EXPECT_EQ(a < b, cmp < 0);
+		EXPECT_EQ(a <= b, cmp <= 0);
+		EXPECT_EQ(a > b, cmp > 0);
+		EXPECT_EQ(a >= b, cmp >= 0);
+		EXPECT_EQ(a == b, cmp == 0);
+		EXPECT_TRUE(a == base_uint<BITS>(a));
+		EXPECT_EQ(a.bits(), static_cast<std::uint32_t>(BN_num_bits(bn_a.get())));
+	}
+}
+}
+
+TEST(Base_uint_test, arithmetic_matches_openssl_256)
+{
+	check_arithmetic<256>(256);
+}
+
+TEST(Base_uint_test, arithmetic_matches_openssl_1024)
+{
+	check_arithmetic<1024>(1024);
+}
+
+TEST(Base_uint_test, arithmetic_matches_openssl_1056)
+{
+	// odd count of 32-bit words, the top 64-bit limb is half used
+	check_arithmetic<1056>(1056);
+}
+
+TEST(Base_uint_test, equal_and_compare_every_word)
+{
+	// a difference in any single word, in the SIMD chunks and in the words above them
+	uint1056_t a;
+	a.SetHex("1234");
+	for (std::uint32_t i = 0; i < 33; ++i)
+	{
+		auto b = a;
+		b.begin()[i * 4 + 1] ^= 0x40U;
+		EXPECT_FALSE(a == b) << i;
+		EXPECT_TRUE(a != b) << i;
+		EXPECT_EQ(a < b, (b.begin()[i * 4 + 1] & 0x40U) != 0) << i;
+		EXPECT_EQ(b < a, (b.begin()[i * 4 + 1] & 0x40U) == 0) << i;
+	}
+}
+
+TEST(Base_uint_test, compact_and_bytes)
+{
+	// the mainnet genesis target and a pool target
+	for (std::uint32_t const compact : { 0x1d00ffffU, 0x7d00ffffU, 0x03123456U, 0x02008000U, 0x01003456U, 0x04123456U })
+	{
+		Bn_ctx ctx{ BN_CTX_new(), &BN_CTX_free };
+		Bn expected{ BN_new(), &BN_free };
+		std::uint32_t const size = compact >> 24;
+		BN_set_word(expected.get(), compact & 0x007fffffU);
+		if (size <= 3)
+		{
+			BN_rshift(expected.get(), expected.get(), 8 * (3 - size));
+		}
+		else
+		{
+			BN_lshift(expected.get(), expected.get(), 8 * (size - 3));
+		}
+
+		uint1024_t target;
+		target.SetCompact(compact);
+		EXPECT_EQ(target, from_bn<1024>(expected.get(), ctx.get())) << compact;
+
+		uint256_t small_target;
+		small_target.SetCompact(compact);
+		EXPECT_EQ(small_target, from_bn<256>(expected.get(), ctx.get())) << compact;
+	}
+
+	// big endian 32-bit words, lowest word first
+	uint256_t value;
+	value.SetHex("0102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20");
+	auto const bytes = value.GetBytes();
+	ASSERT_EQ(bytes.size(), 32U);
+	EXPECT_EQ(bytes[0], 0x1dU);
+	EXPECT_EQ(bytes[3], 0x20U);
+	EXPECT_EQ(bytes[28], 0x01U);
+	EXPECT_EQ(bytes[31], 0x04U);
+
+	uint256_t copy;
+	copy.SetBytes(bytes);
+	EXPECT_EQ(copy, value);
+}
+
+TEST(Base_uint_test, division_by_zero_throws)
+{
+	uint1024_t value{ 5 };
+	EXPECT_THROW(value /= uint1024_t(0), std::domain_error);
+	EXPECT_THROW(value /= std::uint64_t{ 0U }, std::domain_error);
+}
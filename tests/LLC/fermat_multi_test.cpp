@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "LLC/prime/fermat.h"
+#include "LLC/prime/fermat_multi.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector<LLC::FermatKernel> const kernels{ LLC::FermatKernel::SCALAR, LLC::FermatKernel::AVX2, LLC::FermatKernel::AVX512, LLC::FermatKernel::AVX512IFMA };
+
+// odd numbers of all sizes, full width and all bits set
+std::vector<uint1024_t> create_moduli(std::size_t count)
+{
+	std::mt19937 rng{ 1024 };
+	std::vector<uint1024_t> moduli;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::uint32_t w[32]{};
+		std::uint32_t const words = (i % 4 == 0) ? 32 : 1 + rng() % 32;
+		for (std::uint32_t j = 0; j < words; ++j)
+		{
+			w[j] = (i % 9 == 0) ? ~0U : rng();
+		}
+		w[0] |= 1U;
+		if (words == 1 && w[0] == 1)
+		{
+			w[0] = 3;
+		}
+
+		uint1024_t modulus;
+		std::memcpy(modulus.begin(), w, sizeof(w));
+		moduli.push_back(modulus);
+	}
+	return moduli;
+}
+}
+
+TEST(Fermat_multi_test, kernels_match_scalar)
+{
+	auto const moduli = create_moduli(40);
+	for (auto kernel : kernels)
+	{
+		if (!LLC::FermatSupported(kernel))
+		{
+			continue;
+		}
+
+		// full sets of lanes and remainders that are padded or run scalar
+		for (std::size_t count : { std::size_t{ 1 }, std::size_t{ 2 }, std::size_t{ 5 }, std::size_t{ LLC::FermatLanes(kernel) + 3U }, moduli.size() })
+		{
+			std::vector<uint1024_t> results(count);
+			LLC::FermatMulti(kernel, moduli.data(), results.data(), count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				EXPECT_EQ(results[i], LLC::fermat_prime(moduli[i])) << static_cast<int>(kernel) << " " << moduli[i].GetHex();
+			}
+		}
+	}
+}
+
+TEST(Fermat_multi_test, primes_pass)
+{
+	// 2^1023 + 1155 is the first probable prime above 2^1023, 2^521 - 1 is prime and 2^521 + 1 is divisible by 3
+	uint1024_t big_prime = (uint1024_t(1) << 1023) + 1155;
+	uint1024_t mersenne = (uint1024_t(1) << 521) - 1;
+	std::vector<uint1024_t> const moduli{ big_prime, mersenne, big_prime + 2, mersenne + 2 };
+	for (auto kernel : kernels)
+	{
+		if (!LLC::FermatSupported(kernel))
+		{
+			continue;
+		}
+
+		std::vector<uint1024_t> results(moduli.size());
+		LLC::FermatMulti(kernel, moduli.data(), results.data(), moduli.size());
+		EXPECT_EQ(results[1], 1) << static_cast<int>(kernel);
+		EXPECT_NE(results[3], 1) << static_cast<int>(kernel);
+		EXPECT_EQ(results[0], 1) << static_cast<int>(kernel);
+	}
+}
@@ -0,0 +1,67 @@
+// Benchmark: compact reference Keccak-f[1600] against the unrolled lane complementing one, and the SK hashes using it
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "LLC/hash/SK.h"
+#include "LLC/hash/SK/KeccakF-1600-interface.h"
+
+namespace
+{
+constexpr std::size_t iterations{ 200000U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+void run(char const* name, std::function<void(std::size_t)> const& function)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		function(i);
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-32s %10.1f ns/op\n", name, duration / iterations);
+}
+}
+
+int main()
+{
+	std::array<std::uint64_t, 25> state{};
+	state[0] = 1U;
+
+	run("keccak-f[1600] compact", [&state](std::size_t)
+	{
+		KeccakF1600_StatePermute_Compact(state.data());
+	});
+	g_sink += state[0];
+
+	run("keccak-f[1600] opt64", [&state](std::size_t)
+	{
+		KeccakF1600_StatePermute_Opt64(state.data());
+	});
+	g_sink += state[0];
+
+	// the SK hashes use the permutation selected at build time
+	std::vector<std::uint8_t> header(216);
+	run("SK1024 (block header)", [&header](std::size_t i)
+	{
+		header[215] = static_cast<std::uint8_t>(i);
+		g_sink += LLC::SK1024(header.begin(), header.end()).Get64(0);
+	});
+
+	std::vector<std::uint8_t> address(32);
+	run("SK256 (address)", [&address](std::size_t i)
+	{
+		address[31] = static_cast<std::uint8_t>(i);
+		g_sink += LLC::SK256(address).Get64(0);
+	});
+
+	run("SK64 (checksum)", [&address](std::size_t i)
+	{
+		address[31] = static_cast<std::uint8_t>(i);
+		g_sink += LLC::SK64(address.begin(), address.end());
+	});
+
+	return g_sink == 0U ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "LLC/hash/SK.h"
+#include "LLC/hash/SK/KeccakF-1600-interface.h"
+#include "LLC/hash/SK/KeccakHash.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+TEST(Keccak_test, opt64_permutation_identical_to_compact_test)
+{
+	std::uint64_t seed{ 0x0123456789abcdefULL };
+	for (int i = 0; i < 100; ++i)
+	{
+		std::array<std::uint64_t, 25> compact_state;
+		for (auto& lane : compact_state)
+		{
+			// xorshift
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			lane = seed;
+		}
+		auto opt64_state = compact_state;
+
+		KeccakF1600_StatePermute_Compact(compact_state.data());
+		KeccakF1600_StatePermute_Opt64(opt64_state.data());
+		EXPECT_EQ(compact_state, opt64_state);
+	}
+}
+
+TEST(Keccak_test, fixed_parameter_initialize_test)
+{
+	std::vector<std::uint8_t> const data{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	for (auto const parameters : { std::array<std::uint32_t, 3>{ 576, 1024, 1024 }, std::array<std::uint32_t, 3>{ 1344, 256, 256 } })
+	{
+		Keccak_HashInstance runtime_instance;
+		Keccak_HashInstance fixed_instance;
+		EXPECT_EQ(Keccak_HashInitialize(&runtime_instance, parameters[0], parameters[1], parameters[2], 0x05), SUCCESS);
+		if (parameters[0] == 576)
+		{
+			EXPECT_EQ((Keccak_HashInitialize<576, 1024>(&fixed_instance, parameters[2], 0x05)), SUCCESS);
+		}
+		else
+		{
+			EXPECT_EQ((Keccak_HashInitialize<1344, 256>(&fixed_instance, parameters[2], 0x05)), SUCCESS);
+		}
+
+		std::vector<std::uint8_t> runtime_hash(parameters[2] / 8);
+		std::vector<std::uint8_t> fixed_hash(parameters[2] / 8);
+		Keccak_HashUpdate(&runtime_instance, data.data(), data.size() * 8);
+		Keccak_HashUpdate(&fixed_instance, data.data(), data.size() * 8);
+		Keccak_HashFinal(&runtime_instance, runtime_hash.data());
+		Keccak_HashFinal(&fixed_instance, fixed_hash.data());
+		EXPECT_EQ(runtime_hash, fixed_hash);
+	}
+}
@@ -0,0 +1,50 @@
+// Benchmark: SK1024 hashes per second per core of block header sized messages for the scalar, AVX2 and AVX-512 kernels
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "LLC/hash/SK_multi.h"
+
+namespace
+{
+constexpr std::size_t header_size{ 216U };
+constexpr std::size_t batch_size{ 64U };
+constexpr std::size_t iterations{ 2000U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+void run(char const* name, LLC::SK1024Kernel kernel)
+{
+	if (!LLC::SK1024Supported(kernel))
+	{
+		std::printf("%-10s not supported\n", name);
+		return;
+	}
+
+	std::vector<std::uint8_t> headers(header_size * batch_size);
+	std::vector<std::uint8_t const*> messages;
+	for (std::size_t i = 0; i < batch_size; ++i)
+	{
+		headers[i * header_size] = static_cast<std::uint8_t>(i);
+		messages.push_back(&headers[i * header_size]);
+	}
+	std::vector<uint1024_t> hashes(batch_size);
+
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		headers[header_size - 1]++;		// nonce changes between the runs
+		LLC::SK1024Multi(kernel, messages.data(), header_size, hashes.data(), batch_size);
+		g_sink += hashes[0].Get64(0);
+	}
+	auto const duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-10s %12.0f hashes/s\n", name, iterations * batch_size / duration);
+}
+}
+
+int main()
+{
+	run("scalar", LLC::SK1024Kernel::SCALAR);
+	run("avx2", LLC::SK1024Kernel::AVX2);
+	run("avx512", LLC::SK1024Kernel::AVX512);
+	return g_sink == 0U ? 1 : 0;
+}
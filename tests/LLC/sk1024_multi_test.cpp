@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "LLC/hash/SK.h"
+#include "LLC/hash/SK_multi.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+// SK1024 of the bytes 0x00 .. 0xd7 (216 bytes, the size of a block header) and of the empty message
+std::string const header_sized_hash{ "eece89da54034a279b583a6f82658cc9c18d99fcade02c97cf98e4af7d772da4f9499c45fb6fe26341d5e5ba149fe5beae97758d78b57d6e408a3d3f9ae03b7bec620fe4e09102b2266d186138ab8c76b5dadffecd33f2082266d69244925e82aee5f5d2f2c4d8d8f65c882de4b7232b25ed937ff9830ffb5612a4902bcf68df" };
+std::string const empty_hash{ "0014c54f08d7d8fddb361058ba809c4ee2e036b7e1e31b9248617ed2368b4c19e07be5d538ca50e2679cbc30785a169cbc6fad3e7c50cb0c7804f4a221072024ac0bc6e3ac8251fb7b681793badfa15b9ca2092cf2a65072dfde56c047208b7071ba9ae173b5c5f71b9d65814cd27a71945bb90e96179ea0ee5d84e0b62ff6f0" };
+
+std::vector<LLC::SK1024Kernel> const kernels{ LLC::SK1024Kernel::SCALAR, LLC::SK1024Kernel::AVX2, LLC::SK1024Kernel::AVX512 };
+
+std::vector<std::uint8_t> create_message(std::size_t size, std::size_t seed)
+{
+	std::vector<std::uint8_t> message(size);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		message[i] = static_cast<std::uint8_t>(i + seed * 31);
+	}
+	return message;
+}
+}
+
+TEST(SK1024_multi_test, known_answer_test)
+{
+	auto const header = create_message(216, 0);
+	EXPECT_EQ(LLC::SK1024(header.begin(), header.end()).ToString(), header_sized_hash);
+
+	for (auto kernel : kernels)
+	{
+		if (!LLC::SK1024Supported(kernel))
+		{
+			continue;
+		}
+
+		// a full set of lanes plus a remainder
+		std::size_t const count = 2 * LLC::SK1024Lanes(kernel) + 1;
+		std::vector<std::uint8_t const*> messages(count, header.data());
+		std::vector<uint1024_t> hashes(count);
+		LLC::SK1024Multi(kernel, messages.data(), header.size(), hashes.data(), count);
+		for (auto const& hash : hashes)
+		{
+			EXPECT_EQ(hash.ToString(), header_sized_hash);
+		}
+
+		std::uint8_t const empty{ 0 };
+		messages.assign(count, &empty);
+		LLC::SK1024Multi(kernel, messages.data(), 0, hashes.data(), count);
+		for (auto const& hash : hashes)
+		{
+			EXPECT_EQ(hash.ToString(), empty_hash);
+		}
+	}
+}
+
+TEST(SK1024_multi_test, identical_to_sk1024_test)
+{
+	// block boundaries of skein (128 bytes) and of the keccak rate (72 bytes) included
+	for (std::size_t size : { 1U, 8U, 72U, 127U, 128U, 129U, 216U, 256U, 300U })
+	{
+		std::vector<std::vector<std::uint8_t>> data;
+		std::vector<std::uint8_t const*> messages;
+		for (std::size_t i = 0; i < 19; ++i)
+		{
+			data.push_back(create_message(size, i));
+		}
+		for (auto const& message : data)
+		{
+			messages.push_back(message.data());
+		}
+
+		for (auto kernel : kernels)
+		{
+			std::vector<uint1024_t> hashes(messages.size());
+			LLC::SK1024Multi(kernel, messages.data(), size, hashes.data(), hashes.size());
+			for (std::size_t i = 0; i < messages.size(); ++i)
+			{
+				EXPECT_EQ(hashes[i], LLC::SK1024(data[i].begin(), data[i].end())) << "kernel " << static_cast<int>(kernel) << " size " << size << " message " << i;
+			}
+		}
+	}
+}
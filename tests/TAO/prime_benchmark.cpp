@@ -0,0 +1,95 @@
+// Benchmark: prime channel shares per second (GetPrimeDifficulty with and without offsets, GetPrimeDifficulties), Fermat tests per second of the Montgomery,
+// the OpenSSL implementation and the multi lane kernels and the small prime sieve
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "TAO/Ledger/prime.h"
+#include "LLC/prime/fermat_multi.h"
+
+namespace
+{
+// GetPrime() of the prime channel block 2023281
+char const* const share_prime{ "000008b60c656453f28d18ed2fd27745e9468b1cd4269366b81755b1266e872bdf5623ec40aa40d491319f511cb9cc6a9884177a5f7228c3ff0c29a24d9f4e8b6dc48d4765107f8f5cd32494096823a8f53f5d1ef6b17e4b9c2e9aed620bf8415dabd93ff613730fac3677198545ea99c6bfc780fd15c8e25efa8c4f5433d9a1" };
+constexpr std::size_t iterations{ 2000U };
+constexpr std::size_t batch_size{ 8U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+template<typename F>
+double per_second(F&& function)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		function(i);
+	}
+	return iterations / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run(char const* name, LLC::FermatKernel kernel, uint1024_t const& prime)
+{
+	if (!LLC::FermatSupported(kernel))
+	{
+		std::printf("fermat %-10s not supported\n", name);
+		return;
+	}
+
+	std::vector<uint1024_t> numbers(batch_size);
+	std::vector<uint1024_t> results(batch_size);
+	auto const batches = per_second([&](std::size_t i)
+	{
+		for (std::size_t j = 0; j < batch_size; ++j)
+		{
+			numbers[j] = prime + 2 * (i * batch_size + j);
+		}
+		LLC::FermatMulti(kernel, numbers.data(), results.data(), batch_size);
+		g_sink += results[0].Get64(0);
+	});
+	std::printf("fermat %-10s %10.0f tests/s\n", name, batches * batch_size);
+}
+}
+
+int main()
+{
+	uint1024_t prime;
+	prime.SetHex(share_prime);
+
+	auto const montgomery = per_second([&prime](std::size_t i) { g_sink += TAO::Ledger::FermatTest(prime + 2 * i).Get64(0); });
+	auto const openssl = per_second([&prime](std::size_t i) { g_sink += TAO::Ledger::FermatTestBigNum(prime + 2 * i).Get64(0); });
+	auto const shares = per_second([&prime](std::size_t) { g_sink += static_cast<std::uint64_t>(TAO::Ledger::GetPrimeDifficulty(prime, {}, true)); });
+
+	// shares with the offsets of the miner, only the claimed positions are tested
+	std::vector<std::uint8_t> offsets;
+	TAO::Ledger::GetOffsets(prime, offsets);
+	auto const offset_shares = per_second([&](std::size_t) { g_sink += static_cast<std::uint64_t>(TAO::Ledger::GetPrimeDifficulty(prime, offsets, true)); });
+
+	// shares of different miners validated together
+	std::vector<uint1024_t> const primes(batch_size, prime);
+	std::vector<double> difficulties(batch_size);
+	auto const share_batches = per_second([&](std::size_t)
+	{
+		TAO::Ledger::GetPrimeDifficulties(primes.data(), difficulties.data(), batch_size);
+		g_sink += static_cast<std::uint64_t>(difficulties[0]);
+	});
+
+	// small divisors of every offset one by one against one sieve of the whole range
+	auto const small_divisors = per_second([&prime](std::size_t i) { g_sink += TAO::Ledger::SmallDivisors(prime + 2 * i) ? 1U : 0U; });
+	auto const sieves = per_second([&prime](std::size_t i) { g_sink += TAO::Ledger::SmallPrimeSieve(prime + 2 * i).count(); });
+
+	// shares of random odd numbers, most are rejected by the sieve of the base
+	auto const bogus_shares = per_second([&prime](std::size_t i) { g_sink += static_cast<std::uint64_t>(TAO::Ledger::GetPrimeDifficulty(prime + 2 * (i + 1), {}, true)) + 1U; });
+
+	std::printf("fermat montgomery %10.0f tests/s\n", montgomery);
+	std::printf("fermat openssl    %10.0f tests/s\n", openssl);
+	run("scalar", LLC::FermatKernel::SCALAR, prime);
+	run("avx2", LLC::FermatKernel::AVX2, prime);
+	run("avx512", LLC::FermatKernel::AVX512, prime);
+	run("avx512ifma", LLC::FermatKernel::AVX512IFMA, prime);
+	std::printf("small divisors    %10.0f tests/s\n", small_divisors);
+	std::printf("small prime sieve %10.0f sieves/s (%u offsets, %u primes)\n", sieves, TAO::Ledger::SIEVE_RANGE, TAO::Ledger::SIEVE_PRIMES);
+	std::printf("prime shares      %10.0f shares/s\n", shares);
+	std::printf("bogus shares      %10.0f shares/s\n", bogus_shares);
+	std::printf("prime shares offs %10.0f shares/s\n", offset_shares);
+	std::printf("prime shares x%zu   %10.0f shares/s\n", batch_size, share_batches * batch_size);
+	return g_sink == 0U ? 1 : 0;
+}
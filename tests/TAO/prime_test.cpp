@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "TAO/Ledger/prime.h"
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// GetPrime() of the prime channel block 2023281 (reward test data) and its difficulty with the OpenSSL Fermat test
+std::string const share_prime{ "000008b60c656453f28d18ed2fd27745e9468b1cd4269366b81755b1266e872bdf5623ec40aa40d491319f511cb9cc6a9884177a5f7228c3ff0c29a24d9f4e8b6dc48d4765107f8f5cd32494096823a8f53f5d1ef6b17e4b9c2e9aed620bf8415dabd93ff613730fac3677198545ea99c6bfc780fd15c8e25efa8c4f5433d9a1" };
+double const share_difficulty{ 9.1615080 };
+
+// random number with the given count of 32 bit words, optionally with all bits set or only the top bit set
+uint1024_t create_number(std::mt19937& rng, std::uint32_t words, bool odd)
+{
+	std::uint32_t w[32]{};
+	for (std::uint32_t i = 0; i < words; ++i)
+	{
+		w[i] = rng();
+	}
+	w[0] = odd ? (w[0] | 1U) : (w[0] & ~1U);
+
+	uint1024_t result;
+	std::memcpy(result.begin(), w, sizeof(w));
+	return result;
+}
+}
+
+TEST(Prime_test, fermat_matches_openssl)
+{
+	std::mt19937 rng{ 1024 };
+	for (std::uint32_t i = 0; i < 500; ++i)
+	{
+		auto const number = create_number(rng, 1 + i % 32, true);
+		EXPECT_EQ(TAO::Ledger::FermatTest(number), TAO::Ledger::FermatTestBigNum(number)) << number.GetHex();
+	}
+}
+
+TEST(Prime_test, fermat_full_width_moduli)
+{
+	// results above 2^1023 need the extra carry word in the montgomery reduction
+	std::mt19937 rng{ 2048 };
+	for (std::uint32_t i = 0; i < 200; ++i)
+	{
+		auto number = create_number(rng, 32, true);
+		number |= uint1024_t(1) << 1023;
+		EXPECT_EQ(TAO::Ledger::FermatTest(number), TAO::Ledger::FermatTestBigNum(number)) << number.GetHex();
+	}
+
+	uint1024_t all_ones = ~uint1024_t(0);
+	EXPECT_EQ(TAO::Ledger::FermatTest(all_ones), TAO::Ledger::FermatTestBigNum(all_ones));
+
+	uint1024_t top_bit = (uint1024_t(1) << 1023) + 1;
+	EXPECT_EQ(TAO::Ledger::FermatTest(top_bit), TAO::Ledger::FermatTestBigNum(top_bit));
+}
+
+TEST(Prime_test, fermat_even_and_small_numbers)
+{
+	std::mt19937 rng{ 4096 };
+	for (std::uint32_t i = 0; i < 20; ++i)
+	{
+		auto const number = create_number(rng, 32, false);
+		EXPECT_EQ(TAO::Ledger::FermatTest(number), TAO::Ledger::FermatTestBigNum(number));
+	}
+
+	for (std::uint64_t i = 1; i < 64; ++i)
+	{
+		EXPECT_EQ(TAO::Ledger::FermatTest(uint1024_t(i)), TAO::Ledger::FermatTestBigNum(uint1024_t(i))) << i;
+	}
+}
+
+TEST(Prime_test, prime_share_difficulty)
+{
+	uint1024_t prime;
+	prime.SetHex(share_prime);
+
+	EXPECT_TRUE(TAO::Ledger::PrimeCheck(prime));
+	for (std::uint32_t offset = 0; offset <= 14; offset += 2)
+	{
+		EXPECT_EQ(TAO::Ledger::FermatTest(prime + offset), TAO::Ledger::FermatTestBigNum(prime + offset));
+	}
+
+	EXPECT_NEAR(TAO::Ledger::GetPrimeDifficulty(prime, {}, true), share_difficulty, 1e-7);
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime + 2, {}, true), 0.0);
+}
+
+TEST(Prime_test, fermat_batch_matches_single)
+{
+	// odd, even and small numbers mixed, more than a batch of lanes
+	std::mt19937 rng{ 8192 };
+	std::vector<uint1024_t> numbers;
+	for (std::uint32_t i = 0; i < 21; ++i)
+	{
+		numbers.push_back(create_number(rng, 1 + (i * 7) % 32, i % 5 != 0));
+	}
+	numbers.push_back(uint1024_t(1));
+	numbers.push_back(uint1024_t(3));
+
+	std::vector<uint1024_t> results(numbers.size());
+	TAO::Ledger::FermatTestBatch(numbers.data(), results.data(), numbers.size());
+	for (std::size_t i = 0; i < numbers.size(); ++i)
+	{
+		EXPECT_EQ(results[i], TAO::Ledger::FermatTestBigNum(numbers[i])) << numbers[i].GetHex();
+	}
+}
+
+TEST(Prime_test, prime_difficulties_of_several_shares)
+{
+	uint1024_t prime;
+	prime.SetHex(share_prime);
+
+	// the share, composites and the share again
+	std::vector<uint1024_t> primes{ prime, prime + 2, prime, prime + 4 };
+	std::vector<double> difficulties(primes.size());
+	TAO::Ledger::GetPrimeDifficulties(primes.data(), difficulties.data(), primes.size());
+
+	for (std::size_t i = 0; i < primes.size(); ++i)
+	{
+		EXPECT_EQ(difficulties[i], TAO::Ledger::GetPrimeDifficulty(primes[i], {}, true));
+	}
+	EXPECT_NEAR(difficulties[0], share_difficulty, 1e-7);
+	EXPECT_EQ(difficulties[1], 0.0);
+}
+
+TEST(Prime_test, prime_difficulty_with_offsets)
+{
+	uint1024_t prime;
+	prime.SetHex(share_prime);
+
+	std::vector<std::uint8_t> offsets;
+	TAO::Ledger::GetOffsets(prime, offsets);
+	ASSERT_GT(offsets.size(), 4U);
+
+	EXPECT_NEAR(TAO::Ledger::GetPrimeDifficulty(prime, offsets, true), share_difficulty, 1e-7);
+
+	// a wrong fractional difficulty is rejected
+	offsets[offsets.size() - 4] ^= 1U;
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, offsets, true), 0.0);
+}
+
+TEST(Prime_test, prime_difficulty_rejects_bogus_offsets)
+{
+	uint1024_t prime;
+	prime.SetHex(share_prime);
+
+	std::vector<std::uint8_t> offsets;
+	TAO::Ledger::GetOffsets(prime, offsets);
+	auto const fraction_index = static_cast<std::ptrdiff_t>(offsets.size() - 4);
+
+	// too short for the fractional difficulty
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, { 2, 4, 6 }, true), 0.0);
+
+	// the same prime counted twice
+	auto repeated = offsets;
+	repeated.insert(repeated.begin() + fraction_index, 0);
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, repeated, true), 0.0);
+
+	// odd and too large gaps
+	auto odd = offsets;
+	odd[0] = 3;
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, odd, true), 0.0);
+	auto large = offsets;
+	large[0] = 14;
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, large, true), 0.0);
+
+	// the cluster starts with gaps 10, 2. Gaps 8, 4 claim the composite +8 and still reach +12
+	ASSERT_EQ(offsets[0], 10U);
+	ASSERT_EQ(offsets[1], 2U);
+	auto composite = offsets;
+	composite[0] = 8;
+	composite[1] = 4;
+	EXPECT_FALSE(TAO::Ledger::PrimeCheck(prime + 8));
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime, composite, true), 0.0);
+
+	// offsets of a composite base
+	EXPECT_EQ(TAO::Ledger::GetPrimeDifficulty(prime + 2, offsets, true), 0.0);
+
+	// without verification the claim is taken as it is
+	EXPECT_NEAR(TAO::Ledger::GetPrimeDifficulty(prime, offsets, false), share_difficulty, 1e-7);
+}
+
+TEST(Prime_test, small_prime_sieve_matches_divisions)
+{
+	// the sieve primes by trial division
+	std::vector<std::uint32_t> primes;
+	for (std::uint32_t n = 2; primes.size() < TAO::Ledger::SIEVE_PRIMES; ++n)
+	{
+		bool prime = true;
+		for (auto const p : primes)
+		{
+			prime = prime && n % p != 0;
+		}
+		if (prime)
+		{
+			primes.push_back(n);
+		}
+	}
+
+	uint1024_t share;
+	share.SetHex(share_prime);
+	std::mt19937 rng{ 16384 };
+	std::vector<uint1024_t> numbers{ share, uint1024_t(1), create_number(rng, 1, true) };
+	for (std::uint32_t i = 0; i < 4; ++i)
+	{
+		numbers.push_back(create_number(rng, 1 + i * 10, i % 2 == 0));
+	}
+
+	for (auto const& number : numbers)
+	{
+		auto const sieve = TAO::Ledger::SmallPrimeSieve(number);
+		for (std::uint32_t offset = 0; offset < TAO::Ledger::SIEVE_RANGE; ++offset)
+		{
+			auto const candidate = number + offset;
+			bool divisible = false;
+			bool small_divisor = false;
+			for (std::size_t i = 0; i < primes.size(); ++i)
+			{
+				bool const divides = candidate % static_cast<std::uint16_t>(primes[i]) == 0;
+				divisible = divisible || divides;
+				small_divisor = small_divisor || (divides && i < 11);
+			}
+			EXPECT_EQ(sieve[offset], divisible) << candidate.GetHex();
+			EXPECT_EQ(TAO::Ledger::SmallDivisors(candidate), !small_divisor) << candidate.GetHex();
+		}
+	}
+}
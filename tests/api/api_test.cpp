@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "api/shared_data_reader.hpp"
+#include "config/config_api.hpp"
+#include "persistance/data_reader_mock.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace ::nexuspool;
+using namespace ::testing;
+
+namespace
+{
+std::vector<persistance::Data_reader::Uptr> create_data_readers(std::size_t count)
+{
+	std::vector<persistance::Data_reader::Uptr> data_readers;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		data_readers.push_back(std::make_unique<NiceMock<persistance::Data_reader_mock>>());
+	}
+	return data_readers;
+}
+
+std::uint16_t read_db_reader_count(std::string const& db_readers)
+{
+	auto const config_file = "api_test_config.json";
+	{
+		std::ofstream file(config_file);
+		file << R"({"public_ip":"127.0.0.1","listen_port":8080,"wallet_ip":"127.0.0.1","mining_mode":"hash",)"
+			<< R"("auth_user":"user","auth_pw":"pw")" << db_readers << "}";
+	}
+
+	auto config_api = config::create_api_config();
+	EXPECT_TRUE(config_api->read_config(config_file));
+	std::remove(config_file);
+	return config_api->get_db_reader_count();
+}
+}
+
+TEST(Config_api_test, db_readers_at_least_one)
+{
+	EXPECT_EQ(read_db_reader_count(""), 4U);
+	EXPECT_EQ(read_db_reader_count(R"(,"db_readers":8)"), 8U);
+	EXPECT_EQ(read_db_reader_count(R"(,"db_readers":1)"), 1U);
+	EXPECT_EQ(read_db_reader_count(R"(,"db_readers":0)"), 1U);
+}
+
+TEST(Shared_data_reader_test, checkout_waits_for_checkin)
+{
+	api::Shared_data_reader shared_data_reader{ create_data_readers(1U) };
+	std::atomic_bool checked_out{ false };
+	std::thread request;
+	{
+		auto reader = shared_data_reader.checkout();
+
+		// all readers in use -> the next request waits
+		request = std::thread([&shared_data_reader, &checked_out]()
+		{
+			auto reader = shared_data_reader.checkout();
+			checked_out = true;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		EXPECT_FALSE(checked_out);
+	}
+
+	// reader returned at the end of the scope
+	request.join();
+	EXPECT_TRUE(checked_out);
+}
+
+TEST(Shared_data_reader_test, readers_used_concurrently)
+{
+	api::Shared_data_reader shared_data_reader{ create_data_readers(2U) };
+	auto first_reader = shared_data_reader.checkout();
+	auto second_reader = shared_data_reader.checkout();
+	EXPECT_NE(first_reader.operator->(), second_reader.operator->());
+
+	// a moved reader is returned only once
+	auto moved_reader = std::move(first_reader);
+	EXPECT_NE(moved_reader.operator->(), nullptr);
+}
+
+TEST(Shared_data_reader_test, reader_returned_when_query_throws)
+{
+	auto data_readers = create_data_readers(1U);
+	auto& data_reader = static_cast<persistance::Data_reader_mock&>(*data_readers.front());
+	EXPECT_CALL(data_reader, get_account(_)).WillOnce(Throw(std::runtime_error{ "db locked" }));
+	EXPECT_CALL(data_reader, get_pool_hashrate()).WillOnce(Throw(std::runtime_error{ "db locked" })).WillOnce(Return(42.0));
+	api::Shared_data_reader shared_data_reader{ std::move(data_readers) };
+
+	EXPECT_THROW(shared_data_reader.get_account("account"), std::runtime_error);
+	EXPECT_THROW(shared_data_reader.checkout()->get_pool_hashrate(), std::runtime_error);
+
+	// the only reader is available again, otherwise the query would wait forever
+	EXPECT_DOUBLE_EQ(shared_data_reader.get_pool_hashrate(), 42.0);
+}
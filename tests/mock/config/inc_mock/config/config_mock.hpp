@@ -32,6 +32,10 @@ public:
     MOCK_METHOD(std::uint16_t, get_hashrate_interval, (), (const override));
     MOCK_METHOD(bool, get_miner_notifications, (), (const override));
     MOCK_METHOD(bool, get_legacy_mode, (), (const override));
+    MOCK_METHOD(std::uint16_t, get_io_threads, (), (const override));
+    MOCK_METHOD(std::uint16_t, get_validation_threads, (), (const override));
+    MOCK_METHOD(std::uint16_t, get_share_flush_interval, (), (const override));
+    MOCK_METHOD(std::uint16_t, get_vardiff_shares_per_minute, (), (const override));
 };
 
 
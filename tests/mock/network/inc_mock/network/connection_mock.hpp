@@ -14,7 +14,9 @@ public:
     MOCK_METHOD(Endpoint const&, remote_endpoint, (), (const, override));
     MOCK_METHOD(Endpoint const&, local_endpoint, (), (const, override));
     MOCK_METHOD(void, transmit, (Shared_payload tx_buffer), (override));
+    MOCK_METHOD(void, transmit, (Payload_sequence tx_buffers), (override));
     MOCK_METHOD(void, close, (), (override));
+    MOCK_METHOD(void, post, (std::function<void()> handler), (override));
 };
 
 }
@@ -15,6 +15,7 @@ public:
 
     MOCK_METHOD(Data_reader_factory_mock::Sptr, get_data_reader_factory, (), (override));
     MOCK_METHOD(Data_writer_factory_mock::Sptr, get_data_writer_factory, (), (override));
+    MOCK_METHOD(void, stop, (), (override));
 };
 
 
@@ -6,6 +6,7 @@
 #include <persistance/data_writer.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace nexuspool
 {
@@ -31,6 +32,10 @@ public:
     MOCK_METHOD(bool, update_reward_of_payment, (double reward, std::string account, std::uint32_t round_number), (override));
     MOCK_METHOD(bool, delete_empty_payments, (), (override));
     MOCK_METHOD(bool, update_block_share_difficulty, (std::uint32_t height, double share_difficulty), (override));
+    MOCK_METHOD(bool, add_shares_to_accounts, (std::vector<Account_share_data> data), (override));
+    MOCK_METHOD(bool, begin_transaction, (), (override));
+    MOCK_METHOD(bool, commit_transaction, (), (override));
+    MOCK_METHOD(bool, rollback_transaction, (), (override));
 };
 
 // Wrapper for unique data_writer. Ensures thread safety
@@ -53,6 +58,11 @@ public:
     MOCK_METHOD(bool, update_reward_of_payment, (double reward, std::string account, std::uint32_t round_number), (override));
     MOCK_METHOD(bool, delete_empty_payments, (), (override));
     MOCK_METHOD(bool, update_block_share_difficulty, (std::uint32_t height, double share_difficulty), (override));
+    MOCK_METHOD(bool, add_shares_to_accounts, (std::vector<Account_share_data> data), (override));
+    MOCK_METHOD(bool, write_transaction, (Write write), (override));
+    MOCK_METHOD(void, write_async, (Write write, Result_handler handler), (override));
+    MOCK_METHOD(void, flush, (), (override));
+    MOCK_METHOD(void, stop, (), (override));
 };
 
 }
@@ -13,9 +13,11 @@ class Miner_connection_mock : public Miner_connection
 public:
 
     MOCK_METHOD(void, stop, (), (override));
+    MOCK_METHOD(void, send_work, (std::shared_ptr<Work_message const> work_message, Nonce_range const& nonce_range), (override));
+    MOCK_METHOD(bool, takes_work, (), (const, override));
     MOCK_METHOD(network::Connection::Handler, connection_handler, (), (override));
     MOCK_METHOD(void, get_hashrate, (), (override));
-    MOCK_METHOD(void, send_pool_notification, (std::string message), (override));
+    MOCK_METHOD(void, send_pool_notification, (network::Shared_payload notification), (override));
 };
 
 }
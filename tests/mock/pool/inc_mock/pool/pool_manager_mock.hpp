@@ -17,7 +17,7 @@ public:
     MOCK_METHOD(void, set_block, (LLP::CBlock const& block), (override));
     MOCK_METHOD(void, add_block_to_storage, (std::uint32_t block_map_id), (override));
     MOCK_METHOD(void, get_block, (Get_block_handler&& handler), (override));
-    MOCK_METHOD(void, submit_block, (std::unique_ptr<LLP::CBlock> block, Session_key miner_key, Submit_block_handler handler), (override));
+    MOCK_METHOD(void, submit_block, (std::unique_ptr<LLP::CBlock> block, Session_key miner_key, std::uint32_t pool_nbits, LLP::Block_hash_context::Sptr hash_context, network::Connection::Sptr connection, Submit_block_handler handler), (override));
     MOCK_METHOD(std::uint32_t, get_pool_nbits, (), (const override));
 };
 
@@ -16,11 +16,13 @@ public:
 	MOCK_METHOD(void, update_user_data, (Session_user const& user_data), (override));
 	MOCK_METHOD(std::chrono::steady_clock::time_point, get_update_time, (), (const override));
 	MOCK_METHOD(void, set_update_time, (std::chrono::steady_clock::time_point update_time), (override));
-	MOCK_METHOD(bool, add_share, (), (override));
+	MOCK_METHOD(bool, add_share, (double share_weight), (override));
 	MOCK_METHOD(void, reset_shares, (), (override));
 	MOCK_METHOD(void, update_hashrate, (double hashrate, std::uint32_t pool_nbits, std::uint32_t network_nbits), (override));
-	MOCK_METHOD(void, set_block, (LLP::CBlock const& block), (override));
-	MOCK_METHOD(std::unique_ptr<LLP::CBlock>, get_block, (), (override));
+	MOCK_METHOD(std::uint32_t, retarget_difficulty, (std::uint32_t pool_nbits, std::uint32_t network_nbits), (override));
+	MOCK_METHOD(std::uint32_t, add_job, (std::shared_ptr<LLP::CBlock const> block, Nonce_range const& nonce_range, std::uint32_t pool_nbits), (override));
+	MOCK_METHOD(bool, get_job, (std::uint32_t work_id, Session_job& job), (const override));
+	MOCK_METHOD(bool, get_latest_job, (Session_job& job), (const override));
 	MOCK_METHOD(bool, create_account, (), (override));
 	MOCK_METHOD(void, login, (), (override));
 	MOCK_METHOD(bool, is_inactive, (), (const override));
@@ -0,0 +1,33 @@
+#ifndef NEXUSPOOL_REWARD_COMPONENT_MOCK_HPP
+#define NEXUSPOOL_REWARD_COMPONENT_MOCK_HPP
+
+#include "gmock/gmock.h"
+#include "reward/component.hpp"
+
+namespace nexuspool {
+namespace reward {
+
+class Component_mock : public Component
+{
+public:
+
+    MOCK_METHOD(Difficulty_result, check_difficulty, (const LLP::CBlock& block, std::uint32_t pool_nbits), (const, override));
+    MOCK_METHOD(Difficulty_result, check_difficulty, (const LLP::CBlock& block, LLP::Block_hash_context const& hash_context), (const, override));
+    MOCK_METHOD(Difficulty_result, check_difficulty, (uint1024_t const& block_hash, LLP::Block_hash_context const& hash_context), (const, override));
+    MOCK_METHOD(Difficulty_result, check_difficulty, (double prime_difficulty, const LLP::CBlock& block, std::uint32_t pool_nbits), (const, override));
+    MOCK_METHOD(bool, start_round, (std::uint16_t round_duration_hours), (override));
+    MOCK_METHOD(bool, is_round_active, (), (override));
+    MOCK_METHOD(std::uint32_t, get_current_round, (), (const, override));
+    MOCK_METHOD(void, get_start_end_round_times, (std::chrono::system_clock::time_point& start_time, std::chrono::system_clock::time_point& end_time), (override));
+    MOCK_METHOD(bool, end_round, (std::uint32_t round_number), (override));
+    MOCK_METHOD(Calculate_rewards_result, calculate_rewards, (std::uint32_t round_number), (override));
+    MOCK_METHOD(bool, pay_round, (std::uint32_t round), (override));
+    MOCK_METHOD(bool, process_unpaid_rounds, (), (override));
+    MOCK_METHOD(void, block_found, (), (override));
+    MOCK_METHOD(void, update_block_hashes_from_current_round, (), (override));
+};
+
+}
+}
+
+#endif
@@ -2,7 +2,10 @@
 #include <sqlite/sqlite3.h>
 #include "persistance_fixture.hpp"
 #include "persistance/command/command.hpp"
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace persistance;
 using ::nexuspool::persistance::command::Type;
@@ -363,6 +366,38 @@ TEST_F(Persistance_fixture, command_add_block)
 	m_test_data.delete_from_block_table(block_height_input);
 }
 
+TEST_F(Persistance_fixture, read_written_block)
+{
+	// every column of the result row is decoded into its member of Block_data
+	std::int64_t const block_height_input = 5983134;
+	persistance::Block_data const block_input{ "", static_cast<std::uint32_t>(block_height_input), "HASH", 7896.5, true, "blockfinder", 987654, "current_datetime", 2.54 };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	EXPECT_TRUE(data_writer->add_block(block_input));
+
+	auto data_reader = m_persistance_component->get_data_reader_factory()->create_data_reader();
+	auto const blocks = data_reader->get_blocks_from_round(block_input.m_round);
+	ASSERT_EQ(blocks.size(), 1U);
+	EXPECT_EQ(blocks.front().m_hash, block_input.m_hash);
+	EXPECT_EQ(blocks.front().m_height, block_input.m_height);
+	EXPECT_EQ(blocks.front().m_type, block_input.m_type);
+	EXPECT_DOUBLE_EQ(blocks.front().m_difficulty, block_input.m_difficulty);
+	EXPECT_EQ(blocks.front().m_orphan, block_input.m_orphan);
+	EXPECT_EQ(blocks.front().m_block_finder, block_input.m_block_finder);
+	EXPECT_EQ(blocks.front().m_round, block_input.m_round);
+	EXPECT_DOUBLE_EQ(blocks.front().m_mainnet_reward, block_input.m_mainnet_reward);
+
+	auto const heights = data_reader->get_blocks_without_hash_from_round(block_input.m_round);
+	ASSERT_EQ(heights.size(), 1U);
+	EXPECT_EQ(heights.front(), block_input.m_height);
+
+	// a statement without result rows can be executed again with other parameters
+	EXPECT_TRUE(data_reader->get_blocks_from_round(block_input.m_round + 1).empty());
+	EXPECT_EQ(data_reader->get_blocks_from_round(block_input.m_round).size(), 1U);
+
+	// cleanup db
+	m_test_data.delete_from_block_table(block_height_input);
+}
+
 TEST_F(Persistance_fixture, command_update_block_share_difficulty)
 {
 	std::int64_t const block_height_input = 5983133;
@@ -584,3 +619,243 @@ TEST_F(Persistance_fixture, command_reset_shares_from_accounts)
 
 
 
+
+TEST_F(Persistance_fixture, command_add_shares_to_accounts)
+{
+	std::string account_name{ "testaccount" };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	auto data_reader = m_persistance_component->get_data_reader_factory()->create_data_reader();
+	// create a new testaccount
+	auto result_create_account = data_writer->create_account(account_name, "");
+	EXPECT_TRUE(result_create_account);
+
+	// empty batch is a no-op
+	EXPECT_TRUE(data_writer->add_shares_to_accounts({}));
+
+	Account_share_data share_data;
+	share_data.m_address = account_name;
+	share_data.m_shares = 100;
+	share_data.m_hashrate = 1000;
+	share_data.m_update_hashrate = true;
+	EXPECT_TRUE(data_writer->add_shares_to_accounts({ share_data }));
+
+	auto result_account = data_reader->get_account(account_name);
+	EXPECT_EQ(result_account.m_shares, 100);
+	EXPECT_EQ(result_account.m_hashrate, 1000);
+
+	// shares accumulate, hashrate is only written if flagged
+	share_data.m_shares = 50;
+	share_data.m_hashrate = 2000;
+	share_data.m_update_hashrate = false;
+	EXPECT_TRUE(data_writer->add_shares_to_accounts({ share_data }));
+
+	result_account = data_reader->get_account(account_name);
+	EXPECT_EQ(result_account.m_shares, 150);
+	EXPECT_EQ(result_account.m_hashrate, 1000);
+
+	// cleanup db
+	m_test_data.delete_from_account_table(account_name);
+
+}
+
+// -----------------------------------------------------------------------------------------------
+// Storage thread
+// -----------------------------------------------------------------------------------------------
+
+TEST_F(Persistance_fixture, write_async)
+{
+	std::string account_name{ "testaccount" };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	auto data_reader = m_persistance_component->get_data_reader_factory()->create_data_reader();
+	EXPECT_TRUE(data_writer->create_account(account_name, ""));
+
+	// writes from several threads, batched by the storage thread
+	std::atomic<int> succeeded{ 0 };
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			for (int j = 0; j < 250; ++j)
+			{
+				Account_share_data share_data;
+				share_data.m_address = account_name;
+				share_data.m_shares = 1;
+				data_writer->write_async([share_data](Data_writer& writer) { return writer.add_shares_to_accounts({ share_data }); },
+					[&succeeded](bool result) { succeeded += result ? 1 : 0; });
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	data_writer->flush();
+	EXPECT_EQ(succeeded, 1000);
+	EXPECT_EQ(data_reader->get_account(account_name).m_shares, 1000);
+
+	// a failing write doesn't affect the other writes of its batch
+	std::atomic<int> failed{ 0 };
+	data_writer->write_async([&](Data_writer& writer) { return writer.create_account(account_name, ""); }, [&failed](bool result) { failed += result ? 0 : 1; });
+	data_writer->write_async([&](Data_writer& writer) { return writer.add_shares_to_accounts({ Account_share_data{ account_name, 1 } }); }, {});
+	data_writer->flush();
+	EXPECT_EQ(failed, 1);
+	EXPECT_EQ(data_reader->get_account(account_name).m_shares, 1001);
+
+	// cleanup db
+	m_test_data.delete_from_account_table(account_name);
+}
+
+TEST_F(Persistance_fixture, nested_transaction)
+{
+	std::string account_name{ "testaccount" };
+	std::string account_name_2{ "testaccount2" };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	auto data_reader = m_persistance_component->get_data_reader_factory()->create_data_reader();
+
+	data_writer->write_async([&](Data_writer& writer)
+	{
+		EXPECT_TRUE(writer.begin_transaction());
+		EXPECT_TRUE(writer.create_account(account_name, ""));
+		// the inner transaction is reverted, the outer one is committed
+		EXPECT_TRUE(writer.begin_transaction());
+		EXPECT_TRUE(writer.create_account(account_name_2, ""));
+		EXPECT_TRUE(writer.rollback_transaction());
+		return writer.commit_transaction();
+	}, [](bool result) { EXPECT_TRUE(result); });
+	data_writer->flush();
+
+	EXPECT_TRUE(data_reader->does_account_exists(account_name));
+	EXPECT_FALSE(data_reader->does_account_exists(account_name_2));
+
+	// cleanup db
+	m_test_data.delete_from_account_table(account_name);
+}
+
+TEST_F(Persistance_fixture, write_transaction)
+{
+	std::string account_name{ "testaccount" };
+	std::string account_name_2{ "testaccount2" };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	auto data_reader = m_persistance_component->get_data_reader_factory()->create_data_reader();
+
+	// all writes are committed together
+	EXPECT_TRUE(data_writer->write_transaction([&](Data_writer& writer)
+	{
+		return writer.create_account(account_name, "") && writer.add_shares_to_accounts({ Account_share_data{ account_name, 5 } });
+	}));
+	EXPECT_EQ(data_reader->get_account(account_name).m_shares, 5);
+
+	// a failing write reverts all writes of the transaction
+	EXPECT_FALSE(data_writer->write_transaction([&](Data_writer& writer)
+	{
+		EXPECT_TRUE(writer.create_account(account_name_2, ""));
+		EXPECT_TRUE(writer.add_shares_to_accounts({ Account_share_data{ account_name, 5 } }));
+		return writer.create_account(account_name, "");
+	}));
+	EXPECT_FALSE(data_reader->does_account_exists(account_name_2));
+	EXPECT_EQ(data_reader->get_account(account_name).m_shares, 5);
+
+	// cleanup db
+	m_test_data.delete_from_account_table(account_name);
+}
+
+TEST_F(Persistance_fixture, stop_writes_queued_data)
+{
+	std::string account_name{ "testaccount" };
+	auto data_writer = m_persistance_component->get_data_writer_factory()->create_shared_data_writer();
+	data_writer->write_async([&](Data_writer& writer) { return writer.create_account(account_name, ""); }, {});
+	m_persistance_component->stop();
+
+	EXPECT_TRUE(m_persistance_component->get_data_reader_factory()->create_data_reader()->does_account_exists(account_name));
+
+	// writes after stop fail
+	bool async_result{ true };
+	data_writer->write_async([](Data_writer&) { return true; }, [&async_result](bool result) { async_result = result; });
+	EXPECT_FALSE(async_result);
+	EXPECT_FALSE(data_writer->create_account("testaccount2", ""));
+
+	// cleanup db
+	m_test_data.delete_from_account_table(account_name);
+}
+
+TEST_F(Persistance_fixture, schema_indexes_used_by_queries)
+{
+	// the writing connection of the component migrated the db to the latest schema
+	EXPECT_EQ(m_test_data.get_schema_version(), 2);
+
+	std::vector<std::string> const queries{
+		"SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block WHERE round = 1;",
+		"SELECT height FROM block WHERE hash = '' AND round = 1",
+		"UPDATE block SET orphan = 0, mainnet_reward = 1.0 WHERE hash = 'hash'",
+		"UPDATE block SET share_difficulty = 1.0 WHERE height = 1",
+		"SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block ORDER BY height DESC LIMIT 100;",
+		"SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE name = 'name';",
+		"SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE round = 1 AND payment_date_time = ''",
+		"UPDATE payment SET payment_date_time = CURRENT_TIMESTAMP, tx_id = 'tx_id' WHERE round = 1 AND name = 'name'",
+		"UPDATE payment SET amount = 1.0 WHERE name = 'name' AND round = 1",
+		"SELECT name, shares FROM account WHERE shares > 0;" };
+
+	for (auto const& query : queries)
+	{
+		auto const plan = m_test_data.get_query_plan(query);
+		EXPECT_NE(plan.find(" INDEX "), std::string::npos) << query << " -> " << plan;
+	}
+}
+
+TEST_F(Persistance_fixture, schema_migration)
+{
+	// db of schema version 1.0 without versioning
+	std::string const db_filename{ "test_migration.sqlite3" };
+	std::remove(db_filename.c_str());
+	sqlite3* handle;
+	sqlite3_open_v2(db_filename.c_str(), &handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+	sqlite3_exec(handle, R"(CREATE TABLE block (
+		  id INTEGER PRIMARY KEY AUTOINCREMENT,
+		  hash TEXT NOT NULL,
+		  height INTEGER NOT NULL,
+		  type TEXT NOT NULL,
+		  difficulty REAL NOT NULL,
+		  orphan INTEGER NOT NULL,
+		  block_finder TEXT NOT NULL,
+		  round INTEGER NOT NULL,
+		  block_found_time TEXT NOT NULL,
+		  mainnet_reward REAL NOT NULL
+		);
+		CREATE TABLE config (
+		  id INTEGER PRIMARY KEY AUTOINCREMENT,
+		  version TEXT NOT NULL,
+		  difficulty_divider INTEGER NOT NULL,
+		  fee INTEGER NOT NULL,
+		  mining_mode TEXT NOT NULL,
+		  round_duration_hours INTEGER NOT NULL
+		);
+		INSERT INTO config (version, difficulty_divider, fee, mining_mode, round_duration_hours) VALUES('1.0', 1, 1, 'HASH', 24);)",
+		NULL, NULL, NULL);
+
+	config::Persistance_config config{ config::Persistance_type::sqlite, db_filename };
+	auto component = persistance::create_component(m_logger, config);
+	EXPECT_EQ(component->get_data_reader_factory()->create_data_reader()->get_config().m_version, "1.1");
+	EXPECT_EQ(Test_data::get_schema_version(handle), 2);
+	EXPECT_EQ(sqlite3_exec(handle, "SELECT share_difficulty FROM block;", NULL, NULL, NULL), SQLITE_OK);
+	component->stop();
+
+	// a migrated db isn't migrated again
+	sqlite3_exec(handle, "DROP INDEX block_hash;", NULL, NULL, NULL);
+	auto component_restarted = persistance::create_component(m_logger, config);
+	EXPECT_EQ(sqlite3_exec(handle, "SELECT 1 FROM block INDEXED BY block_hash WHERE hash = '';", NULL, NULL, NULL), SQLITE_ERROR);
+	component_restarted->stop();
+
+	sqlite3_close(handle);
+	std::remove(db_filename.c_str());
+}
+
+TEST_F(Persistance_fixture, schema_migration_repeated_on_unversioned_db)
+{
+	// dbs of the latest schema which were created before the versioning run all migrations again
+	m_test_data.set_schema_version(0);
+	auto component = persistance::create_component(m_logger, m_config);
+	EXPECT_EQ(m_test_data.get_schema_version(), 2);
+	component->stop();
+}
@@ -0,0 +1,185 @@
+// Benchmark: hot queries of the sqlite commands on a synthetic db with millions of payments, before and after the
+// schema migration which adds the indexes. Usage: schema_benchmark [scale], scale 1 -> 4M payments, 400k blocks
+#include <sqlite/sqlite3.h>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/types.hpp"
+#include "persistance/create_component.hpp"
+
+using namespace ::nexuspool;
+
+namespace
+{
+constexpr std::size_t iterations{ 50U };
+char const* const db_filename{ "schema_benchmark.sqlite3" };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+struct Query
+{
+	char const* m_name;
+	char const* m_sql;
+	std::function<void(sqlite3_stmt*, std::mt19937&)> m_bind;
+};
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void remove_db()
+{
+	for (auto const& filename : { std::string{ db_filename }, std::string{ db_filename } + "-wal", std::string{ db_filename } + "-shm" })
+	{
+		std::remove(filename.c_str());
+	}
+}
+
+std::string account_name(std::uint32_t account)
+{
+	return "account" + std::to_string(account);
+}
+
+void fill(sqlite3* handle, std::uint32_t rounds, std::uint32_t accounts, std::uint32_t accounts_per_round, std::uint32_t blocks_per_round)
+{
+	std::mt19937 rng{ 42 };
+	sqlite3_exec(handle, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+
+	sqlite3_stmt* stmt;
+	sqlite3_prepare_v2(handle, "INSERT INTO account (name, created_at, last_active, connection_count, shares, hashrate, display_name) VALUES(?, '2021-09-19 10:20:04', '2021-09-19 10:20:04', 1, ?, 0, '')", -1, &stmt, 0);
+	for (std::uint32_t account = 0; account < accounts; ++account)
+	{
+		// only the miners of the current round have shares
+		sqlite3_bind_text(stmt, 1, account_name(account).c_str(), -1, SQLITE_TRANSIENT);
+		sqlite3_bind_double(stmt, 2, account < accounts_per_round ? 10.0 : 0.0);
+		sqlite3_step(stmt);
+		sqlite3_reset(stmt);
+	}
+	sqlite3_finalize(stmt);
+
+	sqlite3_stmt* round_stmt;
+	sqlite3_stmt* block_stmt;
+	sqlite3_stmt* payment_stmt;
+	sqlite3_prepare_v2(handle, "INSERT INTO round (total_shares, total_reward, blocks, start_date_time, end_date_time, is_active, is_paid) VALUES(0, 0, 0, '', '', 0, 1)", -1, &round_stmt, 0);
+	sqlite3_prepare_v2(handle, "INSERT INTO block (hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward) VALUES(?, ?, 'prime', 1.0, 0, ?, ?, '', 1.0)", -1, &block_stmt, 0);
+	sqlite3_prepare_v2(handle, "INSERT INTO payment (name, amount, shares, payment_date_time, round, tx_id) VALUES(?, 1.0, 1.0, ?, ?, '')", -1, &payment_stmt, 0);
+	std::uint32_t height{ 1 };
+	for (std::uint32_t round = 1; round <= rounds; ++round)
+	{
+		sqlite3_step(round_stmt);
+		sqlite3_reset(round_stmt);
+		for (std::uint32_t block = 0; block < blocks_per_round; ++block, ++height)
+		{
+			// the block hashes of the last block of a round aren't known yet
+			auto const hash = block + 1 == blocks_per_round ? std::string{} : "hash" + std::to_string(height);
+			sqlite3_bind_text(block_stmt, 1, hash.c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_int(block_stmt, 2, height);
+			sqlite3_bind_text(block_stmt, 3, account_name(rng() % accounts).c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_int(block_stmt, 4, round);
+			sqlite3_step(block_stmt);
+			sqlite3_reset(block_stmt);
+		}
+		for (std::uint32_t payment = 0; payment < accounts_per_round; ++payment)
+		{
+			// the payments of the last round aren't paid yet
+			sqlite3_bind_text(payment_stmt, 1, account_name(rng() % accounts).c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(payment_stmt, 2, round == rounds ? "" : "2021-09-19 10:20:04", -1, SQLITE_STATIC);
+			sqlite3_bind_int(payment_stmt, 3, round);
+			sqlite3_step(payment_stmt);
+			sqlite3_reset(payment_stmt);
+		}
+	}
+	sqlite3_finalize(round_stmt);
+	sqlite3_finalize(block_stmt);
+	sqlite3_finalize(payment_stmt);
+	sqlite3_exec(handle, "COMMIT;", NULL, NULL, NULL);
+}
+
+void run(sqlite3* handle, std::vector<Query> const& queries)
+{
+	for (auto const& query : queries)
+	{
+		std::mt19937 rng{ 1 };
+		sqlite3_stmt* stmt;
+		sqlite3_prepare_v2(handle, query.m_sql, -1, &stmt, 0);
+		auto const start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < iterations; ++i)
+		{
+			query.m_bind(stmt, rng);
+			while (sqlite3_step(stmt) == SQLITE_ROW)
+			{
+				g_sink += sqlite3_column_int(stmt, 0);
+			}
+			sqlite3_reset(stmt);
+		}
+		std::printf("%-40s %12.3f ms/op\n", query.m_name, elapsed_ms(start) / iterations);
+		sqlite3_finalize(stmt);
+	}
+}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint32_t const scale = argc > 1 ? static_cast<std::uint32_t>(std::atoi(argv[1])) : 1U;
+	std::uint32_t const rounds{ 2000U * scale };
+	std::uint32_t const accounts{ 20000U };
+	std::uint32_t const accounts_per_round{ 2000U };
+	std::uint32_t const blocks_per_round{ 200U };
+
+	auto logger = spdlog::stdout_color_mt("logger");
+	config::Persistance_config const config{ config::Persistance_type::sqlite, db_filename };
+	remove_db();
+	{
+		// tables of the latest schema
+		auto component = persistance::create_component(logger, config);
+		component->stop();
+	}
+
+	// a db of a pool which ran before the indexes were added
+	sqlite3* handle;
+	sqlite3_open_v2(db_filename, &handle, SQLITE_OPEN_READWRITE, NULL);
+	sqlite3_exec(handle, R"(DROP INDEX block_round_hash; DROP INDEX block_hash; DROP INDEX block_height; DROP INDEX payment_name_round;
+		DROP INDEX payment_round_payment_date_time; DROP INDEX account_shares; PRAGMA user_version = 0;)", NULL, NULL, NULL);
+
+	auto start = std::chrono::steady_clock::now();
+	fill(handle, rounds, accounts, accounts_per_round, blocks_per_round);
+	std::printf("fill %u rounds, %u blocks, %u payments: %.0f ms\n", rounds, rounds * blocks_per_round, rounds * accounts_per_round, elapsed_ms(start));
+
+	auto const random_round = [rounds](sqlite3_stmt* stmt, std::mt19937& rng) { sqlite3_bind_int(stmt, 1, 1 + rng() % rounds); };
+	auto const random_account = [accounts](sqlite3_stmt* stmt, std::mt19937& rng)
+	{
+		sqlite3_bind_text(stmt, 1, account_name(rng() % accounts).c_str(), -1, SQLITE_TRANSIENT);
+	};
+	std::vector<Query> const queries{
+		{ "get_blocks_from_round", "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block WHERE round = ?;", random_round },
+		{ "get_blocks_without_hash_from_round", "SELECT height FROM block WHERE hash = '' AND round = ?", random_round },
+		{ "get_latest_blocks", "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block ORDER BY height DESC LIMIT 100;", [](sqlite3_stmt*, std::mt19937&) {} },
+		{ "get_payments", "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE name = ?;", random_account },
+		{ "get_not_paid_data_from_round", "SELECT name, amount, shares, payment_date_time, round, tx_id FROM payment WHERE round = ? AND payment_date_time = ''", random_round },
+		{ "get_active_accounts_from_round", "SELECT name, shares FROM account WHERE shares > 0;", [](sqlite3_stmt*, std::mt19937&) {} } };
+
+	std::printf("\nwithout indexes\n");
+	run(handle, queries);
+
+	start = std::chrono::steady_clock::now();
+	{
+		auto component = persistance::create_component(logger, config);
+		component->stop();
+	}
+	std::printf("\nmigration: %.0f ms\n", elapsed_ms(start));
+
+	std::printf("\nwith indexes\n");
+	run(handle, queries);
+
+	sqlite3_close(handle);
+	remove_db();
+	std::printf("sink %llu\n", static_cast<unsigned long long>(g_sink & 1U));
+	return 0;
+}
@@ -0,0 +1,267 @@
+// Benchmark: queries per second of the data_reader queries through the former command path (parameters bound by name,
+// rows of std::variant columns handed out as std::any) and through the typed sqlite::Statement.
+// Usage: statement_benchmark [iterations]
+#include <sqlite/sqlite3.h>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <any>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+#include "config/types.hpp"
+#include "persistance/create_component.hpp"
+#include "persistance/sqlite/statement.hpp"
+
+using namespace ::nexuspool;
+using namespace ::nexuspool::persistance;
+
+namespace
+{
+char const* const db_filename{ "statement_benchmark.sqlite3" };
+constexpr std::uint32_t accounts{ 2000U };
+constexpr std::uint32_t rounds{ 500U };
+constexpr std::uint32_t blocks_per_round{ 20U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+char const* const get_account_sql{ "SELECT name, created_at, last_active, connection_count, shares, hashrate, display_name FROM account WHERE name = :name;" };
+char const* const get_blocks_from_round_sql{ "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block WHERE round = :round;" };
+char const* const get_latest_blocks_sql{ "SELECT hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward FROM block ORDER BY height DESC LIMIT 100;" };
+
+// ------------------------------------------------------------------------------------
+// former command path
+struct Column_any
+{
+	enum Datatype : std::uint8_t { string = 0, int32, int64, double_t };
+
+	Datatype m_type;
+	std::variant<std::string, std::int32_t, std::int64_t, double> m_data;
+};
+using Row_any = std::vector<Column_any>;
+using Result_any = std::vector<Row_any>;
+
+Row_any const account_row{ {Column_any::string}, {Column_any::string}, {Column_any::string}, {Column_any::int32},
+	{Column_any::double_t}, {Column_any::double_t}, {Column_any::string} };
+Row_any const block_row{ {Column_any::string}, {Column_any::int32}, {Column_any::string}, {Column_any::double_t},
+	{Column_any::int32}, {Column_any::string}, {Column_any::int32}, {Column_any::string}, {Column_any::double_t} };
+
+class Command_any
+{
+public:
+
+	Command_any(sqlite3* handle, char const* sql, Row_any row) : m_row{ std::move(row) }
+	{
+		sqlite3_prepare_v2(handle, sql, -1, &m_stmt, NULL);
+	}
+	~Command_any() { sqlite3_finalize(m_stmt); }
+
+	void set_params(std::any params, char const* name)
+	{
+		m_params = std::move(params);
+		auto const index = sqlite3_bind_parameter_index(m_stmt, name);
+		if (auto const* text = std::any_cast<std::string>(&m_params))
+		{
+			sqlite3_bind_text(m_stmt, index, text->c_str(), -1, SQLITE_TRANSIENT);
+		}
+		else
+		{
+			sqlite3_bind_int64(m_stmt, index, std::any_cast<std::int64_t>(m_params));
+		}
+	}
+
+	std::any execute()
+	{
+		Result_any result;
+		int ret;
+		while ((ret = sqlite3_step(m_stmt)) == SQLITE_ROW)
+		{
+			auto column_index = 0;
+			Row_any row;
+			for (auto column : m_row)
+			{
+				switch (column.m_type)
+				{
+				case Column_any::string: column.m_data = std::string(reinterpret_cast<const char*>(sqlite3_column_text(m_stmt, column_index))); break;
+				case Column_any::int32: column.m_data = sqlite3_column_int(m_stmt, column_index); break;
+				case Column_any::int64: column.m_data = static_cast<std::int64_t>(sqlite3_column_int64(m_stmt, column_index)); break;
+				case Column_any::double_t: column.m_data = sqlite3_column_double(m_stmt, column_index); break;
+				}
+				row.push_back(column);
+				column_index++;
+			}
+			result.push_back(std::move(row));
+		}
+		sqlite3_reset(m_stmt);
+		sqlite3_clear_bindings(m_stmt);
+		return result;
+	}
+
+private:
+
+	sqlite3_stmt* m_stmt{ nullptr };
+	Row_any m_row;
+	std::any m_params;
+};
+
+Account_data convert_to_account_data(Row_any row)
+{
+	return Account_data{ std::get<std::string>(row[0].m_data), static_cast<std::uint16_t>(std::get<std::int32_t>(row[3].m_data)),
+		std::get<std::string>(row[1].m_data), std::get<std::string>(row[2].m_data), std::get<double>(row[4].m_data),
+		std::get<double>(row[5].m_data), std::get<std::string>(row[6].m_data) };
+}
+
+Block_data convert_to_block_data(Row_any row)
+{
+	return Block_data{ std::get<std::string>(row[0].m_data), static_cast<std::uint32_t>(std::get<std::int32_t>(row[1].m_data)),
+		std::get<std::string>(row[2].m_data), std::get<double>(row[3].m_data), std::get<std::int32_t>(row[4].m_data) ? true : false,
+		std::get<std::string>(row[5].m_data), static_cast<std::uint32_t>(std::get<std::int32_t>(row[6].m_data)),
+		std::get<std::string>(row[7].m_data), std::get<double>(row[8].m_data) };
+}
+
+// ------------------------------------------------------------------------------------
+
+double elapsed_s(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void remove_db()
+{
+	for (auto const& filename : { std::string{ db_filename }, std::string{ db_filename } + "-wal", std::string{ db_filename } + "-shm" })
+	{
+		std::remove(filename.c_str());
+	}
+}
+
+std::string account_name(std::uint32_t account)
+{
+	return "account" + std::to_string(account);
+}
+
+void fill(sqlite3* handle)
+{
+	sqlite3_exec(handle, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+	sqlite3_stmt* stmt;
+	sqlite3_prepare_v2(handle, "INSERT INTO account (name, created_at, last_active, connection_count, shares, hashrate, display_name) VALUES(?, '2021-09-19 10:20:04', '2021-09-19 10:20:04', 1, 10.0, 100.0, 'display_name')", -1, &stmt, 0);
+	for (std::uint32_t account = 0; account < accounts; ++account)
+	{
+		sqlite3_bind_text(stmt, 1, account_name(account).c_str(), -1, SQLITE_TRANSIENT);
+		sqlite3_step(stmt);
+		sqlite3_reset(stmt);
+	}
+	sqlite3_finalize(stmt);
+
+	sqlite3_prepare_v2(handle, "INSERT INTO block (hash, height, type, difficulty, orphan, block_finder, round, block_found_time, mainnet_reward) VALUES(?, ?, 'prime', 1.0, 0, ?, ?, '2021-09-19 10:20:04', 1.0)", -1, &stmt, 0);
+	for (std::uint32_t height = 1; height <= rounds * blocks_per_round; ++height)
+	{
+		sqlite3_bind_text(stmt, 1, ("hash" + std::to_string(height)).c_str(), -1, SQLITE_TRANSIENT);
+		sqlite3_bind_int(stmt, 2, height);
+		sqlite3_bind_text(stmt, 3, account_name(height % accounts).c_str(), -1, SQLITE_TRANSIENT);
+		sqlite3_bind_int(stmt, 4, 1 + (height - 1) / blocks_per_round);
+		sqlite3_step(stmt);
+		sqlite3_reset(stmt);
+	}
+	sqlite3_finalize(stmt);
+	sqlite3_exec(handle, "COMMIT;", NULL, NULL, NULL);
+}
+
+void run(char const* name, std::size_t iterations, std::function<void(std::size_t)> const& query)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		query(i);
+	}
+	std::printf("%-40s %12.0f queries/s\n", name, iterations / elapsed_s(start));
+}
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t const iterations = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 100000U;
+
+	auto logger = spdlog::stdout_color_mt("logger");
+	config::Persistance_config const config{ config::Persistance_type::sqlite, db_filename };
+	remove_db();
+	{
+		// tables of the latest schema
+		auto component = persistance::create_component(logger, config);
+		component->stop();
+	}
+
+	sqlite3* handle;
+	sqlite3_open_v2(db_filename, &handle, SQLITE_OPEN_READWRITE, NULL);
+	fill(handle);
+
+	std::vector<std::string> names;
+	for (std::uint32_t account = 0; account < accounts; ++account)
+	{
+		names.push_back(account_name(account));
+	}
+
+	{
+		Command_any get_account{ handle, get_account_sql, account_row };
+		Command_any get_blocks_from_round{ handle, get_blocks_from_round_sql, block_row };
+		Command_any get_latest_blocks{ handle, get_latest_blocks_sql, block_row };
+
+		std::printf("std::any commands, rows of std::variant columns\n");
+		run("get_account", iterations, [&](std::size_t i)
+		{
+			get_account.set_params(names[i % accounts], ":name");
+			auto result = std::any_cast<Result_any>(get_account.execute());
+			g_sink += convert_to_account_data(std::move(result.front())).m_connections;
+		});
+		run("get_blocks_from_round", iterations, [&](std::size_t i)
+		{
+			get_blocks_from_round.set_params(static_cast<std::int64_t>(1 + i % rounds), ":round");
+			auto result = std::any_cast<Result_any>(get_blocks_from_round.execute());
+			std::vector<Block_data> blocks;
+			for (auto& row : result)
+			{
+				blocks.push_back(convert_to_block_data(std::move(row)));
+			}
+			g_sink += blocks.size();
+		});
+		run("get_latest_blocks", iterations / 10, [&](std::size_t)
+		{
+			auto result = std::any_cast<Result_any>(get_latest_blocks.execute());
+			std::vector<Block_data> blocks;
+			for (auto& row : result)
+			{
+				blocks.push_back(convert_to_block_data(std::move(row)));
+			}
+			g_sink += blocks.size();
+		});
+	}
+
+	{
+		sqlite::Statement<Account_data, std::string> get_account{ logger, handle, get_account_sql };
+		sqlite::Statement<Block_data, std::int64_t> get_blocks_from_round{ logger, handle, get_blocks_from_round_sql };
+		sqlite::Statement<Block_data> get_latest_blocks{ logger, handle, get_latest_blocks_sql };
+
+		std::printf("\ntyped statements\n");
+		run("get_account", iterations, [&](std::size_t i)
+		{
+			Account_data account{};
+			get_account.get_row(account, names[i % accounts]);
+			g_sink += account.m_connections;
+		});
+		run("get_blocks_from_round", iterations, [&](std::size_t i)
+		{
+			g_sink += get_blocks_from_round.get_rows(static_cast<std::int64_t>(1 + i % rounds)).size();
+		});
+		run("get_latest_blocks", iterations / 10, [&](std::size_t)
+		{
+			g_sink += get_latest_blocks.get_rows().size();
+		});
+	}
+
+	sqlite3_close(handle);
+	remove_db();
+	std::printf("sink %llu\n", static_cast<unsigned long long>(g_sink & 1U));
+	return 0;
+}
@@ -66,6 +66,43 @@ public:
 		delete_from_table("config", "id", config_id);
 	}
 
+	// details of all steps of the query plan
+	std::string get_query_plan(std::string const& query)
+	{
+		std::string plan;
+		sqlite3_stmt* stmt;
+		sqlite3_prepare_v2(m_handle, ("EXPLAIN QUERY PLAN " + query).c_str(), -1, &stmt, 0);
+		while (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			plan += std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3))) + "; ";
+		}
+		sqlite3_finalize(stmt);
+		return plan;
+	}
+
+	int get_schema_version()
+	{
+		return get_schema_version(m_handle);
+	}
+
+	static int get_schema_version(sqlite3* handle)
+	{
+		int version{ 0 };
+		sqlite3_stmt* stmt;
+		sqlite3_prepare_v2(handle, "PRAGMA user_version;", -1, &stmt, 0);
+		if (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			version = sqlite3_column_int(stmt, 0);
+		}
+		sqlite3_finalize(stmt);
+		return version;
+	}
+
+	void set_schema_version(int version)
+	{
+		sqlite3_exec(m_handle, ("PRAGMA user_version = " + std::to_string(version) + ";").c_str(), NULL, NULL, NULL);
+	}
+
 	std::string m_db_filename{ "test.sqlite3" };
 	std::vector<std::string> const m_invalid_input{ "", "asfagsgdsdfg", "123415234" };
 	std::vector<std::string> m_valid_account_names_input{};
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "common/bounded_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ::nexuspool;
+
+TEST(Bounded_queue_test, try_push_full_queue)
+{
+	common::Bounded_queue<int> queue{ 2U };
+	EXPECT_TRUE(queue.try_push(1));
+	EXPECT_TRUE(queue.try_push(2));
+	EXPECT_FALSE(queue.try_push(3));
+	EXPECT_EQ(queue.size(), 2U);
+
+	int element{ 0 };
+	EXPECT_TRUE(queue.pop(element));
+	EXPECT_EQ(element, 1);
+	EXPECT_TRUE(queue.try_push(3));
+}
+
+TEST(Bounded_queue_test, batch_pop)
+{
+	common::Bounded_queue<int> queue{ 10U };
+	for (int i = 0; i < 5; ++i)
+	{
+		ASSERT_TRUE(queue.try_push(int{ i }));
+	}
+
+	std::vector<int> elements{ 42 };
+	EXPECT_EQ(queue.pop(elements, 3U), 3U);
+	EXPECT_EQ(elements, (std::vector<int>{ 0, 1, 2 }));
+	EXPECT_EQ(queue.pop(elements, 3U), 2U);
+	EXPECT_EQ(elements, (std::vector<int>{ 3, 4 }));
+	EXPECT_EQ(queue.size(), 0U);
+}
+
+TEST(Bounded_queue_test, closed_queue_is_drained)
+{
+	common::Bounded_queue<int> queue{ 10U };
+	ASSERT_TRUE(queue.try_push(1));
+	ASSERT_TRUE(queue.try_push(2));
+	queue.close();
+
+	// no new elements, the queued ones are still handed out
+	EXPECT_FALSE(queue.try_push(3));
+	EXPECT_FALSE(queue.push(3));
+	std::vector<int> elements;
+	EXPECT_EQ(queue.pop(elements, 10U), 2U);
+	EXPECT_EQ(queue.pop(elements, 10U), 0U);
+	int element{ 0 };
+	EXPECT_FALSE(queue.pop(element));
+}
+
+TEST(Bounded_queue_test, push_waits_for_free_space)
+{
+	common::Bounded_queue<int> queue{ 1U };
+	ASSERT_TRUE(queue.try_push(1));
+
+	std::atomic_bool pushed{ false };
+	std::thread producer([&queue, &pushed]()
+	{
+		pushed = queue.push(2);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_FALSE(pushed);
+
+	int element{ 0 };
+	EXPECT_TRUE(queue.pop(element));
+	producer.join();
+	EXPECT_TRUE(pushed);
+	EXPECT_TRUE(queue.pop(element));
+	EXPECT_EQ(element, 2);
+}
+
+TEST(Bounded_queue_test, close_wakes_consumers)
+{
+	common::Bounded_queue<int> queue{ 1U };
+	std::vector<std::thread> consumers;
+	std::atomic<int> finished{ 0 };
+	for (int i = 0; i < 2; ++i)
+	{
+		consumers.emplace_back([&queue, &finished]()
+		{
+			std::vector<int> elements;
+			if (queue.pop(elements, 4U) == 0U)
+			{
+				finished++;
+			}
+		});
+	}
+
+	queue.close();
+	for (auto& consumer : consumers)
+	{
+		consumer.join();
+	}
+	EXPECT_EQ(finished, 2);
+}
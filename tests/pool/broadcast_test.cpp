@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "pool/broadcast.hpp"
+#include "LLP/packet.hpp"
+#include "LLP/pool_protocol.hpp"
+#include <nlohmann/json.hpp>
+#include <limits>
+#include <vector>
+
+using namespace ::nexuspool;
+
+namespace
+{
+LLP::CBlock create_block()
+{
+	LLP::CBlock block;
+	block.nVersion = 8U;
+	block.nChannel = 2U;
+	block.nHeight = 4000000U;
+	block.nBits = 0x7b00d8e5;
+	block.nNonce = 0xFFFFFFFFFFFFFFFFULL;
+	block.hashPrevBlock.SetHex("9a1f3c5e7b2d4f6081a3c5e7092b4d6f8a1c3e5f7b9d0f2a4c6e8a0b2d4f6a8c");
+	block.hashMerkleRoot.SetHex("0123456789abcdef00ff10ef20df30cf40bf50af609f708f807f906fa05fb04f");
+	return block;
+}
+
+// reference: the per miner json dump of the WORK packet
+network::Payload create_expected_packet(LLP::CBlock block, Session_job const& job)
+{
+	block.nNonce = job.m_nonce_range.m_start;
+	auto block_data = nexuspool::uint2bytes(job.m_pool_nbits);
+	auto const block_bytes = block.serialize();
+	block_data.insert(block_data.end(), block_bytes.begin(), block_bytes.end());
+
+	nlohmann::json j;
+	j["work_id"] = job.m_work_id;
+	j["block"] = nlohmann::json::binary(block_data);
+	j["nonce_start"] = job.m_nonce_range.m_start;
+	j["nonce_end"] = job.m_nonce_range.m_end;
+	auto const j_string = j.dump();
+
+	Packet packet{ Packet::WORK, network::Payload{ j_string.begin(), j_string.end() } };
+	return *packet.get_bytes();
+}
+
+network::Payload join(network::Payload_sequence const& payload_sequence)
+{
+	network::Payload packet;
+	for (auto const& payload : payload_sequence)
+	{
+		packet.insert(packet.end(), payload->begin(), payload->end());
+	}
+	return packet;
+}
+}
+
+TEST(Work_message_test, json_identical_to_dump)
+{
+	auto const block = create_block();
+	Work_message work_message{ block, 0x7c00d8e5 };
+
+	std::vector<Session_job> jobs(5U);
+	jobs[0].m_work_id = 1U;
+	jobs[0].m_pool_nbits = 0x7c00d8e5;
+	jobs[0].m_nonce_range = Nonce_range{ 0U, 1ULL << 40 };
+	// edge values -> longest numbers
+	jobs[1].m_work_id = std::numeric_limits<std::uint32_t>::max();
+	jobs[1].m_pool_nbits = std::numeric_limits<std::uint32_t>::max();
+	jobs[1].m_nonce_range = Nonce_range{ std::numeric_limits<std::uint64_t>::max() - 1, std::numeric_limits<std::uint64_t>::max() };
+	// shortest numbers
+	jobs[2].m_work_id = 0U;
+	jobs[2].m_pool_nbits = 0U;
+	jobs[2].m_nonce_range = Nonce_range{ 0U, 0U };
+	// single and two digit bytes
+	jobs[3].m_work_id = 10U;
+	jobs[3].m_pool_nbits = 0x0a09630b;
+	jobs[3].m_nonce_range = Nonce_range{ 0x0a090807640063ffULL, 0x0a090807640063ffULL + 1 };
+	// legacy miners without a nonce range
+	jobs[4].m_work_id = 99999U;
+	jobs[4].m_pool_nbits = 0x7c00d8e5;
+
+	for (auto const& job : jobs)
+	{
+		EXPECT_EQ(join(work_message.get_payload(job, 2U)), create_expected_packet(block, job)) << "work_id " << job.m_work_id;
+	}
+}
+
+TEST(Work_message_test, json_parsed_by_miner)
+{
+	auto const block = create_block();
+	Work_message work_message{ block, 0x7c00d8e5 };
+	Session_job job;
+	job.m_work_id = std::numeric_limits<std::uint32_t>::max();
+	job.m_pool_nbits = 0x7d00d8e5;
+	job.m_nonce_range = Nonce_range{ 1ULL << 63, std::numeric_limits<std::uint64_t>::max() };
+
+	Packet packet{ std::make_shared<network::Payload>(join(work_message.get_payload(job, 2U))) };
+	ASSERT_TRUE(packet.is_valid());
+	EXPECT_EQ(packet.m_header, Packet::WORK);
+	EXPECT_EQ(packet.m_length, packet.m_data->size());
+
+	auto const j = nlohmann::json::parse(packet.m_data->begin(), packet.m_data->end());
+	EXPECT_EQ(j.at("work_id").get<std::uint32_t>(), job.m_work_id);
+	EXPECT_EQ(j.at("nonce_start").get<std::uint64_t>(), job.m_nonce_range.m_start);
+	EXPECT_EQ(j.at("nonce_end").get<std::uint64_t>(), job.m_nonce_range.m_end);
+	auto const block_data = j.at("block").at("bytes").get<std::vector<std::uint8_t>>();
+	ASSERT_EQ(block_data.size(), 4U + create_block().serialize().size());
+	EXPECT_EQ(nexuspool::bytes2uint(block_data, 0U), job.m_pool_nbits);
+	EXPECT_EQ(nexuspool::bytes2uint64(block_data, block_data.size() - 8U), job.m_nonce_range.m_start);
+}
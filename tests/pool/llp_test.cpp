@@ -4,6 +4,8 @@
 #include "LLP/packet.hpp"
 #include "LLP/block.hpp"
 #include "LLP/utils.hpp"
+#include "LLP/pool_protocol.hpp"
+#include "LLP/packet_buffer.hpp"
 
 using namespace ::nexuspool;
 using namespace ::testing;
@@ -119,3 +121,156 @@ TEST(LLP_test, extract_block_height_data_packet_from_valid_data_buffer_test)
 	EXPECT_EQ(remaining_size, 0);
 
 }
+
+TEST(LLP_test, pool_protocol_v3_work_test)
+{
+	pool_protocol_v3::Work work_input;
+	work_input.m_work_id = 7U;
+	work_input.m_pool_nbits = 0x7c00ffffU;
+	work_input.m_nonce_start = 1ULL << 44;
+	work_input.m_nonce_end = 2ULL << 44;
+	work_input.m_block.nVersion = 4U;
+	work_input.m_block.nChannel = 2U;
+	work_input.m_block.nHeight = 4873493U;
+	work_input.m_block.nBits = 0x7b0fffffU;
+	work_input.m_block.nNonce = 1234567890123ULL;
+	work_input.m_block.hashMerkleRoot = 987654321U;
+
+	auto const data = pool_protocol_v3::encode_work(work_input);
+	EXPECT_EQ(data.size(), pool_protocol_v3::work_size);
+
+	pool_protocol_v3::Work work;
+	EXPECT_TRUE(pool_protocol_v3::decode_work(data, work));
+	EXPECT_EQ(work.m_work_id, work_input.m_work_id);
+	EXPECT_EQ(work.m_pool_nbits, work_input.m_pool_nbits);
+	EXPECT_EQ(work.m_nonce_start, work_input.m_nonce_start);
+	EXPECT_EQ(work.m_nonce_end, work_input.m_nonce_end);
+	EXPECT_EQ(work.m_block.nHeight, work_input.m_block.nHeight);
+	EXPECT_EQ(work.m_block.nBits, work_input.m_block.nBits);
+	EXPECT_EQ(work.m_block.nNonce, work_input.m_block.nNonce);
+	EXPECT_EQ(work.m_block.hashMerkleRoot, work_input.m_block.hashMerkleRoot);
+
+	// wrong size
+	EXPECT_FALSE(pool_protocol_v3::decode_work(network::Payload(data.begin(), data.end() - 1), work));
+}
+
+TEST(LLP_test, pool_protocol_v3_submit_block_test)
+{
+	pool_protocol_v3::Submit_block submit_block_input;
+	submit_block_input.m_work_id = 7U;
+	submit_block_input.m_nonce = 0xfedcba9876543210ULL;
+
+	auto data = pool_protocol_v3::encode_submit_block(submit_block_input);
+	EXPECT_EQ(data.size(), pool_protocol_v3::submit_block_min_size);
+
+	pool_protocol_v3::Submit_block submit_block;
+	EXPECT_TRUE(pool_protocol_v3::decode_submit_block(data, submit_block));
+	EXPECT_EQ(submit_block.m_work_id, submit_block_input.m_work_id);
+	EXPECT_EQ(submit_block.m_nonce, submit_block_input.m_nonce);
+	EXPECT_FALSE(submit_block.m_has_merkle_root);
+	EXPECT_TRUE(submit_block.m_offsets.empty());
+
+	// with merkle_root and offsets
+	submit_block_input.m_has_merkle_root = true;
+	submit_block_input.m_merkle_root = 123456789U;
+	submit_block_input.m_offsets = { 0, 4, 6, 10, 12 };
+	data = pool_protocol_v3::encode_submit_block(submit_block_input);
+	EXPECT_TRUE(pool_protocol_v3::decode_submit_block(data, submit_block));
+	EXPECT_TRUE(submit_block.m_has_merkle_root);
+	EXPECT_EQ(submit_block.m_merkle_root, submit_block_input.m_merkle_root);
+	EXPECT_EQ(submit_block.m_offsets, submit_block_input.m_offsets);
+
+	// truncated data
+	EXPECT_FALSE(pool_protocol_v3::decode_submit_block(network::Payload(data.begin(), data.end() - 1), submit_block));
+}
+
+TEST(LLP_test, packet_buffer_split_packet_test)
+{
+	network::Payload const data{ 1, 2, 3, 4, 5, 6, 7, 8 };
+	auto const input = create_packet(Packet::BLOCK_DATA, data).get_bytes();
+
+	Packet_buffer packet_buffer;
+	Packet_view packet;
+	// header and length only
+	EXPECT_TRUE(packet_buffer.append(input->data(), 5));
+	EXPECT_FALSE(packet_buffer.next_packet(packet));
+	EXPECT_EQ(packet_buffer.get_pending_size(), 5U);
+
+	EXPECT_TRUE(packet_buffer.append(input->data() + 5, input->size() - 5));
+	EXPECT_TRUE(packet_buffer.next_packet(packet));
+	EXPECT_TRUE(packet.is_valid());
+	EXPECT_EQ(packet.m_header, Packet::BLOCK_DATA);
+	EXPECT_EQ(packet.m_length, data.size());
+	EXPECT_EQ(packet.m_data.to_payload(), data);
+	EXPECT_FALSE(packet_buffer.next_packet(packet));
+	EXPECT_EQ(packet_buffer.get_pending_size(), 0U);
+}
+
+TEST(LLP_test, packet_buffer_multiple_packets_test)
+{
+	network::Payload const data{ 1, 2, 3 };
+	auto const first = create_packet(Packet::BLOCK_DATA, data).get_bytes();
+	Packet request;
+	auto const second = request.get_packet(Packet::GET_BLOCK).get_bytes();
+	auto const third = create_packet(Packet::BLOCK_HEIGHT, data).get_bytes();
+
+	network::Payload input{ first->begin(), first->end() };
+	input.insert(input.end(), second->begin(), second->end());
+	input.insert(input.end(), third->begin(), third->end());
+	// only the first byte of the next packet
+	input.push_back(Packet::BLOCK_DATA);
+
+	Packet_buffer packet_buffer;
+	EXPECT_TRUE(packet_buffer.append(input));
+
+	Packet_view packet;
+	EXPECT_TRUE(packet_buffer.next_packet(packet));
+	EXPECT_EQ(packet.m_header, Packet::BLOCK_DATA);
+	EXPECT_EQ(packet.m_data.to_payload(), data);
+
+	EXPECT_TRUE(packet_buffer.next_packet(packet));
+	EXPECT_EQ(packet.m_header, Packet::GET_BLOCK);
+	EXPECT_EQ(packet.m_length, 0U);
+	EXPECT_TRUE(packet.m_data.empty());
+
+	EXPECT_TRUE(packet_buffer.next_packet(packet));
+	EXPECT_EQ(packet.m_header, Packet::BLOCK_HEIGHT);
+	// keep the view while more data arrives
+	EXPECT_EQ(packet_buffer.get_pending_size(), 1U);
+	EXPECT_TRUE(packet_buffer.append(input));
+	EXPECT_EQ(packet.m_data.to_payload(), data);
+
+	EXPECT_EQ(packet_buffer.get_pending_size(), input.size() + 1U);
+	packet_buffer.clear();
+	EXPECT_EQ(packet_buffer.get_pending_size(), 0U);
+}
+
+TEST(LLP_test, packet_buffer_max_size_test)
+{
+	Packet_buffer packet_buffer{ 8U };
+	network::Payload const data(6U, 0);
+
+	EXPECT_TRUE(packet_buffer.append(data));
+	EXPECT_FALSE(packet_buffer.append(data));
+	EXPECT_EQ(packet_buffer.get_pending_size(), data.size());
+}
+
+TEST(LLP_test, packet_payload_sequence_test)
+{
+	auto packet = create_packet(Packet::BLOCK_DATA, network::Payload{ 1, 2, 3, 4 });
+	auto const sequence = packet.get_payload_sequence();
+	ASSERT_EQ(sequence.size(), 2U);
+	// data is not copied
+	EXPECT_EQ(sequence[1], packet.m_data);
+
+	network::Payload bytes;
+	for (auto const& payload : sequence)
+	{
+		bytes.insert(bytes.end(), payload->begin(), payload->end());
+	}
+	EXPECT_EQ(bytes, *packet.get_bytes());
+
+	Packet request;
+	request = request.get_packet(Packet::GET_BLOCK);
+	EXPECT_EQ(request.get_payload_sequence().size(), 1U);
+}
@@ -6,7 +6,9 @@
 #include "network/connection_mock.hpp"
 #include "pool/pool_manager_mock.hpp"
 #include "pool/session_mock.hpp"
-#include "LLC/random.h"
+#include "LLP/packet.hpp"
+#include "LLP/pool_protocol.hpp"
+#include <nlohmann/json.hpp>
 
 using namespace ::nexuspool;
 using namespace ::testing;
@@ -23,7 +25,7 @@ public:
 		m_pool_manager = std::make_shared<NiceMock<Pool_manager_mock>>();
 		m_session_registry = std::make_shared<NiceMock<Session_registry_mock>>();
 
-		m_miner_connection = create_miner_connection(m_logger, m_connection, m_pool_manager, LLC::GetRand256(), m_session_registry);
+		m_miner_connection = create_miner_connection(m_logger, m_connection, m_pool_manager, Session_key{ 1U }, m_session_registry);
 	}
 
 protected:
@@ -34,6 +36,21 @@ protected:
 	std::shared_ptr<Session_registry_mock> m_session_registry;
 	std::shared_ptr<Miner_connection> m_miner_connection;
 
+	void receive(std::uint8_t header, nlohmann::json const& data)
+	{
+		auto const data_string = data.dump();
+		Packet packet{ header, network::Payload{ data_string.begin(), data_string.end() } };
+		m_miner_connection->connection_handler()(network::Result::receive_ok, packet.get_bytes());
+	}
+
+	void login(std::uint32_t protocol_version)
+	{
+		nlohmann::json login;
+		login["username"] = "8BJhfDBEhs73RYmUeM6YRvamRHWP6zYXyUnuGfwMvWVfXdLcQRb";
+		login["display_name"] = "miner";
+		login["protocol_version"] = protocol_version;
+		receive(Packet::LOGIN, login);
+	}
 
 	void TearDown() override
 	{
@@ -45,4 +62,62 @@ TEST_F(Miner_connection_fixture, stop_test)
 {
 	EXPECT_CALL(*m_connection, close()).Times(1);
 	m_miner_connection->stop();
-}
\ No newline at end of file
+}
+
+TEST_F(Miner_connection_fixture, no_transmit_after_connection_closed_test)
+{
+	EXPECT_CALL(*m_connection, transmit(An<network::Shared_payload>())).Times(1);
+	m_miner_connection->get_hashrate();
+
+	// the connection is kept after close, other threads only check the closed state
+	m_miner_connection->connection_handler()(network::Result::connection_closed, nullptr);
+	m_miner_connection->get_hashrate();
+}
+
+TEST_F(Miner_connection_fixture, login_json_miner_without_version_warning_test)
+{
+	auto session = std::make_shared<NiceMock<Session_mock>>();
+	ON_CALL(*m_session_registry, get_session(_)).WillByDefault(Return(session));
+	ON_CALL(*m_session_registry, valid_nxs_address(_)).WillByDefault(Return(true));
+	ON_CALL(*m_session_registry, does_account_exists(_)).WillByDefault(Return(true));
+
+	network::Payload_sequence login_response;
+	EXPECT_CALL(*m_connection, transmit(An<network::Payload_sequence>())).WillOnce(SaveArg<0>(&login_response));
+
+	login(POOL_PROTOCOL_VERSION_JSON);
+
+	ASSERT_EQ(login_response.size(), 2U);
+	EXPECT_EQ(login_response[0]->front(), Packet::LOGIN_V2_SUCCESS);
+	auto const response = nlohmann::json::parse(login_response[1]->begin(), login_response[1]->end());
+	EXPECT_EQ(response.at("result_code").get<Pool_protocol_result>(), Pool_protocol_result::Success);
+	EXPECT_EQ(response.at("protocol_version").get<int>(), POOL_PROTOCOL_VERSION);
+}
+
+TEST_F(Miner_connection_fixture, json_miner_nonce_outside_range_rejected_test)
+{
+	auto session = std::make_shared<NiceMock<Session_mock>>();
+	Session_user logged_in_user;
+	logged_in_user.m_logged_in = true;
+	EXPECT_CALL(*session, get_user_data()).WillOnce(Return(Session_user{})).WillRepeatedly(Return(logged_in_user));
+	ON_CALL(*m_session_registry, get_session(_)).WillByDefault(Return(session));
+	ON_CALL(*m_session_registry, valid_nxs_address(_)).WillByDefault(Return(true));
+	login(POOL_PROTOCOL_VERSION_JSON);
+
+	Session_job job;
+	job.m_work_id = 5U;
+	job.m_block = std::make_shared<LLP::CBlock const>();
+	job.m_nonce_range = Nonce_range{ 1000U, 2000U };
+	ON_CALL(*session, get_job(5U, _)).WillByDefault(DoAll(SetArgReferee<1>(job), Return(true)));
+
+	// the json WORK message told the miner its nonce range
+	network::Payload_sequence response;
+	EXPECT_CALL(*m_connection, transmit(An<network::Payload_sequence>())).WillOnce(SaveArg<0>(&response));
+	EXPECT_CALL(*m_pool_manager, submit_block(_, _, _, _, _, _)).Times(0);
+	receive(Packet::SUBMIT_BLOCK, nlohmann::json{ { "work_id", 5U }, { "nonce", 2000U } });
+	ASSERT_FALSE(response.empty());
+	EXPECT_EQ(response[0]->front(), Packet::REJECT);
+	Mock::VerifyAndClearExpectations(m_pool_manager.get());
+
+	EXPECT_CALL(*m_pool_manager, submit_block(_, _, _, _, _, _)).Times(1);
+	receive(Packet::SUBMIT_BLOCK, nlohmann::json{ { "work_id", 5U }, { "nonce", 1999U } });
+}
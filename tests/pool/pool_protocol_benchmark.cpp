@@ -0,0 +1,102 @@
+// Microbenchmark: WORK / SUBMIT_BLOCK encoding of pool protocol v2 (json) against v3 (binary)
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include "LLP/block.hpp"
+#include "LLP/packet.hpp"
+#include "LLP/pool_protocol.hpp"
+#include "LLP/utils.hpp"
+
+using namespace ::nexuspool;
+
+namespace
+{
+constexpr std::size_t iterations{ 100000U };
+
+std::uint64_t g_sink{ 0U };		// keeps the compiler from optimising the benchmark away
+
+void run(char const* name, std::function<void(std::size_t)> const& function)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		function(i);
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-32s %10.1f ns/op\n", name, duration / iterations);
+}
+
+LLP::CBlock create_block()
+{
+	LLP::CBlock block;
+	block.nVersion = 4U;
+	block.nChannel = 2U;
+	block.nHeight = 4873493U;
+	block.nBits = 0x7b0fffffU;
+	block.hashPrevBlock = 0xabcdef0123456789ULL;
+	block.hashMerkleRoot = 0x0123456789abcdefULL;
+	return block;
+}
+}
+
+int main()
+{
+	auto const block = create_block();
+	std::uint32_t const pool_nbits{ 0x7c00ffffU };
+
+	// WORK encode
+	run("work v2 (json) encode", [&block, pool_nbits](std::size_t i)
+	{
+		auto block_data = block.serialize();
+		auto const pool_nbits_bytes = uint2bytes(pool_nbits);
+		block_data.insert(block_data.begin(), pool_nbits_bytes.begin(), pool_nbits_bytes.end());
+		nlohmann::json j;
+		j["work_id"] = 1;
+		j["block"] = nlohmann::json::binary(block_data);
+		j["nonce_start"] = i;
+		j["nonce_end"] = i + 1;
+		auto const j_string = j.dump();
+		Packet packet{ Packet::WORK, network::Payload{ j_string.begin(), j_string.end() } };
+		g_sink += packet.get_bytes()->size();
+	});
+
+	run("work v3 (binary) encode", [&block, pool_nbits](std::size_t i)
+	{
+		pool_protocol_v3::Work work;
+		work.m_work_id = 1;
+		work.m_pool_nbits = pool_nbits;
+		work.m_nonce_start = i;
+		work.m_nonce_end = i + 1;
+		work.m_block = block;
+		Packet packet{ Packet::WORK, pool_protocol_v3::encode_work(work) };
+		g_sink += packet.get_bytes()->size();
+	});
+
+	// SUBMIT_BLOCK decode
+	nlohmann::json j;
+	j["work_id"] = 1;
+	j["nonce"] = 0xfedcba9876543210ULL;
+	auto const j_string = j.dump();
+	network::Payload const submit_block_v2{ j_string.begin(), j_string.end() };
+	run("submit_block v2 (json) decode", [&submit_block_v2](std::size_t)
+	{
+		auto const j = nlohmann::json::parse(submit_block_v2.begin(), submit_block_v2.end());
+		std::uint64_t const nonce = j.at("nonce");
+		g_sink += nonce;
+	});
+
+	pool_protocol_v3::Submit_block submit_block;
+	submit_block.m_work_id = 1;
+	submit_block.m_nonce = 0xfedcba9876543210ULL;
+	auto const submit_block_v3 = pool_protocol_v3::encode_submit_block(submit_block);
+	run("submit_block v3 (binary) decode", [&submit_block_v3](std::size_t)
+	{
+		pool_protocol_v3::Submit_block result;
+		pool_protocol_v3::decode_submit_block(submit_block_v3, result);
+		g_sink += result.m_nonce;
+	});
+
+	std::printf("(%llu)\n", static_cast<unsigned long long>(g_sink));
+	return 0;
+}
@@ -0,0 +1,371 @@
+#include <gtest/gtest.h>
+#include "pool/session_impl.hpp"
+#include "persistance/data_reader_mock.hpp"
+#include "persistance/data_writer_mock.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ::nexuspool;
+using namespace ::testing;
+
+namespace
+{
+std::uint32_t const network_nbits{ 0x7b00d8e5 };
+std::uint32_t const pool_nbits{ 0x7c00d8e5 };		// 256 times easier than the network difficulty
+}
+
+class Session_fixture : public ::testing::Test
+{
+public:
+
+	Session_fixture()
+	{
+		m_data_writer = std::make_shared<NiceMock<persistance::Shared_data_writer_mock>>();
+		m_share_ledger = std::make_shared<Share_ledger>(m_data_writer);
+		m_work_queue = std::make_shared<Session_work_queue>();
+	}
+
+protected:
+
+	// one share per minute -> a share window of quick shares retargets to a harder difficulty
+	std::shared_ptr<Session_impl> create_session(std::uint32_t vardiff_shares_per_minute = 1U, Session_key key = 1U)
+	{
+		return std::make_shared<Session_impl>(key, m_work_queue, m_data_writer,
+			std::make_shared<Shared_data_reader>(std::make_unique<NiceMock<persistance::Data_reader_mock>>()),
+			m_share_ledger, common::Mining_mode::HASH, false, vardiff_shares_per_minute, [this]() { return m_time; });
+	}
+
+	std::unique_ptr<Session_registry_impl> create_session_registry(std::uint32_t session_expiry_time = 300U)
+	{
+		return std::make_unique<Session_registry_impl>(std::make_unique<NiceMock<persistance::Data_reader_mock>>(),
+			m_data_writer, m_share_ledger, nullptr, session_expiry_time, common::Mining_mode::HASH, false, 0U);
+	}
+
+	static std::shared_ptr<LLP::CBlock const> create_block(std::uint32_t height)
+	{
+		auto block = std::make_shared<LLP::CBlock>();
+		block->nChannel = 2;
+		block->nHeight = height;
+		block->nBits = network_nbits;
+		return block;
+	}
+
+	std::chrono::steady_clock::time_point m_time{ std::chrono::steady_clock::now() };	// share times of the sessions
+	std::shared_ptr<persistance::Shared_data_writer_mock> m_data_writer;
+	Share_ledger::Sptr m_share_ledger;
+	Session_work_queue::Sptr m_work_queue;
+};
+
+TEST_F(Session_fixture, share_credited_with_weight_of_its_job)
+{
+	auto session = create_session();
+
+	auto const first_nbits = session->retarget_difficulty(pool_nbits, network_nbits);
+	EXPECT_EQ(first_nbits, pool_nbits);
+	auto const first_work_id = session->add_job(create_block(1U), Nonce_range{}, first_nbits);
+
+	// complete a share window far below the target share time -> next retarget doubles the difficulty
+	for (auto i = 0; i < 5; ++i)
+	{
+		m_time += std::chrono::milliseconds(2);
+		session->add_share(1.0);
+	}
+	auto const second_nbits = session->retarget_difficulty(pool_nbits, network_nbits);
+	EXPECT_NE(second_nbits, pool_nbits);
+	auto const second_work_id = session->add_job(create_block(1U), Nonce_range{}, second_nbits);
+
+	Session_job first_job, second_job;
+	ASSERT_TRUE(session->get_job(first_work_id, first_job));
+	ASSERT_TRUE(session->get_job(second_work_id, second_job));
+	EXPECT_EQ(first_job.m_pool_nbits, first_nbits);
+	EXPECT_DOUBLE_EQ(first_job.m_share_weight, 1.0);
+	EXPECT_EQ(second_job.m_pool_nbits, second_nbits);
+	EXPECT_DOUBLE_EQ(second_job.m_share_weight, 2.0);
+
+	// share on the older job is still valid but only worth the difficulty it was issued with
+	auto const shares_before = session->get_user_data().m_account.m_shares;
+	EXPECT_TRUE(session->add_share(first_job.m_share_weight));
+	EXPECT_DOUBLE_EQ(session->get_user_data().m_account.m_shares, shares_before + 1.0);
+	EXPECT_TRUE(session->add_share(second_job.m_share_weight));
+	EXPECT_DOUBLE_EQ(session->get_user_data().m_account.m_shares, shares_before + 3.0);
+}
+
+TEST_F(Session_fixture, session_table_insert_find_erase)
+{
+	Session_table table;
+	EXPECT_FALSE(table.insert(0U, create_session()));		// 0 marks an empty slot
+
+	// enough sessions to grow the table several times
+	std::vector<std::shared_ptr<Session_impl>> sessions;
+	for (Session_key key = 1U; key <= 200U; ++key)
+	{
+		sessions.push_back(create_session(0U, key));
+		ASSERT_TRUE(table.insert(key, sessions.back()));
+	}
+	EXPECT_FALSE(table.insert(100U, create_session(0U, 100U)));
+	EXPECT_EQ(table.size(), 200U);
+	EXPECT_EQ(table.find(100U), sessions[99]);
+	EXPECT_EQ(table.find(201U), nullptr);
+
+	// the backward shift keeps the probe sequences of the remaining sessions intact
+	for (Session_key key = 2U; key <= 200U; key += 2)
+	{
+		ASSERT_TRUE(table.erase(key));
+	}
+	EXPECT_FALSE(table.erase(2U));
+	EXPECT_EQ(table.size(), 100U);
+	for (Session_key key = 1U; key <= 200U; ++key)
+	{
+		EXPECT_EQ(table.find(key), key % 2 == 1 ? sessions[key - 1] : nullptr);
+	}
+
+	std::size_t visited{ 0U };
+	table.for_each([&visited](Session_key key, std::shared_ptr<Session> const& session)
+	{
+		EXPECT_EQ(key % 2, 1U);
+		EXPECT_NE(session, nullptr);
+		visited++;
+	});
+	EXPECT_EQ(visited, 100U);
+
+	table.clear();
+	EXPECT_EQ(table.size(), 0U);
+	EXPECT_EQ(table.find(1U), nullptr);
+}
+
+TEST_F(Session_fixture, registry_add_lookup_remove_across_shards)
+{
+	auto session_registry = create_session_registry(60U);
+
+	// sequential keys -> every shard holds sessions
+	std::vector<Session_key> keys;
+	for (auto i = 0; i < 100; ++i)
+	{
+		keys.push_back(session_registry->create_session());
+	}
+	EXPECT_EQ(session_registry->get_sessions_size(), 100U);
+	for (auto const key : keys)
+	{
+		EXPECT_NE(session_registry->get_session(key), nullptr);
+	}
+	EXPECT_EQ(session_registry->get_session(0U), nullptr);
+	EXPECT_EQ(session_registry->get_session(keys.back() + 1), nullptr);
+
+	// expire every second session
+	auto const expired_time = std::chrono::steady_clock::now() - std::chrono::minutes(5);
+	for (std::size_t i = 0; i < keys.size(); i += 2)
+	{
+		session_registry->get_session(keys[i])->set_update_time(expired_time);
+	}
+	session_registry->clear_unused_sessions();
+	EXPECT_EQ(session_registry->get_sessions_size(), 50U);
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		EXPECT_EQ(session_registry->get_session(keys[i]) == nullptr, i % 2 == 0);
+	}
+
+	session_registry->stop();
+	EXPECT_EQ(session_registry->get_sessions_size(), 0U);
+	EXPECT_EQ(session_registry->get_session(keys[1]), nullptr);
+}
+
+TEST_F(Session_fixture, registry_concurrent_iteration)
+{
+	auto session_registry = create_session_registry();
+
+	std::atomic_bool creating{ true };
+	std::thread maintenance([&session_registry, &creating]()
+	{
+		while (creating)
+		{
+			session_registry->reset_work_status_of_sessions();
+			session_registry->end_round();
+			session_registry->clear_unused_sessions();
+			session_registry->get_hashrate();
+		}
+	});
+
+	std::vector<std::thread> creators;
+	std::vector<std::vector<Session_key>> keys(4U);
+	for (auto& creator_keys : keys)
+	{
+		creators.emplace_back([&session_registry, &creator_keys]()
+		{
+			for (auto i = 0; i < 250; ++i)
+			{
+				creator_keys.push_back(session_registry->create_session());
+			}
+		});
+	}
+	for (auto& creator : creators)
+	{
+		creator.join();
+	}
+	creating = false;
+	maintenance.join();
+
+	EXPECT_EQ(session_registry->get_sessions_size(), 1000U);
+	for (auto const& creator_keys : keys)
+	{
+		for (auto const key : creator_keys)
+		{
+			EXPECT_NE(session_registry->get_session(key), nullptr);
+		}
+	}
+}
+
+TEST_F(Session_fixture, work_queue_ordering)
+{
+	Session_work_queue work_queue;
+	Session_key key{ 0U };
+	EXPECT_FALSE(work_queue.pop(key));
+	work_queue.push(3U);
+	work_queue.push(1U);
+	work_queue.push(2U);
+	for (auto const expected_key : { 3U, 1U, 2U })
+	{
+		ASSERT_TRUE(work_queue.pop(key));
+		EXPECT_EQ(key, expected_key);
+	}
+	EXPECT_FALSE(work_queue.pop(key));
+
+	work_queue.push(4U);
+	work_queue.clear();
+	EXPECT_FALSE(work_queue.pop(key));
+}
+
+TEST_F(Session_fixture, registry_hands_out_work_in_request_order)
+{
+	auto session_registry = create_session_registry(60U);
+	std::vector<std::shared_ptr<Session>> sessions;
+	for (auto i = 0; i < 3; ++i)
+	{
+		sessions.push_back(session_registry->get_session(session_registry->create_session()));
+	}
+
+	// new sessions need work in the order they have been created
+	for (auto const& session : sessions)
+	{
+		EXPECT_EQ(session_registry->get_session_with_no_work(), session);
+		EXPECT_FALSE(session->is_need_work());
+	}
+	EXPECT_EQ(session_registry->get_session_with_no_work(), nullptr);
+
+	// a session is queued only once, however often it asks for work
+	sessions[2]->needs_work(true);
+	sessions[2]->needs_work(true);
+	sessions[0]->needs_work(true);
+	EXPECT_EQ(session_registry->get_session_with_no_work(), sessions[2]);
+	EXPECT_EQ(session_registry->get_session_with_no_work(), sessions[0]);
+	EXPECT_EQ(session_registry->get_session_with_no_work(), nullptr);
+
+	// sessions which got work in the meantime or have been removed are skipped
+	sessions[0]->needs_work(true);
+	sessions[1]->needs_work(true);
+	sessions[2]->needs_work(true);
+	sessions[0]->needs_work(false);
+	sessions[1]->set_update_time(std::chrono::steady_clock::now() - std::chrono::minutes(5));
+	session_registry->clear_unused_sessions();
+	EXPECT_EQ(session_registry->get_session_with_no_work(), sessions[2]);
+	EXPECT_EQ(session_registry->get_session_with_no_work(), nullptr);
+}
+
+TEST_F(Session_fixture, job_table_evicts_oldest_job)
+{
+	auto session = create_session(0U);
+	Session_job job;
+	EXPECT_FALSE(session->get_job(1U, job));
+	EXPECT_FALSE(session->get_latest_job(job));
+
+	// the ring holds the 8 latest jobs
+	std::vector<std::uint32_t> work_ids;
+	for (auto i = 0; i < 8; ++i)
+	{
+		work_ids.push_back(session->add_job(create_block(1U), Nonce_range{}, pool_nbits));
+	}
+	for (auto const work_id : work_ids)
+	{
+		ASSERT_TRUE(session->get_job(work_id, job));
+		EXPECT_EQ(job.m_work_id, work_id);
+	}
+	EXPECT_FALSE(session->get_job(0U, job));		// 0 is invalid
+
+	// the 9th job takes the slot of the 1st
+	auto const work_id = session->add_job(create_block(1U), Nonce_range{}, pool_nbits);
+	EXPECT_FALSE(session->get_job(work_ids.front(), job));
+	ASSERT_TRUE(session->get_job(work_id, job));
+	EXPECT_EQ(job.m_work_id, work_id);
+	ASSERT_TRUE(session->get_latest_job(job));
+	EXPECT_EQ(job.m_work_id, work_id);
+	for (std::size_t i = 1; i < work_ids.size(); ++i)
+	{
+		EXPECT_TRUE(session->get_job(work_ids[i], job));
+	}
+}
+
+TEST_F(Session_fixture, job_table_stale_work_id_after_wraparound)
+{
+	auto session = create_session(0U);
+	std::vector<std::uint32_t> work_ids;
+	for (auto i = 0; i < 20; ++i)
+	{
+		work_ids.push_back(session->add_job(create_block(1U), Nonce_range{ static_cast<std::uint64_t>(i), static_cast<std::uint64_t>(i + 1) }, pool_nbits));
+	}
+
+	// after the ring wrapped twice every slot is shared by work_ids 8 apart, only the latest one is found
+	Session_job job;
+	for (std::size_t i = 0; i < work_ids.size(); ++i)
+	{
+		auto const found = session->get_job(work_ids[i], job);
+		EXPECT_EQ(found, i >= work_ids.size() - 8) << "work_id " << work_ids[i];
+		if (found)
+		{
+			EXPECT_EQ(job.m_work_id, work_ids[i]);
+			EXPECT_EQ(job.m_nonce_range.m_start, i);
+		}
+	}
+	// a work_id which hasn't been handed out yet maps to an occupied slot
+	EXPECT_FALSE(session->get_job(work_ids.back() + 8, job));
+}
+
+TEST_F(Session_fixture, job_table_rejects_evicted_job)
+{
+	auto session = create_session(0U);
+	auto const old_work_id = session->add_job(create_block(1U), Nonce_range{}, pool_nbits);
+	auto const current_work_id = session->add_job(create_block(1U), Nonce_range{}, pool_nbits);
+
+	// a new height evicts all jobs of previous heights -> shares on them are rejected
+	auto const work_id = session->add_job(create_block(2U), Nonce_range{}, pool_nbits);
+	Session_job job;
+	EXPECT_FALSE(session->get_job(old_work_id, job));
+	EXPECT_FALSE(session->get_job(current_work_id, job));
+	ASSERT_TRUE(session->get_job(work_id, job));
+	EXPECT_EQ(job.m_block->nHeight, 2U);
+}
+
+TEST_F(Session_fixture, share_ledger_failed_async_flush_written_before_round_end)
+{
+	persistance::Shared_data_writer::Result_handler async_flush_handler;
+	EXPECT_CALL(*m_data_writer, write_async(_, _)).WillOnce(SaveArg<1>(&async_flush_handler));
+	m_share_ledger->add_share("account", 1.0);
+	m_share_ledger->flush_async([](bool) {});
+	ASSERT_TRUE(async_flush_handler);
+
+	// the queued async flush fails while the round end flush waits for it
+	m_share_ledger->add_share("account", 2.0);
+	EXPECT_CALL(*m_data_writer, flush()).WillOnce([&async_flush_handler]() { async_flush_handler(false); });
+	std::vector<persistance::Account_share_data> round_data;
+	EXPECT_CALL(*m_data_writer, add_shares_to_accounts(_)).WillOnce(DoAll(SaveArg<0>(&round_data), Return(true)));
+	EXPECT_TRUE(m_share_ledger->flush());
+	ASSERT_EQ(round_data.size(), 1U);
+	EXPECT_EQ(round_data.front().m_address, "account");
+	EXPECT_DOUBLE_EQ(round_data.front().m_shares, 3.0);
+
+	// nothing of the old round is left for the next round
+	EXPECT_CALL(*m_data_writer, write_async(_, _)).Times(0);
+	bool next_round_result{ false };
+	m_share_ledger->flush_async([&next_round_result](bool result) { next_round_result = result; });
+	EXPECT_TRUE(next_round_result);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "pool/share_filter.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ::nexuspool;
+
+TEST(Share_filter_test, duplicate_detection)
+{
+	Share_filter share_filter;
+	uint512_t const merkle_root{ 0x1234567890ULL };
+	EXPECT_TRUE(share_filter.insert(merkle_root, 42U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 42U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 42U));
+	EXPECT_EQ(share_filter.get_duplicates(), 2U);
+
+	// same nonce of another block, another nonce of the same block
+	EXPECT_TRUE(share_filter.insert(uint512_t{ 0x1234567891ULL }, 42U));
+	EXPECT_TRUE(share_filter.insert(merkle_root, 43U));
+	EXPECT_EQ(share_filter.get_duplicates(), 2U);
+
+	// new height
+	share_filter.clear();
+	EXPECT_TRUE(share_filter.insert(merkle_root, 42U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 42U));
+}
+
+TEST(Share_filter_test, full_table_never_rejects_new_share)
+{
+	// capacity is rounded up to 4 slots
+	Share_filter share_filter{ 3U };
+	uint512_t const merkle_root{ 1U };
+	for (std::uint64_t nonce = 0; nonce < 4U; ++nonce)
+	{
+		ASSERT_TRUE(share_filter.insert(merkle_root, nonce));
+	}
+
+	// no free slot left -> new shares pass, the stored ones are still detected
+	for (std::uint64_t nonce = 4U; nonce < 100U; ++nonce)
+	{
+		EXPECT_TRUE(share_filter.insert(merkle_root, nonce));
+	}
+	for (std::uint64_t nonce = 0; nonce < 4U; ++nonce)
+	{
+		EXPECT_FALSE(share_filter.insert(merkle_root, nonce));
+	}
+	EXPECT_TRUE(share_filter.insert(merkle_root, 4U));
+	EXPECT_EQ(share_filter.get_duplicates(), 4U);
+}
+
+TEST(Share_filter_test, colliding_slots)
+{
+	// every fingerprint maps to the single slot
+	Share_filter share_filter{ 1U };
+	uint512_t const merkle_root{ 1U };
+	EXPECT_TRUE(share_filter.insert(merkle_root, 1U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 1U));
+
+	// a share colliding with the stored one is treated as new, but can't be remembered
+	EXPECT_TRUE(share_filter.insert(merkle_root, 2U));
+	EXPECT_TRUE(share_filter.insert(merkle_root, 2U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 1U));
+	EXPECT_EQ(share_filter.get_duplicates(), 2U);
+}
+
+TEST(Share_filter_test, fingerprint_collision_not_rejected)
+{
+	// the fingerprint only covers the low 128 bits of the merkle root -> both shares have the same fingerprint
+	Share_filter share_filter;
+	uint512_t const merkle_root{ 1U };
+	uint512_t const colliding_merkle_root = merkle_root + (uint512_t{ 1U } << 128);
+	EXPECT_TRUE(share_filter.insert(merkle_root, 42U));
+	EXPECT_TRUE(share_filter.insert(colliding_merkle_root, 42U));
+	EXPECT_FALSE(share_filter.insert(merkle_root, 42U));
+	EXPECT_FALSE(share_filter.insert(colliding_merkle_root, 42U));
+	EXPECT_EQ(share_filter.get_duplicates(), 2U);
+}
+
+TEST(Share_filter_test, concurrent_inserts)
+{
+	Share_filter share_filter;
+	std::size_t const threads{ 4U };
+	std::uint64_t const shares{ 10000U };
+	std::atomic<std::uint64_t> accepted{ 0U };
+
+	// all threads submit the same shares -> each share passes exactly once
+	std::vector<std::thread> submitters;
+	for (std::size_t i = 0; i < threads; ++i)
+	{
+		submitters.emplace_back([&share_filter, &accepted, shares]()
+		{
+			for (std::uint64_t nonce = 0; nonce < shares; ++nonce)
+			{
+				if (share_filter.insert(uint512_t{ nonce % 7 }, nonce))
+				{
+					accepted++;
+				}
+			}
+		});
+	}
+	for (auto& submitter : submitters)
+	{
+		submitter.join();
+	}
+
+	EXPECT_EQ(accepted, shares);
+	EXPECT_EQ(share_filter.get_duplicates(), (threads - 1) * shares);
+}
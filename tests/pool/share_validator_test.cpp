@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include "pool/share_validator.hpp"
+#include "network/connection_mock.hpp"
+#include "reward/component_mock.hpp"
+#include <asio/io_context.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace ::nexuspool;
+using namespace ::testing;
+
+namespace
+{
+std::uint32_t const pool_nbits{ 0x7c00d8e5 };
+
+// shares with an even nonce are accepted
+reward::Difficulty_result get_result(std::uint64_t nonce)
+{
+	return nonce % 2 == 0 ? reward::Difficulty_result::accept : reward::Difficulty_result::reject;
+}
+
+// prime share with offsets -> validated on its own
+std::unique_ptr<LLP::CBlock> create_prime_block(std::uint64_t nonce)
+{
+	auto block = std::make_unique<LLP::CBlock>();
+	block->nChannel = 1;
+	block->nHeight = 10U;
+	block->nNonce = nonce;
+	block->vOffsets = { 2U, 4U };
+	return block;
+}
+}
+
+class Share_validator_fixture : public ::testing::Test
+{
+public:
+
+	Share_validator_fixture()
+		: m_io_context{ std::make_shared<::asio::io_context>() }
+		, m_connection{ std::make_shared<NiceMock<network::Connection_mock>>() }
+	{
+		ON_CALL(m_reward_component, check_difficulty(An<LLP::CBlock const&>(), An<std::uint32_t>()))
+			.WillByDefault(Invoke([](LLP::CBlock const& block, std::uint32_t) { return get_result(block.nNonce); }));
+		ON_CALL(m_reward_component, check_difficulty(An<LLP::CBlock const&>(), An<LLP::Block_hash_context const&>()))
+			.WillByDefault(Invoke([](LLP::CBlock const& block, LLP::Block_hash_context const&) { return get_result(block.nNonce); }));
+		ON_CALL(m_reward_component, check_difficulty(An<uint1024_t const&>(), An<LLP::Block_hash_context const&>()))
+			.WillByDefault(Invoke([this](uint1024_t const& block_hash, LLP::Block_hash_context const&) { return get_result(m_nonce_of_hash.at(block_hash)); }));
+		ON_CALL(m_reward_component, check_difficulty(An<double>(), An<LLP::CBlock const&>(), An<std::uint32_t>()))
+			.WillByDefault(Invoke([](double, LLP::CBlock const& block, std::uint32_t) { return get_result(block.nNonce); }));
+
+		// the strand of the connection is simulated by collecting the completions, the test runs them
+		ON_CALL(*m_connection, post(_)).WillByDefault(Invoke([this](std::function<void()> handler)
+		{
+			std::scoped_lock lock(m_mutex);
+			m_posted.push_back(std::move(handler));
+			m_condition.notify_all();
+		}));
+	}
+
+protected:
+
+	void create_share_validator(std::uint16_t threads, std::size_t queue_size)
+	{
+		m_share_validator = std::make_unique<Share_validator>(m_io_context, m_reward_component, threads, queue_size);
+	}
+
+	Share_validator::Handler get_handler()
+	{
+		return [this](std::unique_ptr<LLP::CBlock> block, reward::Difficulty_result result)
+		{
+			m_results.emplace_back(block->nNonce, result);
+		};
+	}
+
+	bool wait_for_completions(std::size_t count)
+	{
+		std::unique_lock lock(m_mutex);
+		return m_condition.wait_for(lock, std::chrono::seconds(10), [this, count]() { return m_posted.size() >= count; });
+	}
+
+	void run_completions()
+	{
+		std::vector<std::function<void()>> posted;
+		{
+			std::scoped_lock lock(m_mutex);
+			posted.swap(m_posted);
+		}
+		for (auto& handler : posted)
+		{
+			handler();
+		}
+	}
+
+	std::shared_ptr<::asio::io_context> m_io_context;
+	std::shared_ptr<network::Connection_mock> m_connection;
+	NiceMock<reward::Component_mock> m_reward_component;
+	std::map<uint1024_t, std::uint64_t> m_nonce_of_hash;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::vector<std::function<void()>> m_posted;
+	std::vector<std::pair<std::uint64_t, reward::Difficulty_result>> m_results;
+	std::unique_ptr<Share_validator> m_share_validator;
+};
+
+TEST_F(Share_validator_fixture, completion_on_connection_strand)
+{
+	create_share_validator(1U, 16U);
+	EXPECT_CALL(*m_connection, post(_)).Times(2);
+
+	m_share_validator->validate(create_prime_block(2U), pool_nbits, nullptr, m_connection, get_handler());
+	m_share_validator->validate(create_prime_block(3U), pool_nbits, nullptr, m_connection, get_handler());
+	ASSERT_TRUE(wait_for_completions(2U));
+
+	// nothing is handed to the io_context
+	EXPECT_EQ(m_io_context->poll(), 0U);
+	EXPECT_TRUE(m_results.empty());
+	run_completions();
+	ASSERT_EQ(m_results.size(), 2U);
+	EXPECT_EQ(m_results[0], std::make_pair(std::uint64_t{ 2U }, reward::Difficulty_result::accept));
+	EXPECT_EQ(m_results[1], std::make_pair(std::uint64_t{ 3U }, reward::Difficulty_result::reject));
+}
+
+TEST_F(Share_validator_fixture, completion_without_connection_on_io_context)
+{
+	create_share_validator(1U, 16U);
+	m_share_validator->validate(create_prime_block(2U), pool_nbits, nullptr, nullptr, get_handler());
+	m_share_validator->stop();
+
+	EXPECT_EQ(m_io_context->run(), 1U);
+	ASSERT_EQ(m_results.size(), 1U);
+	EXPECT_EQ(m_results[0].second, reward::Difficulty_result::accept);
+}
+
+TEST_F(Share_validator_fixture, closed_queue_validates_inline)
+{
+	create_share_validator(1U, 16U);
+	m_share_validator->stop();
+
+	// the submitting thread validates the share itself
+	m_share_validator->validate(create_prime_block(2U), pool_nbits, nullptr, m_connection, get_handler());
+	EXPECT_EQ(m_share_validator->get_metrics().m_validated_inline, 1U);
+	run_completions();
+	ASSERT_EQ(m_results.size(), 1U);
+	EXPECT_EQ(m_results[0].second, reward::Difficulty_result::accept);
+}
+
+TEST_F(Share_validator_fixture, full_queue_validates_inline)
+{
+	create_share_validator(1U, 1U);
+
+	// the worker is blocked in the first share, the second fills the queue
+	std::promise<void> release_worker;
+	auto worker_released = release_worker.get_future().share();
+	std::promise<void> worker_blocked;
+	EXPECT_CALL(m_reward_component, check_difficulty(An<LLP::CBlock const&>(), An<std::uint32_t>()))
+		.WillOnce(Invoke([&](LLP::CBlock const& block, std::uint32_t)
+		{
+			worker_blocked.set_value();
+			worker_released.wait();
+			return get_result(block.nNonce);
+		}))
+		.WillRepeatedly(Invoke([](LLP::CBlock const& block, std::uint32_t) { return get_result(block.nNonce); }));
+
+	m_share_validator->validate(create_prime_block(2U), pool_nbits, nullptr, m_connection, get_handler());
+	worker_blocked.get_future().wait();
+	m_share_validator->validate(create_prime_block(4U), pool_nbits, nullptr, m_connection, get_handler());
+	m_share_validator->validate(create_prime_block(5U), pool_nbits, nullptr, m_connection, get_handler());
+	EXPECT_EQ(m_share_validator->get_metrics().m_validated_inline, 1U);
+
+	release_worker.set_value();
+	m_share_validator->stop();
+	run_completions();
+	EXPECT_EQ(m_results.size(), 3U);
+	EXPECT_EQ(m_share_validator->get_metrics().m_validated, 3U);
+}
+
+TEST_F(Share_validator_fixture, stop_drains_queue)
+{
+	create_share_validator(1U, 100U);
+	for (std::uint64_t nonce = 0; nonce < 50U; ++nonce)
+	{
+		m_share_validator->validate(create_prime_block(nonce), pool_nbits, nullptr, m_connection, get_handler());
+	}
+	m_share_validator->stop();
+
+	// every queued share is validated before the workers exit
+	auto const metrics = m_share_validator->get_metrics();
+	EXPECT_EQ(metrics.m_validated, 50U);
+	EXPECT_EQ(metrics.m_validated_inline, 0U);
+	EXPECT_EQ(metrics.m_queue_depth, 0U);
+	run_completions();
+	EXPECT_EQ(m_results.size(), 50U);
+}
+
+TEST_F(Share_validator_fixture, batch_results_match_shares)
+{
+	create_share_validator(1U, 100U);
+
+	LLP::CBlock block;
+	block.nChannel = 2;
+	block.nHeight = 10U;
+	block.nBits = 0x7b00d8e5;
+	auto const hash_context = std::make_shared<LLP::Block_hash_context const>(block, pool_nbits);
+	for (std::uint64_t nonce = 0; nonce < 8U; ++nonce)
+	{
+		m_nonce_of_hash.emplace(hash_context->get_hash(nonce), nonce);
+	}
+
+	// the worker is blocked until all hash shares are queued -> they are taken as one batch
+	std::promise<void> release_worker;
+	auto worker_released = release_worker.get_future().share();
+	EXPECT_CALL(m_reward_component, check_difficulty(An<LLP::CBlock const&>(), An<std::uint32_t>()))
+		.WillOnce(Invoke([worker_released](LLP::CBlock const& block, std::uint32_t)
+		{
+			worker_released.wait();
+			return get_result(block.nNonce);
+		}));
+
+	m_share_validator->validate(create_prime_block(100U), pool_nbits, nullptr, m_connection, get_handler());
+	for (std::uint64_t nonce = 0; nonce < 8U; ++nonce)
+	{
+		auto share = std::make_unique<LLP::CBlock>(block);
+		share->nNonce = nonce;
+		m_share_validator->validate(std::move(share), pool_nbits, hash_context, m_connection, get_handler());
+	}
+	release_worker.set_value();
+	m_share_validator->stop();
+
+	run_completions();
+	ASSERT_EQ(m_results.size(), 9U);
+	for (auto const& result : m_results)
+	{
+		EXPECT_EQ(result.second, get_result(result.first));
+	}
+}
@@ -1,6 +1,5 @@
 #include <gtest/gtest.h>
 #include <chrono>
-#include <thread>
 #include "pool/utils.hpp"
 
 using namespace ::nexuspool;
@@ -8,15 +7,94 @@ using namespace ::testing;
 
 TEST(Utils_test, Hashrate_helper_test)
 {
-	Hashrate_helper hashrate_helper{ common::Mining_mode::PRIME };
-	hashrate_helper.add_share();
-	std::this_thread::sleep_for(std::chrono::milliseconds(10));
-	hashrate_helper.add_share();
-	std::this_thread::sleep_for(std::chrono::milliseconds(15));
-	hashrate_helper.add_share();
-	std::this_thread::sleep_for(std::chrono::milliseconds(20));
-	hashrate_helper.add_share();
-	std::this_thread::sleep_for(std::chrono::milliseconds(25));
-	hashrate_helper.add_share();
-
-}
\ No newline at end of file
+	auto time = std::chrono::steady_clock::now();
+	Hashrate_helper hashrate_helper{ common::Mining_mode::PRIME, [&time]() { return time; } };
+	EXPECT_FALSE(hashrate_helper.add_share());
+	time += std::chrono::milliseconds(10);
+	EXPECT_FALSE(hashrate_helper.add_share());
+	time += std::chrono::milliseconds(15);
+	EXPECT_FALSE(hashrate_helper.add_share());
+	time += std::chrono::milliseconds(20);
+	EXPECT_FALSE(hashrate_helper.add_share());
+	time += std::chrono::milliseconds(25);
+	EXPECT_TRUE(hashrate_helper.add_share());
+	EXPECT_EQ(hashrate_helper.get_average_share_time(), std::chrono::milliseconds(14));
+
+	time += std::chrono::milliseconds(30);
+	EXPECT_EQ(hashrate_helper.get_time_since_last_share(), std::chrono::milliseconds(30));
+}
+
+TEST(Utils_test, Vardiff_test)
+{
+	Vardiff disabled{ 0U };
+	EXPECT_FALSE(disabled.is_enabled());
+	EXPECT_FALSE(disabled.retarget(std::chrono::minutes(10)));
+
+	// target share time 10s
+	Vardiff vardiff{ 6U };
+	EXPECT_TRUE(vardiff.is_enabled());
+	EXPECT_EQ(vardiff.get_step(), 0);
+
+	// inside the window
+	vardiff.set_average_share_time(std::chrono::seconds(8));
+	EXPECT_FALSE(vardiff.retarget(std::chrono::seconds(1)));
+
+	// too many shares -> harder
+	vardiff.set_average_share_time(std::chrono::seconds(2));
+	EXPECT_TRUE(vardiff.retarget(std::chrono::seconds(1)));
+	EXPECT_EQ(vardiff.get_step(), 1);
+	// the share window is only used once
+	EXPECT_FALSE(vardiff.retarget(std::chrono::seconds(1)));
+
+	// too few shares -> easier
+	vardiff.set_average_share_time(std::chrono::seconds(30));
+	EXPECT_TRUE(vardiff.retarget(std::chrono::seconds(1)));
+	EXPECT_EQ(vardiff.get_step(), 0);
+
+	// no shares at all -> easier
+	EXPECT_TRUE(vardiff.retarget(std::chrono::seconds(41)));
+	EXPECT_EQ(vardiff.get_step(), -1);
+
+	for (int i = 0; i < 2 * Vardiff::max_step; ++i)
+	{
+		vardiff.set_average_share_time(std::chrono::seconds(1));
+		vardiff.retarget(std::chrono::seconds(1));
+	}
+	EXPECT_EQ(vardiff.get_step(), Vardiff::max_step);
+}
+
+TEST(Utils_test, get_vardiff_nbits_test)
+{
+	uint1024_t network_target;
+	network_target.SetCompact(0x7c3fffffU);
+	auto const network_nbits = network_target.GetCompact();
+	auto const pool_nbits = (network_target << 4).GetCompact();
+	uint1024_t pool_target;
+	pool_target.SetCompact(pool_nbits);
+
+	int step = 0;
+	EXPECT_EQ(get_vardiff_nbits(pool_nbits, network_nbits, step), pool_nbits);
+
+	step = 2;
+	EXPECT_EQ(get_vardiff_nbits(pool_nbits, network_nbits, step), (pool_target >> 2).GetCompact());
+	EXPECT_EQ(step, 2);
+
+	step = -3;
+	EXPECT_EQ(get_vardiff_nbits(pool_nbits, network_nbits, step), (pool_target << 3).GetCompact());
+	EXPECT_EQ(step, -3);
+
+	// never harder than the network difficulty
+	step = 10;
+	EXPECT_EQ(get_vardiff_nbits(pool_nbits, network_nbits, step), network_nbits);
+	EXPECT_EQ(step, 4);
+	// pool_nbits is rounded by the compact format -> about 16
+	EXPECT_NEAR(get_share_weight(pool_nbits, network_nbits), 16.0, 0.001);
+
+	// pool target 3 times the network target -> the second step is clamped to the network target
+	auto const uneven_pool_nbits = ((network_target << 1) + network_target).GetCompact();
+	step = 10;
+	EXPECT_EQ(get_vardiff_nbits(uneven_pool_nbits, network_nbits, step), network_nbits);
+	EXPECT_EQ(step, 2);
+	// shares are only worth the real difficulty, not 2^step
+	EXPECT_NEAR(get_share_weight(uneven_pool_nbits, network_nbits), 3.0, 0.001);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "pool/work_template.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace ::nexuspool;
+
+namespace
+{
+std::uint32_t const pool_nbits{ 0x7c00d8e5 };
+
+LLP::CBlock create_block(std::uint32_t height)
+{
+	LLP::CBlock block;
+	block.nChannel = 2;
+	block.nHeight = height;
+	block.nBits = 0x7b00d8e5;
+	return block;
+}
+}
+
+TEST(Work_template_test, no_work_without_block_of_current_height)
+{
+	Work_template work_template;
+	Work_message::Sptr work_message;
+	Nonce_range nonce_range;
+	EXPECT_FALSE(work_template.get_work(work_message, nonce_range));
+
+	work_template.reset(10U);
+	EXPECT_FALSE(work_template.set_block(create_block(9U), pool_nbits));
+	EXPECT_FALSE(work_template.is_valid());
+	EXPECT_FALSE(work_template.get_work(work_message, nonce_range));
+
+	EXPECT_TRUE(work_template.set_block(create_block(10U), pool_nbits));
+	EXPECT_TRUE(work_template.is_valid());
+	EXPECT_TRUE(work_template.get_work(work_message, nonce_range));
+	EXPECT_EQ(work_message->get_block().nHeight, 10U);
+}
+
+TEST(Work_template_test, range_assignment)
+{
+	Work_template work_template;
+	work_template.reset(10U);
+	ASSERT_TRUE(work_template.set_block(create_block(10U), pool_nbits));
+
+	Work_message::Sptr work_message;
+	Nonce_range nonce_range;
+	ASSERT_TRUE(work_template.get_work(work_message, nonce_range));
+	EXPECT_EQ(nonce_range.m_start, 0U);
+	EXPECT_EQ(nonce_range.m_end, Work_template::nonce_range_size);
+	EXPECT_EQ(work_message->get_pool_nbits(), pool_nbits);
+
+	Work_message::Sptr second_work_message;
+	ASSERT_TRUE(work_template.get_work(second_work_message, nonce_range));
+	EXPECT_EQ(nonce_range.m_start, Work_template::nonce_range_size);
+	EXPECT_EQ(nonce_range.m_end, 2 * Work_template::nonce_range_size);
+	// serialized once for all miners
+	EXPECT_EQ(second_work_message, work_message);
+
+	// a new block for the height starts again at the first range
+	ASSERT_TRUE(work_template.set_block(create_block(10U), pool_nbits));
+	ASSERT_TRUE(work_template.get_work(work_message, nonce_range));
+	EXPECT_EQ(nonce_range.m_start, 0U);
+	EXPECT_NE(second_work_message, work_message);
+}
+
+TEST(Work_template_test, ranges_dont_overlap)
+{
+	Work_template work_template;
+	work_template.reset(10U);
+	ASSERT_TRUE(work_template.set_block(create_block(10U), pool_nbits));
+
+	std::vector<Nonce_range> nonce_ranges(1000U);
+	Work_message::Sptr work_message;
+	for (auto& nonce_range : nonce_ranges)
+	{
+		ASSERT_TRUE(work_template.get_work(work_message, nonce_range));
+		EXPECT_TRUE(nonce_range.is_valid());
+	}
+
+	std::sort(nonce_ranges.begin(), nonce_ranges.end(), [](auto const& lhs, auto const& rhs) { return lhs.m_start < rhs.m_start; });
+	for (std::size_t i = 1; i < nonce_ranges.size(); ++i)
+	{
+		EXPECT_GE(nonce_ranges[i].m_start, nonce_ranges[i - 1].m_end);
+		EXPECT_FALSE(nonce_ranges[i - 1].contains(nonce_ranges[i].m_start));
+	}
+}
+
+TEST(Work_template_test, range_index_wraps)
+{
+	Work_template work_template;
+	work_template.reset(10U);
+	ASSERT_TRUE(work_template.set_block(create_block(10U), pool_nbits));
+
+	Work_message::Sptr work_message;
+	Nonce_range nonce_range;
+	Nonce_range last_range;
+	for (std::uint64_t i = 0; i < Work_template::max_nonce_ranges; ++i)
+	{
+		ASSERT_TRUE(work_template.get_work(work_message, nonce_range));
+		last_range = nonce_range;
+	}
+	// the last range ends below the top of the nonce space, m_end doesn't overflow
+	EXPECT_TRUE(last_range.is_valid());
+	EXPECT_EQ(last_range.m_end, Work_template::max_nonce_ranges * Work_template::nonce_range_size);
+
+	ASSERT_TRUE(work_template.get_work(work_message, nonce_range));
+	EXPECT_EQ(nonce_range.m_start, 0U);
+	EXPECT_EQ(nonce_range.m_end, Work_template::nonce_range_size);
+}
@@ -62,7 +62,7 @@ public:
 		{
 			common::Block_reward_data reward_data{};
 			EXPECT_CALL(*m_test_data.m_http_interface_mock_raw, get_block_reward_data(block.m_hash, _)).WillRepeatedly(Return(true));
-			EXPECT_CALL(*m_test_data.m_shared_data_writer_mock, update_block_rewards(block.m_hash, _, _)).WillRepeatedly(Return(true));
+			EXPECT_CALL(*m_test_data.m_data_writer_mock, update_block_rewards(block.m_hash, _, _)).WillRepeatedly(Return(true));
 		}
 	}
 
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "reward_fixture.hpp"
 #include "common/utils.hpp"
+#include "TAO/Ledger/prime.h"
 
 using namespace ::nexuspool;
 
@@ -54,6 +55,17 @@ TEST_F(Reward_fixture_created_component, prime_difficulty_test)
 	test_block.nNonce+=100;
 	result = m_component->check_difficulty(test_block, test_nbits);
 	EXPECT_EQ(result, nexuspool::reward::Difficulty_result::reject);
+	test_block.nNonce-=100;
+
+	// offsets submitted by the miner, only the claimed positions are tested
+	TAO::Ledger::GetOffsets(test_block.GetPrime(), test_block.vOffsets);
+	result = m_component->check_difficulty(test_block, test_nbits);
+	EXPECT_EQ(result, nexuspool::reward::Difficulty_result::block_found);
+
+	// a wrong fractional difficulty
+	test_block.vOffsets.back()++;
+	result = m_component->check_difficulty(test_block, test_nbits);
+	EXPECT_EQ(result, nexuspool::reward::Difficulty_result::reject);
 
 	//todo: find example of a block that would be accpepted by the pool but not mainnet
 
@@ -131,7 +143,7 @@ TEST_F(Reward_fixture_created_component, pay_round_calculate_rewards_tests)
 	{
 		common::Block_reward_data reward_data{};
 		EXPECT_CALL(*m_test_data.m_http_interface_mock_raw, get_block_reward_data(block.m_hash, _)).WillRepeatedly(Return(true));
-		EXPECT_CALL(*m_test_data.m_shared_data_writer_mock, update_block_rewards(block.m_hash, _, _)).WillOnce(Return(true));
+		EXPECT_CALL(*m_test_data.m_data_writer_mock, update_block_rewards(block.m_hash, _, _)).WillOnce(Return(true));
 	}
 
 	auto result = m_component->pay_round(test_round_not_active_not_paid_data.m_round);
@@ -162,15 +174,48 @@ TEST_F(Reward_fixture_created_component, end_round_test)
 	double total_shares_input = 0;
 	for (auto& active_account : test_active_accounts_from_round)
 	{
-		EXPECT_CALL(*m_test_data.m_shared_data_writer_mock, add_payment(_)).WillRepeatedly(Return(true));
+		EXPECT_CALL(*m_test_data.m_data_writer_mock, add_payment(_)).WillRepeatedly(Return(true));
 		total_shares_input += active_account.m_shares;
 	}
 	EXPECT_CALL(*m_test_data.m_data_reader_mock_raw, get_total_shares_from_accounts).WillOnce(Return(total_shares_input));
 	EXPECT_CALL(*m_test_data.m_data_reader_mock_raw, get_active_accounts_from_round).WillOnce(Return(test_active_accounts_from_round));
-	EXPECT_CALL(*m_test_data.m_shared_data_writer_mock, reset_shares_from_accounts).WillOnce(Return(true));
-	EXPECT_CALL(*m_test_data.m_shared_data_writer_mock, update_round(_)).WillOnce(Return(true));
+	EXPECT_CALL(*m_test_data.m_data_writer_mock, reset_shares_from_accounts).WillOnce(Return(true));
+	EXPECT_CALL(*m_test_data.m_data_writer_mock, update_round(_)).WillOnce(Return(true));
 
 	auto result = m_component->end_round(test_round_data.m_round);
 	EXPECT_TRUE(result);
 }
 
+TEST_F(Reward_fixture_created_component, end_round_write_failed_test)
+{
+	EXPECT_CALL(*m_test_data.m_data_reader_mock_raw, get_latest_round).WillRepeatedly(Return(test_round_data));
+	EXPECT_TRUE(m_component->is_round_active());
+
+	EXPECT_CALL(*m_test_data.m_data_reader_mock_raw, get_total_shares_from_accounts).WillOnce(Return(10.0));
+	EXPECT_CALL(*m_test_data.m_data_reader_mock_raw, get_active_accounts_from_round).WillOnce(Return(test_active_accounts_from_round));
+	EXPECT_CALL(*m_test_data.m_data_writer_mock, add_payment(_)).WillRepeatedly(Return(true));
+	// first failed write rolls back the transaction, the round isn't ended
+	EXPECT_CALL(*m_test_data.m_data_writer_mock, reset_shares_from_accounts).WillOnce(Return(false));
+	EXPECT_CALL(*m_test_data.m_data_writer_mock, update_round(_)).Times(0);
+
+	auto result = m_component->end_round(test_round_data.m_round);
+	EXPECT_FALSE(result);
+	EXPECT_EQ(m_component->get_current_round(), test_round_data.m_round);
+}
+
+
+TEST_F(Reward_fixture_created_component, difficulty_hash_context_test)
+{
+	LLP::CBlock test_block = m_test_data.create_hash_channel_test_block();
+	std::uint32_t test_nbits = test_block.nBits;
+	LLP::Block_hash_context hash_context{ test_block, test_nbits };
+
+	EXPECT_EQ(hash_context.get_hash(test_block.nNonce), test_block.GetHash());
+	auto result = m_component->check_difficulty(test_block, hash_context);
+	EXPECT_EQ(result, nexuspool::reward::Difficulty_result::block_found);
+
+	test_block.nNonce++;
+	EXPECT_EQ(hash_context.get_hash(test_block.nNonce), test_block.GetHash());
+	result = m_component->check_difficulty(test_block, hash_context);
+	EXPECT_EQ(result, nexuspool::reward::Difficulty_result::reject);
+}
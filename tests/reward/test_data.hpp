@@ -58,6 +58,7 @@ public:
 		m_data_writer_factory_mock = std::make_shared<NiceMock<persistance::Data_writer_factory_mock>>();
 		m_data_reader_mock = std::make_unique<NiceMock<persistance::Data_reader_mock>>();
 		m_shared_data_writer_mock = std::make_shared<NiceMock<persistance::Shared_data_writer_mock>>();
+		m_data_writer_mock = std::make_unique<NiceMock<persistance::Data_writer_mock>>();
 		m_data_reader_mock_raw = m_data_reader_mock.get();
 
 		m_http_interface_mock = std::make_unique<nexus_http_interface::Component_mock>();
@@ -129,6 +130,13 @@ public:
 		ON_CALL(*m_persistance_component_mock, get_data_reader_factory()).WillByDefault(Return(m_data_reader_factory_mock));
 
 		ON_CALL(*m_data_writer_factory_mock, create_shared_data_writer_impl()).WillByDefault(Return(m_shared_data_writer_mock));
+		// transactions are written with the plain data_writer mock
+		ON_CALL(*m_data_writer_mock, begin_transaction()).WillByDefault(Return(true));
+		ON_CALL(*m_data_writer_mock, commit_transaction()).WillByDefault(Return(true));
+		ON_CALL(*m_shared_data_writer_mock, write_transaction(_)).WillByDefault(Invoke([this](persistance::Shared_data_writer::Write write)
+		{
+			return write(*m_data_writer_mock);
+		}));
 		ON_CALL(*m_data_reader_factory_mock, create_data_reader_impl()).WillByDefault(Return(ByMove(std::move(m_data_reader_mock))));
 
 		return std::move(m_persistance_component_mock);
@@ -140,6 +148,7 @@ public:
 	std::unique_ptr<persistance::Data_reader_mock> m_data_reader_mock;
 	persistance::Data_reader_mock* m_data_reader_mock_raw{ nullptr };
 	std::shared_ptr<persistance::Shared_data_writer_mock> m_shared_data_writer_mock;
+	std::unique_ptr<persistance::Data_writer_mock> m_data_writer_mock;
 	std::unique_ptr<nexus_http_interface::Component_mock> m_http_interface_mock;
 	nexus_http_interface::Component_mock* m_http_interface_mock_raw{ nullptr };
 	std::shared_ptr<chrono::Timer_factory_mock> m_timer_factory_mock;